@@ -29,6 +29,77 @@
 
 #include "mcu_arch.h"
 
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+/** maximum number of events handled per wakeup */
+#define MCU_EVENT_MAX 8
+
+static int mcu_epoll_fd = -1;
+/** eventfd used to wake up the main loop from other threads */
+static int mcu_wakeup_fd = -1;
+
+static void mcu_arch_event_init(void)
+{
+  mcu_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (mcu_epoll_fd < 0) {
+    perror("mcu_arch_event_init: epoll_create1");
+    return;
+  }
+  mcu_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (mcu_wakeup_fd < 0) {
+    perror("mcu_arch_event_init: eventfd");
+    return;
+  }
+  mcu_arch_event_watch_fd(mcu_wakeup_fd, FALSE);
+}
+
+void mcu_arch_event_watch_fd(int fd, bool_t out)
+{
+  if (mcu_epoll_fd < 0 || fd < 0) {
+    return;
+  }
+  struct epoll_event ev;
+  ev.events = EPOLLIN | (out ? EPOLLOUT : 0);
+  ev.data.fd = fd;
+  if (epoll_ctl(mcu_epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+    if (errno != ENOENT || epoll_ctl(mcu_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      perror("mcu_arch_event_watch_fd");
+    }
+  }
+}
+
+void mcu_arch_event_wakeup(void)
+{
+  if (mcu_wakeup_fd >= 0) {
+    const uint64_t one = 1;
+    if (write(mcu_wakeup_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+      perror("mcu_arch_event_wakeup");
+    }
+  }
+}
+
+void mcu_arch_event_wait(void)
+{
+  if (mcu_epoll_fd < 0) {
+    return;
+  }
+  struct epoll_event events[MCU_EVENT_MAX];
+  int n = epoll_wait(mcu_epoll_fd, events, MCU_EVENT_MAX, -1);
+  for (int i = 0; i < n; i++) {
+    /* reset the wakeup counter, other fds are handled by the event functions */
+    if (events[i].data.fd == mcu_wakeup_fd) {
+      uint64_t val;
+      if (read(mcu_wakeup_fd, &val, sizeof(val)) < 0 && errno != EAGAIN) {
+        perror("mcu_arch_event_wait");
+      }
+    }
+  }
+}
+
 #if USE_LINUX_SIGNAL
 #include "message_pragmas.h"
 PRINT_CONFIG_MSG("Catching SIGINT. Press CTRL-C twice to stop program.")
@@ -39,7 +110,6 @@ PRINT_CONFIG_MSG("Catching SIGINT. Press CTRL-C twice to stop program.")
  */
 
 #include <stdlib.h>
-#include <stdio.h>
 #include <signal.h>
 
 /**
@@ -70,11 +140,16 @@ void mcu_arch_init(void)
   if (sigaction(SIGINT, &sa, NULL) == -1) {
     printf("Can't catch SIGINT\n");
   }
+
+  mcu_arch_event_init();
 }
 
 #else
 
-void mcu_arch_init(void) { }
+void mcu_arch_init(void)
+{
+  mcu_arch_event_init();
+}
 
 #endif
 
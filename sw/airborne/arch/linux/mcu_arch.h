@@ -30,8 +30,41 @@
 #ifndef MCU_ARCH_H_
 #define MCU_ARCH_H_
 
+#include "std.h"
+
+/** Block the main loop until a timer elapsed or a file descriptor is ready.
+ * If FALSE, the main loop polls the peripherals continuously.
+ */
+#ifndef MCU_EVENT_WAIT
+#define MCU_EVENT_WAIT TRUE
+#endif
+
 extern void mcu_arch_init(void);
 
+/** Wake up the main loop and events on registered file descriptors.
+ * Used when MCU_EVENT_WAIT is TRUE.
+ * @{
+ */
+
+/** Watch a file descriptor from the main loop.
+ * The main loop wakes up when fd is readable,
+ * or writable if out is TRUE (e.g. while data is waiting to be sent).
+ * Can be called again on the same fd to change out.
+ */
+extern void mcu_arch_event_watch_fd(int fd, bool_t out);
+
+/** Wake up the main loop, can be called from any thread */
+extern void mcu_arch_event_wakeup(void);
+
+/** Block until a watched fd is ready or mcu_arch_event_wakeup() is called */
+extern void mcu_arch_event_wait(void);
+
+/** @}*/
+
+#if MCU_EVENT_WAIT
+#define mcu_event_wait() mcu_arch_event_wait()
+#endif
+
 #define mcu_int_enable() {}
 #define mcu_int_disable() {}
 
@@ -23,108 +23,250 @@
 
 /** @file arch/linux/mcu_periph/i2c_arch.c
  * I2C functionality
+ *
+ * Each bus has its own thread running the transactions with I2C_RDWR ioctls,
+ * so the main loop is never blocked by the bus.
+ * The transaction status is only updated from i2c_event (main thread),
+ * the thread wakes up the main loop when a transaction is done.
  */
 
 #include "mcu_periph/i2c.h"
+#include "mcu_arch.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
-#include <errno.h>
+
+/** Linux specific part of an I2C bus, pointed to by the reg_addr field */
+struct i2c_linux {
+  int fd;
+  pthread_t thread;
+  sem_t sem;              ///< posted for each submitted transaction
+  /** next transaction run by the thread,
+   * transactions between trans_extract_idx and done_idx are finished */
+  uint8_t done_idx;
+  enum I2CTransactionStatus result[I2C_TRANSACTION_QUEUE_LEN];
+  uint32_t submit_time[I2C_TRANSACTION_QUEUE_LEN];   ///< in usec
+  uint32_t bus_time[I2C_TRANSACTION_QUEUE_LEN];      ///< in usec
+  struct i2c_arch_stats stats;
+};
+
+static uint32_t i2c_time_usec(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+/** Run a transaction as a single I2C_RDWR ioctl (repeated start for TxRx) */
+static bool_t i2c_transfer(int fd, struct i2c_transaction *t)
+{
+  struct i2c_msg msgs[2];
+  struct i2c_rdwr_ioctl_data data = { msgs, 0 };
+
+  if (t->type == I2CTransTx || t->type == I2CTransTxRx) {
+    msgs[data.nmsgs].addr = t->slave_addr;
+    msgs[data.nmsgs].flags = 0;
+    msgs[data.nmsgs].len = t->len_w;
+    msgs[data.nmsgs].buf = (uint8_t *)t->buf;
+    data.nmsgs++;
+  }
+  if (t->type == I2CTransRx || t->type == I2CTransTxRx) {
+    msgs[data.nmsgs].addr = t->slave_addr;
+    msgs[data.nmsgs].flags = I2C_M_RD;
+    msgs[data.nmsgs].len = t->len_r;
+    msgs[data.nmsgs].buf = (uint8_t *)t->buf;
+    data.nmsgs++;
+  }
+  return (ioctl(fd, I2C_RDWR, &data) >= 0);
+}
+#pragma GCC diagnostic pop
+
+static void *i2c_thread(void *data)
+{
+  struct i2c_periph *p = (struct i2c_periph *)data;
+  struct i2c_linux *il = (struct i2c_linux *)(p->reg_addr);
+
+  while (TRUE) {
+    if (sem_wait(&il->sem) != 0) {
+      continue; // interrupted by a signal
+    }
+    uint8_t idx = il->done_idx;
+    uint32_t start = i2c_time_usec();
+    il->result[idx] = i2c_transfer(il->fd, p->trans[idx]) ? I2CTransSuccess : I2CTransFailed;
+    il->bus_time[idx] = i2c_time_usec() - start;
+    // result is visible before the index
+    __atomic_store_n(&il->done_idx, (idx + 1) % I2C_TRANSACTION_QUEUE_LEN, __ATOMIC_RELEASE);
+    mcu_arch_event_wakeup();
+  }
+  return NULL;
+}
+
+/** Report the finished transactions of a bus */
+static void i2c_linux_event(struct i2c_periph *p)
+{
+  struct i2c_linux *il = (struct i2c_linux *)(p->reg_addr);
+  if (il == NULL) {
+    return;
+  }
+
+  const uint8_t done = __atomic_load_n(&il->done_idx, __ATOMIC_ACQUIRE);
+  const uint32_t now = i2c_time_usec();
+  while (p->trans_extract_idx != done) {
+    uint8_t idx = p->trans_extract_idx;
+    uint32_t latency = now - il->submit_time[idx];
+    il->stats.nb_trans++;
+    if (il->result[idx] == I2CTransFailed) {
+      il->stats.nb_failed++;
+    }
+    il->stats.bus_time = il->bus_time[idx];
+    il->stats.bus_time_max = Max(il->stats.bus_time_max, il->bus_time[idx]);
+    il->stats.latency = latency;
+    il->stats.latency_max = Max(il->stats.latency_max, latency);
+    p->trans[idx]->status = il->result[idx];
+    p->trans_extract_idx = (idx + 1) % I2C_TRANSACTION_QUEUE_LEN;
+  }
+}
 
 void i2c_event(void)
 {
+#if USE_I2C0
+  i2c_linux_event(&i2c0);
+#endif
+#if USE_I2C1
+  i2c_linux_event(&i2c1);
+#endif
+#if USE_I2C2
+  i2c_linux_event(&i2c2);
+#endif
 }
 
 void i2c_setbitrate(struct i2c_periph *p  __attribute__((unused)), int bitrate __attribute__((unused)))
 {
 }
 
-bool_t i2c_idle(struct i2c_periph *p __attribute__((unused)))
+bool_t i2c_idle(struct i2c_periph *p)
 {
-  return TRUE;
+  return (p->trans_extract_idx == p->trans_insert_idx);
 }
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-qual"
 bool_t i2c_submit(struct i2c_periph *p, struct i2c_transaction *t)
 {
-  int file = (int)p->reg_addr;
-
-  // Set the slave address
-  ioctl(file, I2C_SLAVE, t->slave_addr);
-
-  // Switch the different transaction types
-  switch (t->type) {
-      // Just transmitting
-    case I2CTransTx:
-      if (write(file, (uint8_t *)t->buf, t->len_w) < 0) {
-        t->status = I2CTransFailed;
-        return TRUE;
-      }
-      break;
-      // Just reading
-    case I2CTransRx:
-      if (read(file, (uint8_t *)t->buf, t->len_r) < 0) {
-        t->status = I2CTransFailed;
-        return TRUE;
-      }
-      break;
-      // First Transmit and then read
-    case I2CTransTxRx:
-      if (write(file, (uint8_t *)t->buf, t->len_w) < 0 ||
-          read(file, (uint8_t *)t->buf, t->len_r) < 0) {
-        t->status = I2CTransFailed;
-        return TRUE;
-      }
-      break;
-    default:
-      break;
+  struct i2c_linux *il = (struct i2c_linux *)(p->reg_addr);
+  if (il == NULL) {
+    t->status = I2CTransFailed;
+    return TRUE;
   }
 
-  // Successfull transfer
-  t->status = I2CTransSuccess;
+  uint8_t idx = p->trans_insert_idx;
+  uint8_t next = (idx + 1) % I2C_TRANSACTION_QUEUE_LEN;
+  if (next == p->trans_extract_idx) {
+    // queue full
+    p->errors->queue_full_cnt++;
+    t->status = I2CTransFailed;
+    return FALSE;
+  }
+
+  t->status = I2CTransPending;
+  p->trans[idx] = t;
+  il->submit_time[idx] = i2c_time_usec();
+  p->trans_insert_idx = next;
+  // start the transaction in the bus thread
+  sem_post(&il->sem);
   return TRUE;
 }
-#pragma GCC diagnostic pop
+
+struct i2c_arch_stats *i2c_arch_get_stats(struct i2c_periph *p)
+{
+  struct i2c_linux *il = (struct i2c_linux *)(p->reg_addr);
+  return (il != NULL) ? &il->stats : NULL;
+}
+
+/** Open the bus device and start its thread */
+static void i2c_linux_init(struct i2c_periph *p, const char *dev)
+{
+  int fd = open(dev, O_RDWR);
+  if (fd < 0) {
+    fprintf(stderr, "I2C: could not open %s\n", dev);
+    p->reg_addr = NULL;
+    return;
+  }
+
+  struct i2c_linux *il = calloc(1, sizeof(struct i2c_linux));
+  il->fd = fd;
+  sem_init(&il->sem, 0, 0);
+  p->reg_addr = (void *)il;
+
+  if (pthread_create(&il->thread, NULL, i2c_thread, (void *)p) != 0) {
+    fprintf(stderr, "I2C: could not create thread for %s\n", dev);
+    p->reg_addr = NULL;
+    close(fd);
+    free(il);
+    return;
+  }
+  pthread_detach(il->thread);
+}
 
 
 #if USE_I2C0
 struct i2c_errors i2c0_errors;
 
+#ifndef I2C0_DEV
+#define I2C0_DEV "/dev/i2c-0"
+#endif
+
 void i2c0_hw_init(void)
 {
-  i2c1.reg_addr = (void *)open("/dev/i2c-0", O_RDWR);
   i2c0.errors = &i2c0_errors;
 
   /* zeros error counter */
   ZEROS_ERR_COUNTER(i2c0_errors);
+
+  i2c_linux_init(&i2c0, I2C0_DEV);
 }
 #endif
 
 #if USE_I2C1
 struct i2c_errors i2c1_errors;
 
+#ifndef I2C1_DEV
+#define I2C1_DEV "/dev/i2c-1"
+#endif
+
 void i2c1_hw_init(void)
 {
-  i2c1.reg_addr = (void *)open("/dev/i2c-1", O_RDWR);
   i2c1.errors = &i2c1_errors;
 
   /* zeros error counter */
   ZEROS_ERR_COUNTER(i2c1_errors);
+
+  i2c_linux_init(&i2c1, I2C1_DEV);
 }
 #endif
 
 #if USE_I2C2
 struct i2c_errors i2c2_errors;
 
+#ifndef I2C2_DEV
+#define I2C2_DEV "/dev/i2c-2"
+#endif
+
 void i2c2_hw_init(void)
 {
-  i2c2.reg_addr = (void *)open("/dev/i2c-2", O_RDWR);
   i2c2.errors = &i2c2_errors;
 
   /* zeros error counter */
   ZEROS_ERR_COUNTER(i2c2_errors);
+
+  i2c_linux_init(&i2c2, I2C2_DEV);
 }
 #endif
@@ -30,6 +30,23 @@
 
 #include "mcu_periph/i2c.h"
 
+/** Transaction statistics of an I2C bus, times in usec */
+struct i2c_arch_stats {
+  uint32_t nb_trans;      ///< finished transactions
+  uint32_t nb_failed;     ///< failed transactions
+  uint32_t bus_time;      ///< duration of the last transfer on the bus
+  uint32_t bus_time_max;
+  uint32_t latency;       ///< time from submit to completion of the last transaction
+  uint32_t latency_max;
+};
+
+struct i2c_periph;
+
+/** Get the statistics of a bus
+ * @return NULL if the bus is not opened
+ */
+extern struct i2c_arch_stats *i2c_arch_get_stats(struct i2c_periph *p);
+
 #if USE_I2C0
 extern void i2c0_hw_init(void);
 #endif /* USE_I2C0 */
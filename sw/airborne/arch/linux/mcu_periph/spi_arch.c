@@ -21,6 +21,12 @@
 /**
  * @file arch/linux/mcu_periph/spi_arch.c
  * Handling of SPI hardware for Linux.
+ *
+ * Each bus has its own thread running the transactions with spidev ioctls.
+ * All transactions queued when the thread wakes up are sent with a single
+ * SPI_IOC_MESSAGE(n) ioctl.
+ * The transaction status is only updated from spi_event (main thread),
+ * where the after_cb callbacks are called.
  */
 
 #include <stdio.h>
@@ -28,13 +34,41 @@
 #include <stdlib.h>
 #include <fcntl.h>
 #include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
 
 #include <sys/ioctl.h>
 #include <linux/spi/spidev.h>
 
 #include "mcu_periph/spi.h"
+#include "mcu_arch.h"
 #include BOARD_CONFIG
 
+/** Linux specific part of a SPI bus, pointed to by the reg_addr field */
+struct spi_linux {
+  int fd;
+  uint32_t speed_hz;
+  pthread_t thread;
+  sem_t sem;              ///< posted for each submitted transaction
+  /** next transaction run by the thread,
+   * transactions between trans_extract_idx and done_idx are finished */
+  uint8_t done_idx;
+  enum SPITransactionStatus result[SPI_TRANSACTION_QUEUE_LEN];
+  uint32_t submit_time[SPI_TRANSACTION_QUEUE_LEN];   ///< in usec
+  uint32_t bus_time[SPI_TRANSACTION_QUEUE_LEN];      ///< in usec, of the whole ioctl
+  /** buffers for transactions with different input and output lengths */
+  uint8_t *scratch[SPI_TRANSACTION_QUEUE_LEN];
+  uint16_t scratch_len[SPI_TRANSACTION_QUEUE_LEN];
+  struct spi_arch_stats stats;
+};
+
+static uint32_t spi_time_usec(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
 
 void spi_init_slaves(void)
 {
@@ -45,62 +79,166 @@ void spi_init_slaves(void)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-qual"
-bool_t spi_submit(struct spi_periph *p, struct spi_transaction *t)
+/** Fill the transfer of the transaction in slot idx */
+static void spi_fill_xfer(struct spi_linux *sl, uint8_t idx, struct spi_transaction *t,
+                          struct spi_ioc_transfer *xfer, bool_t last)
 {
-  int fd = (int)p->reg_addr;
-
-  struct spi_ioc_transfer xfer;
-  memset(&xfer, 0, sizeof xfer);
+  memset(xfer, 0, sizeof(struct spi_ioc_transfer));
 
   /* length in bytes of transaction */
   uint16_t buf_len = Max(t->input_length, t->output_length);
 
-  /* handle transactions with different input/output length */
+  /* handle transactions with different input/output length,
+   * only one of the buffers can be shorter */
+  if (buf_len > t->input_length || buf_len > t->output_length) {
+    if (sl->scratch_len[idx] < buf_len) {
+      sl->scratch[idx] = realloc(sl->scratch[idx], buf_len);
+      sl->scratch_len[idx] = buf_len;
+    }
+    memset(sl->scratch[idx], 0, buf_len);
+  }
   if (buf_len > t->output_length) {
-    uint8_t tx_buf[buf_len];
-    memset(tx_buf, 0, sizeof tx_buf);
     /* copy bytes to transmit to larger buffer, rest filled with zero */
-    memcpy(tx_buf, (void *)t->output_buf, t->output_length);
-    xfer.tx_buf = (unsigned long)tx_buf;
+    memcpy(sl->scratch[idx], (void *)t->output_buf, t->output_length);
+    xfer->tx_buf = (unsigned long)sl->scratch[idx];
   } else {
-    xfer.tx_buf = (unsigned long)t->output_buf;
+    xfer->tx_buf = (unsigned long)t->output_buf;
   }
-
   if (buf_len > t->input_length) {
-    uint8_t rx_buf[buf_len];
-    memset(rx_buf, 0, sizeof rx_buf);
-    xfer.rx_buf = (unsigned long)rx_buf;
+    xfer->rx_buf = (unsigned long)sl->scratch[idx];
   } else {
-    xfer.rx_buf = (unsigned long)t->input_buf;
+    xfer->rx_buf = (unsigned long)t->input_buf;
   }
 
-  xfer.len = buf_len;
-  /* fixed speed of 1Mhz for now, use SPIClockDiv?? */
-  xfer.speed_hz = (uint32_t)p->init_struct;
-  xfer.delay_usecs = 0;
+  xfer->len = buf_len;
+  xfer->speed_hz = sl->speed_hz;
+  xfer->delay_usecs = 0;
   if (t->dss == SPIDss16bit) {
-    xfer.bits_per_word = 16;
+    xfer->bits_per_word = 16;
   } else {
-    xfer.bits_per_word = 8;
+    xfer->bits_per_word = 8;
   }
-  if (t->select == SPISelectUnselect || t->select == SPIUnselect) {
-    xfer.cs_change = 1;
+  /* cs_change deselects between transfers, but keeps CS selected after the last one */
+  bool_t unselect = (t->select == SPISelectUnselect || t->select == SPIUnselect);
+  xfer->cs_change = last ? !unselect : unselect;
+}
+
+/** Copy the received data if an extra rx buffer was used */
+static void spi_copy_input(struct spi_linux *sl, uint8_t idx, struct spi_transaction *t)
+{
+  if (Max(t->input_length, t->output_length) > t->input_length) {
+    memcpy((void *)t->input_buf, sl->scratch[idx], t->input_length);
   }
+}
+#pragma GCC diagnostic pop
+
+static void *spi_thread(void *data)
+{
+  struct spi_periph *p = (struct spi_periph *)data;
+  struct spi_linux *sl = (struct spi_linux *)(p->reg_addr);
+  struct spi_ioc_transfer xfer[SPI_TRANSACTION_QUEUE_LEN];
+
+  while (TRUE) {
+    if (sem_wait(&sl->sem) != 0) {
+      continue; // interrupted by a signal
+    }
+    /* take all the queued transactions */
+    uint8_t nb = 1;
+    while (nb < SPI_TRANSACTION_QUEUE_LEN - 1 && sem_trywait(&sl->sem) == 0) {
+      nb++;
+    }
+
+    const uint8_t first = sl->done_idx;
+    for (uint8_t i = 0; i < nb; i++) {
+      uint8_t idx = (first + i) % SPI_TRANSACTION_QUEUE_LEN;
+      spi_fill_xfer(sl, idx, p->trans[idx], &xfer[i], i == nb - 1);
+    }
+    uint32_t start = spi_time_usec();
+    bool_t ok = (ioctl(sl->fd, SPI_IOC_MESSAGE(nb), xfer) >= 0);
+    uint32_t bus_time = spi_time_usec() - start;
+    for (uint8_t i = 0; i < nb; i++) {
+      uint8_t idx = (first + i) % SPI_TRANSACTION_QUEUE_LEN;
+      if (ok) {
+        spi_copy_input(sl, idx, p->trans[idx]);
+      }
+      sl->result[idx] = ok ? SPITransSuccess : SPITransFailed;
+      sl->bus_time[idx] = bus_time;
+    }
+    // results are visible before the index
+    __atomic_store_n(&sl->done_idx, (first + nb) % SPI_TRANSACTION_QUEUE_LEN, __ATOMIC_RELEASE);
+    mcu_arch_event_wakeup();
+  }
+  return NULL;
+}
+
+/** Report the finished transactions of a bus */
+static void spi_linux_event(struct spi_periph *p)
+{
+  struct spi_linux *sl = (struct spi_linux *)(p->reg_addr);
+  if (sl == NULL) {
+    return;
+  }
+
+  const uint8_t done = __atomic_load_n(&sl->done_idx, __ATOMIC_ACQUIRE);
+  const uint32_t now = spi_time_usec();
+  while (p->trans_extract_idx != done) {
+    uint8_t idx = p->trans_extract_idx;
+    struct spi_transaction *t = p->trans[idx];
+    uint32_t latency = now - sl->submit_time[idx];
+    sl->stats.nb_trans++;
+    if (sl->result[idx] == SPITransFailed) {
+      sl->stats.nb_failed++;
+    }
+    sl->stats.bus_time = sl->bus_time[idx];
+    sl->stats.bus_time_max = Max(sl->stats.bus_time_max, sl->bus_time[idx]);
+    sl->stats.latency = latency;
+    sl->stats.latency_max = Max(sl->stats.latency_max, latency);
+    p->trans_extract_idx = (idx + 1) % SPI_TRANSACTION_QUEUE_LEN;
+    t->status = sl->result[idx];
+    if (t->after_cb != 0) {
+      t->after_cb(t);
+    }
+  }
+}
 
-  if (ioctl(fd, SPI_IOC_MESSAGE(1), &xfer) < 0) {
+void spi_event(void)
+{
+#if USE_SPI0
+  spi_linux_event(&spi0);
+#endif
+#if USE_SPI1
+  spi_linux_event(&spi1);
+#endif
+}
+
+bool_t spi_submit(struct spi_periph *p, struct spi_transaction *t)
+{
+  struct spi_linux *sl = (struct spi_linux *)(p->reg_addr);
+  if (sl == NULL) {
     t->status = SPITransFailed;
     return FALSE;
   }
 
-  /* copy recieved data if we had to use an extra rx_buffer */
-  if (buf_len > t->input_length) {
-    memcpy((void *)t->input_buf, (void *)((uint32_t)xfer.rx_buf), t->input_length);
+  uint8_t idx = p->trans_insert_idx;
+  uint8_t next = (idx + 1) % SPI_TRANSACTION_QUEUE_LEN;
+  if (next == p->trans_extract_idx) {
+    // queue full
+    t->status = SPITransFailed;
+    return FALSE;
   }
 
-  t->status = SPITransSuccess;
+  t->status = SPITransPending;
+  /* called from the main thread when the transaction is queued */
+  if (t->before_cb != 0) {
+    t->before_cb(t);
+  }
+  p->trans[idx] = t;
+  sl->submit_time[idx] = spi_time_usec();
+  p->trans_insert_idx = next;
+  // start the transaction in the bus thread
+  sem_post(&sl->sem);
   return TRUE;
 }
-#pragma GCC diagnostic pop
 
 bool_t spi_lock(struct spi_periph *p, uint8_t slave)
 {
@@ -114,6 +252,30 @@ bool_t spi_resume(struct spi_periph *p, uint8_t slave)
   return FALSE;
 }
 
+struct spi_arch_stats *spi_arch_get_stats(struct spi_periph *p)
+{
+  struct spi_linux *sl = (struct spi_linux *)(p->reg_addr);
+  return (sl != NULL) ? &sl->stats : NULL;
+}
+
+/** Start the thread of an opened bus */
+static void spi_linux_init(struct spi_periph *p, int fd, uint32_t speed_hz)
+{
+  struct spi_linux *sl = calloc(1, sizeof(struct spi_linux));
+  sl->fd = fd;
+  sl->speed_hz = speed_hz;
+  sem_init(&sl->sem, 0, 0);
+  p->reg_addr = (void *)sl;
+
+  if (pthread_create(&sl->thread, NULL, spi_thread, (void *)p) != 0) {
+    perror("SPI: could not create thread");
+    p->reg_addr = NULL;
+    free(sl);
+    return;
+  }
+  pthread_detach(sl->thread);
+}
+
 
 #if USE_SPI0
 
@@ -142,7 +304,6 @@ void spi0_arch_init(void)
     spi0.reg_addr = NULL;
     return;
   }
-  spi0.reg_addr = (void *)fd;
 
   /* spi mode */
   unsigned char spi_mode = SPI0_MODE;
@@ -167,7 +328,7 @@ void spi0_arch_init(void)
   if (ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &spi_speed) < 0) {
     perror("SPI0: can't set max speed hz");
   }
-  spi0.init_struct = (void *)SPI0_MAX_SPEED_HZ;
+  spi_linux_init(&spi0, fd, SPI0_MAX_SPEED_HZ);
 }
 #endif /* USE_SPI0 */
 
@@ -198,7 +359,6 @@ void spi1_arch_init(void)
     spi1.reg_addr = NULL;
     return;
   }
-  spi1.reg_addr = (void *)fd;
 
   /* spi mode */
   unsigned char spi_mode = SPI1_MODE;
@@ -214,7 +374,7 @@ void spi1_arch_init(void)
 
   /* bits per word default to 8 */
   unsigned char spi_bits_per_word = SPI1_BITS_PER_WORD;
-  if (ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &spi_bits_per_word) < 0) {r
+  if (ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &spi_bits_per_word) < 0) {
     perror("SPI1: can't set bits per word");
   }
 
@@ -223,6 +383,6 @@ void spi1_arch_init(void)
   if (ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &spi_speed) < 0) {
     perror("SPI1: can't set max speed hz");
   }
-  spi1.init_struct = (void *)SPI1_MAX_SPEED_HZ;
+  spi_linux_init(&spi1, fd, SPI1_MAX_SPEED_HZ);
 }
 #endif /* USE_SPI1 */
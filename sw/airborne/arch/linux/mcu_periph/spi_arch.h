@@ -26,5 +26,23 @@
 #ifndef SPI_ARCH_H
 #define SPI_ARCH_H
 
+#include "std.h"
+
+/** Transaction statistics of a SPI bus, times in usec */
+struct spi_arch_stats {
+  uint32_t nb_trans;      ///< finished transactions
+  uint32_t nb_failed;     ///< failed transactions
+  uint32_t bus_time;      ///< duration of the last ioctl, for all the transfers it contained
+  uint32_t bus_time_max;
+  uint32_t latency;       ///< time from submit to completion of the last transaction
+  uint32_t latency_max;
+};
+
+struct spi_periph;
+
+/** Get the statistics of a bus
+ * @return NULL if the bus is not opened
+ */
+extern struct spi_arch_stats *spi_arch_get_stats(struct spi_periph *p);
 
 #endif // SPI_ARCH_H
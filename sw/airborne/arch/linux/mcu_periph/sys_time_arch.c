@@ -25,6 +25,7 @@
  */
 
 #include "mcu_periph/sys_time.h"
+#include "mcu_arch.h"
 #include <stdio.h>
 #include <pthread.h>
 #include <sys/timerfd.h>
@@ -83,7 +84,7 @@ void *sys_time_thread_main(void *data)
       perror("Couldn't read timer!");
     }
     if (missed > 1) {
-      fprintf(stderr, "Missed %lld timer events!\n", missed);
+      sys_time.nb_missed_tick += missed - 1;
     }
     /* set current sys_time */
     sys_tick_handler();
@@ -132,15 +133,22 @@ static void sys_tick_handler(void)
   sys_time.nb_tick = sys_time_ticks_of_sec(d_sec) + sys_time_ticks_of_usec(d_nsec / 1000);
 
   /* advance virtual timers */
+  bool_t elapsed = FALSE;
   for (unsigned int i = 0; i < SYS_TIME_NB_TIMER; i++) {
     if (sys_time.timer[i].in_use &&
         sys_time.nb_tick >= sys_time.timer[i].end_time) {
       sys_time.timer[i].end_time += sys_time.timer[i].duration;
+      sys_time_prof_elapsed(i);
       sys_time.timer[i].elapsed = TRUE;
+      elapsed = TRUE;
       /* call registered callbacks, WARNING: they will be executed in the sys_time thread! */
       if (sys_time.timer[i].cb) {
         sys_time.timer[i].cb(i);
       }
     }
   }
+  /* let the main loop run the elapsed periodic tasks */
+  if (elapsed) {
+    mcu_arch_event_wakeup();
+  }
 }
@@ -30,6 +30,7 @@
 
 #include "std.h"
 #include <unistd.h>
+#include <time.h>
 
 /**
  * Get the time in microseconds since startup.
@@ -52,6 +53,21 @@ static inline uint32_t get_sys_time_msec(void)
          msec_of_cpu_ticks(sys_time.nb_sec_rem);
 }
 
+#define SYS_TIME_HAS_CPU_TICKS 1
+
+/**
+ * Get a free running counter in CPU ticks (usec), wraps around.
+ * Read from CLOCK_MONOTONIC, so it is more precise than get_sys_time_usec
+ * which is only updated by the sys_time thread.
+ * @return CPU ticks
+ */
+static inline uint32_t get_sys_time_cpu_ticks(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
 static inline void sys_time_usleep(uint32_t us)
 {
   usleep(us);
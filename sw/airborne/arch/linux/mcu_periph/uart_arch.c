@@ -21,6 +21,10 @@
 
 /** @file arch/linux/mcu_periph/uart_arch.c
  * linux uart handling
+ *
+ * The receive ring is filled with one read per contiguous free span and the
+ * transmit ring is flushed with one write per contiguous span, either at the
+ * end of each message (link device send_message) or from the event loop.
  */
 
 #include BOARD_CONFIG
@@ -35,34 +39,56 @@
 #include <errno.h>
 
 #include "serial_port.h"
+#include "mcu_arch.h"
 
 // #define TRACE(fmt,args...)    fprintf(stderr, fmt, args)
 #define TRACE(fmt,args...)
 
+/** Linux specific part of a UART, pointed to by the reg_addr field */
+struct uart_linux {
+  struct SerialPort *port;
+  struct uart_arch_stats stats;
+};
+
+static void uart_send_message(struct uart_periph *periph);
 
 void uart_periph_set_baudrate(struct uart_periph *periph, uint32_t baud)
 {
   periph->baudrate = baud;
 
-  struct SerialPort *port;
+  struct uart_linux *ul = (struct uart_linux *)(periph->reg_addr);
+  if (ul == NULL) {
+    // use register address to store the linux part
+    ul = calloc(1, sizeof(struct uart_linux));
+    periph->reg_addr = (void *)ul;
+  }
   // close serial port if already open
-  if (periph->reg_addr != NULL) {
-    port = (struct SerialPort *)(periph->reg_addr);
-    serial_port_close(port);
-    serial_port_free(port);
+  if (ul->port != NULL) {
+    serial_port_close(ul->port);
+    serial_port_free(ul->port);
   }
   // open serial port
-  port = serial_port_new();
-  // use register address to store SerialPort structure pointer...
-  periph->reg_addr = (void *)port;
+  ul->port = serial_port_new();
 
   //TODO: set device name in application and pass as argument
   // FIXME: paparazzi baud is 9600 for B9600 while open_raw needs 12 for B9600
   // /printf("opening %s on uart0 at termios.h baud value=%d\n", periph->dev, baud);
-  int ret = serial_port_open_raw(port, periph->dev, baud);
+  int ret = serial_port_open_raw(ul->port, periph->dev, baud);
   if (ret != 0) {
     TRACE("Error opening %s code %d\n", periph->dev, ret);
+    ul->port->fd = -1;
+  } else {
+    // wake up the main loop on incoming data
+    mcu_arch_event_watch_fd(ul->port->fd, FALSE);
   }
+  // flush the transmit queue at the end of each message
+  periph->device.send_message = (send_message_t)uart_send_message;
+}
+
+struct uart_arch_stats *uart_arch_get_stats(struct uart_periph *periph)
+{
+  struct uart_linux *ul = (struct uart_linux *)(periph->reg_addr);
+  return (ul != NULL) ? &ul->stats : NULL;
 }
 
 void uart_transmit(struct uart_periph *periph, uint8_t data)
@@ -70,63 +96,115 @@ void uart_transmit(struct uart_periph *periph, uint8_t data)
   uint16_t temp = (periph->tx_insert_idx + 1) % UART_TX_BUFFER_SIZE;
 
   if (temp == periph->tx_extract_idx) {
-    printf("uart tx queue full!\n");
-    return;  // no room
+    // no room
+    struct uart_linux *ul = (struct uart_linux *)(periph->reg_addr);
+    if (ul != NULL) {
+      ul->stats.tx_dropped++;
+    }
+    return;
   }
 
-  // check if in process of sending data
-  if (periph->tx_running) { // yes, add to queue
-    periph->tx_buf[periph->tx_insert_idx] = data;
-    periph->tx_insert_idx = temp;
-  } else { // no, set running flag and write to output register
+  periph->tx_buf[periph->tx_insert_idx] = data;
+  periph->tx_insert_idx = temp;
+
+  if (!periph->tx_running && periph->reg_addr != NULL) {
+    // keep the main loop running until the queue is sent
     periph->tx_running = TRUE;
-    struct SerialPort *port = (struct SerialPort *)(periph->reg_addr);
-    int ret = write((int)(port->fd), &data, 1);
-    if (ret < 1) {
-      TRACE("uart_transmit: write %d failed [%d: %s]\n", data, ret, strerror(errno));
-      /* if write was interrupted, put data into queue */
-      if (errno == EINTR) {
-        periph->tx_buf[periph->tx_insert_idx] = data;
-        periph->tx_insert_idx = temp;
-      }
-    }
+    mcu_arch_event_watch_fd(((struct uart_linux *)(periph->reg_addr))->port->fd, TRUE);
   }
 }
 
-
-static inline void uart_handler(struct uart_periph *periph)
+/**
+ * Write the transmit queue, one write per contiguous span of the ring.
+ * Stops when the queue is empty or the fd would block.
+ */
+static void uart_flush_tx(struct uart_periph *periph, struct uart_linux *ul)
 {
-  unsigned char c = 'D';
-
-  if (periph->reg_addr == NULL) { return; } // device not initialized ?
+  int fd = ul->port->fd;
 
-  struct SerialPort *port = (struct SerialPort *)(periph->reg_addr);
-  int fd = port->fd;
-
-  // check if more data to send
-  if (periph->tx_insert_idx != periph->tx_extract_idx) {
-    int ret = write(fd, &(periph->tx_buf[periph->tx_extract_idx]), 1);
-    if (ret < 1) {
-      TRACE("uart_handler: write %x failed [%d: %s]\n", periph->tx_buf[periph->tx_extract_idx], ret, strerror(errno));
+  while (periph->tx_insert_idx != periph->tx_extract_idx) {
+    uint16_t end = (periph->tx_insert_idx > periph->tx_extract_idx) ?
+                   periph->tx_insert_idx : UART_TX_BUFFER_SIZE;
+    uint16_t len = end - periph->tx_extract_idx;
+    ssize_t ret = write(fd, &periph->tx_buf[periph->tx_extract_idx], len);
+    ul->stats.tx_syscalls++;
+    if (ret <= 0) {
+      if (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        TRACE("uart_flush_tx: write failed [%d: %s]\n", errno, strerror(errno));
+      }
+      return;
     }
-    else {
-      periph->tx_extract_idx++;
-      periph->tx_extract_idx %= UART_TX_BUFFER_SIZE;
+    ul->stats.tx_bytes += ret;
+    periph->tx_extract_idx = (periph->tx_extract_idx + ret) % UART_TX_BUFFER_SIZE;
+    if (ret < len) {
+      // device buffer full, continue when writable
+      return;
     }
-  } else {
+  }
+
+  if (periph->tx_running) {
     periph->tx_running = FALSE;   // clear running flag
+    mcu_arch_event_watch_fd(fd, FALSE);
   }
+}
 
-  if (read(fd, &c, 1) > 0) {
-    //printf("r %x %c\n",c,c);
-    uint16_t temp = (periph->rx_insert_idx + 1) % UART_RX_BUFFER_SIZE;
-    periph->rx_buf[periph->rx_insert_idx] = c;
-    // check for more room in queue
-    if (temp != periph->rx_extract_idx) {
-      periph->rx_insert_idx = temp;  // update insert index
+/**
+ * Read all available data, one read per contiguous free span of the ring.
+ * Data that doesn't fit in the ring is read anyway and counted as dropped.
+ */
+static void uart_fill_rx(struct uart_periph *periph, struct uart_linux *ul)
+{
+  int fd = ul->port->fd;
+
+  while (TRUE) {
+    uint8_t *buf;
+    uint16_t len;
+    uint8_t discard[64];
+    // the ring is full when insert is just before extract
+    uint16_t last = (periph->rx_extract_idx + UART_RX_BUFFER_SIZE - 1) % UART_RX_BUFFER_SIZE;
+    if (periph->rx_insert_idx == last) {
+      buf = discard;
+      len = sizeof(discard);
+    } else {
+      buf = &periph->rx_buf[periph->rx_insert_idx];
+      len = ((periph->rx_insert_idx < last) ? last : UART_RX_BUFFER_SIZE) - periph->rx_insert_idx;
+    }
+    ssize_t ret = read(fd, buf, len);
+    ul->stats.rx_syscalls++;
+    if (ret <= 0) {
+      if (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        TRACE("uart_fill_rx: read failed [%d: %s]\n", errno, strerror(errno));
+      }
+      return;
+    }
+    if (buf == discard) {
+      ul->stats.rx_dropped += ret;
+      periph->ore++;
+    } else {
+      ul->stats.rx_bytes += ret;
+      periph->rx_insert_idx = (periph->rx_insert_idx + ret) % UART_RX_BUFFER_SIZE;
+    }
+    if (ret < len) {
+      // nothing more to read for now
+      return;
     }
   }
+}
+
+static void uart_send_message(struct uart_periph *periph)
+{
+  struct uart_linux *ul = (struct uart_linux *)(periph->reg_addr);
+  if (ul == NULL || ul->port->fd < 0) { return; } // device not initialized ?
+  uart_flush_tx(periph, ul);
+}
+
+static inline void uart_handler(struct uart_periph *periph)
+{
+  struct uart_linux *ul = (struct uart_linux *)(periph->reg_addr);
+  if (ul == NULL || ul->port->fd < 0) { return; } // device not initialized ?
 
+  uart_flush_tx(periph, ul);
+  uart_fill_rx(periph, ul);
 }
 
 void uart_event(void)
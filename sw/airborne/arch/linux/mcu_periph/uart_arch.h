@@ -26,6 +26,16 @@
 #ifndef UART_ARCH_H
 #define UART_ARCH_H
 
+#include <stdint.h>
+
+/* larger buffers than on MCUs, data is read and written in blocks */
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE 1024
+#endif
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 1024
+#endif
+
 #include "mcu_periph/uart.h"
 
 // for definition of baud rates
@@ -50,4 +60,21 @@ static inline int uart_speed(int def)
 }
 #define UART_SPEED(_def) uart_speed(_def)
 
+/** Input/output statistics of a UART */
+struct uart_arch_stats {
+  uint32_t rx_bytes;      ///< bytes read
+  uint32_t rx_syscalls;   ///< read calls
+  uint32_t rx_dropped;    ///< bytes read while the receive buffer was full
+  uint32_t tx_bytes;      ///< bytes written
+  uint32_t tx_syscalls;   ///< write calls
+  uint32_t tx_dropped;    ///< bytes not queued because the transmit buffer was full
+};
+
+struct uart_periph;
+
+/** Get the statistics of a UART
+ * @return NULL if the UART is not opened
+ */
+extern struct uart_arch_stats *uart_arch_get_stats(struct uart_periph *periph);
+
 #endif /* UART_ARCH_H */
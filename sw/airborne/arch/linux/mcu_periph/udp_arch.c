@@ -21,89 +21,372 @@
 
 /** @file arch/linux/mcu_periph/udp_arch.c
  * linux UDP handling
+ *
+ * Each UDP peripheral has its own thread blocking on the socket.
+ * All pending datagrams are drained at once with recvmmsg and copied to the
+ * rx buffer, which is a single producer/single consumer ring shared with the
+ * autopilot loop.
+ * Outgoing messages are coalesced into MTU sized datagrams in one of two tx
+ * batches. Once per event loop the filled batch is handed over to the thread,
+ * which sends it with a single sendmmsg while the other one is being filled.
  */
 
+#define _GNU_SOURCE /* recvmmsg, sendmmsg */
+
 #include "mcu_periph/udp.h"
 #include "udp_socket.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include "rt_priority.h"
+#include "mcu_arch.h"
+
+/** Maximum number of datagrams per recvmmsg/sendmmsg call */
+#ifndef UDP_MMSG_NB
+#define UDP_MMSG_NB 16
+#endif
+
+/** Maximum datagram size (ethernet MTU minus IP and UDP headers) */
+#ifndef UDP_MTU
+#define UDP_MTU 1472
+#endif
+
+#ifndef UDP_THREAD_PRIO
+#define UDP_THREAD_PRIO 10
+#endif
+
+/** Batch of outgoing datagrams */
+struct udp_tx_batch {
+  uint8_t buf[UDP_MMSG_NB][UDP_MTU];
+  uint16_t len[UDP_MMSG_NB];
+  uint8_t nb;                     ///< number of datagrams in use
+  uint32_t msgs;                  ///< number of messages in the batch
+};
+
+/** Linux specific UDP network structure */
+struct udp_thread {
+  struct UdpSocket sock;
+  struct udp_periph *periph;
+  pthread_t thread;
+  int efd;                        ///< eventfd used to wake up the thread
+  /* Transmit double buffer */
+  struct udp_tx_batch tx[2];
+  uint8_t tx_fill;                ///< batch currently filled by the autopilot loop
+  volatile bool_t tx_busy;        ///< the other batch is owned by the thread
+  /* Receive buffers for recvmmsg */
+  uint8_t rx_dgram[UDP_MMSG_NB][UDP_MTU];
+  volatile uint32_t rx_stamp;     ///< reception time of last datagrams in usec
+  volatile uint32_t rx_seq;       ///< incremented by the thread at each reception
+  uint32_t rx_seq_seen;           ///< last rx_seq seen by the autopilot loop
+  /* Rate computation */
+  uint32_t rate_stamp;
+  uint32_t rate_rx_packets;
+  uint32_t rate_tx_packets;
+};
+
+static void *udp_thread_main(void *data);
+
+/** Get monotonic time in usec (wraps after ~71 minutes, only used for differences) */
+static uint32_t udp_get_time_usec(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(now.tv_sec * 1000000 + now.tv_nsec / 1000);
+}
 
 /**
  * Initialize the UDP peripheral.
- * Allocate UdpSocket struct and create and bind the UDP socket.
+ * Allocate the network struct, create and bind the UDP socket and start the
+ * reception thread.
  */
 void udp_arch_periph_init(struct udp_periph *p, char *host, int port_out, int port_in, bool_t broadcast)
 {
-  struct UdpSocket *sock = malloc(sizeof(struct UdpSocket));
-  udp_socket_create(sock, host, port_out, port_in, broadcast);
-  p->network = (void *)sock;
+  struct udp_thread *t = calloc(1, sizeof(struct udp_thread));
+  if (t == NULL) {
+    perror("udp_arch_periph_init: could not allocate network");
+    return;
+  }
+  if (udp_socket_create(&t->sock, host, port_out, port_in, broadcast) < 0) {
+    free(t);
+    return;
+  }
+  t->periph = p;
+  t->efd = eventfd(0, 0);
+  t->rate_stamp = udp_get_time_usec();
+  p->network = (void *)t;
+
+  if (t->efd < 0 || pthread_create(&t->thread, NULL, udp_thread_main, (void *)t)) {
+    perror("udp_arch_periph_init: could not start udp thread");
+    p->network = NULL;
+    if (t->efd >= 0) {
+      close(t->efd);
+    }
+    close(t->sock.sockfd);
+    free(t);
+    return;
+  }
+}
+
+/**
+ * Copy one datagram to the rx ring.
+ * Only called from the UDP thread, which is the only writer of rx_insert_idx.
+ * The datagram is dropped if it doesn't fit entirely.
+ */
+static void udp_ring_write(struct udp_periph *p, uint8_t *buf, uint16_t len)
+{
+  uint16_t insert = p->rx_insert_idx;
+  int16_t space = p->rx_extract_idx - insert;
+  if (space <= 0) {
+    space += UDP_RX_BUFFER_SIZE;
+  }
+  if (len > space - 1) {
+    p->stats.rx_dropped += len;
+    return;
+  }
+  /* copy in one or two contiguous spans */
+  uint16_t first = Min(len, UDP_RX_BUFFER_SIZE - insert);
+  memcpy(&p->rx_buf[insert], buf, first);
+  memcpy(&p->rx_buf[0], buf + first, len - first);
+  /* make data visible before publishing the new index */
+  __sync_synchronize();
+  p->rx_insert_idx = (insert + len) % UDP_RX_BUFFER_SIZE;
+}
+
+/**
+ * Drain all pending datagrams of the socket (UDP thread).
+ */
+static void udp_thread_recv(struct udp_thread *t)
+{
+  struct mmsghdr msgs[UDP_MMSG_NB];
+  struct iovec iov[UDP_MMSG_NB];
+  int i, n;
+
+  do {
+    memset(msgs, 0, sizeof(msgs));
+    for (i = 0; i < UDP_MMSG_NB; i++) {
+      iov[i].iov_base = t->rx_dgram[i];
+      iov[i].iov_len = UDP_MTU;
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    n = recvmmsg(t->sock.sockfd, msgs, UDP_MMSG_NB, MSG_DONTWAIT, NULL);
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        perror("udp_thread_recv");
+      }
+      return;
+    }
+    for (i = 0; i < n; i++) {
+      udp_ring_write(t->periph, t->rx_dgram[i], msgs[i].msg_len);
+    }
+    t->periph->stats.rx_packets += n;
+    t->rx_stamp = udp_get_time_usec();
+    __sync_synchronize();
+    t->rx_seq++;
+    mcu_arch_event_wakeup();
+  } while (n == UDP_MMSG_NB);
+}
+
+/**
+ * Send the batch handed over by the autopilot loop (UDP thread).
+ */
+static void udp_thread_send(struct udp_thread *t)
+{
+  struct udp_tx_batch *b = &t->tx[t->tx_fill ^ 1];
+  struct mmsghdr msgs[UDP_MMSG_NB];
+  struct iovec iov[UDP_MMSG_NB];
+  int i, sent = 0;
+
+  memset(msgs, 0, sizeof(msgs));
+  for (i = 0; i < b->nb; i++) {
+    iov[i].iov_base = b->buf[i];
+    iov[i].iov_len = b->len[i];
+    msgs[i].msg_hdr.msg_name = &t->sock.addr_out;
+    msgs[i].msg_hdr.msg_namelen = sizeof(t->sock.addr_out);
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  while (sent < b->nb) {
+    int n = sendmmsg(t->sock.sockfd, &msgs[sent], b->nb - sent, 0);
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      perror("udp_thread_send");
+      break;
+    }
+    sent += n;
+  }
+  t->periph->stats.tx_packets += sent;
+  t->periph->stats.tx_messages += b->msgs;
+
+  /* release the batch */
+  __sync_synchronize();
+  t->tx_busy = FALSE;
+}
+
+/**
+ * UDP thread, wakes up on reception or when a tx batch is ready.
+ */
+static void *udp_thread_main(void *data)
+{
+  struct udp_thread *t = (struct udp_thread *)data;
+  struct pollfd fds[2];
+
+  get_rt_prio(UDP_THREAD_PRIO);
+
+  fds[0].fd = t->sock.sockfd;
+  fds[0].events = POLLIN;
+  fds[1].fd = t->efd;
+  fds[1].events = POLLIN;
+
+  while (1) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("udp_thread_main: poll failed");
+      break;
+    }
+    if (fds[1].revents & POLLIN) {
+      uint64_t val;
+      if (read(t->efd, &val, sizeof(val)) == sizeof(val)) {
+        udp_thread_send(t);
+      }
+    }
+    if (fds[0].revents & POLLIN) {
+      udp_thread_recv(t);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Hand over the filled tx batch to the UDP thread if it is idle.
+ */
+static void udp_tx_handover(struct udp_thread *t)
+{
+  if (t->tx_busy || t->tx[t->tx_fill].nb == 0) {
+    return;
+  }
+  t->tx_fill ^= 1;
+  t->tx[t->tx_fill].nb = 0;
+  t->tx[t->tx_fill].msgs = 0;
+  __sync_synchronize();
+  t->tx_busy = TRUE;
+  uint64_t one = 1;
+  if (write(t->efd, &one, sizeof(one)) != sizeof(one)) {
+    perror("udp_tx_handover");
+  }
 }
 
 /**
- * Read bytes from UDP
+ * Called from the event loop.
+ * Bytes are copied to the rx buffer by the UDP thread, so only update the
+ * statistics here and hand over the pending telemetry to the thread.
  */
 void udp_receive(struct udp_periph *p)
 {
   if (p == NULL) return;
   if (p->network == NULL) return;
 
-  int16_t i;
-  int16_t available = UDP_RX_BUFFER_SIZE - udp_char_available(p);
-  uint8_t buf[UDP_RX_BUFFER_SIZE];
-  struct UdpSocket *sock = (struct UdpSocket *) p->network;
+  struct udp_thread *t = (struct udp_thread *) p->network;
+  uint32_t now = udp_get_time_usec();
 
-  if (available <= 0) {
-    return;  // No space
+  /* latency between reception by the thread and processing by the autopilot */
+  if (t->rx_seq != t->rx_seq_seen) {
+    __sync_synchronize();
+    uint32_t latency = now - t->rx_stamp;
+    t->rx_seq_seen = t->rx_seq;
+    p->stats.rx_latency_avg = (7 * p->stats.rx_latency_avg + latency) / 8;
+    if (latency > p->stats.rx_latency_max) {
+      p->stats.rx_latency_max = latency;
+    }
   }
 
-  socklen_t slen = sizeof(struct sockaddr_in);
-  ssize_t byte_read = recvfrom(sock->sockfd, buf, UDP_RX_BUFFER_SIZE, MSG_DONTWAIT,
-                               (struct sockaddr *)&sock->addr_in, &slen);
+  /* packet rates, updated every second */
+  if (now - t->rate_stamp >= 1000000) {
+    float dt = (now - t->rate_stamp) / 1e6f;
+    p->stats.rx_rate = (uint16_t)((p->stats.rx_packets - t->rate_rx_packets) / dt);
+    p->stats.tx_rate = (uint16_t)((p->stats.tx_packets - t->rate_tx_packets) / dt);
+    t->rate_rx_packets = p->stats.rx_packets;
+    t->rate_tx_packets = p->stats.tx_packets;
+    t->rate_stamp = now;
+  }
 
-  if (byte_read > 0) {
-    for (i = 0; i < byte_read; i++) {
-      p->rx_buf[p->rx_insert_idx] = buf[i];
-      p->rx_insert_idx = (p->rx_insert_idx + 1) % UDP_RX_BUFFER_SIZE;
+  udp_tx_handover(t);
+}
+
+/**
+ * Append data to the current tx batch.
+ * @param new_dgram if TRUE the data starts a new datagram, otherwise it is
+ *                  appended to the last one if there is enough room left
+ */
+static void udp_tx_append(struct udp_periph *p, struct udp_thread *t, uint8_t *buf, uint16_t len,
+                          bool_t new_dgram)
+{
+  struct udp_tx_batch *b = &t->tx[t->tx_fill];
+  if (new_dgram || b->nb == 0 || b->len[b->nb - 1] + len > UDP_MTU) {
+    if (b->nb == UDP_MMSG_NB) {
+      /* batch is full, try to hand it over now */
+      udp_tx_handover(t);
+      b = &t->tx[t->tx_fill];
+      if (b->nb == UDP_MMSG_NB) {
+        p->stats.tx_dropped++;
+        return;
+      }
     }
+    b->len[b->nb] = 0;
+    b->nb++;
   }
+  memcpy(&b->buf[b->nb - 1][b->len[b->nb - 1]], buf, len);
+  b->len[b->nb - 1] += len;
+  b->msgs++;
 }
 
 /**
- * Send a message
+ * Send a message.
+ * The message is appended to the current tx batch, in the last datagram if
+ * there is enough room left or in a new one. It is actually sent by the UDP
+ * thread after the next handover.
  */
 void udp_send_message(struct udp_periph *p)
 {
   if (p == NULL) return;
   if (p->network == NULL) return;
 
-  struct UdpSocket *sock = (struct UdpSocket *) p->network;
-
-  if (p->tx_insert_idx > 0) {
-    ssize_t bytes_sent = sendto(sock->sockfd, p->tx_buf, p->tx_insert_idx, MSG_DONTWAIT,
-                                (struct sockaddr *)&sock->addr_out, sizeof(sock->addr_out));
-    if (bytes_sent != p->tx_insert_idx) {
-      if (bytes_sent < 0) {
-        perror("udp_send_message failed");
-      }
-      else {
-        fprintf(stderr, "udp_send_message: only sent %d bytes instead of %d\n",
-                (int)bytes_sent, p->tx_insert_idx);
-      }
-    }
-    p->tx_insert_idx = 0;
+  uint16_t len = p->tx_insert_idx;
+  if (len == 0) {
+    return;
   }
+  p->tx_insert_idx = 0;
+
+  udp_tx_append(p, (struct udp_thread *) p->network, p->tx_buf, len, FALSE);
 }
 
 /**
- * Send a packet from another buffer
+ * Send a packet from another buffer.
+ * The packet is sent in its own datagram through the tx batch, so it stays
+ * in order with the messages. Packets larger than UDP_MTU are dropped.
  */
 void udp_send_raw(struct udp_periph *p, uint8_t *buffer, uint16_t size)
 {
   if (p == NULL) return;
   if (p->network == NULL) return;
 
-  struct UdpSocket *sock = (struct UdpSocket *) p->network;
-  ssize_t test __attribute__((unused)) = sendto(sock->sockfd, buffer, size, MSG_DONTWAIT,
-                                         (struct sockaddr *)&sock->addr_out, sizeof(sock->addr_out));
+  if (size == 0) {
+    return;
+  }
+  if (size > UDP_MTU) {
+    p->stats.tx_dropped++;
+    return;
+  }
+  udp_tx_append(p, (struct udp_thread *) p->network, buffer, size, TRUE);
 }
@@ -26,6 +26,11 @@
 #ifndef UDP_ARCH_H
 #define UDP_ARCH_H
 
+/** Larger receive buffer since all pending datagrams are drained at once */
+#ifndef UDP_RX_BUFFER_SIZE
+#define UDP_RX_BUFFER_SIZE 2048
+#endif
+
 #include "mcu_periph/udp.h"
 #include "udp_socket.h"
 
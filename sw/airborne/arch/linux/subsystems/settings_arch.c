@@ -19,54 +19,332 @@
  * Boston, MA 02111-1307, USA.
  */
 
+
 /**
  * @file arch/linux/subsystems/settings_arch.c
  * linux arch Persistent settings.
  *
- * Saves the PersistentSettings struct to a binary file.
+ * Settings are stored in a log structured file:
+ * a header followed by records appended each time settings are saved.
+ * Each record holds one setting, identified by a hash of its variable name,
+ * and is protected by a checksum:
+ *
+ * |key (4)|len (2)|value (len)|crc32 (4)|
+ *
+ * Only the settings that changed since the last save are appended, the last
+ * record of a setting is the valid one. A record interrupted by a power loss
+ * fails the checksum and is ignored with everything after it.
+ * When the file grows too large, or after a firmware update changed the
+ * settings list (schema), all current values are written to a new file which
+ * atomically replaces the old one with rename().
+ *
+ * Since settings are matched by name, tuned values survive firmware updates:
+ * removed settings are dropped and new ones keep their default value.
  */
 
 #include "subsystems/settings.h"
+#include "generated/settings.h"
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 /** Default file used to store persistent settings */
 #ifndef PERSISTENT_SETTINGS_FILE
 #define PERSISTENT_SETTINGS_FILE "pprz_persistent_settings.binary"
 #endif
 
+/** Compact the file when it holds more than this number of records per setting */
+#ifndef PERSISTENT_SETTINGS_COMPACT_RATIO
+#define PERSISTENT_SETTINGS_COMPACT_RATIO 8
+#endif
+
+#define PERSISTENT_SETTINGS_MAGIC 0x53505050  ///< "PPPS" in little endian
+#define PERSISTENT_SETTINGS_FORMAT 2          ///< file format version
+#define PERSISTENT_HEADER_LEN 12              ///< magic, format, schema
+#define PERSISTENT_RECORD_OVERHEAD 10         ///< key, len, crc
+
+static const struct persistent_setting_desc pers_desc[] = PERSISTENT_SETTINGS_DESC;
+
+/** Last stored value of each setting */
+static uint8_t pers_stored[sizeof(struct PersistentSettings) + 1];
+/** Setting has a valid record in the file */
+static bool_t pers_has_record[PERSISTENT_SETTINGS_NB + 1];
+/** Number of records in the file */
+static uint32_t pers_nb_records;
+/** Rewrite the whole file at next save */
+static bool_t pers_need_compaction = TRUE;
+
+/** FNV-1a hash, used for setting keys and schema version */
+static uint32_t fnv1a(uint32_t hash, const uint8_t *buf, uint32_t len)
+{
+  uint32_t i;
+  for (i = 0; i < len; i++) {
+    hash ^= buf[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+#define FNV1A_INIT 2166136261UL
+
+static uint32_t setting_key(const struct persistent_setting_desc *d)
+{
+  return fnv1a(FNV1A_INIT, (const uint8_t *)d->name, strlen(d->name));
+}
+
+/** Schema version: hash of names and sizes of all persistent settings */
+static uint32_t schema_hash(void)
+{
+  uint32_t h = FNV1A_INIT;
+  int i;
+  for (i = 0; i < PERSISTENT_SETTINGS_NB; i++) {
+    h = fnv1a(h, (const uint8_t *)pers_desc[i].name, strlen(pers_desc[i].name) + 1);
+    h = fnv1a(h, &pers_desc[i].size, 1);
+  }
+  return h;
+}
+
+static uint32_t crc32(const uint8_t *buf, uint32_t len)
+{
+  uint32_t crc = 0xFFFFFFFF;
+  uint32_t i;
+  int k;
+  for (i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (k = 0; k < 8; k++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (-(crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static void put_u32(uint8_t *b, uint32_t v)
+{
+  b[0] = v; b[1] = v >> 8; b[2] = v >> 16; b[3] = v >> 24;
+}
+
+static uint32_t get_u32(const uint8_t *b)
+{
+  return b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+/** Serialize the record of setting i with value from ptr
+ * @return record length
+ */
+static uint16_t build_record(uint8_t *b, int i, const uint8_t *ptr)
+{
+  const struct persistent_setting_desc *d = &pers_desc[i];
+  put_u32(b, setting_key(d));
+  b[4] = d->size;
+  b[5] = 0;
+  memcpy(&b[6], ptr + d->offset, d->size);
+  put_u32(&b[6 + d->size], crc32(b, 6 + d->size));
+  return PERSISTENT_RECORD_OVERHEAD + d->size;
+}
+
+/** Write a complete buffer and flush it to the storage */
+static int write_all(int fd, const uint8_t *buf, uint32_t len)
+{
+  while (len > 0) {
+    ssize_t n = write(fd, buf, len);
+    if (n <= 0) {
+      return -1;
+    }
+    buf += n;
+    len -= n;
+  }
+  return fsync(fd);
+}
+
+/** Write all settings to a new file and atomically replace the old one */
+static int32_t persistent_compact(const uint8_t *ptr)
+{
+  static uint8_t buf[PERSISTENT_HEADER_LEN + PERSISTENT_SETTINGS_NB * PERSISTENT_RECORD_OVERHEAD +
+                     sizeof(struct PersistentSettings)];
+  uint32_t len = PERSISTENT_HEADER_LEN;
+  int i;
+
+  put_u32(&buf[0], PERSISTENT_SETTINGS_MAGIC);
+  put_u32(&buf[4], PERSISTENT_SETTINGS_FORMAT);
+  put_u32(&buf[8], schema_hash());
+  for (i = 0; i < PERSISTENT_SETTINGS_NB; i++) {
+    len += build_record(&buf[len], i, ptr);
+  }
+
+  const char *tmp_file = PERSISTENT_SETTINGS_FILE ".tmp";
+  int fd = open(tmp_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    printf("Could not open settings file %s to write!\n", tmp_file);
+    return -1;
+  }
+  if (write_all(fd, buf, len) < 0) {
+    printf("Could not write settings file %s!\n", tmp_file);
+    close(fd);
+    remove(tmp_file);
+    return -1;
+  }
+  close(fd);
+  if (rename(tmp_file, PERSISTENT_SETTINGS_FILE) < 0) {
+    printf("Could not replace settings file %s!\n", PERSISTENT_SETTINGS_FILE);
+    remove(tmp_file);
+    return -1;
+  }
+
+  /* make sure the rename itself is on the storage */
+  char dir[256];
+  strncpy(dir, PERSISTENT_SETTINGS_FILE, sizeof(dir) - 1);
+  dir[sizeof(dir) - 1] = '\0';
+  char *slash = strrchr(dir, '/');
+  if (slash != NULL) {
+    *slash = '\0';
+  } else {
+    strcpy(dir, ".");
+  }
+  int dfd = open(dir, O_RDONLY);
+  if (dfd >= 0) {
+    fsync(dfd);
+    close(dfd);
+  }
+
+  memcpy(pers_stored, ptr, sizeof(struct PersistentSettings));
+  for (i = 0; i < PERSISTENT_SETTINGS_NB; i++) {
+    pers_has_record[i] = TRUE;
+  }
+  pers_nb_records = PERSISTENT_SETTINGS_NB;
+  pers_need_compaction = FALSE;
+  return 0;
+}
+
 int32_t persistent_write(void *ptr, uint32_t size)
 {
-  FILE *file= fopen(PERSISTENT_SETTINGS_FILE, "wb");
-  if (file != NULL) {
-    fwrite(ptr, size, 1, file);
-    fclose(file);
+  static uint8_t buf[PERSISTENT_SETTINGS_NB * PERSISTENT_RECORD_OVERHEAD + sizeof(struct PersistentSettings) + 1];
+  const uint8_t *p = (const uint8_t *)ptr;
+  uint32_t len = 0;
+  int i, nb = 0;
+
+  if (size != sizeof(struct PersistentSettings)) {
+    return -1;
+  }
+
+  if (pers_need_compaction ||
+      pers_nb_records >= PERSISTENT_SETTINGS_COMPACT_RATIO * PERSISTENT_SETTINGS_NB) {
+    return persistent_compact(p);
+  }
+
+  /* only append the settings that changed since last save */
+  for (i = 0; i < PERSISTENT_SETTINGS_NB; i++) {
+    const struct persistent_setting_desc *d = &pers_desc[i];
+    if (pers_has_record[i] && memcmp(p + d->offset, pers_stored + d->offset, d->size) == 0) {
+      continue;
+    }
+    len += build_record(&buf[len], i, p);
+    nb++;
+  }
+  if (nb == 0) {
     return 0;
   }
-  printf("Could not open settings file %s to write!\n", PERSISTENT_SETTINGS_FILE);
-  return -1;
+
+  int fd = open(PERSISTENT_SETTINGS_FILE, O_WRONLY | O_APPEND);
+  if (fd < 0) {
+    return persistent_compact(p);
+  }
+  if (write_all(fd, buf, len) < 0) {
+    printf("Could not write settings file %s!\n", PERSISTENT_SETTINGS_FILE);
+    close(fd);
+    /* file may end with a partial record, rewrite it next time */
+    pers_need_compaction = TRUE;
+    return -1;
+  }
+  close(fd);
+
+  memcpy(pers_stored, p, sizeof(struct PersistentSettings));
+  for (i = 0; i < PERSISTENT_SETTINGS_NB; i++) {
+    pers_has_record[i] = TRUE;
+  }
+  pers_nb_records += nb;
+  return 0;
 }
 
 int32_t persistent_read(void *ptr, uint32_t size)
 {
-  FILE *file= fopen(PERSISTENT_SETTINGS_FILE, "rb");
+  uint8_t *p = (uint8_t *)ptr;
+  int i;
+
+  if (size != sizeof(struct PersistentSettings)) {
+    return -1;
+  }
+  memcpy(pers_stored, p, sizeof(struct PersistentSettings));
+  for (i = 0; i < PERSISTENT_SETTINGS_NB; i++) {
+    pers_has_record[i] = FALSE;
+  }
+  pers_nb_records = 0;
+  pers_need_compaction = TRUE;
+
+  FILE *file = fopen(PERSISTENT_SETTINGS_FILE, "rb");
   if (file == NULL) {
     printf("Could not open settings file %s to read!\n", PERSISTENT_SETTINGS_FILE);
     return -1;
   }
-  /* check if binary file size matches requested struct size */
   fseek(file, 0, SEEK_END);
-  if (ftell(file) != size) {
-    printf("Settings file %s size does not match, deleting it!\n", PERSISTENT_SETTINGS_FILE);
+  long file_size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  uint8_t *buf = malloc(file_size > 0 ? file_size : 1);
+  if (buf == NULL || fread(buf, 1, file_size, file) != (size_t)file_size) {
+    printf("Could not read settings file %s!\n", PERSISTENT_SETTINGS_FILE);
+    free(buf);
     fclose(file);
-    remove(PERSISTENT_SETTINGS_FILE);
     return -1;
   }
-  fseek(file, 0, SEEK_SET);
-  int bytes_read = fread(ptr, size, 1, file);
-  if (bytes_read != size) {
-    printf("Could only read %d of %d bytes from %s!\n", bytes_read, size,
-           PERSISTENT_SETTINGS_FILE);
-  }
   fclose(file);
-  return 0;
+
+  if (file_size < PERSISTENT_HEADER_LEN || get_u32(&buf[0]) != PERSISTENT_SETTINGS_MAGIC ||
+      get_u32(&buf[4]) != PERSISTENT_SETTINGS_FORMAT) {
+    printf("Settings file %s has an unknown format, ignoring it!\n", PERSISTENT_SETTINGS_FILE);
+    free(buf);
+    return -1;
+  }
+  bool_t same_schema = (get_u32(&buf[8]) == schema_hash());
+
+  /* replay records, the last one of each setting wins */
+  uint32_t key[PERSISTENT_SETTINGS_NB + 1];
+  for (i = 0; i < PERSISTENT_SETTINGS_NB; i++) {
+    key[i] = setting_key(&pers_desc[i]);
+  }
+  long idx = PERSISTENT_HEADER_LEN;
+  int nb_loaded = 0;
+  while (idx + PERSISTENT_RECORD_OVERHEAD <= file_size) {
+    uint8_t len = buf[idx + 4];
+    if (idx + PERSISTENT_RECORD_OVERHEAD + len > file_size ||
+        crc32(&buf[idx], 6 + len) != get_u32(&buf[idx + 6 + len])) {
+      printf("Settings file %s: corrupted record, ignoring the end of the file\n", PERSISTENT_SETTINGS_FILE);
+      break;
+    }
+    uint32_t k = get_u32(&buf[idx]);
+    for (i = 0; i < PERSISTENT_SETTINGS_NB; i++) {
+      if (key[i] == k && pers_desc[i].size == len) {
+        memcpy(p + pers_desc[i].offset, &buf[idx + 6], len);
+        memcpy(pers_stored + pers_desc[i].offset, &buf[idx + 6], len);
+        if (!pers_has_record[i]) {
+          nb_loaded++;
+        }
+        pers_has_record[i] = TRUE;
+        break;
+      }
+    }
+    pers_nb_records++;
+    idx += PERSISTENT_RECORD_OVERHEAD + len;
+  }
+  free(buf);
+
+  if (!same_schema) {
+    printf("Settings file %s: settings list changed, %d of %d settings migrated by name\n",
+           PERSISTENT_SETTINGS_FILE, nb_loaded, PERSISTENT_SETTINGS_NB);
+  }
+  /* keep appending only if the file is clean and up to date */
+  pers_need_compaction = !same_schema || idx != file_size;
+  return (nb_loaded > 0) ? 0 : -1;
 }
@@ -78,6 +78,17 @@ static inline uint32_t get_sys_time_msec(void)
   return msec_of_cpu_ticks(T0TC);
 }
 
+#define SYS_TIME_HAS_CPU_TICKS 1
+
+/**
+ * Get a free running counter in CPU ticks, wraps around.
+ * @return CPU ticks (T0 counter)
+ */
+static inline uint32_t get_sys_time_cpu_ticks(void)
+{
+  return T0TC;
+}
+
 
 #define SysTickTimerStart(_t) { _t = T0TC; }
 #define SysTickTimer(_t) ((uint32_t)(T0TC - _t))
@@ -47,6 +47,7 @@ void sys_tick_handler(void)
     if (sys_time.timer[i].in_use &&
         sys_time.nb_tick >= sys_time.timer[i].end_time) {
       sys_time.timer[i].end_time += sys_time.timer[i].duration;
+      sys_time_prof_elapsed(i);
       sys_time.timer[i].elapsed = TRUE;
       if (sys_time.timer[i].cb) {
         sys_time.timer[i].cb(i);
@@ -30,6 +30,7 @@
 #include "mcu_periph/sys_time.h"
 
 #include "libopencm3/cm3/systick.h"
+#include "libopencm3/cm3/scs.h"
 
 #ifdef SYS_TIME_LED
 #include "led.h"
@@ -52,6 +53,11 @@ void sys_time_arch_init(void)
 #endif
   sys_time.cpu_ticks_per_sec = AHB_CLK;
 
+  /* enable the cycle counter for get_sys_time_cpu_ticks */
+  SCS_DEMCR |= SCS_DEMCR_TRCENA;
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+
   /* cpu ticks per desired sys_time timer step */
   sys_time.resolution_cpu_ticks = (uint32_t)(sys_time.resolution * sys_time.cpu_ticks_per_sec + 0.5);
 
@@ -89,6 +95,7 @@ void sys_tick_handler(void)
     if (sys_time.timer[i].in_use &&
         sys_time.nb_tick >= sys_time.timer[i].end_time) {
       sys_time.timer[i].end_time += sys_time.timer[i].duration;
+      sys_time_prof_elapsed(i);
       sys_time.timer[i].elapsed = TRUE;
       if (sys_time.timer[i].cb) {
         sys_time.timer[i].cb(i);
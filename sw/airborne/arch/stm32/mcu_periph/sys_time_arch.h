@@ -37,6 +37,7 @@
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/cm3/systick.h>
+#include <libopencm3/cm3/dwt.h>
 #include "std.h"
 #ifdef RTOS_IS_CHIBIOS
 #include "chibios_stub.h"
@@ -74,6 +75,17 @@ static inline uint32_t get_sys_time_msec(void)
 #endif
 }
 
+#define SYS_TIME_HAS_CPU_TICKS 1
+
+/**
+ * Get a free running counter in CPU ticks, wraps around.
+ * Cycle counter of the DWT unit, enabled by sys_time_arch_init.
+ * @return CPU ticks
+ */
+static inline uint32_t get_sys_time_cpu_ticks(void)
+{
+  return DWT_CYCCNT;
+}
 
 /** Busy wait in microseconds.
  *
@@ -28,6 +28,7 @@
 
 #include "subsystems/radio_control.h"
 #include "subsystems/radio_control/spektrum_arch.h"
+#include "subsystems/radio_control/spektrum.h"
 #include "mcu_periph/uart.h"
 #include "mcu_periph/gpio.h"
 #include "mcu_periph/sys_time.h"
@@ -40,7 +41,6 @@
 
 #include BOARD_CONFIG
 
-#define SPEKTRUM_CHANNELS_PER_FRAME 7
 #define MAX_SPEKTRUM_FRAMES 2
 #define MAX_SPEKTRUM_CHANNELS 16
 
@@ -94,7 +94,9 @@ struct SpektrumStateStruct {
   uint8_t SecondFrame;
   uint16_t LostFrameCnt;
   uint8_t RcAvailable;
-  int16_t values[SPEKTRUM_CHANNELS_PER_FRAME *MAX_SPEKTRUM_FRAMES];
+  uint8_t data[SPEKTRUM_CHANNELS_PER_FRAME * MAX_SPEKTRUM_FRAMES * 2]; ///< channel words as received
+  uint32_t FrameStamp;  ///< time the first byte of the current frame was received in usec
+  uint32_t RcStamp;     ///< time the first byte of the last complete frame was received in usec
 };
 
 typedef struct SpektrumStateStruct SpektrumStateType;
@@ -287,7 +289,6 @@ void radio_control_impl_init(void)
 static inline void SpektrumParser(uint8_t _c, SpektrumStateType *spektrum_state, bool_t secondary_receiver)
 {
 
-  uint16_t ChannelData;
   uint8_t TimedOut;
   static uint8_t TmpEncType = 0;        /* 0 = 10bit, 1 = 11 bit        */
   static uint8_t TmpExpFrames = 0;      /* # of frames for channel data */
@@ -319,6 +320,7 @@ static inline void SpektrumParser(uint8_t _c, SpektrumStateType *spektrum_state,
     }
     spektrum_state->Sync = 1;
     spektrum_state->SpektrumTimer = MAX_BYTE_SPACE;
+    spektrum_state->FrameStamp = get_sys_time_usec();
     return;
   }
 
@@ -369,9 +371,11 @@ static inline void SpektrumParser(uint8_t _c, SpektrumStateType *spektrum_state,
     spektrum_state->SpektrumTimer = MAX_BYTE_SPACE;
     /* we overwrite the buffer now so rc data is not available now */
     spektrum_state->RcAvailable = 0;
-    ChannelData = ((uint16_t)spektrum_state->HighByte << 8) | _c;
-    spektrum_state->values[spektrum_state->ChannelCnt
-                           + (spektrum_state->SecondFrame * 7)] = ChannelData;
+    /* the words are decoded as a block once all frames are received */
+    uint8_t *word = &spektrum_state->data[2 * (spektrum_state->ChannelCnt
+                                          + (spektrum_state->SecondFrame * SPEKTRUM_CHANNELS_PER_FRAME))];
+    word[0] = spektrum_state->HighByte;
+    word[1] = _c;
     spektrum_state->ChannelCnt ++;
   }
 
@@ -382,6 +386,7 @@ static inline void SpektrumParser(uint8_t _c, SpektrumStateType *spektrum_state,
     if (spektrum_state->FrameCnt == TmpExpFrames) {
       /* set the rc_available_flag */
       spektrum_state->RcAvailable = 1;
+      spektrum_state->RcStamp = spektrum_state->FrameStamp;
       spektrum_state->FrameCnt = 0;
     }
     if (!secondary_receiver) { /* main receiver */
@@ -405,9 +410,9 @@ static inline void SpektrumParser(uint8_t _c, SpektrumStateType *spektrum_state,
 void RadioControlEventImp(void (*frame_handler)(void))
 {
   uint8_t ChannelCnt;
-  uint8_t ChannelNum;
-  uint16_t ChannelData;
   uint8_t MaxChannelNum = 0;
+  uint8_t *Data;
+  uint32_t Stamp;
 
 #ifdef RADIO_CONTROL_SPEKTRUM_SECONDARY_PORT
   /* If we have two receivers and at least one of them has new data */
@@ -433,49 +438,19 @@ void RadioControlEventImp(void (*frame_handler)(void))
   if (PrimarySpektrumState.RcAvailable) {
     PrimarySpektrumState.RcAvailable = 0;
 #endif
-    ChannelCnt = 0;
-    /* for every piece of channel data we have received */
-    for (int i = 0; (i < SPEKTRUM_CHANNELS_PER_FRAME * ExpectedFrames); i++) {
 #ifndef RADIO_CONTROL_SPEKTRUM_SECONDARY_PORT
-      ChannelData = PrimarySpektrumState.values[i];
+    Data = PrimarySpektrumState.data;
+    Stamp = PrimarySpektrumState.RcStamp;
 #else
-      ChannelData = (!BestReceiver) ? PrimarySpektrumState.values[i] :
-                    SecondarySpektrumState.values[i];
+    Data = (!BestReceiver) ? PrimarySpektrumState.data : SecondarySpektrumState.data;
+    Stamp = (!BestReceiver) ? PrimarySpektrumState.RcStamp : SecondarySpektrumState.RcStamp;
 #endif
-      /* find out the channel number and its value by  */
-      /* using the EncodingType which is only received */
-      /* from the main receiver                        */
-      switch (EncodingType) {
-        case (0) : /* 10 bit */
-          ChannelNum = (ChannelData >> 10) & 0x0f;
-          /* don't bother decoding unused channels */
-          if (ChannelNum < SPEKTRUM_NB_CHANNEL) {
-            SpektrumBuf[ChannelNum] = ChannelData & 0x3ff;
-            SpektrumBuf[ChannelNum] -= 0x200;
-            SpektrumBuf[ChannelNum] *= MAX_PPRZ / 0x156;
-            ChannelCnt++;
-          }
-          break;
-
-        case (1) : /* 11 bit */
-          ChannelNum = (ChannelData >> 11) & 0x0f;
-          /* don't bother decoding unused channels */
-          if (ChannelNum < SPEKTRUM_NB_CHANNEL) {
-            SpektrumBuf[ChannelNum] = ChannelData & 0x7ff;
-            SpektrumBuf[ChannelNum] -= 0x400;
-            SpektrumBuf[ChannelNum] *= MAX_PPRZ / 0x2AC;
-            ChannelCnt++;
-          }
-          break;
-
-        default : ChannelNum = 0x0F; break;  /* never going to get here */
-      }
-      /* store the value of the highest valid channel */
-      if ((ChannelNum != 0x0F) && (ChannelNum > MaxChannelNum)) {
-        MaxChannelNum = ChannelNum;
-      }
-
-    }
+    /* decode every piece of channel data we have received by  */
+    /* using the EncodingType which is only received from the  */
+    /* main receiver, and store the highest valid channel      */
+    ChannelCnt = spektrum_decode_channels(SpektrumBuf, Data,
+                                          SPEKTRUM_CHANNELS_PER_FRAME * Min(ExpectedFrames, MAX_SPEKTRUM_FRAMES),
+                                          EncodingType, &MaxChannelNum);
 
     /* if we have a valid frame the pass it to the frame handler */
     if (ChannelCnt >= (MaxChannelNum + 1)) {
@@ -493,6 +468,7 @@ void RadioControlEventImp(void (*frame_handler)(void))
         }
         radio_control.values[i] *= SpektrumSigns[i];
       }
+      radio_control_set_frame_stamp(Stamp);
       (*frame_handler)();
     }
   }
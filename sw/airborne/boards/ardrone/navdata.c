@@ -45,6 +45,7 @@
 #include "subsystems/ahrs.h"
 #include "subsystems/abi.h"
 #include "mcu_periph/gpio.h"
+#include "mcu_arch.h"
 
 /* Internal used functions */
 static void *navdata_read(void *data __attribute__((unused)));
@@ -313,6 +314,8 @@ static void *navdata_read(void *data __attribute__((unused)))
       pthread_mutex_lock(&navdata_mutex);
       navdata_available = TRUE;
       pthread_mutex_unlock(&navdata_mutex);
+      // wake up the main loop to handle it
+      mcu_arch_event_wakeup();
     }
   }
 
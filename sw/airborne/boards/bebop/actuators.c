@@ -63,6 +63,8 @@ void actuators_bebop_init(void)
   /* Initialize the I2C connection */
   actuators_bebop.i2c_trans.slave_addr = ACTUATORS_BEBOP_ADDR;
   actuators_bebop.i2c_trans.status = I2CTransDone;
+  actuators_bebop.step = ACTUATORS_BEBOP_STEP_LED;
+  actuators_bebop.bldc_status = 0;
   actuators_bebop.led = 0;
 
 #if PERIODIC_TELEMETRY
@@ -70,13 +72,17 @@ void actuators_bebop_init(void)
 #endif
 }
 
-void actuators_bebop_commit(void)
+/** Request the observation data */
+static void actuators_bebop_get_obs_data(void)
 {
-  // Receive the status
   actuators_bebop.i2c_trans.buf[0] = ACTUATORS_BEBOP_GET_OBS_DATA;
   i2c_transceive(&i2c1, &actuators_bebop.i2c_trans, actuators_bebop.i2c_trans.slave_addr, 1, 13);
+  actuators_bebop.step = ACTUATORS_BEBOP_STEP_OBS_DATA;
+}
 
-  // Update status
+/** Update the status from the received observation data */
+static void actuators_bebop_read_obs_data(void)
+{
   electrical.vsupply = (actuators_bebop.i2c_trans.buf[9] + (actuators_bebop.i2c_trans.buf[8] << 8)) / 100;
   actuators_bebop.rpm_obs[0] = (actuators_bebop.i2c_trans.buf[1] + (actuators_bebop.i2c_trans.buf[0] << 8));
   actuators_bebop.rpm_obs[1] = (actuators_bebop.i2c_trans.buf[3] + (actuators_bebop.i2c_trans.buf[2] << 8));
@@ -87,26 +93,29 @@ void actuators_bebop_commit(void)
   //actuators_bebop_saturate();
 
   // When detected a suicide
-  actuators_bebop.i2c_trans.buf[10] = actuators_bebop.i2c_trans.buf[10] & 0x7;
-  if (actuators_bebop.i2c_trans.buf[11] == 2 && actuators_bebop.i2c_trans.buf[10] != 1) {
+  actuators_bebop.bldc_status = actuators_bebop.i2c_trans.buf[10] & 0x7;
+  if (actuators_bebop.i2c_trans.buf[11] == 2 && actuators_bebop.bldc_status != 1) {
     autopilot_set_motors_on(FALSE);
   }
+}
 
-  // Start the motors
-  if (actuators_bebop.i2c_trans.buf[10] != 4 && actuators_bebop.i2c_trans.buf[10] != 2 && autopilot_motors_on) {
-    // Reset the error
+/** Send the motor command matching the last observed status
+ * @return TRUE if a command was sent
+ */
+static bool_t actuators_bebop_send_cmd(void)
+{
+  // Start the motors, the errors are reset first
+  if (actuators_bebop.bldc_status != 4 && actuators_bebop.bldc_status != 2 && autopilot_motors_on) {
     actuators_bebop.i2c_trans.buf[0] = ACTUATORS_BEBOP_CLEAR_ERROR;
     i2c_transmit(&i2c1, &actuators_bebop.i2c_trans, actuators_bebop.i2c_trans.slave_addr, 1);
-
-    // Start the motors
-    actuators_bebop.i2c_trans.buf[0] = ACTUATORS_BEBOP_START_PROP;
-    i2c_transmit(&i2c1, &actuators_bebop.i2c_trans, actuators_bebop.i2c_trans.slave_addr, 1);
+    actuators_bebop.step = ACTUATORS_BEBOP_STEP_CLEAR_ERROR;
   }
   // Stop the motors
-  else if (actuators_bebop.i2c_trans.buf[10] == 4 && !autopilot_motors_on) {
+  else if (actuators_bebop.bldc_status == 4 && !autopilot_motors_on) {
     actuators_bebop.i2c_trans.buf[0] = ACTUATORS_BEBOP_STOP_PROP;
     i2c_transmit(&i2c1, &actuators_bebop.i2c_trans, actuators_bebop.i2c_trans.slave_addr, 1);
-  } else if (actuators_bebop.i2c_trans.buf[10] == 4 && autopilot_motors_on) {
+    actuators_bebop.step = ACTUATORS_BEBOP_STEP_CMD;
+  } else if (actuators_bebop.bldc_status == 4 && autopilot_motors_on) {
     // Send the commands
     actuators_bebop.i2c_trans.buf[0] = ACTUATORS_BEBOP_SET_REF_SPEED;
     actuators_bebop.i2c_trans.buf[1] = actuators_bebop.rpm_ref[0] >> 8;
@@ -123,15 +132,74 @@ void actuators_bebop_commit(void)
     actuators_bebop.i2c_trans.buf[10] = actuators_bebop_checksum((uint8_t *)actuators_bebop.i2c_trans.buf, 9);
 #pragma GCC diagnostic pop
     i2c_transmit(&i2c1, &actuators_bebop.i2c_trans, actuators_bebop.i2c_trans.slave_addr, 11);
+    actuators_bebop.step = ACTUATORS_BEBOP_STEP_CMD;
+  } else {
+    return FALSE;
   }
+  return TRUE;
+}
 
-  // Update the LEDs
-  if (actuators_bebop.led != (led_hw_values & 0x3)) {
-    actuators_bebop.i2c_trans.buf[0] = ACTUATORS_BEBOP_TOGGLE_GPIO;
-    actuators_bebop.i2c_trans.buf[1] = (led_hw_values & 0x3);
-    i2c_transmit(&i2c1, &actuators_bebop.i2c_trans, actuators_bebop.i2c_trans.slave_addr, 2);
+/** Update the LEDs if they changed
+ * @return TRUE if the LEDs were sent
+ */
+static bool_t actuators_bebop_send_led(void)
+{
+  if (actuators_bebop.led == (led_hw_values & 0x3)) {
+    return FALSE;
+  }
+  actuators_bebop.i2c_trans.buf[0] = ACTUATORS_BEBOP_TOGGLE_GPIO;
+  actuators_bebop.i2c_trans.buf[1] = (led_hw_values & 0x3);
+  i2c_transmit(&i2c1, &actuators_bebop.i2c_trans, actuators_bebop.i2c_trans.slave_addr, 2);
+  actuators_bebop.step = ACTUATORS_BEBOP_STEP_LED;
+
+  actuators_bebop.led = led_hw_values & 0x3;
+  return TRUE;
+}
+
+/** Send the next transaction to the BLDC driver.
+ * The transactions are not blocking (they run in the I2C thread on linux),
+ * so one step is sent per commit once the previous one is finished:
+ * observation data, motor command, then LEDs.
+ */
+void actuators_bebop_commit(void)
+{
+  // Previous transaction not finished yet
+  if (actuators_bebop.i2c_trans.status == I2CTransPending ||
+      actuators_bebop.i2c_trans.status == I2CTransRunning) {
+    return;
+  }
 
-    actuators_bebop.led = led_hw_values & 0x3;
+  switch (actuators_bebop.step) {
+    case ACTUATORS_BEBOP_STEP_OBS_DATA:
+      // Only send a command from a valid status
+      if (actuators_bebop.i2c_trans.status == I2CTransSuccess) {
+        actuators_bebop_read_obs_data();
+        if (actuators_bebop_send_cmd()) {
+          break;
+        }
+      }
+      if (!actuators_bebop_send_led()) {
+        actuators_bebop_get_obs_data();
+      }
+      break;
+
+    case ACTUATORS_BEBOP_STEP_CLEAR_ERROR:
+      // Start the motors
+      actuators_bebop.i2c_trans.buf[0] = ACTUATORS_BEBOP_START_PROP;
+      i2c_transmit(&i2c1, &actuators_bebop.i2c_trans, actuators_bebop.i2c_trans.slave_addr, 1);
+      actuators_bebop.step = ACTUATORS_BEBOP_STEP_CMD;
+      break;
+
+    case ACTUATORS_BEBOP_STEP_CMD:
+      if (!actuators_bebop_send_led()) {
+        actuators_bebop_get_obs_data();
+      }
+      break;
+
+    case ACTUATORS_BEBOP_STEP_LED:
+    default:
+      actuators_bebop_get_obs_data();
+      break;
   }
 }
 
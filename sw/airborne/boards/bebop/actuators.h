@@ -44,8 +44,20 @@
 #define ACTUATORS_BEBOP_GET_INFO      0xA0    ///< Get version information
 
 
+/** Steps of the communication with the BLDC driver,
+ * one transaction is sent per commit.
+ */
+enum ActuatorsBebopStep {
+  ACTUATORS_BEBOP_STEP_OBS_DATA,      ///< Get the observation data
+  ACTUATORS_BEBOP_STEP_CLEAR_ERROR,   ///< Clear the errors before starting the propellers
+  ACTUATORS_BEBOP_STEP_CMD,           ///< Start or stop the propellers, or set the reference speed
+  ACTUATORS_BEBOP_STEP_LED            ///< Update the LEDs
+};
+
 struct ActuatorsBebop {
   struct i2c_transaction i2c_trans;   ///< I2C transaction for communicating with the bebop BLDC driver
+  enum ActuatorsBebopStep step;       ///< Step of the last transaction sent
+  uint8_t bldc_status;                ///< Last observed status of the BLDC driver
   uint16_t rpm_ref[4];                ///< Reference RPM
   uint16_t rpm_obs[4];                ///< Observed RPM
   uint8_t led;                        ///< Current led status
@@ -32,6 +32,7 @@
 #include <inttypes.h>
 #include <string.h>
 #include "subsystems/datalink/datalink.h"
+#include "subsystems/datalink/dl_dispatch.h"
 
 #include "generated/modules.h"
 
@@ -77,151 +78,234 @@ uint8_t joystick_block;
 #define MOfCm(_x) (((float)(_x))/100.)
 #define MOfMM(_x) (((float)(_x))/1000.)
 
-#define SenderIdOfMsg(x) (x[0])
-#define IdOfMsg(x) (x[1])
-
-void dl_parse_msg(void)
+static bool_t dl_ping_cb(uint8_t *buf __attribute__((unused)))
 {
-  datalink_time = 0;
-  uint8_t msg_id = IdOfMsg(dl_buffer);
-#if 0 // not ready yet
-  uint8_t sender_id = SenderIdOfMsg(dl_buffer);
-
-  /* parse telemetry messages coming from other AC */
-  if (sender_id != 0) {
-    switch (msg_id) {
-#ifdef TCAS
-      case DL_TCAS_RA: {
-        if (DL_TCAS_RESOLVE_ac_id(dl_buffer) == AC_ID && SenderIdOfMsg(dl_buffer) != AC_ID) {
-          uint8_t ac_id_conflict = SenderIdOfMsg(dl_buffer);
-          tcas_acs_status[the_acs_id[ac_id_conflict]].resolve = DL_TCAS_RA_resolve(dl_buffer);
-        }
-      }
-#endif
-    }
-    return;
-  }
-#endif
+  DOWNLINK_SEND_PONG(DefaultChannel, DefaultDevice);
+  return TRUE;
+}
 
-  if (msg_id == DL_PING) {
-    DOWNLINK_SEND_PONG(DefaultChannel, DefaultDevice);
-  } else
 #ifdef TRAFFIC_INFO
-    if (msg_id == DL_ACINFO && DL_ACINFO_ac_id(dl_buffer) != AC_ID) {
-      uint8_t id = DL_ACINFO_ac_id(dl_buffer);
-      float ux = MOfCm(DL_ACINFO_utm_east(dl_buffer));
-      float uy = MOfCm(DL_ACINFO_utm_north(dl_buffer));
-      float a = MOfCm(DL_ACINFO_alt(dl_buffer));
-      float c = RadOfDeg(((float)DL_ACINFO_course(dl_buffer)) / 10.);
-      float s = MOfCm(DL_ACINFO_speed(dl_buffer));
-      float cl = MOfCm(DL_ACINFO_climb(dl_buffer));
-      uint32_t t = DL_ACINFO_itow(dl_buffer);
-      SetAcInfo(id, ux, uy, c, a, s, cl, t);
-    } else
+static bool_t dl_acinfo_cb(uint8_t *buf)
+{
+  if (DL_ACINFO_ac_id(buf) == AC_ID) { return FALSE; }
+  uint8_t id = DL_ACINFO_ac_id(buf);
+  float ux = MOfCm(DL_ACINFO_utm_east(buf));
+  float uy = MOfCm(DL_ACINFO_utm_north(buf));
+  float a = MOfCm(DL_ACINFO_alt(buf));
+  float c = RadOfDeg(((float)DL_ACINFO_course(buf)) / 10.);
+  float s = MOfCm(DL_ACINFO_speed(buf));
+  float cl = MOfCm(DL_ACINFO_climb(buf));
+  uint32_t t = DL_ACINFO_itow(buf);
+  SetAcInfo(id, ux, uy, c, a, s, cl, t);
+  return TRUE;
+}
 #endif
+
 #ifdef NAV
-      if (msg_id == DL_MOVE_WP && DL_MOVE_WP_ac_id(dl_buffer) == AC_ID) {
-        uint8_t wp_id = DL_MOVE_WP_wp_id(dl_buffer);
-        float a = MOfMM(DL_MOVE_WP_alt(dl_buffer));
-
-        /* Computes from (lat, long) in the referenced UTM zone */
-        struct LlaCoor_f lla;
-        lla.lat = RadOfDeg((float)(DL_MOVE_WP_lat(dl_buffer) / 1e7));
-        lla.lon = RadOfDeg((float)(DL_MOVE_WP_lon(dl_buffer) / 1e7));
-        struct UtmCoor_f utm;
-        utm.zone = nav_utm_zone0;
-        utm_of_lla_f(&utm, &lla);
-        nav_move_waypoint(wp_id, utm.east, utm.north, a);
-
-        /* Waypoint range is limited. Computes the UTM pos back from the relative
-           coordinates */
-        utm.east = waypoints[wp_id].x + nav_utm_east0;
-        utm.north = waypoints[wp_id].y + nav_utm_north0;
-        DOWNLINK_SEND_WP_MOVED(DefaultChannel, DefaultDevice, &wp_id, &utm.east, &utm.north, &a, &nav_utm_zone0);
-      } else if (msg_id == DL_BLOCK && DL_BLOCK_ac_id(dl_buffer) == AC_ID) {
-        nav_goto_block(DL_BLOCK_block_id(dl_buffer));
-        SEND_NAVIGATION(&(DefaultChannel).trans_tx, &(DefaultDevice).device);
-      } else
+static bool_t dl_move_wp_cb(uint8_t *buf)
+{
+  if (DL_MOVE_WP_ac_id(buf) != AC_ID) { return FALSE; }
+  uint8_t wp_id = DL_MOVE_WP_wp_id(buf);
+  float a = MOfMM(DL_MOVE_WP_alt(buf));
+
+  /* Computes from (lat, long) in the referenced UTM zone */
+  struct LlaCoor_f lla;
+  lla.lat = RadOfDeg((float)(DL_MOVE_WP_lat(buf) / 1e7));
+  lla.lon = RadOfDeg((float)(DL_MOVE_WP_lon(buf) / 1e7));
+  struct UtmCoor_f utm;
+  utm.zone = nav_utm_zone0;
+  utm_of_lla_f(&utm, &lla);
+  nav_move_waypoint(wp_id, utm.east, utm.north, a);
+
+  /* Waypoint range is limited. Computes the UTM pos back from the relative
+     coordinates */
+  utm.east = waypoints[wp_id].x + nav_utm_east0;
+  utm.north = waypoints[wp_id].y + nav_utm_north0;
+  DOWNLINK_SEND_WP_MOVED(DefaultChannel, DefaultDevice, &wp_id, &utm.east, &utm.north, &a, &nav_utm_zone0);
+  return TRUE;
+}
+
+static bool_t dl_block_cb(uint8_t *buf)
+{
+  if (DL_BLOCK_ac_id(buf) != AC_ID) { return FALSE; }
+  nav_goto_block(DL_BLOCK_block_id(buf));
+  SEND_NAVIGATION(&(DefaultChannel).trans_tx, &(DefaultDevice).device);
+  return TRUE;
+}
 #endif /** NAV */
+
 #ifdef WIND_INFO
-        if (msg_id == DL_WIND_INFO && DL_WIND_INFO_ac_id(dl_buffer) == AC_ID) {
-          struct FloatVect2 wind;
-          wind.x = DL_WIND_INFO_north(dl_buffer);
-          wind.y = DL_WIND_INFO_east(dl_buffer);
-          stateSetHorizontalWindspeed_f(&wind);
+static bool_t dl_wind_info_cb(uint8_t *buf)
+{
+  if (DL_WIND_INFO_ac_id(buf) != AC_ID) { return FALSE; }
+  struct FloatVect2 wind;
+  wind.x = DL_WIND_INFO_north(buf);
+  wind.y = DL_WIND_INFO_east(buf);
+  stateSetHorizontalWindspeed_f(&wind);
 #if !USE_AIRSPEED
-          float airspeed = DL_WIND_INFO_airspeed(dl_buffer);
-          stateSetAirspeed_f(&airspeed);
+  float airspeed = DL_WIND_INFO_airspeed(buf);
+  stateSetAirspeed_f(&airspeed);
 #endif
 #ifdef WIND_INFO_RET
-          DOWNLINK_SEND_WIND_INFO_RET(DefaultChannel, DefaultDevice, &wind.y, &wind.x, stateGetAirspeed_f());
+  DOWNLINK_SEND_WIND_INFO_RET(DefaultChannel, DefaultDevice, &wind.y, &wind.x, stateGetAirspeed_f());
 #endif
-        } else
+  return TRUE;
+}
 #endif /** WIND_INFO */
 
 #ifdef HITL
-          /** Infrared and GPS sensors are replaced by messages on the datalink */
-          if (msg_id == DL_HITL_INFRARED) {
-            /** This code simulates infrared.c:ir_update() */
-            infrared.roll = DL_HITL_INFRARED_roll(dl_buffer);
-            infrared.pitch = DL_HITL_INFRARED_pitch(dl_buffer);
-            infrared.top = DL_HITL_INFRARED_top(dl_buffer);
-          } else if (msg_id == DL_HITL_UBX) {
-            /** This code simulates gps_ubx.c:parse_ubx() */
-            if (gps_msg_received) {
-              gps_nb_ovrn++;
-            } else {
-              ubx_class = DL_HITL_UBX_class(dl_buffer);
-              ubx_id = DL_HITL_UBX_id(dl_buffer);
-              uint8_t l = DL_HITL_UBX_ubx_payload_length(dl_buffer);
-              uint8_t *ubx_payload = DL_HITL_UBX_ubx_payload(dl_buffer);
-              memcpy(ubx_msg_buf, ubx_payload, l);
-              gps_msg_received = TRUE;
-            }
-          } else
+/** Infrared and GPS sensors are replaced by messages on the datalink */
+static bool_t dl_hitl_infrared_cb(uint8_t *buf)
+{
+  /** This code simulates infrared.c:ir_update() */
+  infrared.roll = DL_HITL_INFRARED_roll(buf);
+  infrared.pitch = DL_HITL_INFRARED_pitch(buf);
+  infrared.top = DL_HITL_INFRARED_top(buf);
+  return TRUE;
+}
+
+static bool_t dl_hitl_ubx_cb(uint8_t *buf)
+{
+  /** This code simulates gps_ubx.c:parse_ubx() */
+  if (gps_msg_received) {
+    gps_nb_ovrn++;
+  } else {
+    ubx_class = DL_HITL_UBX_class(buf);
+    ubx_id = DL_HITL_UBX_id(buf);
+    uint8_t l = DL_HITL_UBX_ubx_payload_length(buf);
+    uint8_t *ubx_payload = DL_HITL_UBX_ubx_payload(buf);
+    memcpy(ubx_msg_buf, ubx_payload, l);
+    gps_msg_received = TRUE;
+  }
+  return TRUE;
+}
 #endif
+
 #ifdef DlSetting
-            if (msg_id == DL_SETTING && DL_SETTING_ac_id(dl_buffer) == AC_ID) {
-              uint8_t i = DL_SETTING_index(dl_buffer);
-              float val = DL_SETTING_value(dl_buffer);
-              DlSetting(i, val);
-              DOWNLINK_SEND_DL_VALUE(DefaultChannel, DefaultDevice, &i, &val);
-            } else if (msg_id == DL_GET_SETTING && DL_GET_SETTING_ac_id(dl_buffer) == AC_ID) {
-              uint8_t i = DL_GET_SETTING_index(dl_buffer);
-              float val = settings_get_value(i);
-              DOWNLINK_SEND_DL_VALUE(DefaultChannel, DefaultDevice, &i, &val);
-            } else
+static bool_t dl_setting_cb(uint8_t *buf)
+{
+  if (DL_SETTING_ac_id(buf) != AC_ID) { return FALSE; }
+  uint8_t i = DL_SETTING_index(buf);
+  float val = DL_SETTING_value(buf);
+  DlSetting(i, val);
+  DOWNLINK_SEND_DL_VALUE(DefaultChannel, DefaultDevice, &i, &val);
+  return TRUE;
+}
+
+static bool_t dl_get_setting_cb(uint8_t *buf)
+{
+  if (DL_GET_SETTING_ac_id(buf) != AC_ID) { return FALSE; }
+  uint8_t i = DL_GET_SETTING_index(buf);
+  float val = settings_get_value(i);
+  DOWNLINK_SEND_DL_VALUE(DefaultChannel, DefaultDevice, &i, &val);
+  return TRUE;
+}
 #endif /** Else there is no dl_settings section in the flight plan */
+
 #if USE_JOYSTICK
-              if (msg_id == DL_JOYSTICK_RAW && DL_JOYSTICK_RAW_ac_id(dl_buffer) == AC_ID) {
-                JoystickHandeDatalink(DL_JOYSTICK_RAW_roll(dl_buffer),
-                                      DL_JOYSTICK_RAW_pitch(dl_buffer),
-                                      DL_JOYSTICK_RAW_throttle(dl_buffer));
-              } else
+static bool_t dl_joystick_raw_cb(uint8_t *buf)
+{
+  if (DL_JOYSTICK_RAW_ac_id(buf) != AC_ID) { return FALSE; }
+  JoystickHandeDatalink(DL_JOYSTICK_RAW_roll(buf),
+                        DL_JOYSTICK_RAW_pitch(buf),
+                        DL_JOYSTICK_RAW_throttle(buf));
+  return TRUE;
+}
 #endif // USE_JOYSTICK
+
 #if defined RADIO_CONTROL && defined RADIO_CONTROL_TYPE_DATALINK
-                if (msg_id == DL_RC_3CH /*&& DL_RC_3CH_ac_id(dl_buffer) == TX_ID*/) {
+static bool_t dl_rc_3ch_cb(uint8_t *buf)
+{
+  /* && DL_RC_3CH_ac_id(buf) == TX_ID */
 #ifdef RADIO_CONTROL_DATALINK_LED
-                  LED_TOGGLE(RADIO_CONTROL_DATALINK_LED);
+  LED_TOGGLE(RADIO_CONTROL_DATALINK_LED);
 #endif
-                  parse_rc_3ch_datalink(
-                    DL_RC_3CH_throttle_mode(dl_buffer),
-                    DL_RC_3CH_roll(dl_buffer),
-                    DL_RC_3CH_pitch(dl_buffer));
-                } else if (msg_id == DL_RC_4CH && DL_RC_4CH_ac_id(dl_buffer) == AC_ID) {
+  parse_rc_3ch_datalink(
+    DL_RC_3CH_throttle_mode(buf),
+    DL_RC_3CH_roll(buf),
+    DL_RC_3CH_pitch(buf));
+  return TRUE;
+}
+
+static bool_t dl_rc_4ch_cb(uint8_t *buf)
+{
+  if (DL_RC_4CH_ac_id(buf) != AC_ID) { return FALSE; }
 #ifdef RADIO_CONTROL_DATALINK_LED
-                  LED_TOGGLE(RADIO_CONTROL_DATALINK_LED);
-#endif
-                  parse_rc_4ch_datalink(
-                    DL_RC_4CH_mode(dl_buffer),
-                    DL_RC_4CH_throttle(dl_buffer),
-                    DL_RC_4CH_roll(dl_buffer),
-                    DL_RC_4CH_pitch(dl_buffer),
-                    DL_RC_4CH_yaw(dl_buffer));
-                } else
+  LED_TOGGLE(RADIO_CONTROL_DATALINK_LED);
+#endif
+  parse_rc_4ch_datalink(
+    DL_RC_4CH_mode(buf),
+    DL_RC_4CH_throttle(buf),
+    DL_RC_4CH_roll(buf),
+    DL_RC_4CH_pitch(buf),
+    DL_RC_4CH_yaw(buf));
+  return TRUE;
+}
 #endif // RC_DATALINK
-                { /* Last else */
-                  /* Parse modules datalink */
-                  modules_parse_datalink(msg_id);
-                }
+
+static struct dl_msg_event dl_ping_ev;
+#ifdef TRAFFIC_INFO
+static struct dl_msg_event dl_acinfo_ev;
+#endif
+#ifdef NAV
+static struct dl_msg_event dl_move_wp_ev, dl_block_ev;
+#endif
+#ifdef WIND_INFO
+static struct dl_msg_event dl_wind_info_ev;
+#endif
+#ifdef HITL
+static struct dl_msg_event dl_hitl_infrared_ev, dl_hitl_ubx_ev;
+#endif
+#ifdef DlSetting
+static struct dl_msg_event dl_setting_ev, dl_get_setting_ev;
+#endif
+#if USE_JOYSTICK
+static struct dl_msg_event dl_joystick_raw_ev;
+#endif
+#if defined RADIO_CONTROL && defined RADIO_CONTROL_TYPE_DATALINK
+static struct dl_msg_event dl_rc_3ch_ev, dl_rc_4ch_ev;
+#endif
+
+/** Bind modules and firmware handlers to the dispatch table.
+ * The firmware handlers are bound last so they are called first,
+ * the modules only get the messages not handled by the firmware.
+ */
+void datalink_init(void)
+{
+  /* Bind modules datalink */
+  modules_datalink_init();
+
+  DlBindMsg(DL_PING, &dl_ping_ev, dl_ping_cb);
+#ifdef TRAFFIC_INFO
+  DlBindMsg(DL_ACINFO, &dl_acinfo_ev, dl_acinfo_cb);
+#endif
+#ifdef NAV
+  DlBindMsg(DL_MOVE_WP, &dl_move_wp_ev, dl_move_wp_cb);
+  DlBindMsg(DL_BLOCK, &dl_block_ev, dl_block_cb);
+#endif
+#ifdef WIND_INFO
+  DlBindMsg(DL_WIND_INFO, &dl_wind_info_ev, dl_wind_info_cb);
+#endif
+#ifdef HITL
+  DlBindMsg(DL_HITL_INFRARED, &dl_hitl_infrared_ev, dl_hitl_infrared_cb);
+  DlBindMsg(DL_HITL_UBX, &dl_hitl_ubx_ev, dl_hitl_ubx_cb);
+#endif
+#ifdef DlSetting
+  DlBindMsg(DL_SETTING, &dl_setting_ev, dl_setting_cb);
+  DlBindMsg(DL_GET_SETTING, &dl_get_setting_ev, dl_get_setting_cb);
+#endif
+#if USE_JOYSTICK
+  DlBindMsg(DL_JOYSTICK_RAW, &dl_joystick_raw_ev, dl_joystick_raw_cb);
+#endif
+#if defined RADIO_CONTROL && defined RADIO_CONTROL_TYPE_DATALINK
+  DlBindMsg(DL_RC_3CH, &dl_rc_3ch_ev, dl_rc_3ch_cb);
+  DlBindMsg(DL_RC_4CH, &dl_rc_4ch_ev, dl_rc_4ch_cb);
+#endif
+}
+
+void dl_parse_msg(void)
+{
+  datalink_time = 0;
+
+  dl_dispatch(dl_buffer);
 }
@@ -226,6 +226,10 @@ void init_ap(void)
 
   modules_init();
 
+#if defined DATALINK || defined SITL
+  datalink_init();
+#endif
+
   settings_init();
 
   /**** start timers for periodic functions *****/
@@ -276,35 +280,42 @@ void handle_periodic_tasks_ap(void)
 
   if (sys_time_check_and_ack_timer(sensors_tid)) {
     sensors_task();
+    sys_time_timer_done(sensors_tid);
   }
 
 #if USE_BARO_BOARD
   if (sys_time_check_and_ack_timer(baro_tid)) {
     baro_periodic();
+    sys_time_timer_done(baro_tid);
   }
 #endif
 
   if (sys_time_check_and_ack_timer(navigation_tid)) {
     navigation_task();
+    sys_time_timer_done(navigation_tid);
   }
 
 #ifndef AHRS_TRIGGERED_ATTITUDE_LOOP
   if (sys_time_check_and_ack_timer(attitude_tid)) {
     attitude_loop();
+    sys_time_timer_done(attitude_tid);
   }
 #endif
 
   if (sys_time_check_and_ack_timer(modules_tid)) {
     modules_periodic_task();
+    sys_time_timer_done(modules_tid);
   }
 
   if (sys_time_check_and_ack_timer(monitor_tid)) {
     monitor_task();
+    sys_time_timer_done(monitor_tid);
   }
 
   if (sys_time_check_and_ack_timer(telemetry_tid)) {
     reporting_task();
     LED_PERIODIC();
+    sys_time_timer_done(telemetry_tid);
   }
 
 }
@@ -714,6 +725,9 @@ void event_task_ap(void)
     telecommand_task();
   }
 
+  /* ABI messages sent by other threads to main loop modules */
+  abi_queue_dispatch(&abi_main_queue);
+
   modules_event_task();
 
 #ifdef AHRS_TRIGGERED_ATTITUDE_LOOP
@@ -271,6 +271,9 @@ void event_task_fbw(void)
 
     SetActuatorsFromCommands(trimmed_commands, autopilot_mode);
     fbw_new_actuators = 0;
+#if defined RADIO_CONTROL && RADIO_CONTROL_LATENCY
+    radio_control_latency_update();
+#endif
 #if OUTBACK_CHALLENGE_VERY_DANGEROUS_RULE_AP_CAN_FORCE_FAILSAFE
     if (crash == 1) {
       for (;;) {
@@ -347,11 +350,13 @@ void handle_periodic_tasks_fbw(void)
 
   if (sys_time_check_and_ack_timer(fbw_periodic_tid)) {
     periodic_task_fbw();
+    sys_time_timer_done(fbw_periodic_tid);
   }
 
 #if !(DISABLE_ELECTRICAL)
   if (sys_time_check_and_ack_timer(electrical_tid)) {
     electrical_periodic();
+    sys_time_timer_done(electrical_tid);
   }
 #endif
 
@@ -29,6 +29,7 @@
 #define MODULES_DATALINK_C
 
 #include "subsystems/datalink/datalink.h"
+#include "subsystems/datalink/dl_dispatch.h"
 
 #include "generated/modules.h"
 
@@ -56,111 +57,153 @@
 #include "state.h"
 #include "led.h"
 
-#define IdOfMsg(x) (x[1])
-
-void dl_parse_msg(void)
+static bool_t dl_ping_cb(uint8_t *buf __attribute__((unused)))
 {
+  DOWNLINK_SEND_PONG(DefaultChannel, DefaultDevice);
+  return TRUE;
+}
 
-  datalink_time = 0;
+static bool_t dl_setting_cb(uint8_t *buf)
+{
+  if (DL_SETTING_ac_id(buf) != AC_ID) { return FALSE; }
+  uint8_t i = DL_SETTING_index(buf);
+  float var = DL_SETTING_value(buf);
+  DlSetting(i, var);
+  DOWNLINK_SEND_DL_VALUE(DefaultChannel, DefaultDevice, &i, &var);
+  return TRUE;
+}
 
-  uint8_t msg_id = IdOfMsg(dl_buffer);
-  switch (msg_id) {
-
-    case  DL_PING: {
-      DOWNLINK_SEND_PONG(DefaultChannel, DefaultDevice);
-    }
-    break;
-
-    case DL_SETTING : {
-      if (DL_SETTING_ac_id(dl_buffer) != AC_ID) { break; }
-      uint8_t i = DL_SETTING_index(dl_buffer);
-      float var = DL_SETTING_value(dl_buffer);
-      DlSetting(i, var);
-      DOWNLINK_SEND_DL_VALUE(DefaultChannel, DefaultDevice, &i, &var);
-    }
-    break;
-
-    case DL_GET_SETTING : {
-      if (DL_GET_SETTING_ac_id(dl_buffer) != AC_ID) { break; }
-      uint8_t i = DL_GET_SETTING_index(dl_buffer);
-      float val = settings_get_value(i);
-      DOWNLINK_SEND_DL_VALUE(DefaultChannel, DefaultDevice, &i, &val);
-    }
-    break;
+static bool_t dl_get_setting_cb(uint8_t *buf)
+{
+  if (DL_GET_SETTING_ac_id(buf) != AC_ID) { return FALSE; }
+  uint8_t i = DL_GET_SETTING_index(buf);
+  float val = settings_get_value(i);
+  DOWNLINK_SEND_DL_VALUE(DefaultChannel, DefaultDevice, &i, &val);
+  return TRUE;
+}
 
 #if defined USE_NAVIGATION
-    case DL_BLOCK : {
-      if (DL_BLOCK_ac_id(dl_buffer) != AC_ID) { break; }
-      nav_goto_block(DL_BLOCK_block_id(dl_buffer));
-    }
-    break;
-
-    case DL_MOVE_WP : {
-      uint8_t ac_id = DL_MOVE_WP_ac_id(dl_buffer);
-      if (ac_id != AC_ID) { break; }
-      if (stateIsLocalCoordinateValid()) {
-        uint8_t wp_id = DL_MOVE_WP_wp_id(dl_buffer);
-        struct LlaCoor_i lla;
-        lla.lat = DL_MOVE_WP_lat(dl_buffer);
-        lla.lon = DL_MOVE_WP_lon(dl_buffer);
-        /* WP_alt from message is alt above MSL in mm
-         * lla.alt is above ellipsoid in mm
-         */
-        lla.alt = DL_MOVE_WP_alt(dl_buffer) - state.ned_origin_i.hmsl +
-                  state.ned_origin_i.lla.alt;
-        waypoint_move_lla(wp_id, &lla);
-      }
-    }
-    break;
+static bool_t dl_block_cb(uint8_t *buf)
+{
+  if (DL_BLOCK_ac_id(buf) != AC_ID) { return FALSE; }
+  nav_goto_block(DL_BLOCK_block_id(buf));
+  return TRUE;
+}
+
+static bool_t dl_move_wp_cb(uint8_t *buf)
+{
+  uint8_t ac_id = DL_MOVE_WP_ac_id(buf);
+  if (ac_id != AC_ID) { return FALSE; }
+  if (stateIsLocalCoordinateValid()) {
+    uint8_t wp_id = DL_MOVE_WP_wp_id(buf);
+    struct LlaCoor_i lla;
+    lla.lat = DL_MOVE_WP_lat(buf);
+    lla.lon = DL_MOVE_WP_lon(buf);
+    /* WP_alt from message is alt above MSL in mm
+     * lla.alt is above ellipsoid in mm
+     */
+    lla.alt = DL_MOVE_WP_alt(buf) - state.ned_origin_i.hmsl +
+              state.ned_origin_i.lla.alt;
+    waypoint_move_lla(wp_id, &lla);
+  }
+  return TRUE;
+}
 #endif /* USE_NAVIGATION */
+
 #ifdef RADIO_CONTROL_TYPE_DATALINK
-    case DL_RC_3CH :
+static bool_t dl_rc_3ch_cb(uint8_t *buf)
+{
 #ifdef RADIO_CONTROL_DATALINK_LED
-      LED_TOGGLE(RADIO_CONTROL_DATALINK_LED);
+  LED_TOGGLE(RADIO_CONTROL_DATALINK_LED);
 #endif
-      parse_rc_3ch_datalink(
-        DL_RC_3CH_throttle_mode(dl_buffer),
-        DL_RC_3CH_roll(dl_buffer),
-        DL_RC_3CH_pitch(dl_buffer));
-      break;
-    case DL_RC_4CH :
-      if (DL_RC_4CH_ac_id(dl_buffer) == AC_ID) {
+  parse_rc_3ch_datalink(
+    DL_RC_3CH_throttle_mode(buf),
+    DL_RC_3CH_roll(buf),
+    DL_RC_3CH_pitch(buf));
+  return TRUE;
+}
+
+static bool_t dl_rc_4ch_cb(uint8_t *buf)
+{
+  if (DL_RC_4CH_ac_id(buf) == AC_ID) {
 #ifdef RADIO_CONTROL_DATALINK_LED
-        LED_TOGGLE(RADIO_CONTROL_DATALINK_LED);
+    LED_TOGGLE(RADIO_CONTROL_DATALINK_LED);
 #endif
-        parse_rc_4ch_datalink(DL_RC_4CH_mode(dl_buffer),
-                              DL_RC_4CH_throttle(dl_buffer),
-                              DL_RC_4CH_roll(dl_buffer),
-                              DL_RC_4CH_pitch(dl_buffer),
-                              DL_RC_4CH_yaw(dl_buffer));
-      }
-      break;
+    parse_rc_4ch_datalink(DL_RC_4CH_mode(buf),
+                          DL_RC_4CH_throttle(buf),
+                          DL_RC_4CH_roll(buf),
+                          DL_RC_4CH_pitch(buf),
+                          DL_RC_4CH_yaw(buf));
+    return TRUE;
+  }
+  return FALSE;
+}
 #endif // RADIO_CONTROL_TYPE_DATALINK
+
+#if defined GPS_DATALINK
+static bool_t dl_remote_gps_cb(uint8_t *buf)
+{
+  // Check if the GPS is for this AC
+  if (DL_REMOTE_GPS_ac_id(buf) != AC_ID) { return FALSE; }
+
+  // Parse the GPS
+  parse_gps_datalink(
+    DL_REMOTE_GPS_numsv(buf),
+    DL_REMOTE_GPS_ecef_x(buf),
+    DL_REMOTE_GPS_ecef_y(buf),
+    DL_REMOTE_GPS_ecef_z(buf),
+    DL_REMOTE_GPS_lat(buf),
+    DL_REMOTE_GPS_lon(buf),
+    DL_REMOTE_GPS_alt(buf),
+    DL_REMOTE_GPS_hmsl(buf),
+    DL_REMOTE_GPS_ecef_xd(buf),
+    DL_REMOTE_GPS_ecef_yd(buf),
+    DL_REMOTE_GPS_ecef_zd(buf),
+    DL_REMOTE_GPS_tow(buf),
+    DL_REMOTE_GPS_course(buf));
+  return TRUE;
+}
+#endif
+
+static struct dl_msg_event dl_ping_ev, dl_setting_ev, dl_get_setting_ev;
+#if defined USE_NAVIGATION
+static struct dl_msg_event dl_block_ev, dl_move_wp_ev;
+#endif
+#ifdef RADIO_CONTROL_TYPE_DATALINK
+static struct dl_msg_event dl_rc_3ch_ev, dl_rc_4ch_ev;
+#endif
 #if defined GPS_DATALINK
-    case DL_REMOTE_GPS :
-      // Check if the GPS is for this AC
-      if (DL_REMOTE_GPS_ac_id(dl_buffer) != AC_ID) { break; }
-
-      // Parse the GPS
-      parse_gps_datalink(
-        DL_REMOTE_GPS_numsv(dl_buffer),
-        DL_REMOTE_GPS_ecef_x(dl_buffer),
-        DL_REMOTE_GPS_ecef_y(dl_buffer),
-        DL_REMOTE_GPS_ecef_z(dl_buffer),
-        DL_REMOTE_GPS_lat(dl_buffer),
-        DL_REMOTE_GPS_lon(dl_buffer),
-        DL_REMOTE_GPS_alt(dl_buffer),
-        DL_REMOTE_GPS_hmsl(dl_buffer),
-        DL_REMOTE_GPS_ecef_xd(dl_buffer),
-        DL_REMOTE_GPS_ecef_yd(dl_buffer),
-        DL_REMOTE_GPS_ecef_zd(dl_buffer),
-        DL_REMOTE_GPS_tow(dl_buffer),
-        DL_REMOTE_GPS_course(dl_buffer));
-      break;
+static struct dl_msg_event dl_remote_gps_ev;
 #endif
-    default:
-      break;
-  }
-  /* Parse modules datalink */
-  modules_parse_datalink(msg_id);
+
+/** Bind modules and firmware handlers to the dispatch table.
+ * The firmware handlers are bound last so they are called first,
+ * the modules only get the messages not handled by the firmware.
+ */
+void datalink_init(void)
+{
+  /* Bind modules datalink */
+  modules_datalink_init();
+
+  DlBindMsg(DL_PING, &dl_ping_ev, dl_ping_cb);
+  DlBindMsg(DL_SETTING, &dl_setting_ev, dl_setting_cb);
+  DlBindMsg(DL_GET_SETTING, &dl_get_setting_ev, dl_get_setting_cb);
+#if defined USE_NAVIGATION
+  DlBindMsg(DL_BLOCK, &dl_block_ev, dl_block_cb);
+  DlBindMsg(DL_MOVE_WP, &dl_move_wp_ev, dl_move_wp_cb);
+#endif
+#ifdef RADIO_CONTROL_TYPE_DATALINK
+  DlBindMsg(DL_RC_3CH, &dl_rc_3ch_ev, dl_rc_3ch_cb);
+  DlBindMsg(DL_RC_4CH, &dl_rc_4ch_ev, dl_rc_4ch_cb);
+#endif
+#if defined GPS_DATALINK
+  DlBindMsg(DL_REMOTE_GPS, &dl_remote_gps_ev, dl_remote_gps_cb);
+#endif
+}
+
+void dl_parse_msg(void)
+{
+  datalink_time = 0;
+
+  dl_dispatch(dl_buffer);
 }
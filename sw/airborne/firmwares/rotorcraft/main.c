@@ -123,6 +123,7 @@ int main(void)
   while (1) {
     handle_periodic_tasks();
     main_event();
+    mcu_event_wait();
   }
   return 0;
 }
@@ -132,6 +133,11 @@ STATIC_INLINE void main_init(void)
 {
   mcu_init();
 
+#if MCU_EVENT_WAIT
+  /* messages queued by other threads for the main loop wake it up */
+  abi_main_queue.notify = mcu_arch_event_wakeup;
+#endif
+
   electrical_init();
 
   stateInit();
@@ -165,6 +171,10 @@ STATIC_INLINE void main_init(void)
 
   modules_init();
 
+#if defined DATALINK || defined SITL
+  datalink_init();
+#endif
+
   settings_init();
 
   mcu_int_enable();
@@ -192,25 +202,32 @@ STATIC_INLINE void handle_periodic_tasks(void)
 {
   if (sys_time_check_and_ack_timer(main_periodic_tid)) {
     main_periodic();
+    sys_time_timer_done(main_periodic_tid);
   }
   if (sys_time_check_and_ack_timer(modules_tid)) {
     modules_periodic_task();
+    sys_time_timer_done(modules_tid);
   }
   if (sys_time_check_and_ack_timer(radio_control_tid)) {
     radio_control_periodic_task();
+    sys_time_timer_done(radio_control_tid);
   }
   if (sys_time_check_and_ack_timer(failsafe_tid)) {
     failsafe_check();
+    sys_time_timer_done(failsafe_tid);
   }
   if (sys_time_check_and_ack_timer(electrical_tid)) {
     electrical_periodic();
+    sys_time_timer_done(electrical_tid);
   }
   if (sys_time_check_and_ack_timer(telemetry_tid)) {
     telemetry_periodic();
+    sys_time_timer_done(telemetry_tid);
   }
 #if USE_BARO_BOARD
   if (sys_time_check_and_ack_timer(baro_tid)) {
     baro_periodic();
+    sys_time_timer_done(baro_tid);
   }
 #endif
 }
@@ -230,6 +247,9 @@ STATIC_INLINE void main_periodic(void)
   /* set actuators     */
   //actuators_set(autopilot_motors_on);
   SetActuatorsFromCommands(commands, autopilot_mode);
+#if RADIO_CONTROL_LATENCY
+  radio_control_latency_update();
+#endif
 
   if (autopilot_in_flight) {
     RunOnceEvery(PERIODIC_FREQUENCY, { autopilot_flight_time++;
@@ -328,5 +348,8 @@ STATIC_INLINE void main_event(void)
   DetectGroundEvent();
 #endif
 
+  /* ABI messages sent by other threads to main loop modules */
+  abi_queue_dispatch(&abi_main_queue);
+
   modules_event_task();
 }
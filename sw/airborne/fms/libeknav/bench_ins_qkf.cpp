@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file fms/libeknav/bench_ins_qkf.cpp
+ *
+ * Run the float and double versions of ins_qkf_fast on a simulated flight,
+ * report their accuracy against the simulation and the time of the
+ * prediction and update steps.
+ *
+ * The flight is a slow circle with oscillating attitude, IMU at 512Hz,
+ * magnetometer and gravity vector updates at 16Hz, GPS at 4Hz and baro at 50Hz.
+ */
+
+#include "ins_qkf_fast.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <random>
+
+using namespace Eigen;
+
+#define IMU_FREQ 512
+#define MAG_DIV 32
+#define GPS_DIV 128
+#define BARO_DIV 10
+#define DURATION 300.
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/** Simulated trajectory around a fixed ECEF point */
+struct truth {
+  Vector3d pos, vel, accel;   ///< ECEF
+  Quaterniond q;              ///< ECEF to body
+  Vector3d rates;             ///< body rates
+};
+
+struct simulation {
+  Vector3d origin;
+  Matrix3d ned_to_ecef;
+  Quaterniond q_ecef2ned;
+  std::mt19937 gen;
+  std::normal_distribution<double> n;
+
+  simulation() : gen(42), n(0., 1.)
+  {
+    const double lat = 43.56 * M_PI / 180., lon = 1.48 * M_PI / 180., r = 6378137. + 150.;
+    origin << r * cos(lat) * cos(lon), r * cos(lat) * sin(lon), r * sin(lat);
+    ned_to_ecef << -sin(lat) * cos(lon), -sin(lon), -cos(lat) * cos(lon),
+                -sin(lat) * sin(lon),  cos(lon), -cos(lat) * sin(lon),
+                cos(lat), 0., -sin(lat);
+    q_ecef2ned = Quaterniond(ned_to_ecef.transpose());
+  }
+
+  Vector3d noise(double sigma) { return Vector3d(n(gen), n(gen), n(gen)) * sigma; }
+
+  /** circle of 30m radius in 60s, at constant altitude */
+  void at(double t, truth& s)
+  {
+    const double w = 2 * M_PI / 60., R = 30.;
+    Vector3d p(R * cos(w * t), R * sin(w * t), 0.);
+    Vector3d v(-R * w * sin(w * t), R * w * cos(w * t), 0.);
+    Vector3d a(-R * w * w * cos(w * t), -R * w * w * sin(w * t), 0.);
+    s.pos = origin + ned_to_ecef * p;
+    s.vel = ned_to_ecef * v;
+    s.accel = ned_to_ecef * a;
+    /* attitude: heading along the track with oscillating roll and pitch */
+    const double phi = 0.2 * sin(0.5 * t), theta = 0.1 * sin(0.3 * t), psi = w * t + M_PI / 2;
+    const double dphi = 0.1 * cos(0.5 * t), dtheta = 0.03 * cos(0.3 * t), dpsi = w;
+    Quaterniond q_ned2body = (AngleAxisd(psi, Vector3d::UnitZ()) * AngleAxisd(theta, Vector3d::UnitY()) *
+                              AngleAxisd(phi, Vector3d::UnitX())).inverse();
+    s.q = q_ned2body * q_ecef2ned;
+    s.rates << dphi - sin(theta) * dpsi,
+            cos(phi) * dtheta + sin(phi) * cos(theta) * dpsi,
+            -sin(phi) * dtheta + cos(phi) * cos(theta) * dpsi;
+  }
+};
+
+/** filter results */
+struct result {
+  double att_err2, pos_err2, vel_err2;
+  double t_predict, t_update;
+  int nb, nb_update;
+};
+
+template <typename Scalar>
+static void run(const char *name, simulation sim, struct result& res)
+{
+  typedef Matrix<Scalar, 3, 1> vec3;
+  typedef ins_qkf_fast::ins_qkf<Scalar> filter_t;
+  const double dt = 1. / IMU_FREQ;
+  const vec3 gyro_noise(1e-4, 1e-4, 1e-4), bias_noise(1e-8, 1e-8, 1e-8), accel_noise(1e-2, 1e-2, 1e-2);
+  const Vector3d gyro_bias(0.01, -0.02, 0.005);
+  const Vector3d mag_ned(0.5156, -0.0571, 0.8549);
+  filter_t *ins = new filter_t(gyro_noise, bias_noise, accel_noise);
+  typename filter_t::batch_t batch;
+  truth s;
+
+  sim.at(0., s);
+  /* start with errors */
+  Quaterniond q0 = s.q * ins_qkf_fast::quat_exp<double>(Vector3d(0.05, -0.05, 0.2));
+  ins->reset(s.pos + Vector3d(5., -3., 2.), vec3::Zero(), q0.cast<Scalar>(),
+             vec3::Constant(0.05), vec3::Constant(0.3), vec3::Constant(10.), vec3::Constant(1.));
+  const vec3 mag_ref = (sim.ned_to_ecef * mag_ned.normalized()).cast<Scalar>();
+
+  memset(&res, 0, sizeof(res));
+  for (int i = 1; i <= DURATION * IMU_FREQ; i++) {
+    const double t = i * dt;
+    sim.at(t, s);
+    const Vector3d gravity = -9.81 * s.pos.normalized();
+    const vec3 accel = (s.q * (s.accel - gravity) + sim.noise(0.05)).cast<Scalar>();
+    const vec3 gyro = (s.rates + gyro_bias + sim.noise(0.002)).cast<Scalar>();
+
+    double t0 = now_ns();
+    ins->predict(gyro, accel, dt);
+    res.t_predict += now_ns() - t0;
+
+    Vector3d mag_obs = s.q * (sim.ned_to_ecef * mag_ned.normalized()) + sim.noise(0.01);
+    Vector3d gps_pos = s.pos + sim.noise(1.);
+    Vector3d gps_vel = s.vel + sim.noise(0.2);
+    double baro = s.pos.norm() + sim.noise(0.5)(0);
+
+    t0 = now_ns();
+    batch.clear();
+    if (i % MAG_DIV == 0) {
+      ins->add_vector(batch, mag_ref, mag_obs.cast<Scalar>(), Scalar(1e-3));
+      ins->add_vector(batch, s.pos.normalized().cast<Scalar>(), accel, Scalar(1e-2));
+    }
+    if (i % GPS_DIV == 0) {
+      ins->add_gps_pv(batch, gps_pos, gps_vel.cast<Scalar>(), vec3::Constant(1.), vec3::Constant(0.04));
+    }
+    if (i % BARO_DIV == 0) {
+      ins->add_baro(batch, baro, Scalar(0.25));
+    }
+    if (!batch.empty()) {
+      ins->update(batch);
+      res.nb_update++;
+    }
+    res.t_update += now_ns() - t0;
+
+    if (t > 60.) {
+      /* errors after convergence */
+      Quaterniond dq = ins->orientation.template cast<double>() * s.q.conjugate();
+      if (dq.w() < 0.) {
+        dq.coeffs() *= -1.;
+      }
+      double a = ins_qkf_fast::quat_log<double>(dq).norm();
+      res.att_err2 += a * a;
+      res.pos_err2 += (ins->position - s.pos).squaredNorm();
+      res.vel_err2 += (ins->velocity.template cast<double>() - s.vel).squaredNorm();
+      res.nb++;
+    }
+  }
+  printf("%-8s %9.3f %9.3f %12.4f %9.3f %9.3f   %s\n", name,
+         res.t_predict / 1e3 / (DURATION * IMU_FREQ), res.t_update / 1e3 / res.nb_update,
+         sqrt(res.att_err2 / res.nb) * 180. / M_PI, sqrt(res.pos_err2 / res.nb), sqrt(res.vel_err2 / res.nb),
+         ins->is_real() ? "" : "(diverged)");
+  delete ins;
+}
+
+int main(void)
+{
+  simulation sim;
+  struct result rf, rd;
+  printf("%-8s %9s %9s %12s %9s %9s\n", "", "predict", "update", "att rms", "pos rms", "vel rms");
+  printf("%-8s %9s %9s %12s %9s %9s\n", "", "(us)", "(us)", "(deg)", "(m)", "(m/s)");
+  run<double>("double", sim, rd);
+  run<float>("float", sim, rf);
+  printf("speedup  %9.2f %9.2f\n", rd.t_predict / rf.t_predict, (rd.t_update / rd.nb_update) / (rf.t_update / rf.nb_update));
+  return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file fms/libeknav/ins_qkf_api.cpp
+ *
+ * C interface to the single precision ins_qkf_fast filter.
+ */
+
+#include "ins_qkf_api.h"
+#include "ins_qkf_fast.hpp"
+
+#include <new>
+
+using namespace Eigen;
+
+static ins_qkf_f *ins;
+static ins_qkf_f::batch_t batch;
+
+/* the paparazzi q_a2b is the conjugate of the Eigen active rotation */
+static inline Quaternionf quat_of_pprz(const struct FloatQuat *q)
+{
+  return Quaternionf(q->qi, -q->qx, -q->qy, -q->qz);
+}
+
+static inline Vector3f vect_of_pprz(const struct FloatVect3 *v)
+{
+  return Vector3f(v->x, v->y, v->z);
+}
+
+void ins_qkf_api_init(float gyro_white, float gyro_stability, float accel_white)
+{
+  /* Eigen fixed size members need an aligned allocation */
+  static unsigned char buf[sizeof(ins_qkf_f)] __attribute__((aligned(32)));
+  if (ins != NULL) {
+    ins->~ins_qkf_f();
+  }
+  ins = new (buf) ins_qkf_f(Vector3f::Constant(gyro_white), Vector3f::Constant(gyro_stability),
+                            Vector3f::Constant(accel_white));
+  batch.clear();
+}
+
+void ins_qkf_api_reset(struct EcefCoor_d *pos, struct FloatVect3 *vel,
+                       struct FloatQuat *q_ecef2body, struct InsQkfInitErrors *err)
+{
+  ins->reset(Vector3d(pos->x, pos->y, pos->z), vect_of_pprz(vel), quat_of_pprz(q_ecef2body).normalized(),
+             Vector3f::Constant(err->gyro_bias), Vector3f::Constant(err->attitude),
+             Vector3f::Constant(err->position), Vector3f::Constant(err->velocity));
+  batch.clear();
+}
+
+void ins_qkf_api_predict(struct FloatRates *gyro, struct FloatVect3 *accel, float dt)
+{
+  ins->predict(Vector3f(gyro->p, gyro->q, gyro->r), vect_of_pprz(accel), dt);
+}
+
+void ins_qkf_api_add_vector(struct FloatVect3 *ref, struct FloatVect3 *obs, float noise)
+{
+  ins->add_vector(batch, vect_of_pprz(ref), vect_of_pprz(obs), noise);
+}
+
+void ins_qkf_api_add_gps(struct EcefCoor_d *pos, struct FloatVect3 *vel, float p_noise, float v_noise)
+{
+  ins->add_gps_pv(batch, Vector3d(pos->x, pos->y, pos->z), vect_of_pprz(vel),
+                  Vector3f::Constant(p_noise), Vector3f::Constant(v_noise));
+}
+
+void ins_qkf_api_add_baro(double altitude, float noise)
+{
+  ins->add_baro(batch, altitude, noise);
+}
+
+bool_t ins_qkf_api_update(void)
+{
+  if (!batch.empty()) {
+    ins->update(batch);
+    batch.clear();
+  }
+  return ins->is_real();
+}
+
+void ins_qkf_api_get_state(struct EcefCoor_d *pos, struct FloatVect3 *vel,
+                           struct FloatQuat *q_ecef2body, struct FloatRates *gyro_bias)
+{
+  pos->x = ins->position(0);
+  pos->y = ins->position(1);
+  pos->z = ins->position(2);
+  vel->x = ins->velocity(0);
+  vel->y = ins->velocity(1);
+  vel->z = ins->velocity(2);
+  q_ecef2body->qi = ins->orientation.w();
+  q_ecef2body->qx = -ins->orientation.x();
+  q_ecef2body->qy = -ins->orientation.y();
+  q_ecef2body->qz = -ins->orientation.z();
+  if (gyro_bias != NULL) {
+    gyro_bias->p = ins->gyro_bias(0);
+    gyro_bias->q = ins->gyro_bias(1);
+    gyro_bias->r = ins->gyro_bias(2);
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file fms/libeknav/ins_qkf_api.h
+ *
+ * C interface to the single precision ins_qkf_fast filter.
+ *
+ * Noises are variances, as in basic_ins_qkf.
+ * Observations are queued with the ins_qkf_api_add_xxx functions and
+ * incorporated all at once by ins_qkf_api_update.
+ * Quaternions follow the paparazzi convention (q_ecef2body as used by
+ * float_quat_vmult), vectors are ECEF unless stated otherwise.
+ */
+
+#ifndef INS_QKF_API_H
+#define INS_QKF_API_H
+
+#include "std.h"
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_geodetic_double.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** One sigma errors of the initial state */
+struct InsQkfInitErrors {
+  float gyro_bias;  ///< rad/s
+  float attitude;   ///< rad
+  float position;   ///< m
+  float velocity;   ///< m/s
+};
+
+/** Create the filter
+ * @param gyro_white gyro white noise ((rad/s)^2/Hz)
+ * @param gyro_stability gyro bias instability ((rad/s^2)^2/Hz)
+ * @param accel_white accelerometer white noise ((m/s^2)^2/Hz)
+ */
+extern void ins_qkf_api_init(float gyro_white, float gyro_stability, float accel_white);
+
+/** Reset the state
+ * @param pos ECEF position (m)
+ * @param vel ECEF velocity (m/s)
+ * @param q_ecef2body orientation
+ * @param err initial errors
+ */
+extern void ins_qkf_api_reset(struct EcefCoor_d *pos, struct FloatVect3 *vel,
+                              struct FloatQuat *q_ecef2body, struct InsQkfInitErrors *err);
+
+/** Propagate with IMU measurements
+ * @param gyro body rates (rad/s)
+ * @param accel body specific force (m/s^2)
+ * @param dt time step (s)
+ */
+extern void ins_qkf_api_predict(struct FloatRates *gyro, struct FloatVect3 *accel, float dt);
+
+/** Queue a vector observation
+ * @param ref reference direction in ECEF
+ * @param obs observed direction in body frame
+ * @param noise variance of the angular error (rad^2)
+ */
+extern void ins_qkf_api_add_vector(struct FloatVect3 *ref, struct FloatVect3 *obs, float noise);
+
+/** Queue a GPS position and velocity observation
+ * @param pos ECEF position (m)
+ * @param vel ECEF velocity (m/s)
+ * @param p_noise position variance (m^2)
+ * @param v_noise velocity variance ((m/s)^2)
+ */
+extern void ins_qkf_api_add_gps(struct EcefCoor_d *pos, struct FloatVect3 *vel, float p_noise, float v_noise);
+
+/** Queue a geocentric altitude observation
+ * @param altitude distance to the center of the earth (m)
+ * @param noise variance (m^2)
+ */
+extern void ins_qkf_api_add_baro(double altitude, float noise);
+
+/** Incorporate the queued observations
+ * @return FALSE if the filter diverged, it should be reset
+ */
+extern bool_t ins_qkf_api_update(void);
+
+/** Get the current state
+ * @param pos ECEF position (m)
+ * @param vel ECEF velocity (m/s)
+ * @param q_ecef2body orientation
+ * @param gyro_bias gyro bias (rad/s), can be NULL
+ */
+extern void ins_qkf_api_get_state(struct EcefCoor_d *pos, struct FloatVect3 *vel,
+                                  struct FloatQuat *q_ecef2body, struct FloatRates *gyro_bias);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INS_QKF_API_H */
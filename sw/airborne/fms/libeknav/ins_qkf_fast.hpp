@@ -0,0 +1,368 @@
+#ifndef INS_QKF_FAST_HPP
+#define INS_QKF_FAST_HPP
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file fms/libeknav/ins_qkf_fast.hpp
+ *
+ * Eigen 3 port of the libeknav basic_ins_qkf (ins_qkf.hpp) for the Linux targets.
+ *
+ * The filter is templated on the scalar type of the attitude, velocity and
+ * covariance. It is used in single precision (Eigen vectorizes the 12x12
+ * float blocks), the double instantiation is a reference for accuracy checks.
+ * The ECEF position is always kept in double precision.
+ *
+ * Differences with basic_ins_qkf:
+ *  - the state transition matrix is never built, the covariance propagation
+ *    only applies its non identity blocks, including the position/attitude
+ *    term that the hand unrolled version drops
+ *  - accel_cov, the tangent space to translation coupling, reduces to
+ *    -[a_ecef]x: no AngleAxis is built at each step
+ *  - the process noise blocks are computed once for a given dt
+ *  - observations are accumulated in an observation_batch and incorporated
+ *    in one update as a sequence of scalar updates (GPS position, velocity,
+ *    vector observations and baro in the same batch)
+ *  - the gyro measurements are standard body rates
+ *
+ * State and error vector, as in basic_ins_qkf:
+ * gyro bias (0), attitude (3), ECEF position (6), ECEF velocity (9).
+ * The orientation rotates ECEF vectors to the body frame: v_body = orientation * v_ecef.
+ */
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+
+namespace ins_qkf_fast {
+
+/** Quaternion of a rotation vector */
+template <typename Scalar>
+Eigen::Quaternion<Scalar> quat_exp(const Eigen::Matrix<Scalar, 3, 1>& v)
+{
+  Scalar angle = v.norm();
+  if (angle <= Eigen::NumTraits<Scalar>::epsilon()) {
+    return Eigen::Quaternion<Scalar>::Identity();
+  }
+  Eigen::Quaternion<Scalar> ret;
+  ret.w() = std::cos(angle * Scalar(0.5));
+  ret.vec() = (std::sin(angle * Scalar(0.5)) / angle) * v;
+  return ret;
+}
+
+/** Rotation vector of a unit quaternion */
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> quat_log(const Eigen::Quaternion<Scalar>& q)
+{
+  Scalar mag = q.vec().norm();
+  if (mag <= Eigen::NumTraits<Scalar>::epsilon()) {
+    return Eigen::Matrix<Scalar, 3, 1>::Zero();
+  }
+  Scalar angle = Scalar(2) * std::atan2(mag, q.w());
+  return q.vec() * (angle / mag);
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> skew(const Eigen::Matrix<Scalar, 3, 1>& v)
+{
+  Eigen::Matrix<Scalar, 3, 3> m;
+  m << 0, -v(2), v(1),
+       v(2), 0, -v(0),
+       -v(1), v(0), 0;
+  return m;
+}
+
+/** Index of the first error state of each block */
+enum block_t {
+  BLOCK_GYRO_BIAS = 0,
+  BLOCK_ATTITUDE = 3,
+  BLOCK_POSITION = 6,
+  BLOCK_VELOCITY = 9
+};
+
+/**
+ * Scalar observations waiting to be incorporated.
+ * Each row observes one 3 elements block of the error state.
+ * The residuals are computed against the mean state when the observation is
+ * added, so a batch must be incorporated before the next prediction.
+ */
+template <typename Scalar>
+struct observation_batch {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  /// Three GPS position and velocity rows, two rows per vector and one for the baro
+  static const int max_rows = 16;
+
+  struct row {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    Eigen::Matrix<Scalar, 3, 1> h;  ///< non zero part of the observation row
+    Scalar residual;                ///< observation minus prediction
+    Scalar noise;                   ///< variance of the observation noise
+    int block;                      ///< observed block, see block_t
+  };
+
+  row rows[max_rows];
+  int size;
+
+  observation_batch() : size(0) {}
+  void clear(void) { size = 0; }
+  bool empty(void) const { return size == 0; }
+
+  /** @return FALSE if the batch is full */
+  bool add(int block, const Eigen::Matrix<Scalar, 3, 1>& h, Scalar residual, Scalar noise)
+  {
+    if (size >= max_rows) {
+      return false;
+    }
+    rows[size].h = h;
+    rows[size].residual = residual;
+    rows[size].noise = noise;
+    rows[size].block = block;
+    size++;
+    return true;
+  }
+};
+
+template <typename Scalar>
+struct ins_qkf {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef Eigen::Matrix<Scalar, 3, 1> vec3_t;
+  typedef Eigen::Matrix<Scalar, 3, 3> mat3_t;
+  typedef Eigen::Matrix<Scalar, 12, 1> error_t;
+  typedef Eigen::Matrix<Scalar, 12, 12> cov_t;
+  typedef Eigen::Quaternion<Scalar> quat_t;
+  typedef observation_batch<Scalar> batch_t;
+
+  /// Process noise densities, see basic_ins_qkf
+  vec3_t gyro_stability_noise;
+  vec3_t gyro_white_noise;
+  vec3_t accel_white_noise;
+
+  /// Mean state
+  vec3_t gyro_bias;
+  quat_t orientation;
+  Eigen::Vector3d position;
+  vec3_t velocity;
+
+  /// Covariance, elements ordered as the error vector
+  cov_t cov;
+
+  ins_qkf(const vec3_t& _gyro_white_noise, const vec3_t& _gyro_stability_noise,
+          const vec3_t& _accel_white_noise)
+    : gyro_stability_noise(_gyro_stability_noise)
+    , gyro_white_noise(_gyro_white_noise)
+    , accel_white_noise(_accel_white_noise)
+    , noise_dt(-1)
+  {
+    reset(Eigen::Vector3d::Zero(), vec3_t::Zero(), quat_t::Identity(),
+          vec3_t::Ones(), vec3_t::Ones(), vec3_t::Ones(), vec3_t::Ones());
+  }
+
+  /**
+   * Reset the mean state and set a diagonal covariance
+   * @param pos ECEF position (m)
+   * @param vel ECEF velocity (m/s)
+   * @param q ECEF to body orientation
+   * @param bias_error, att_error, pos_error, vel_error one sigma errors
+   */
+  void reset(const Eigen::Vector3d& pos, const vec3_t& vel, const quat_t& q,
+             const vec3_t& bias_error, const vec3_t& att_error,
+             const vec3_t& pos_error, const vec3_t& vel_error)
+  {
+    gyro_bias.setZero();
+    orientation = q;
+    position = pos;
+    velocity = vel;
+    error_t d;
+    d << bias_error, att_error, pos_error, vel_error;
+    cov = d.cwiseProduct(d).asDiagonal();
+  }
+
+  /**
+   * Propagate the filter by one IMU step
+   * @param gyro_meas body rates (rad/s)
+   * @param accel_meas specific force in body frame (m/s^2)
+   * @param dt time step (s)
+   */
+  void predict(const vec3_t& gyro_meas, const vec3_t& accel_meas, Scalar dt)
+  {
+    const mat3_t rot = orientation.conjugate().toRotationMatrix();
+    const vec3_t accel_ecef = rot * accel_meas;
+    const vec3_t gravity = (position.normalized() * -9.81).template cast<Scalar>();
+    const vec3_t accel_resid = accel_ecef + gravity;
+
+    // A = [ I 0 0 0 ; dtR I 0 0 ; 0 hQ I dtI ; 0 dtQ 0 I ], with Q = [a_ecef]x
+    const mat3_t dtR = rot * dt;
+    const mat3_t dtQ = skew(vec3_t(accel_ecef * dt));
+    const mat3_t hQ = dtQ * (Scalar(0.5) * dt);
+
+    // cov = A * (A * cov)^T, cov is symmetric: the blocks are updated by columns only,
+    // contiguous in memory, the order matters since each uses the previous values of the others
+    for (int k = 0; k < 2; k++) {
+      cov.template middleCols<3>(6) += cov.template middleCols<3>(9) * dt + cov.template middleCols<3>(3) * hQ.transpose();
+      cov.template middleCols<3>(9) += cov.template middleCols<3>(3) * dtQ.transpose();
+      cov.template middleCols<3>(3) += cov.template leftCols<3>() * dtR.transpose();
+      cov.transposeInPlace();
+    }
+
+    if (dt != noise_dt) {
+      update_process_noise(dt);
+    }
+    cov.diagonal() += process_noise;
+
+    orientation = (quat_exp<Scalar>((gyro_bias - gyro_meas) * dt) * orientation).normalized();
+    position += (velocity * dt + accel_resid * (Scalar(0.5) * dt * dt)).template cast<double>();
+    velocity += accel_resid * dt;
+  }
+
+  /**
+   * Add a vector observation
+   * @param batch observation batch
+   * @param ref reference unit vector in ECEF
+   * @param obs observed vector in body frame
+   * @param error variance of the angular error (rad^2)
+   */
+  void add_vector(batch_t& batch, const vec3_t& ref, const vec3_t& obs, Scalar error) const
+  {
+    const vec3_t obs_ref = orientation.conjugate() * obs;
+    const vec3_t v_residual = quat_log<Scalar>(quat_t().setFromTwoVectors(ref, obs_ref));
+    vec3_t h0 = ref.cross(
+      (std::abs(ref.dot(obs_ref)) < Scalar(0.9994)) ? obs_ref :
+      (std::abs(ref.dot(vec3_t::UnitX())) < Scalar(0.707)) ? vec3_t::UnitX() : vec3_t::UnitY()).normalized();
+    vec3_t h1 = -ref.cross(h0);
+    batch.add(BLOCK_ATTITUDE, h0, h0.dot(v_residual), error);
+    batch.add(BLOCK_ATTITUDE, h1, h1.dot(v_residual), error);
+  }
+
+  /** Add a GPS ECEF position observation, p_error is the variance (m^2) */
+  void add_gps_p(batch_t& batch, const Eigen::Vector3d& pos, const vec3_t& p_error) const
+  {
+    const vec3_t residual = (pos - position).template cast<Scalar>();
+    for (int i = 0; i < 3; i++) {
+      batch.add(BLOCK_POSITION, vec3_t::Unit(i), residual(i), p_error(i));
+    }
+  }
+
+  /** Add a GPS ECEF velocity observation, v_error is the variance ((m/s)^2) */
+  void add_gps_v(batch_t& batch, const vec3_t& vel, const vec3_t& v_error) const
+  {
+    const vec3_t residual = vel - velocity;
+    for (int i = 0; i < 3; i++) {
+      batch.add(BLOCK_VELOCITY, vec3_t::Unit(i), residual(i), v_error(i));
+    }
+  }
+
+  /** Add a GPS ECEF position and velocity observation */
+  void add_gps_pv(batch_t& batch, const Eigen::Vector3d& pos, const vec3_t& vel,
+                  const vec3_t& p_error, const vec3_t& v_error) const
+  {
+    add_gps_p(batch, pos, p_error);
+    add_gps_v(batch, vel, v_error);
+  }
+
+  /** Add a barometric observation of the distance to the earth center (m), as BARO_CENTER_OF_MASS */
+  void add_baro(batch_t& batch, double altitude, Scalar baro_error) const
+  {
+    const double height = position.norm();
+    batch.add(BLOCK_POSITION, (position / height).template cast<Scalar>(), Scalar(altitude - height), baro_error);
+  }
+
+  /**
+   * Incorporate all the observations of a batch.
+   * Sequential scalar updates, the residual of each row is corrected by the
+   * update of the previous ones. The mean state is updated once at the end.
+   */
+  void update(const batch_t& batch)
+  {
+    error_t dx = error_t::Zero();
+    error_t g;
+    for (int k = 0; k < batch.size; k++) {
+      const typename batch_t::row& r = batch.rows[k];
+      g.noalias() = cov.template middleCols<3>(r.block) * r.h;
+      const Scalar s = r.h.dot(g.template segment<3>(r.block)) + r.noise;
+      if (s <= Scalar(0)) {
+        continue;
+      }
+      const Scalar inv_s = Scalar(1) / s;
+      const Scalar innovation = r.residual - r.h.dot(dx.template segment<3>(r.block));
+      dx += g * (innovation * inv_s);
+      cov.noalias() -= (g * inv_s) * g.transpose();
+    }
+    cov.template triangularView<Eigen::StrictlyLower>() = cov.transpose().eval();
+    apply_update(dx);
+  }
+
+  /** Single observation helpers, same interface as basic_ins_qkf */
+  void obs_vector(const vec3_t& ref, const vec3_t& obs, Scalar error)
+  {
+    batch_t b;
+    add_vector(b, ref, obs, error);
+    update(b);
+  }
+
+  void obs_gps_pv_report(const Eigen::Vector3d& pos, const vec3_t& vel,
+                         const vec3_t& p_error, const vec3_t& v_error)
+  {
+    batch_t b;
+    add_gps_pv(b, pos, vel, p_error, v_error);
+    update(b);
+  }
+
+  void obs_baro_report(double altitude, Scalar baro_error)
+  {
+    batch_t b;
+    add_baro(b, altitude, baro_error);
+    update(b);
+  }
+
+  /** @return True if the state and covariance are neither NaN nor Inf */
+  bool is_real(void) const
+  {
+    return cov.allFinite() && gyro_bias.allFinite() && orientation.coeffs().allFinite() &&
+           position.allFinite() && velocity.allFinite();
+  }
+
+private:
+  /// Diagonal process noise for noise_dt
+  error_t process_noise;
+  Scalar noise_dt;
+
+  void update_process_noise(Scalar dt)
+  {
+    process_noise << gyro_stability_noise * dt, gyro_white_noise * dt,
+                  accel_white_noise * (Scalar(0.5) * dt * dt), accel_white_noise * dt;
+    noise_dt = dt;
+  }
+
+  void apply_update(const error_t& dx)
+  {
+    gyro_bias += dx.template segment<3>(0);
+    orientation = (orientation * quat_exp<Scalar>(dx.template segment<3>(3))).normalized();
+    position += dx.template segment<3>(6).template cast<double>();
+    velocity += dx.template segment<3>(9);
+  }
+};
+
+} // namespace ins_qkf_fast
+
+typedef ins_qkf_fast::ins_qkf<float> ins_qkf_f;
+typedef ins_qkf_fast::ins_qkf<double> ins_qkf_d;
+
+#endif /* INS_QKF_FAST_HPP */
@@ -9,12 +9,32 @@ unsigned int entry_counter;
 
 FILE* ins_logfile;		// note: initilaized in init_ins_state
 
+#if EKNAV_FAST_QKF
+static ins_qkf_f ins = ins_qkf_f(gyro_stability_noise.cast<float>(), gyroscope_noise.cast<float>(),
+                                 accelerometer_noise.cast<float>());
+static ins_qkf_f::batch_t batch;
+#else
 //useless initialization (I hate C++)
 static basic_ins_qkf ins = basic_ins_qkf(Vector3d::Zero(), 0, 0, 0,
 					 gyro_stability_noise,gyroscope_noise, accelerometer_noise);
 
 // import most common Eigen types 
 USING_PART_OF_NAMESPACE_EIGEN
+#endif /* EKNAV_FAST_QKF */
+
+/* timing and GPS residuals, to compare the filter implementations */
+static struct {
+  double predict_ns, update_ns;
+  unsigned int nb_predict, nb_update;
+  double gps_pos_res2, gps_vel_res2;
+  unsigned int nb_gps;
+} stats;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
 
 int main(int, char *argv[]) {
   
@@ -37,6 +57,15 @@ int main(int, char *argv[]) {
   main_run_from_file(raw_log_fd, e);
   
   printf("Finished\n");
+  #if EKNAV_FAST_QKF
+  printf("ins_qkf_fast (float, batched observations)\n");
+  #else
+  printf("basic_ins_qkf (double)\n");
+  #endif
+  printf("predict %8.3f us (%u)\n", stats.predict_ns / 1e3 / stats.nb_predict, stats.nb_predict);
+  printf("update  %8.3f us (%u)\n", stats.update_ns / 1e3 / stats.nb_update, stats.nb_update);
+  printf("GPS residuals rms: position %.3f m, velocity %.3f m/s (%u)\n",
+         sqrt(stats.gps_pos_res2 / stats.nb_gps), sqrt(stats.gps_vel_res2 / stats.nb_gps), stats.nb_gps);
   return 0;
 
 }
@@ -216,8 +245,45 @@ static void main_run_from_file(int file_descriptor, struct raw_log_entry first_e
 static void main_run_ins(uint8_t data_valid) {
   
   double dt_imu_freq = 0.001953125; //  1/512; // doesn't work?
+  double t0 = now_ns();
   ins.predict(RATES_AS_VECTOR3D(imu_float.gyro), VECT3_AS_VECTOR3D(imu_float.accel), dt_imu_freq);
+  stats.predict_ns += now_ns() - t0;
+  stats.nb_predict++;
+  
+  if(GPS_READY(data_valid)){
+    stats.gps_pos_res2 += (VECT3_AS_VECTOR3D(imu_ecef_pos)/100 - INS_STATE(position)).squaredNorm();
+    stats.gps_vel_res2 += (VECT3_AS_VECTOR3D(imu_ecef_vel)/100 - INS_STATE(velocity)).squaredNorm();
+    stats.nb_gps++;
+  }
   
+  t0 = now_ns();
+#if EKNAV_FAST_QKF
+  /* all the observations of this step in one update */
+  batch.clear();
+  if(MAG_READY(data_valid)){
+    ins.add_vector(batch, reference_direction.cast<float>(), VECT3_AS_VECTOR3D(imu_float.mag).cast<float>(), magnetometer_noise.norm());
+  }
+  #if UPDATE_WITH_GRAVITY
+  if(CLOSE_TO_GRAVITY(imu_float.accel)){
+    ins.add_vector(batch, ins.position.normalized().cast<float>(), VECT3_AS_VECTOR3D(imu_float.accel).cast<float>(), accelerometer_noise.norm());
+  }
+  #endif /* UPDATE_WITH_GRAVITY */
+  if(BARO_READY(data_valid)){
+    ins.add_baro(batch, baro_0_height+imu_baro_height, baro_noise);
+  }
+  if(GPS_READY(data_valid)){
+    ins.add_gps_pv(batch, VECT3_AS_VECTOR3D(imu_ecef_pos)/100, (VECT3_AS_VECTOR3D(imu_ecef_vel)/100).cast<float>(),
+                   (10*gps_pos_noise).cast<float>(), (10*gps_speed_noise).cast<float>());
+  }
+  if(batch.empty()){
+    return;
+  }
+  ins.update(batch);
+#else
+  if(!(MAG_READY(data_valid) || BARO_READY(data_valid) || GPS_READY(data_valid) ||
+       (UPDATE_WITH_GRAVITY && CLOSE_TO_GRAVITY(imu_float.accel)))){
+    return;
+  }
   if(MAG_READY(data_valid)){
 		ins.obs_vector(reference_direction, VECT3_AS_VECTOR3D(imu_float.mag), magnetometer_noise.norm());
 	}
@@ -225,7 +291,7 @@ static void main_run_ins(uint8_t data_valid) {
   #if UPDATE_WITH_GRAVITY
   if(CLOSE_TO_GRAVITY(imu_float.accel)){
 		// use the gravity as reference
-		ins.obs_vector(ins.avg_state.position.normalized(), VECT3_AS_VECTOR3D(imu_float.accel), accelerometer_noise.norm());
+		ins.obs_vector(INS_STATE(position).normalized(), VECT3_AS_VECTOR3D(imu_float.accel), accelerometer_noise.norm());
 	}
   #endif /* UPDATE_WITH_GRAVITY */
   
@@ -236,6 +302,9 @@ static void main_run_ins(uint8_t data_valid) {
   if(GPS_READY(data_valid)){
 		ins.obs_gps_pv_report(VECT3_AS_VECTOR3D(imu_ecef_pos)/100, VECT3_AS_VECTOR3D(imu_ecef_vel)/100, 10*gps_pos_noise, 10*gps_speed_noise);
 	}   // comment out multiple lines */
+#endif /* EKNAV_FAST_QKF */
+  stats.update_ns += now_ns() - t0;
+  stats.nb_update++;
 }
 
 
@@ -245,10 +314,16 @@ static void init_ins_state(void){
 	
 	ins_logfile = fopen(INS_LOG_FILE, "w");
 	
+#if EKNAV_FAST_QKF
+	ins.reset(pos_0_ecef, speed_0_ecef.cast<float>(), orientation_0.cast<float>(),
+	          Vector3f::Zero(), Vector3f::Zero(), Vector3f::Zero(), Vector3f::Zero());
+	ins.gyro_bias = bias_0.cast<float>();
+#else
 	ins.avg_state.gyro_bias   = bias_0;
 	ins.avg_state.orientation = orientation_0;
 	ins.avg_state.position    = pos_0_ecef;
 	ins.avg_state.velocity    = speed_0_ecef;
+#endif /* EKNAV_FAST_QKF */
   
   struct DoubleQuat ecef2body;
   struct DoubleEulers eu_ecef2body;
@@ -286,7 +361,11 @@ static void init_ins_state(void){
               orientation_cov_0,
 							pos_cov_0,
 							speed_cov_0;
+#if EKNAV_FAST_QKF
+	ins.cov = diag_cov.cwiseProduct(diag_cov).cast<float>().asDiagonal();
+#else
 	ins.cov = (diag_cov.cwise()*diag_cov).asDiagonal();
+#endif /* EKNAV_FAST_QKF */
 	
 }
 
@@ -403,8 +482,8 @@ static void print_estimator_state(double time) {
 										q_ned2body;
 										
 	VECTOR_AS_VECT3(pos_ecef,pos_0_ecef);
-	VECTOR_AS_VECT3(cur_pos_ecef,ins.avg_state.position);
-	VECTOR_AS_VECT3(cur_vel_ecef,ins.avg_state.velocity);
+	VECTOR_AS_VECT3(cur_pos_ecef,INS_STATE(position));
+	VECTOR_AS_VECT3(cur_vel_ecef,INS_STATE(velocity));
 	
 	ned_of_ecef_point_d(&pos_ned, &current_ltp, &cur_pos_ecef);
 	ned_of_ecef_vect_d(&vel_ned, &current_ltp, &cur_vel_ecef);
@@ -423,8 +502,8 @@ static void print_estimator_state(double time) {
 
   fprintf(ins_logfile, "%f %d BOOZ2_INS2 %d %d %d %d %d %d %d %d %d\n", time, AC_ID, xdd, ydd, zdd, xd, yd, zd, x, y, z);
   #if 0
-  QUAT_ASSIGN(q_ecef2body, ins.avg_state.orientation.w(), -ins.avg_state.orientation.x(),
-	         -ins.avg_state.orientation.y(), -ins.avg_state.orientation.z());
+  QUAT_ASSIGN(q_ecef2body, INS_STATE(orientation).w(), -INS_STATE(orientation).x(),
+	         -INS_STATE(orientation).y(), -INS_STATE(orientation).z());
   QUAT_ASSIGN(q_ned2enu, 0, M_SQRT1_2, M_SQRT1_2, 0);
   
   FLOAT_QUAT_OF_RMAT(q_ecef2enu, current_ltp.ltp_of_ecef);
@@ -432,7 +511,7 @@ static void print_estimator_state(double time) {
   FLOAT_QUAT_COMP(q_ned2body, q_ned2enu, q_enu2body);					// q_ned2body = q_enu2body * q_ned2enu
 
   #else /* if 0 */
-  QUATERNIOND_AS_DOUBLEQUAT(q_ecef2body, ins.avg_state.orientation);
+  QUATERNIOND_AS_DOUBLEQUAT(q_ecef2body, INS_STATE(orientation));
   DOUBLE_QUAT_OF_RMAT(q_ecef2enu, current_ltp.ltp_of_ecef);
   FLOAT_QUAT_INV_COMP(q_enu2body, q_ecef2enu, q_ecef2body);
   QUAT_ENU_FROM_TO_NED(q_enu2body, q_ned2body);
@@ -452,25 +531,25 @@ static void print_estimator_state(double time) {
 				sqrt(ins.cov( 3, 3)),  sqrt(ins.cov( 4, 4)),  sqrt(ins.cov( 5, 5)), 
 				sqrt(ins.cov( 6, 6)),  sqrt(ins.cov( 7, 7)),  sqrt(ins.cov( 8, 8)), 
 				sqrt(ins.cov( 9, 9)),  sqrt(ins.cov(10,10)),  sqrt(ins.cov(11,11)));
-  fprintf(ins_logfile, "%f %d BOOZ_SIM_GYRO_BIAS %f %f %f\n", time, AC_ID, ins.avg_state.gyro_bias(0), ins.avg_state.gyro_bias(1), ins.avg_state.gyro_bias(2));
+  fprintf(ins_logfile, "%f %d BOOZ_SIM_GYRO_BIAS %f %f %f\n", time, AC_ID, INS_STATE(gyro_bias)(0), INS_STATE(gyro_bias)(1), INS_STATE(gyro_bias)(2));
 
 #else /* FILTER_OUTPUT_IN_ECEF */
   int32_t xdd = 0;
   int32_t ydd = 0;
   int32_t zdd = 0;
 
-  int32_t xd = ins.avg_state.velocity(0)/0.0000019073;
-  int32_t yd = ins.avg_state.velocity(1)/0.0000019073;
-  int32_t zd = ins.avg_state.velocity(2)/0.0000019073;
-  int32_t x = ins.avg_state.position(0)/0.0039;
-  int32_t y = ins.avg_state.position(1)/0.0039;
-  int32_t z = ins.avg_state.position(2)/0.0039;
+  int32_t xd = INS_STATE(velocity)(0)/0.0000019073;
+  int32_t yd = INS_STATE(velocity)(1)/0.0000019073;
+  int32_t zd = INS_STATE(velocity)(2)/0.0000019073;
+  int32_t x = INS_STATE(position)(0)/0.0039;
+  int32_t y = INS_STATE(position)(1)/0.0039;
+  int32_t z = INS_STATE(position)(2)/0.0039;
 
   fprintf(ins_logfile, "%f %d BOOZ2_INS2 %d %d %d %d %d %d %d %d %d\n", time, AC_ID, xdd, ydd, zdd, xd, yd, zd, x, y, z);
   
   struct FloatQuat q_ecef2body;
-  QUAT_ASSIGN(q_ecef2body, ins.avg_state.orientation.w(), ins.avg_state.orientation.x(),
-	         ins.avg_state.orientation.y(), ins.avg_state.orientation.z());
+  QUAT_ASSIGN(q_ecef2body, INS_STATE(orientation).w(), INS_STATE(orientation).x(),
+	         INS_STATE(orientation).y(), INS_STATE(orientation).z());
   struct FloatEulers e_ecef2body;
   FLOAT_EULERS_OF_QUAT(e_ecef2body, q_ecef2body);
 
@@ -480,6 +559,6 @@ static void print_estimator_state(double time) {
 				sqrt(ins.cov( 3, 3)),  sqrt(ins.cov( 4, 4)),  sqrt(ins.cov( 5, 5)), 
 				sqrt(ins.cov( 6, 6)),  sqrt(ins.cov( 7, 7)),  sqrt(ins.cov( 8, 8)), 
 				sqrt(ins.cov( 9, 9)),  sqrt(ins.cov(10,10)),  sqrt(ins.cov(11,11)));
-  fprintf(ins_logfile, "%f %d BOOZ_SIM_GYRO_BIAS %f %f %f\n", time, AC_ID, ins.avg_state.gyro_bias(0), ins.avg_state.gyro_bias(1), ins.avg_state.gyro_bias(2));
+  fprintf(ins_logfile, "%f %d BOOZ_SIM_GYRO_BIAS %f %f %f\n", time, AC_ID, INS_STATE(gyro_bias)(0), INS_STATE(gyro_bias)(1), INS_STATE(gyro_bias)(2));
 #endif /* FILTER_OUTPUT_IN_NED / ECEF */
 }
@@ -3,7 +3,18 @@
 
 #include <Eigen/Core>
 
+#if EKNAV_FAST_QKF
+#include "ins_qkf_fast.hpp"
+using Eigen::Vector3f;
+using Eigen::Vector3d;
+using Eigen::Quaterniond;
+using Eigen::Matrix;
+/** mean state of the filter in double precision */
+#define INS_STATE(field) (ins.field.cast<double>())
+#else
 #include "ins_qkf.hpp"
+#define INS_STATE(field) (ins.avg_state.field)
+#endif /* EKNAV_FAST_QKF */
 #include "paparazzi_eigen_conversion.h"
 #include "estimate_attitude.h"
 #include "estimate_attitude.c" // should be done by the makefile
@@ -125,7 +136,11 @@ static struct raw_log_entry next_GPS(int);
 
 static void print_estimator_state(double);
 #define AC_ID 210
+#if EKNAV_FAST_QKF
+#define INS_LOG_FILE "log_ins_test3_fast.data"
+#else
 #define INS_LOG_FILE "log_ins_test3.data"
+#endif
 
 
 
@@ -46,6 +46,11 @@ extern "C" {
 
 #define SQUARE(_a) ((_a)*(_a))
 
+/** Identity scaling for the *_SCALED kernels with floating point types.
+ * Fixed point types pass a right shift by their fractional bits instead.
+ */
+#define ALGEBRA_NO_SCALE(_x) (_x)
+
 //
 //
 // Vector algebra
@@ -576,6 +581,30 @@ extern "C" {
     (_qo).qz = (_qi).qz / (_s); \
   }
 
+/* _a2c = _a2b comp _b2c, each element rescaled by _S */
+#define QUAT_COMP_SCALED(_a2c, _a2b, _b2c, _S) {                                                   \
+    (_a2c).qi = _S((_a2b).qi * (_b2c).qi - (_a2b).qx * (_b2c).qx - (_a2b).qy * (_b2c).qy - (_a2b).qz * (_b2c).qz); \
+    (_a2c).qx = _S((_a2b).qi * (_b2c).qx + (_a2b).qx * (_b2c).qi + (_a2b).qy * (_b2c).qz - (_a2b).qz * (_b2c).qy); \
+    (_a2c).qy = _S((_a2b).qi * (_b2c).qy - (_a2b).qx * (_b2c).qz + (_a2b).qy * (_b2c).qi + (_a2b).qz * (_b2c).qx); \
+    (_a2c).qz = _S((_a2b).qi * (_b2c).qz + (_a2b).qx * (_b2c).qy - (_a2b).qy * (_b2c).qx + (_a2b).qz * (_b2c).qi); \
+  }
+
+/* _a2b = _a2c comp inv(_b2c), each element rescaled by _S */
+#define QUAT_COMP_INV_SCALED(_a2b, _a2c, _b2c, _S) {                                                \
+    (_a2b).qi = _S( (_a2c).qi * (_b2c).qi + (_a2c).qx * (_b2c).qx + (_a2c).qy * (_b2c).qy + (_a2c).qz * (_b2c).qz); \
+    (_a2b).qx = _S(-(_a2c).qi * (_b2c).qx + (_a2c).qx * (_b2c).qi - (_a2c).qy * (_b2c).qz + (_a2c).qz * (_b2c).qy); \
+    (_a2b).qy = _S(-(_a2c).qi * (_b2c).qy + (_a2c).qx * (_b2c).qz + (_a2c).qy * (_b2c).qi - (_a2c).qz * (_b2c).qx); \
+    (_a2b).qz = _S(-(_a2c).qi * (_b2c).qz - (_a2c).qx * (_b2c).qy + (_a2c).qy * (_b2c).qx + (_a2c).qz * (_b2c).qi); \
+  }
+
+/* _b2c = inv(_a2b) comp _a2c, each element rescaled by _S */
+#define QUAT_INV_COMP_SCALED(_b2c, _a2b, _a2c, _S) {                                                \
+    (_b2c).qi = _S((_a2b).qi * (_a2c).qi + (_a2b).qx * (_a2c).qx + (_a2b).qy * (_a2c).qy + (_a2b).qz * (_a2c).qz); \
+    (_b2c).qx = _S((_a2b).qi * (_a2c).qx - (_a2b).qx * (_a2c).qi - (_a2b).qy * (_a2c).qz + (_a2b).qz * (_a2c).qy); \
+    (_b2c).qy = _S((_a2b).qi * (_a2c).qy + (_a2b).qx * (_a2c).qz - (_a2b).qy * (_a2c).qi - (_a2b).qz * (_a2c).qx); \
+    (_b2c).qz = _S((_a2b).qi * (_a2c).qz - (_a2b).qx * (_a2c).qy + (_a2b).qy * (_a2c).qx - (_a2b).qz * (_a2c).qi); \
+  }
+
 //
 //
 // Rotation Matrices
@@ -630,6 +659,32 @@ extern "C" {
 
 #define RMAT_COPY(_o, _i) { memcpy(&(_o), &(_i), sizeof(_o));}
 
+/* _m_a2c = _m_b2c * _m_a2b, each element rescaled by _S */
+#define RMAT_COMP_SCALED(_m_a2c, _m_a2b, _m_b2c, _S) {                                             \
+    (_m_a2c).m[0] = _S((_m_b2c).m[0] * (_m_a2b).m[0] + (_m_b2c).m[1] * (_m_a2b).m[3] + (_m_b2c).m[2] * (_m_a2b).m[6]); \
+    (_m_a2c).m[1] = _S((_m_b2c).m[0] * (_m_a2b).m[1] + (_m_b2c).m[1] * (_m_a2b).m[4] + (_m_b2c).m[2] * (_m_a2b).m[7]); \
+    (_m_a2c).m[2] = _S((_m_b2c).m[0] * (_m_a2b).m[2] + (_m_b2c).m[1] * (_m_a2b).m[5] + (_m_b2c).m[2] * (_m_a2b).m[8]); \
+    (_m_a2c).m[3] = _S((_m_b2c).m[3] * (_m_a2b).m[0] + (_m_b2c).m[4] * (_m_a2b).m[3] + (_m_b2c).m[5] * (_m_a2b).m[6]); \
+    (_m_a2c).m[4] = _S((_m_b2c).m[3] * (_m_a2b).m[1] + (_m_b2c).m[4] * (_m_a2b).m[4] + (_m_b2c).m[5] * (_m_a2b).m[7]); \
+    (_m_a2c).m[5] = _S((_m_b2c).m[3] * (_m_a2b).m[2] + (_m_b2c).m[4] * (_m_a2b).m[5] + (_m_b2c).m[5] * (_m_a2b).m[8]); \
+    (_m_a2c).m[6] = _S((_m_b2c).m[6] * (_m_a2b).m[0] + (_m_b2c).m[7] * (_m_a2b).m[3] + (_m_b2c).m[8] * (_m_a2b).m[6]); \
+    (_m_a2c).m[7] = _S((_m_b2c).m[6] * (_m_a2b).m[1] + (_m_b2c).m[7] * (_m_a2b).m[4] + (_m_b2c).m[8] * (_m_a2b).m[7]); \
+    (_m_a2c).m[8] = _S((_m_b2c).m[6] * (_m_a2b).m[2] + (_m_b2c).m[7] * (_m_a2b).m[5] + (_m_b2c).m[8] * (_m_a2b).m[8]); \
+  }
+
+/* _m_a2b = transpose(_m_b2c) * _m_a2c, each element rescaled by _S */
+#define RMAT_COMP_INV_SCALED(_m_a2b, _m_a2c, _m_b2c, _S) {                                         \
+    (_m_a2b).m[0] = _S((_m_b2c).m[0] * (_m_a2c).m[0] + (_m_b2c).m[3] * (_m_a2c).m[3] + (_m_b2c).m[6] * (_m_a2c).m[6]); \
+    (_m_a2b).m[1] = _S((_m_b2c).m[0] * (_m_a2c).m[1] + (_m_b2c).m[3] * (_m_a2c).m[4] + (_m_b2c).m[6] * (_m_a2c).m[7]); \
+    (_m_a2b).m[2] = _S((_m_b2c).m[0] * (_m_a2c).m[2] + (_m_b2c).m[3] * (_m_a2c).m[5] + (_m_b2c).m[6] * (_m_a2c).m[8]); \
+    (_m_a2b).m[3] = _S((_m_b2c).m[1] * (_m_a2c).m[0] + (_m_b2c).m[4] * (_m_a2c).m[3] + (_m_b2c).m[7] * (_m_a2c).m[6]); \
+    (_m_a2b).m[4] = _S((_m_b2c).m[1] * (_m_a2c).m[1] + (_m_b2c).m[4] * (_m_a2c).m[4] + (_m_b2c).m[7] * (_m_a2c).m[7]); \
+    (_m_a2b).m[5] = _S((_m_b2c).m[1] * (_m_a2c).m[2] + (_m_b2c).m[4] * (_m_a2c).m[5] + (_m_b2c).m[7] * (_m_a2c).m[8]); \
+    (_m_a2b).m[6] = _S((_m_b2c).m[2] * (_m_a2c).m[0] + (_m_b2c).m[5] * (_m_a2c).m[3] + (_m_b2c).m[8] * (_m_a2c).m[6]); \
+    (_m_a2b).m[7] = _S((_m_b2c).m[2] * (_m_a2c).m[1] + (_m_b2c).m[5] * (_m_a2c).m[4] + (_m_b2c).m[8] * (_m_a2c).m[7]); \
+    (_m_a2b).m[8] = _S((_m_b2c).m[2] * (_m_a2c).m[2] + (_m_b2c).m[5] * (_m_a2c).m[5] + (_m_b2c).m[8] * (_m_a2c).m[8]); \
+  }
+
 
 
 
@@ -111,6 +111,21 @@ void double_quat_vmult(struct DoubleVect3 *v_out, struct DoubleQuat *q, struct D
   v_out->z = 2 * (m20 * v_in->x + m21 * v_in->y + m22 * v_in->z);
 }
 
+void double_quat_comp(struct DoubleQuat *a2c, struct DoubleQuat *a2b, struct DoubleQuat *b2c)
+{
+  QUAT_COMP_SCALED(*a2c, *a2b, *b2c, ALGEBRA_NO_SCALE);
+}
+
+void double_quat_comp_inv(struct DoubleQuat *a2b, struct DoubleQuat *a2c, struct DoubleQuat *b2c)
+{
+  QUAT_COMP_INV_SCALED(*a2b, *a2c, *b2c, ALGEBRA_NO_SCALE);
+}
+
+void double_quat_inv_comp(struct DoubleQuat *b2c, struct DoubleQuat *a2b, struct DoubleQuat *a2c)
+{
+  QUAT_INV_COMP_SCALED(*b2c, *a2b, *a2c, ALGEBRA_NO_SCALE);
+}
+
 void double_rmat_inv(struct DoubleRMat *m_b2a, struct DoubleRMat *m_a2b)
 {
   /*RMAT_ELMT(*m_b2a, 0, 0) = RMAT_ELMT(*m_a2b, 0, 0);*/
@@ -129,15 +144,15 @@ void double_rmat_inv(struct DoubleRMat *m_b2a, struct DoubleRMat *m_a2b)
  */
 void double_rmat_comp(struct DoubleRMat *m_a2c, struct DoubleRMat *m_a2b, struct DoubleRMat *m_b2c)
 {
-  m_a2c->m[0] = m_b2c->m[0] * m_a2b->m[0] + m_b2c->m[1] * m_a2b->m[3] + m_b2c->m[2] * m_a2b->m[6];
-  m_a2c->m[1] = m_b2c->m[0] * m_a2b->m[1] + m_b2c->m[1] * m_a2b->m[4] + m_b2c->m[2] * m_a2b->m[7];
-  m_a2c->m[2] = m_b2c->m[0] * m_a2b->m[2] + m_b2c->m[1] * m_a2b->m[5] + m_b2c->m[2] * m_a2b->m[8];
-  m_a2c->m[3] = m_b2c->m[3] * m_a2b->m[0] + m_b2c->m[4] * m_a2b->m[3] + m_b2c->m[5] * m_a2b->m[6];
-  m_a2c->m[4] = m_b2c->m[3] * m_a2b->m[1] + m_b2c->m[4] * m_a2b->m[4] + m_b2c->m[5] * m_a2b->m[7];
-  m_a2c->m[5] = m_b2c->m[3] * m_a2b->m[2] + m_b2c->m[4] * m_a2b->m[5] + m_b2c->m[5] * m_a2b->m[8];
-  m_a2c->m[6] = m_b2c->m[6] * m_a2b->m[0] + m_b2c->m[7] * m_a2b->m[3] + m_b2c->m[8] * m_a2b->m[6];
-  m_a2c->m[7] = m_b2c->m[6] * m_a2b->m[1] + m_b2c->m[7] * m_a2b->m[4] + m_b2c->m[8] * m_a2b->m[7];
-  m_a2c->m[8] = m_b2c->m[6] * m_a2b->m[2] + m_b2c->m[7] * m_a2b->m[5] + m_b2c->m[8] * m_a2b->m[8];
+  RMAT_COMP_SCALED(*m_a2c, *m_a2b, *m_b2c, ALGEBRA_NO_SCALE);
+}
+
+/** Composition (multiplication) of two rotation matrices.
+ * m_a2b = m_a2c comp_inv m_b2c , aka  m_a2b = inv(_m_b2c) * m_a2c
+ */
+void double_rmat_comp_inv(struct DoubleRMat *m_a2b, struct DoubleRMat *m_a2c, struct DoubleRMat *m_b2c)
+{
+  RMAT_COMP_INV_SCALED(*m_a2b, *m_a2c, *m_b2c, ALGEBRA_NO_SCALE);
 }
 
 /** rotate 3D vector by rotation matrix.
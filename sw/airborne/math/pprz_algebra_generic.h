@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pprz_algebra_generic.h
+ * @brief Type generic front end to the int32, float and double algebra.
+ *
+ * pprz_quat_comp(&a2c, &a2b, &b2c) calls int32_quat_comp, float_quat_comp
+ * or double_quat_comp depending on the type of its first argument.
+ * The selection is done at compile time (C11 _Generic in C, overloading
+ * in C++), so the generated code is the same as calling the typed function.
+ *
+ * The compositions themselves share a single implementation: the
+ * QUAT_COMP_SCALED and RMAT_COMP_SCALED kernels of pprz_algebra.h,
+ * instantiated with the rescaling of each type.
+ *
+ * @addtogroup math_algebra
+ * @{
+ * @addtogroup math_algebra_generic_functions Type generic functions
+ * @{
+ */
+
+#ifndef PPRZ_ALGEBRA_GENERIC_H
+#define PPRZ_ALGEBRA_GENERIC_H
+
+#include "pprz_algebra_int.h"
+#include "pprz_algebra_float.h"
+#include "pprz_algebra_double.h"
+
+#ifdef __cplusplus
+
+/* one set of overloads per type */
+#define PPRZ_ALGEBRA_OVERLOADS(_pre, _Vect3, _Quat, _RMat, _norm_t)                                       \
+  static inline void pprz_quat_identity(struct _Quat *q) { _pre##_quat_identity(q); }                     \
+  static inline _norm_t pprz_quat_norm(struct _Quat *q) { return _pre##_quat_norm(q); }                   \
+  static inline void pprz_quat_normalize(struct _Quat *q) { _pre##_quat_normalize(q); }                   \
+  static inline void pprz_quat_comp(struct _Quat *a2c, struct _Quat *a2b, struct _Quat *b2c)               \
+  { _pre##_quat_comp(a2c, a2b, b2c); }                                                                    \
+  static inline void pprz_quat_comp_inv(struct _Quat *a2b, struct _Quat *a2c, struct _Quat *b2c)          \
+  { _pre##_quat_comp_inv(a2b, a2c, b2c); }                                                                \
+  static inline void pprz_quat_inv_comp(struct _Quat *b2c, struct _Quat *a2b, struct _Quat *a2c)          \
+  { _pre##_quat_inv_comp(b2c, a2b, a2c); }                                                                \
+  static inline void pprz_quat_vmult(struct _Vect3 *v_out, struct _Quat *q, struct _Vect3 *v_in)          \
+  { _pre##_quat_vmult(v_out, q, v_in); }                                                                  \
+  static inline void pprz_rmat_identity(struct _RMat *rm) { _pre##_rmat_identity(rm); }                    \
+  static inline void pprz_rmat_comp(struct _RMat *m_a2c, struct _RMat *m_a2b, struct _RMat *m_b2c)         \
+  { _pre##_rmat_comp(m_a2c, m_a2b, m_b2c); }                                                              \
+  static inline void pprz_rmat_comp_inv(struct _RMat *m_a2b, struct _RMat *m_a2c, struct _RMat *m_b2c)     \
+  { _pre##_rmat_comp_inv(m_a2b, m_a2c, m_b2c); }                                                          \
+  static inline void pprz_rmat_vmult(struct _Vect3 *vb, struct _RMat *m_a2b, struct _Vect3 *va)            \
+  { _pre##_rmat_vmult(vb, m_a2b, va); }                                                                   \
+  static inline void pprz_rmat_of_quat(struct _RMat *rm, struct _Quat *q) { _pre##_rmat_of_quat(rm, q); }
+
+PPRZ_ALGEBRA_OVERLOADS(int32, Int32Vect3, Int32Quat, Int32RMat, uint32_t)
+PPRZ_ALGEBRA_OVERLOADS(float, FloatVect3, FloatQuat, FloatRMat, float)
+PPRZ_ALGEBRA_OVERLOADS(double, DoubleVect3, DoubleQuat, DoubleRMat, double)
+
+#undef PPRZ_ALGEBRA_OVERLOADS
+
+#elif (defined __STDC_VERSION__ && __STDC_VERSION__ >= 201112L) || \
+  (defined __GNUC__ && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+
+/** Select the int32, float or double version of _fun from the type of _x */
+#define PPRZ_ALGEBRA_SELECT(_x, _fun, _Int32, _Float, _Double) \
+  _Generic((_x),                                               \
+           struct _Int32 *: int32_##_fun,                      \
+           struct _Float *: float_##_fun,                      \
+           struct _Double *: double_##_fun)
+
+#define PPRZ_QUAT_SELECT(_q, _fun) PPRZ_ALGEBRA_SELECT(_q, _fun, Int32Quat, FloatQuat, DoubleQuat)
+#define PPRZ_RMAT_SELECT(_rm, _fun) PPRZ_ALGEBRA_SELECT(_rm, _fun, Int32RMat, FloatRMat, DoubleRMat)
+
+#define pprz_quat_identity(_q)                 PPRZ_QUAT_SELECT(_q, quat_identity)(_q)
+#define pprz_quat_norm(_q)                     PPRZ_QUAT_SELECT(_q, quat_norm)(_q)
+#define pprz_quat_normalize(_q)                PPRZ_QUAT_SELECT(_q, quat_normalize)(_q)
+#define pprz_quat_comp(_a2c, _a2b, _b2c)       PPRZ_QUAT_SELECT(_a2c, quat_comp)(_a2c, _a2b, _b2c)
+#define pprz_quat_comp_inv(_a2b, _a2c, _b2c)   PPRZ_QUAT_SELECT(_a2b, quat_comp_inv)(_a2b, _a2c, _b2c)
+#define pprz_quat_inv_comp(_b2c, _a2b, _a2c)   PPRZ_QUAT_SELECT(_b2c, quat_inv_comp)(_b2c, _a2b, _a2c)
+#define pprz_quat_vmult(_v_out, _q, _v_in)     PPRZ_QUAT_SELECT(_q, quat_vmult)(_v_out, _q, _v_in)
+#define pprz_rmat_identity(_rm)                PPRZ_RMAT_SELECT(_rm, rmat_identity)(_rm)
+#define pprz_rmat_comp(_m_a2c, _m_a2b, _m_b2c) PPRZ_RMAT_SELECT(_m_a2c, rmat_comp)(_m_a2c, _m_a2b, _m_b2c)
+#define pprz_rmat_comp_inv(_m_a2b, _m_a2c, _m_b2c) \
+  PPRZ_RMAT_SELECT(_m_a2b, rmat_comp_inv)(_m_a2b, _m_a2c, _m_b2c)
+#define pprz_rmat_vmult(_vb, _m_a2b, _va)      PPRZ_RMAT_SELECT(_m_a2b, rmat_vmult)(_vb, _m_a2b, _va)
+#define pprz_rmat_of_quat(_rm, _q)             PPRZ_RMAT_SELECT(_rm, rmat_of_quat)(_rm, _q)
+
+#else
+#error "pprz_algebra_generic.h needs a C11 compiler (_Generic) or C++"
+#endif
+
+#endif /* PPRZ_ALGEBRA_GENERIC_H */
+/** @}*/
+/** @}*/
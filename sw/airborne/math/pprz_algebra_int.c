@@ -26,24 +26,42 @@
 
 #include "pprz_algebra_int.h"
 
-#define INT32_SQRT_MAX_ITER 40
+/** Integer square root, rounded to the nearest integer.
+ * Digit by digit method: 16 iterations of shifts and compares, no division.
+ */
 uint32_t int32_sqrt(uint32_t in)
 {
   if (in == 0) {
     return 0;
-  } else {
-    uint32_t s1, s2;
-    uint8_t iter = 0;
-    s2 = in;
-    do {
-      s1 = s2;
-      s2 = in / s1;
-      s2 += s1;
-      s2 /= 2;
-      iter++;
-    } while (((s1 - s2) > 1) && (iter < INT32_SQRT_MAX_ITER));
-    return s2;
   }
+  uint32_t res = 0;
+  /* highest power of four lower or equal to in */
+  uint32_t one = 1u << ((31 - __builtin_clz(in)) & ~1u);
+  while (one != 0) {
+    const uint32_t trial = res + one;
+    const uint32_t ge = (in >= trial);
+    in -= ge ? trial : 0;
+    res = (res >> 1) + (ge ? one : 0);
+    one >>= 2;
+  }
+  /* round to nearest: in is now the remainder in - res^2 */
+  return (in > res) ? res + 1 : res;
+}
+
+uint32_t int32_rsqrt(uint32_t in)
+{
+  if (in == 0) {
+    return UINT32_MAX;
+  }
+  /* scale the input to the full range for a 16 bits accurate square root */
+  const uint32_t s = __builtin_clz(in) & ~1u;
+  const uint32_t r = int32_sqrt(in << s);
+  /* 2^31 / sqrt(in) = 2^(32 + s/2) / r / 2 */
+  const uint32_t q = UINT32_MAX / r;
+  if (s / 2 >= (uint32_t)__builtin_clz(q)) {
+    return UINT32_MAX;
+  }
+  return (q << (s / 2)) >> 1;
 }
 
 
@@ -58,15 +76,7 @@ uint32_t int32_sqrt(uint32_t in)
  */
 void int32_rmat_comp(struct Int32RMat *m_a2c, struct Int32RMat *m_a2b, struct Int32RMat *m_b2c)
 {
-  m_a2c->m[0] = (m_b2c->m[0] * m_a2b->m[0] + m_b2c->m[1] * m_a2b->m[3] + m_b2c->m[2] * m_a2b->m[6]) >> INT32_TRIG_FRAC;
-  m_a2c->m[1] = (m_b2c->m[0] * m_a2b->m[1] + m_b2c->m[1] * m_a2b->m[4] + m_b2c->m[2] * m_a2b->m[7]) >> INT32_TRIG_FRAC;
-  m_a2c->m[2] = (m_b2c->m[0] * m_a2b->m[2] + m_b2c->m[1] * m_a2b->m[5] + m_b2c->m[2] * m_a2b->m[8]) >> INT32_TRIG_FRAC;
-  m_a2c->m[3] = (m_b2c->m[3] * m_a2b->m[0] + m_b2c->m[4] * m_a2b->m[3] + m_b2c->m[5] * m_a2b->m[6]) >> INT32_TRIG_FRAC;
-  m_a2c->m[4] = (m_b2c->m[3] * m_a2b->m[1] + m_b2c->m[4] * m_a2b->m[4] + m_b2c->m[5] * m_a2b->m[7]) >> INT32_TRIG_FRAC;
-  m_a2c->m[5] = (m_b2c->m[3] * m_a2b->m[2] + m_b2c->m[4] * m_a2b->m[5] + m_b2c->m[5] * m_a2b->m[8]) >> INT32_TRIG_FRAC;
-  m_a2c->m[6] = (m_b2c->m[6] * m_a2b->m[0] + m_b2c->m[7] * m_a2b->m[3] + m_b2c->m[8] * m_a2b->m[6]) >> INT32_TRIG_FRAC;
-  m_a2c->m[7] = (m_b2c->m[6] * m_a2b->m[1] + m_b2c->m[7] * m_a2b->m[4] + m_b2c->m[8] * m_a2b->m[7]) >> INT32_TRIG_FRAC;
-  m_a2c->m[8] = (m_b2c->m[6] * m_a2b->m[2] + m_b2c->m[7] * m_a2b->m[5] + m_b2c->m[8] * m_a2b->m[8]) >> INT32_TRIG_FRAC;
+  RMAT_COMP_SCALED(*m_a2c, *m_a2b, *m_b2c, INT32_TRIG_RSHIFT);
 }
 
 /** Composition (multiplication) of two rotation matrices.
@@ -74,15 +84,7 @@ void int32_rmat_comp(struct Int32RMat *m_a2c, struct Int32RMat *m_a2b, struct In
  */
 void int32_rmat_comp_inv(struct Int32RMat *m_a2b, struct Int32RMat *m_a2c, struct Int32RMat *m_b2c)
 {
-  m_a2b->m[0] = (m_b2c->m[0] * m_a2c->m[0] + m_b2c->m[3] * m_a2c->m[3] + m_b2c->m[6] * m_a2c->m[6]) >> INT32_TRIG_FRAC;
-  m_a2b->m[1] = (m_b2c->m[0] * m_a2c->m[1] + m_b2c->m[3] * m_a2c->m[4] + m_b2c->m[6] * m_a2c->m[7]) >> INT32_TRIG_FRAC;
-  m_a2b->m[2] = (m_b2c->m[0] * m_a2c->m[2] + m_b2c->m[3] * m_a2c->m[5] + m_b2c->m[6] * m_a2c->m[8]) >> INT32_TRIG_FRAC;
-  m_a2b->m[3] = (m_b2c->m[1] * m_a2c->m[0] + m_b2c->m[4] * m_a2c->m[3] + m_b2c->m[7] * m_a2c->m[6]) >> INT32_TRIG_FRAC;
-  m_a2b->m[4] = (m_b2c->m[1] * m_a2c->m[1] + m_b2c->m[4] * m_a2c->m[4] + m_b2c->m[7] * m_a2c->m[7]) >> INT32_TRIG_FRAC;
-  m_a2b->m[5] = (m_b2c->m[1] * m_a2c->m[2] + m_b2c->m[4] * m_a2c->m[5] + m_b2c->m[7] * m_a2c->m[8]) >> INT32_TRIG_FRAC;
-  m_a2b->m[6] = (m_b2c->m[2] * m_a2c->m[0] + m_b2c->m[5] * m_a2c->m[3] + m_b2c->m[8] * m_a2c->m[6]) >> INT32_TRIG_FRAC;
-  m_a2b->m[7] = (m_b2c->m[2] * m_a2c->m[1] + m_b2c->m[5] * m_a2c->m[4] + m_b2c->m[8] * m_a2c->m[7]) >> INT32_TRIG_FRAC;
-  m_a2b->m[8] = (m_b2c->m[2] * m_a2c->m[2] + m_b2c->m[5] * m_a2c->m[5] + m_b2c->m[8] * m_a2c->m[8]) >> INT32_TRIG_FRAC;
+  RMAT_COMP_INV_SCALED(*m_a2b, *m_a2c, *m_b2c, INT32_TRIG_RSHIFT);
 }
 
 /** rotate 3D vector by rotation matrix.
@@ -160,18 +162,12 @@ void int32_rmat_of_quat(struct Int32RMat *rm, struct Int32Quat *q)
  */
 void int32_rmat_of_eulers_321(struct Int32RMat *rm, struct Int32Eulers *e)
 {
-  int32_t sphi;
-  PPRZ_ITRIG_SIN(sphi, e->phi);
-  int32_t cphi;
-  PPRZ_ITRIG_COS(cphi, e->phi);
-  int32_t stheta;
-  PPRZ_ITRIG_SIN(stheta, e->theta);
-  int32_t ctheta;
-  PPRZ_ITRIG_COS(ctheta, e->theta);
-  int32_t spsi;
-  PPRZ_ITRIG_SIN(spsi, e->psi);
-  int32_t cpsi;
-  PPRZ_ITRIG_COS(cpsi, e->psi);
+  int32_t sphi, cphi;
+  pprz_itrig_sincos(e->phi, &sphi, &cphi);
+  int32_t stheta, ctheta;
+  pprz_itrig_sincos(e->theta, &stheta, &ctheta);
+  int32_t spsi, cpsi;
+  pprz_itrig_sincos(e->psi, &spsi, &cpsi);
 
   int32_t ctheta_cpsi = INT_MULT_RSHIFT(ctheta, cpsi,   INT32_TRIG_FRAC);
   int32_t ctheta_spsi = INT_MULT_RSHIFT(ctheta, spsi,   INT32_TRIG_FRAC);
@@ -203,18 +199,12 @@ void int32_rmat_of_eulers_321(struct Int32RMat *rm, struct Int32Eulers *e)
 
 void int32_rmat_of_eulers_312(struct Int32RMat *rm, struct Int32Eulers *e)
 {
-  int32_t sphi;
-  PPRZ_ITRIG_SIN(sphi, e->phi);
-  int32_t cphi;
-  PPRZ_ITRIG_COS(cphi, e->phi);
-  int32_t stheta;
-  PPRZ_ITRIG_SIN(stheta, e->theta);
-  int32_t ctheta;
-  PPRZ_ITRIG_COS(ctheta, e->theta);
-  int32_t spsi;
-  PPRZ_ITRIG_SIN(spsi, e->psi);
-  int32_t cpsi;
-  PPRZ_ITRIG_COS(cpsi, e->psi);
+  int32_t sphi, cphi;
+  pprz_itrig_sincos(e->phi, &sphi, &cphi);
+  int32_t stheta, ctheta;
+  pprz_itrig_sincos(e->theta, &stheta, &ctheta);
+  int32_t spsi, cpsi;
+  pprz_itrig_sincos(e->psi, &spsi, &cpsi);
 
   int32_t stheta_spsi = INT_MULT_RSHIFT(stheta, spsi,   INT32_TRIG_FRAC);
   int32_t stheta_cpsi = INT_MULT_RSHIFT(stheta, cpsi,   INT32_TRIG_FRAC);
@@ -252,26 +242,17 @@ void int32_rmat_of_eulers_312(struct Int32RMat *rm, struct Int32Eulers *e)
 
 void int32_quat_comp(struct Int32Quat *a2c, struct Int32Quat *a2b, struct Int32Quat *b2c)
 {
-  a2c->qi = (a2b->qi * b2c->qi - a2b->qx * b2c->qx - a2b->qy * b2c->qy - a2b->qz * b2c->qz) >> INT32_QUAT_FRAC;
-  a2c->qx = (a2b->qi * b2c->qx + a2b->qx * b2c->qi + a2b->qy * b2c->qz - a2b->qz * b2c->qy) >> INT32_QUAT_FRAC;
-  a2c->qy = (a2b->qi * b2c->qy - a2b->qx * b2c->qz + a2b->qy * b2c->qi + a2b->qz * b2c->qx) >> INT32_QUAT_FRAC;
-  a2c->qz = (a2b->qi * b2c->qz + a2b->qx * b2c->qy - a2b->qy * b2c->qx + a2b->qz * b2c->qi) >> INT32_QUAT_FRAC;
+  QUAT_COMP_SCALED(*a2c, *a2b, *b2c, INT32_QUAT_RSHIFT);
 }
 
 void int32_quat_comp_inv(struct Int32Quat *a2b, struct Int32Quat *a2c, struct Int32Quat *b2c)
 {
-  a2b->qi = (a2c->qi * b2c->qi + a2c->qx * b2c->qx + a2c->qy * b2c->qy + a2c->qz * b2c->qz) >> INT32_QUAT_FRAC;
-  a2b->qx = (-a2c->qi * b2c->qx + a2c->qx * b2c->qi - a2c->qy * b2c->qz + a2c->qz * b2c->qy) >> INT32_QUAT_FRAC;
-  a2b->qy = (-a2c->qi * b2c->qy + a2c->qx * b2c->qz + a2c->qy * b2c->qi - a2c->qz * b2c->qx) >> INT32_QUAT_FRAC;
-  a2b->qz = (-a2c->qi * b2c->qz - a2c->qx * b2c->qy + a2c->qy * b2c->qx + a2c->qz * b2c->qi) >> INT32_QUAT_FRAC;
+  QUAT_COMP_INV_SCALED(*a2b, *a2c, *b2c, INT32_QUAT_RSHIFT);
 }
 
 void int32_quat_inv_comp(struct Int32Quat *b2c, struct Int32Quat *a2b, struct Int32Quat *a2c)
 {
-  b2c->qi = (a2b->qi * a2c->qi + a2b->qx * a2c->qx + a2b->qy * a2c->qy + a2b->qz * a2c->qz) >> INT32_QUAT_FRAC;
-  b2c->qx = (a2b->qi * a2c->qx - a2b->qx * a2c->qi - a2b->qy * a2c->qz + a2b->qz * a2c->qy) >> INT32_QUAT_FRAC;
-  b2c->qy = (a2b->qi * a2c->qy + a2b->qx * a2c->qz - a2b->qy * a2c->qi - a2b->qz * a2c->qx) >> INT32_QUAT_FRAC;
-  b2c->qz = (a2b->qi * a2c->qz - a2b->qx * a2c->qy + a2b->qy * a2c->qx - a2b->qz * a2c->qi) >> INT32_QUAT_FRAC;
+  QUAT_INV_COMP_SCALED(*b2c, *a2b, *a2c, INT32_QUAT_RSHIFT);
 }
 
 void int32_quat_comp_norm_shortest(struct Int32Quat *a2c, struct Int32Quat *a2b, struct Int32Quat *b2c)
@@ -362,18 +343,12 @@ void int32_quat_of_eulers(struct Int32Quat *q, struct Int32Eulers *e)
   const int32_t theta2 = e->theta / 2;
   const int32_t psi2   = e->psi   / 2;
 
-  int32_t s_phi2;
-  PPRZ_ITRIG_SIN(s_phi2, phi2);
-  int32_t c_phi2;
-  PPRZ_ITRIG_COS(c_phi2, phi2);
-  int32_t s_theta2;
-  PPRZ_ITRIG_SIN(s_theta2, theta2);
-  int32_t c_theta2;
-  PPRZ_ITRIG_COS(c_theta2, theta2);
-  int32_t s_psi2;
-  PPRZ_ITRIG_SIN(s_psi2, psi2);
-  int32_t c_psi2;
-  PPRZ_ITRIG_COS(c_psi2, psi2);
+  int32_t s_phi2, c_phi2;
+  pprz_itrig_sincos(phi2, &s_phi2, &c_phi2);
+  int32_t s_theta2, c_theta2;
+  pprz_itrig_sincos(theta2, &s_theta2, &c_theta2);
+  int32_t s_psi2, c_psi2;
+  pprz_itrig_sincos(psi2, &s_psi2, &c_psi2);
 
   int32_t c_th_c_ps = INT_MULT_RSHIFT(c_theta2, c_psi2, INT32_TRIG_FRAC);
   int32_t c_th_s_ps = INT_MULT_RSHIFT(c_theta2, s_psi2, INT32_TRIG_FRAC);
@@ -392,10 +367,8 @@ void int32_quat_of_eulers(struct Int32Quat *q, struct Int32Eulers *e)
 
 void int32_quat_of_axis_angle(struct Int32Quat *q, struct Int32Vect3 *uv, int32_t angle)
 {
-  int32_t san2;
-  PPRZ_ITRIG_SIN(san2, (angle / 2));
-  int32_t can2;
-  PPRZ_ITRIG_COS(can2, (angle / 2));
+  int32_t san2, can2;
+  pprz_itrig_sincos(angle / 2, &san2, &can2);
   q->qi = can2;
   q->qx = san2 * uv->x;
   q->qy = san2 * uv->y;
@@ -544,14 +517,10 @@ void int32_eulers_of_quat(struct Int32Eulers *e, struct Int32Quat *q)
 
 void int32_rates_of_eulers_dot_321(struct Int32Rates *r, struct Int32Eulers *e, struct Int32Eulers *ed)
 {
-  int32_t sphi;
-  PPRZ_ITRIG_SIN(sphi, e->phi);
-  int32_t cphi;
-  PPRZ_ITRIG_COS(cphi, e->phi);
-  int32_t stheta;
-  PPRZ_ITRIG_SIN(stheta, e->theta);
-  int32_t ctheta;
-  PPRZ_ITRIG_COS(ctheta, e->theta);
+  int32_t sphi, cphi;
+  pprz_itrig_sincos(e->phi, &sphi, &cphi);
+  int32_t stheta, ctheta;
+  pprz_itrig_sincos(e->theta, &stheta, &ctheta);
 
   int32_t cphi_ctheta = INT_MULT_RSHIFT(cphi,   ctheta, INT32_TRIG_FRAC);
   int32_t sphi_ctheta = INT_MULT_RSHIFT(sphi,   ctheta, INT32_TRIG_FRAC);
@@ -563,10 +532,8 @@ void int32_rates_of_eulers_dot_321(struct Int32Rates *r, struct Int32Eulers *e,
 
 void int32_eulers_dot_321_of_rates(struct Int32Eulers *ed, struct Int32Eulers *e, struct Int32Rates *r)
 {
-  int32_t sphi;
-  PPRZ_ITRIG_SIN(sphi, e->phi);
-  int32_t cphi;
-  PPRZ_ITRIG_COS(cphi, e->phi);
+  int32_t sphi, cphi;
+  pprz_itrig_sincos(e->phi, &sphi, &cphi);
   int32_t stheta;
   PPRZ_ITRIG_SIN(stheta, e->theta);
   int64_t ctheta;
@@ -224,8 +224,14 @@ struct Int64Vect3 {
 
 #define INT_MULT_RSHIFT(_a, _b, _r) (((_a)*(_b))>>(_r))
 
+/* rescaling of a product of two quaternion/trig values, for the *_SCALED kernels */
+#define INT32_QUAT_RSHIFT(_x) ((_x) >> INT32_QUAT_FRAC)
+#define INT32_TRIG_RSHIFT(_x) ((_x) >> INT32_TRIG_FRAC)
+
 
 extern uint32_t int32_sqrt(uint32_t in);
+/** Reciprocal square root, 2^31 / sqrt(in) */
+extern uint32_t int32_rsqrt(uint32_t in);
 #define INT32_SQRT(_out,_in) { _out = int32_sqrt(_in); }
 
 
@@ -453,12 +459,16 @@ static inline void int32_quat_wrap_shortest(struct Int32Quat *q)
 /** normalize a quaternion inplace */
 static inline void int32_quat_normalize(struct Int32Quat *q)
 {
-  int32_t n = int32_quat_norm(q);
-  if (n > 0) {
-    q->qi = q->qi * QUAT1_BFP_OF_REAL(1) / n;
-    q->qx = q->qx * QUAT1_BFP_OF_REAL(1) / n;
-    q->qy = q->qy * QUAT1_BFP_OF_REAL(1) / n;
-    q->qz = q->qz * QUAT1_BFP_OF_REAL(1) / n;
+  uint32_t n2 = q->qi * q->qi + q->qx * q->qx + q->qy * q->qy + q->qz * q->qz;
+  if (n2 > 0) {
+    /* one division for the reciprocal norm, 2^(31 - INT32_QUAT_FRAC) / norm */
+    const int64_t inv_n = int32_rsqrt(n2);
+    const int shift = 31 - INT32_QUAT_FRAC;
+    const int64_t half = 1 << (shift - 1);
+    q->qi = (q->qi * inv_n + half) >> shift;
+    q->qx = (q->qx * inv_n + half) >> shift;
+    q->qy = (q->qy * inv_n + half) >> shift;
+    q->qz = (q->qz * inv_n + half) >> shift;
   }
 }
 
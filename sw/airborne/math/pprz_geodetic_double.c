@@ -31,88 +31,149 @@
 #include "std.h" /* for RadOfDeg */
 
 
+/* WGS84 ellipsoid */
+static const double wgs84_a = 6378137.0;                                 /* semimajor axis in meters   */
+static const double wgs84_e2 = (2. - 1. / 298.257223563) / 298.257223563; /* first eccentricity squared */
+
+/** Fill the rotation from ECEF to ENU from the sine and cosine of the origin */
+static inline void ltp_of_ecef_rmat_from_sincos_d(struct DoubleRMat *ltp_of_ecef,
+    double sin_lat, double cos_lat, double sin_lon, double cos_lon)
+{
+  ltp_of_ecef->m[0] = -sin_lon;
+  ltp_of_ecef->m[1] =  cos_lon;
+  ltp_of_ecef->m[2] =  0.;
+  ltp_of_ecef->m[3] = -sin_lat * cos_lon;
+  ltp_of_ecef->m[4] = -sin_lat * sin_lon;
+  ltp_of_ecef->m[5] =  cos_lat;
+  ltp_of_ecef->m[6] =  cos_lat * cos_lon;
+  ltp_of_ecef->m[7] =  cos_lat * sin_lon;
+  ltp_of_ecef->m[8] =  sin_lat;
+}
+
+/**
+ * Closed form ECEF to LLA conversion.
+ * H. Vermeille, "Computing geodetic coordinates from geocentric coordinates",
+ * Journal of Geodesy, 2004. Valid everywhere except within about 43km
+ * of the earth center. No iteration and a single trigonometric call
+ * for the latitude; the sine and cosine of latitude and longitude are
+ * returned as by-products (sc = {sin_lat, cos_lat, sin_lon, cos_lon}, can be NULL).
+ */
+static inline void lla_of_ecef_sincos_d(struct LlaCoor_d *lla, double *sc, struct EcefCoor_d *ecef)
+{
+  const double e2 = wgs84_e2;
+  const double e4 = e2 * e2;
+  const double inv_a2 = 1. / (wgs84_a * wgs84_a);
+
+  const double r2 = ecef->x * ecef->x + ecef->y * ecef->y;
+  const double r = sqrt(r2);
+  const double p = r2 * inv_a2;
+  const double q = (1. - e2) * inv_a2 * ecef->z * ecef->z;
+  const double rr = (p + q - e4) / 6.;
+  const double s = e4 * p * q / (4. * rr * rr * rr);
+  const double t = cbrt(1. + s + sqrt(s * (2. + s)));
+  const double u = rr * (1. + t + 1. / t);
+  const double v = sqrt(u * u + e4 * q);
+  const double w = e2 * (u + v - q) / (2. * v);
+  const double k = sqrt(u + v + w * w) - w;
+  const double d = k * r / (k + e2);
+  const double dz = sqrt(d * d + ecef->z * ecef->z);
+
+  lla->lat = 2. * atan2(ecef->z, d + dz);
+  lla->lon = atan2(ecef->y, ecef->x);
+  lla->alt = (k + e2 - 1.) / k * dz;
+
+  if (sc != NULL) {
+    sc[0] = ecef->z / dz;
+    sc[1] = d / dz;
+    if (r > 0.) {
+      sc[2] = ecef->y / r;
+      sc[3] = ecef->x / r;
+    } else {
+      sc[2] = 0.;
+      sc[3] = 1.;
+    }
+  }
+}
+
 void ltp_def_from_ecef_d(struct LtpDef_d *def, struct EcefCoor_d *ecef)
 {
 
   /* store the origin of the tangeant plane       */
   VECT3_COPY(def->ecef, *ecef);
   /* compute the lla representation of the origin */
-  lla_of_ecef_d(&def->lla, &def->ecef);
+  double sc[4];
+  lla_of_ecef_sincos_d(&def->lla, sc, &def->ecef);
   /* store the rotation matrix                    */
-  const double sin_lat = sin(def->lla.lat);
-  const double cos_lat = cos(def->lla.lat);
-  const double sin_lon = sin(def->lla.lon);
-  const double cos_lon = cos(def->lla.lon);
-  def->ltp_of_ecef.m[0] = -sin_lon;
-  def->ltp_of_ecef.m[1] =  cos_lon;
-  def->ltp_of_ecef.m[2] =  0.;
-  def->ltp_of_ecef.m[3] = -sin_lat * cos_lon;
-  def->ltp_of_ecef.m[4] = -sin_lat * sin_lon;
-  def->ltp_of_ecef.m[5] =  cos_lat;
-  def->ltp_of_ecef.m[6] =  cos_lat * cos_lon;
-  def->ltp_of_ecef.m[7] =  cos_lat * sin_lon;
-  def->ltp_of_ecef.m[8] =  sin_lat;
+  ltp_of_ecef_rmat_from_sincos_d(&def->ltp_of_ecef, sc[0], sc[1], sc[2], sc[3]);
 
 }
 
-/* http://en.wikipedia.org/wiki/Geodetic_system */
-void lla_of_ecef_d(struct LlaCoor_d *lla, struct EcefCoor_d *ecef)
+void ltp_def_from_lla_d(struct LtpDef_d *def, struct LlaCoor_d *lla)
 {
+  /* store the origin of the tangeant plane */
+  LLA_COPY(def->lla, *lla);
+  /* compute the ecef representation of the origin and the rotation matrix from the same sin/cos */
+  const double sin_lat = sin(lla->lat);
+  const double cos_lat = cos(lla->lat);
+  const double sin_lon = sin(lla->lon);
+  const double cos_lon = cos(lla->lon);
+  const double e2 = wgs84_e2;
+  const double a_chi = wgs84_a / sqrt(1. - e2 * sin_lat * sin_lat);
+  def->ecef.x = (a_chi + lla->alt) * cos_lat * cos_lon;
+  def->ecef.y = (a_chi + lla->alt) * cos_lat * sin_lon;
+  def->ecef.z = (a_chi * (1. - e2) + lla->alt) * sin_lat;
+  ltp_of_ecef_rmat_from_sincos_d(&def->ltp_of_ecef, sin_lat, cos_lat, sin_lon, cos_lon);
+}
 
-  // FIXME : make an ellipsoid struct
-  static const double a = 6378137.0;           /* earth semimajor axis in meters */
-  static const double f = 1. / 298.257223563;  /* reciprocal flattening          */
-  const double b = a * (1. - f);               /* semi-minor axis                */
-  const double b2 = b * b;
-
-  const double e2 = 2.*f - (f * f);            /* first eccentricity squared     */
-  const double ep2 = f * (2. - f) / ((1. - f) * (1. - f)); /* second eccentricity squared    */
-  const double E2 = a * a - b2;
-
-
-  const double z2 = ecef->z * ecef->z;
-  const double r2 = ecef->x * ecef->x + ecef->y * ecef->y;
-  const double r = sqrt(r2);
-  const double F = 54.*b2 * z2;
-  const double G = r2 + (1 - e2) * z2 - e2 * E2;
-  const double c = (e2 * e2 * F * r2) / (G * G * G);
-  const double s = pow((1 + c + sqrt(c * c + 2 * c)), 1. / 3.);
-  const double s1 = 1 + s + 1 / s;
-  const double P = F / (3 * s1 * s1 * G * G);
-  const double Q = sqrt(1 + 2 * e2 * e2 * P);
-  const double ro = -(e2 * P * r) / (1 + Q) + sqrt((a * a / 2) * (1 + 1 / Q) - ((1 - e2) * P * z2) / (Q *
-                    (1 + Q)) - P * r2 / 2);
-  const double tmp = (r - e2 * ro) * (r - e2 * ro);
-  const double U = sqrt(tmp + z2);
-  const double V = sqrt(tmp + (1 - e2) * z2);
-  const double zo = (b2 * ecef->z) / (a * V);
-
-  lla->alt = U * (1 - b2 / (a * V));
-  lla->lat = atan((ecef->z + ep2 * zo) / r);
-  lla->lon = atan2(ecef->y, ecef->x);
-
+void lla_of_ecef_d(struct LlaCoor_d *lla, struct EcefCoor_d *ecef)
+{
+  lla_of_ecef_sincos_d(lla, NULL, ecef);
 }
 
 void ecef_of_lla_d(struct EcefCoor_d *ecef, struct LlaCoor_d *lla)
 {
-
-  // FIXME : make an ellipsoid struct
-  static const double a = 6378137.0;           /* earth semimajor axis in meters */
-  static const double f = 1. / 298.257223563;  /* reciprocal flattening          */
-  const double e2 = 2.*f - (f * f);            /* first eccentricity squared     */
+  const double e2 = wgs84_e2;
 
   const double sin_lat = sin(lla->lat);
   const double cos_lat = cos(lla->lat);
   const double sin_lon = sin(lla->lon);
   const double cos_lon = cos(lla->lon);
   const double chi = sqrt(1. - e2 * sin_lat * sin_lat);
-  const double a_chi = a / chi;
+  const double a_chi = wgs84_a / chi;
 
   ecef->x = (a_chi + lla->alt) * cos_lat * cos_lon;
   ecef->y = (a_chi + lla->alt) * cos_lat * sin_lon;
   ecef->z = (a_chi * (1. - e2) + lla->alt) * sin_lat;
 }
 
+void lla_of_ecef_array_d(struct LlaCoor_d *lla, struct EcefCoor_d *ecef, int n)
+{
+  for (int i = 0; i < n; i++) {
+    lla_of_ecef_sincos_d(&lla[i], NULL, &ecef[i]);
+  }
+}
+
+void ecef_of_lla_array_d(struct EcefCoor_d *ecef, struct LlaCoor_d *lla, int n)
+{
+  for (int i = 0; i < n; i++) {
+    ecef_of_lla_d(&ecef[i], &lla[i]);
+  }
+}
+
+void ned_of_ecef_point_array_d(struct NedCoor_d *ned, struct LtpDef_d *def, struct EcefCoor_d *ecef, int n)
+{
+  /* NED rows of the ENU rotation matrix */
+  const double *m = def->ltp_of_ecef.m;
+  for (int i = 0; i < n; i++) {
+    const double dx = ecef[i].x - def->ecef.x;
+    const double dy = ecef[i].y - def->ecef.y;
+    const double dz = ecef[i].z - def->ecef.z;
+    ned[i].x = m[3] * dx + m[4] * dy + m[5] * dz;
+    ned[i].y = m[0] * dx + m[1] * dy;
+    ned[i].z = -(m[6] * dx + m[7] * dy + m[8] * dz);
+  }
+}
+
 void enu_of_ecef_point_d(struct EnuCoor_d *enu, struct LtpDef_d *def, struct EcefCoor_d *ecef)
 {
   struct EcefCoor_d delta;
@@ -104,8 +104,14 @@ struct LtpDef_d {
 extern void lla_of_utm_d(struct LlaCoor_d *out, struct UtmCoor_d *in);
 extern void ltp_def_from_ecef_d(struct LtpDef_d *def, struct EcefCoor_d *ecef);
 extern void lla_of_ecef_d(struct LlaCoor_d *out, struct EcefCoor_d *in);
+extern void ltp_def_from_lla_d(struct LtpDef_d *def, struct LlaCoor_d *lla);
 extern void ecef_of_lla_d(struct EcefCoor_d *out, struct LlaCoor_d *in);
 
+/** Batch conversions, for ground tools and simulators converting many points at once */
+extern void lla_of_ecef_array_d(struct LlaCoor_d *lla, struct EcefCoor_d *ecef, int n);
+extern void ecef_of_lla_array_d(struct EcefCoor_d *ecef, struct LlaCoor_d *lla, int n);
+extern void ned_of_ecef_point_array_d(struct NedCoor_d *ned, struct LtpDef_d *def, struct EcefCoor_d *ecef, int n);
+
 extern void enu_of_ecef_point_d(struct EnuCoor_d *ned, struct LtpDef_d *def, struct EcefCoor_d *ecef);
 extern void ned_of_ecef_point_d(struct NedCoor_d *ned, struct LtpDef_d *def, struct EcefCoor_d *ecef);
 
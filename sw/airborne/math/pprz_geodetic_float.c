@@ -33,28 +33,77 @@
 /* for ecef_of_XX functions the double versions are needed */
 #include "pprz_geodetic_double.h"
 
+/* WGS84 ellipsoid */
+static const float wgs84_a = 6378137.0;                                 /* semimajor axis in meters   */
+static const float wgs84_e2 = (2. - 1. / 298.257223563) / 298.257223563; /* first eccentricity squared */
+
+/** Fill the rotation from ECEF to ENU from the sine and cosine of the origin */
+static inline void ltp_of_ecef_rmat_from_sincos_f(struct FloatRMat *ltp_of_ecef,
+    float sin_lat, float cos_lat, float sin_lon, float cos_lon)
+{
+  ltp_of_ecef->m[0] = -sin_lon;
+  ltp_of_ecef->m[1] =  cos_lon;
+  /* this element is always zero http://en.wikipedia.org/wiki/Geodetic_system#From_ECEF_to_ENU */
+  ltp_of_ecef->m[2] = 0.;
+  ltp_of_ecef->m[3] = -sin_lat * cos_lon;
+  ltp_of_ecef->m[4] = -sin_lat * sin_lon;
+  ltp_of_ecef->m[5] =  cos_lat;
+  ltp_of_ecef->m[6] =  cos_lat * cos_lon;
+  ltp_of_ecef->m[7] =  cos_lat * sin_lon;
+  ltp_of_ecef->m[8] =  sin_lat;
+}
+
+/**
+ * Closed form ECEF to LLA conversion (Vermeille 2004), see lla_of_ecef_d.
+ * Also returns sc = {sin_lat, cos_lat, sin_lon, cos_lon} if not NULL.
+ */
+static inline void lla_of_ecef_sincos_f(struct LlaCoor_f *lla, float *sc, struct EcefCoor_f *ecef)
+{
+  const float e2 = wgs84_e2;
+  const float e4 = e2 * e2;
+  const float inv_a2 = 1. / (wgs84_a * wgs84_a);
+
+  const float r2 = ecef->x * ecef->x + ecef->y * ecef->y;
+  const float r = sqrtf(r2);
+  const float p = r2 * inv_a2;
+  const float q = (1.f - e2) * inv_a2 * ecef->z * ecef->z;
+  const float rr = (p + q - e4) / 6.f;
+  const float s = e4 * p * q / (4.f * rr * rr * rr);
+  const float t = cbrtf(1.f + s + sqrtf(s * (2.f + s)));
+  const float u = rr * (1.f + t + 1.f / t);
+  const float v = sqrtf(u * u + e4 * q);
+  const float w = e2 * (u + v - q) / (2.f * v);
+  const float k = sqrtf(u + v + w * w) - w;
+  const float d = k * r / (k + e2);
+  const float dz = sqrtf(d * d + ecef->z * ecef->z);
+
+  lla->lat = 2.f * atan2f(ecef->z, d + dz);
+  lla->lon = atan2f(ecef->y, ecef->x);
+  lla->alt = (k + e2 - 1.f) / k * dz;
+
+  if (sc != NULL) {
+    sc[0] = ecef->z / dz;
+    sc[1] = d / dz;
+    if (r > 0.f) {
+      sc[2] = ecef->y / r;
+      sc[3] = ecef->x / r;
+    } else {
+      sc[2] = 0.f;
+      sc[3] = 1.f;
+    }
+  }
+}
+
 void ltp_def_from_ecef_f(struct LtpDef_f *def, struct EcefCoor_f *ecef)
 {
 
   /* store the origin of the tangeant plane       */
   VECT3_COPY(def->ecef, *ecef);
   /* compute the lla representation of the origin */
-  lla_of_ecef_f(&def->lla, &def->ecef);
+  float sc[4];
+  lla_of_ecef_sincos_f(&def->lla, sc, &def->ecef);
   /* store the rotation matrix                    */
-  const float sin_lat = sinf(def->lla.lat);
-  const float cos_lat = cosf(def->lla.lat);
-  const float sin_lon = sinf(def->lla.lon);
-  const float cos_lon = cosf(def->lla.lon);
-  def->ltp_of_ecef.m[0] = -sin_lon;
-  def->ltp_of_ecef.m[1] =  cos_lon;
-  /* this element is always zero http://en.wikipedia.org/wiki/Geodetic_system#From_ECEF_to_ENU */
-  def->ltp_of_ecef.m[2] = 0.;
-  def->ltp_of_ecef.m[3] = -sin_lat * cos_lon;
-  def->ltp_of_ecef.m[4] = -sin_lat * sin_lon;
-  def->ltp_of_ecef.m[5] =  cos_lat;
-  def->ltp_of_ecef.m[6] =  cos_lat * cos_lon;
-  def->ltp_of_ecef.m[7] =  cos_lat * sin_lon;
-  def->ltp_of_ecef.m[8] =  sin_lat;
+  ltp_of_ecef_rmat_from_sincos_f(&def->ltp_of_ecef, sc[0], sc[1], sc[2], sc[3]);
 
 }
 
@@ -62,25 +111,17 @@ void ltp_def_from_lla_f(struct LtpDef_f *def, struct LlaCoor_f *lla)
 {
   /* store the origin of the tangeant plane */
   LLA_COPY(def->lla, *lla);
-  /* compute the ecef representation of the origin */
-  ecef_of_lla_f(&def->ecef, &def->lla);
-
-  /* store the rotation matrix                    */
-  const float sin_lat = sinf(def->lla.lat);
-  const float cos_lat = cosf(def->lla.lat);
-  const float sin_lon = sinf(def->lla.lon);
-  const float cos_lon = cosf(def->lla.lon);
-
-  def->ltp_of_ecef.m[0] = -sin_lon;
-  def->ltp_of_ecef.m[1] =  cos_lon;
-  /* this element is always zero http://en.wikipedia.org/wiki/Geodetic_system#From_ECEF_to_ENU */
-  def->ltp_of_ecef.m[2] = 0.;
-  def->ltp_of_ecef.m[3] = -sin_lat * cos_lon;
-  def->ltp_of_ecef.m[4] = -sin_lat * sin_lon;
-  def->ltp_of_ecef.m[5] =  cos_lat;
-  def->ltp_of_ecef.m[6] =  cos_lat * cos_lon;
-  def->ltp_of_ecef.m[7] =  cos_lat * sin_lon;
-  def->ltp_of_ecef.m[8] =  sin_lat;
+  /* compute the ecef representation of the origin and the rotation matrix from the same sin/cos */
+  const float sin_lat = sinf(lla->lat);
+  const float cos_lat = cosf(lla->lat);
+  const float sin_lon = sinf(lla->lon);
+  const float cos_lon = cosf(lla->lon);
+  const float e2 = wgs84_e2;
+  const float a_chi = wgs84_a / sqrtf(1.f - e2 * sin_lat * sin_lat);
+  def->ecef.x = (a_chi + lla->alt) * cos_lat * cos_lon;
+  def->ecef.y = (a_chi + lla->alt) * cos_lat * sin_lon;
+  def->ecef.z = (a_chi * (1.f - e2) + lla->alt) * sin_lat;
+  ltp_of_ecef_rmat_from_sincos_f(&def->ltp_of_ecef, sin_lat, cos_lat, sin_lon, cos_lon);
 }
 
 void enu_of_ecef_point_f(struct EnuCoor_f *enu, struct LtpDef_f *def, struct EcefCoor_f *ecef)
@@ -201,62 +242,32 @@ void ecef_of_ned_vect_f(struct EcefCoor_f *ecef, struct LtpDef_f *def, struct Ne
 
 
 
-/* http://en.wikipedia.org/wiki/Geodetic_system */
 void lla_of_ecef_f(struct LlaCoor_f *out, struct EcefCoor_f *in)
 {
-
-  // FIXME : make an ellipsoid struct
-  static const float a = 6378137.0;           /* earth semimajor axis in meters */
-  static const float f = 1. / 298.257223563;  /* reciprocal flattening          */
-  const float b = a * (1. - f);               /* semi-minor axis                */
-  const float b2 = b * b;
-
-  const float e2 = 2.*f - (f * f);            /* first eccentricity squared     */
-  const float ep2 = f * (2. - f) / ((1. - f) * (1. - f)); /* second eccentricity squared    */
-  const float E2 = a * a - b2;
-
-
-  const float z2 = in->z * in->z;
-  const float r2 = in->x * in->x + in->y * in->y;
-  const float r = sqrtf(r2);
-  const float F = 54.*b2 * z2;
-  const float G = r2 + (1 - e2) * z2 - e2 * E2;
-  const float c = (e2 * e2 * F * r2) / (G * G * G);
-  const float s = powf((1 + c + sqrtf(c * c + 2 * c)), 1. / 3.);
-  const float s1 = 1 + s + 1 / s;
-  const float P = F / (3 * s1 * s1 * G * G);
-  const float Q = sqrtf(1 + 2 * e2 * e2 * P);
-  const float ro = -(e2 * P * r) / (1 + Q) + sqrtf((a * a / 2) * (1 + 1 / Q) - ((1 - e2) * P * z2) / (Q *
-                   (1 + Q)) - P * r2 / 2);
-  const float tmp = (r - e2 * ro) * (r - e2 * ro);
-  const float U = sqrtf(tmp + z2);
-  const float V = sqrtf(tmp + (1 - e2) * z2);
-  const float zo = (b2 * in->z) / (a * V);
-
-  out->alt = U * (1 - b2 / (a * V));
-  out->lat = atanf((in->z + ep2 * zo) / r);
-  out->lon = atan2f(in->y, in->x);
-
+  lla_of_ecef_sincos_f(out, NULL, in);
 }
 
 void ecef_of_lla_f(struct EcefCoor_f *out, struct LlaCoor_f *in)
 {
-
-  // FIXME : make an ellipsoid struct
-  static const float a = 6378137.0;           /* earth semimajor axis in meters */
-  static const float f = 1. / 298.257223563;  /* reciprocal flattening          */
-  const float e2 = 2.*f - (f * f);            /* first eccentricity squared     */
+  const float e2 = wgs84_e2;
 
   const float sin_lat = sinf(in->lat);
   const float cos_lat = cosf(in->lat);
   const float sin_lon = sinf(in->lon);
   const float cos_lon = cosf(in->lon);
-  const float chi = sqrtf(1. - e2 * sin_lat * sin_lat);
-  const float a_chi = a / chi;
+  const float chi = sqrtf(1.f - e2 * sin_lat * sin_lat);
+  const float a_chi = wgs84_a / chi;
 
   out->x = (a_chi + in->alt) * cos_lat * cos_lon;
   out->y = (a_chi + in->alt) * cos_lat * sin_lon;
-  out->z = (a_chi * (1. - e2) + in->alt) * sin_lat;
+  out->z = (a_chi * (1.f - e2) + in->alt) * sin_lat;
+}
+
+void lla_of_ecef_array_f(struct LlaCoor_f *lla, struct EcefCoor_f *ecef, int n)
+{
+  for (int i = 0; i < n; i++) {
+    lla_of_ecef_sincos_f(&lla[i], NULL, &ecef[i]);
+  }
 }
 
 
@@ -103,6 +103,7 @@ extern void ltp_def_from_ecef_f(struct LtpDef_f *def, struct EcefCoor_f *ecef);
 extern void ltp_def_from_lla_f(struct LtpDef_f *def, struct LlaCoor_f *lla);
 extern void lla_of_ecef_f(struct LlaCoor_f *out, struct EcefCoor_f *in);
 extern void ecef_of_lla_f(struct EcefCoor_f *out, struct LlaCoor_f *in);
+extern void lla_of_ecef_array_f(struct LlaCoor_f *lla, struct EcefCoor_f *ecef, int n);
 extern void enu_of_ecef_point_f(struct EnuCoor_f *enu, struct LtpDef_f *def, struct EcefCoor_f *ecef);
 extern void ned_of_ecef_point_f(struct NedCoor_f *ned, struct LtpDef_f *def, struct EcefCoor_f *ecef);
 extern void enu_of_ecef_vect_f(struct EnuCoor_f *enu, struct LtpDef_f *def, struct EcefCoor_f *ecef);
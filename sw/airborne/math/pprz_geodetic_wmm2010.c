@@ -27,6 +27,7 @@
 
 #include "std.h"
 #include "math/pprz_geodetic_wmm2010.h"
+#include <math.h>
 
 const double gh1[MAXCOEFF] = {
   0.0, -29496.6, -1586.3, 4944.4,
@@ -253,3 +254,74 @@ int16_t mag_calc(int16_t igdgc, double flat, double flon, double elev, int16_t n
   *geo_mag_z = *geo_mag_z * cd - aa * sd;
   return (ios);
 }
+
+/** index of a grid node */
+#define WMM_GRID_IDX(_i, _j, _k) (((_k) * WMM_GRID_N + (_i)) * WMM_GRID_N + (_j))
+
+void wmm_grid_init(struct WmmGrid *grid, double date, float lat, float lon, float step,
+                   float alt0, float alt1)
+{
+  grid->nmax = extrapsh(date, GEO_EPOCH, NMAX_1, NMAX_2, grid->gh);
+  grid->step = step;
+  /* keep the grid within the poles */
+  const float half = step * (WMM_GRID_N - 1) / 2.f;
+  grid->lat0 = Chop(lat - half, -90.f, 90.f - 2.f * half);
+  grid->lon0 = lon - half;
+  grid->alt0 = alt0;
+  grid->alt_step = alt1 - alt0;
+  grid->nb_ready = 0;
+}
+
+bool_t wmm_grid_build(struct WmmGrid *grid, uint16_t nb)
+{
+  while (nb > 0 && grid->nb_ready < WMM_GRID_NB_NODES) {
+    const uint16_t n = grid->nb_ready;
+    const int k = n / (WMM_GRID_N * WMM_GRID_N);
+    const int i = (n / WMM_GRID_N) % WMM_GRID_N;
+    const int j = n % WMM_GRID_N;
+    double x, y, z;
+    mag_calc(1, grid->lat0 + i * grid->step, grid->lon0 + j * grid->step,
+             grid->alt0 + k * grid->alt_step, grid->nmax, grid->gh,
+             &x, &y, &z, IEXT, EXT_COEFF1, EXT_COEFF2, EXT_COEFF3);
+    grid->field[WMM_GRID_IDX(i, j, k)][0] = x;
+    grid->field[WMM_GRID_IDX(i, j, k)][1] = y;
+    grid->field[WMM_GRID_IDX(i, j, k)][2] = z;
+    grid->nb_ready++;
+    nb--;
+  }
+  return (grid->nb_ready == WMM_GRID_NB_NODES);
+}
+
+bool_t wmm_grid_lookup(struct WmmGrid *grid, float lat, float lon, float alt, float field[3])
+{
+  if (grid->nb_ready < WMM_GRID_NB_NODES) {
+    return FALSE;
+  }
+  const float max = WMM_GRID_N - 1;
+  const float fi = (lat - grid->lat0) / grid->step;
+  /* longitude relative to the grid, wrapped to [-180, 180[ */
+  float dlon = fmodf(lon - grid->lon0 + 180.f, 360.f);
+  if (dlon < 0.f) { dlon += 360.f; }
+  const float fj = (dlon - 180.f) / grid->step;
+  if (fi < 0.f || fi > max || fj < 0.f || fj > max) {
+    return FALSE;
+  }
+  const int i = Min((int)fi, WMM_GRID_N - 2);
+  const int j = Min((int)fj, WMM_GRID_N - 2);
+  const float ti = fi - i;
+  const float tj = fj - j;
+  const float tk = (alt - grid->alt0) / grid->alt_step;
+
+  for (int c = 0; c < 3; c++) {
+    float layer[WMM_GRID_NB_ALT];
+    for (int k = 0; k < WMM_GRID_NB_ALT; k++) {
+      const float f00 = grid->field[WMM_GRID_IDX(i, j, k)][c];
+      const float f01 = grid->field[WMM_GRID_IDX(i, j + 1, k)][c];
+      const float f10 = grid->field[WMM_GRID_IDX(i + 1, j, k)][c];
+      const float f11 = grid->field[WMM_GRID_IDX(i + 1, j + 1, k)][c];
+      layer[k] = (1.f - ti) * ((1.f - tj) * f00 + tj * f01) + ti * ((1.f - tj) * f10 + tj * f11);
+    }
+    field[c] = layer[0] + tk * (layer[1] - layer[0]);
+  }
+  return TRUE;
+}
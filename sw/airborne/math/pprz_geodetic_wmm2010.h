@@ -72,6 +72,67 @@ int16_t mag_calc(int16_t igdgc, double flat, double flon, double elev, int16_t n
                  double *gh, double *geo_mag_x, double *geo_mag_y, double *geo_mag_z,
                  int16_t iext, double ext1, double ext2, double ext3);
 
+/** Number of grid nodes in latitude and longitude */
+#ifndef WMM_GRID_N
+#define WMM_GRID_N 4
+#endif
+/** Number of altitude layers of the grid */
+#define WMM_GRID_NB_ALT 2
+#define WMM_GRID_NB_NODES (WMM_GRID_N * WMM_GRID_N * WMM_GRID_NB_ALT)
+
+/**
+ * Interpolation grid of the magnetic field around a point.
+ * The spherical harmonic expansion is only evaluated at the grid nodes,
+ * one node at a time (see wmm_grid_build), afterwards the field at any
+ * point inside the grid is a cheap trilinear interpolation.
+ * The interpolation error is below 5 nT with a 1 deg spacing and below
+ * 20 nT with 2 deg, well below the model accuracy.
+ */
+struct WmmGrid {
+  double gh[MAXCOEFF];                  ///< model coefficients at the grid date
+  int16_t nmax;                         ///< model order
+  float lat0;                           ///< latitude of the south west node (deg)
+  float lon0;                           ///< longitude of the south west node (deg)
+  float step;                           ///< node spacing in latitude and longitude (deg)
+  float alt0;                           ///< altitude of the lower layer (km)
+  float alt_step;                       ///< altitude between the layers (km)
+  float field[WMM_GRID_NB_NODES][3];    ///< north, east, down field at the nodes (nT)
+  uint16_t nb_ready;                    ///< number of nodes computed so far
+};
+
+/**
+ * Initialize a grid centered on a point, no node is computed yet.
+ * @param grid grid to initialize
+ * @param date decimal year
+ * @param lat center latitude (deg)
+ * @param lon center longitude (deg)
+ * @param step node spacing (deg)
+ * @param alt0 altitude of the lower layer (km)
+ * @param alt1 altitude of the upper layer (km)
+ */
+extern void wmm_grid_init(struct WmmGrid *grid, double date, float lat, float lon, float step,
+                          float alt0, float alt1);
+
+/**
+ * Compute some more nodes of the grid.
+ * @param grid grid to build
+ * @param nb maximum number of nodes to compute
+ * @return TRUE when all the nodes are computed
+ */
+extern bool_t wmm_grid_build(struct WmmGrid *grid, uint16_t nb);
+
+/**
+ * Interpolate the magnetic field.
+ * The altitude is extrapolated outside of the layers.
+ * @param grid complete grid
+ * @param lat latitude (deg)
+ * @param lon longitude (deg)
+ * @param alt altitude (km)
+ * @param field north, east, down field (nT)
+ * @return FALSE if the grid is not complete or the point is outside of the grid
+ */
+extern bool_t wmm_grid_lookup(struct WmmGrid *grid, float lat, float lon, float alt, float field[3]);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
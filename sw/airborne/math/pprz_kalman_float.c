@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pprz_kalman_float.c
+ * @brief Covariance propagation and update for float Kalman filters.
+ *
+ */
+
+#include "pprz_kalman_float.h"
+
+void pprz_kf_init_diag_float(float *P, const float *d, int n)
+{
+  int i, j, idx = 0;
+  for (i = 0; i < n; i++) {
+    P[idx++] = d[i];
+    for (j = i + 1; j < n; j++) {
+      P[idx++] = 0.f;
+    }
+  }
+}
+
+void pprz_kf_add_diag_float(float *P, const float *q, int n)
+{
+  int i, idx = 0;
+  for (i = 0; i < n; i++) {
+    P[idx] += q[i];
+    idx += n - i;
+  }
+}
+
+void pprz_kf_unpack_float(float **o, const float *P, int n)
+{
+  int i, j, idx = 0;
+  for (i = 0; i < n; i++) {
+    for (j = i; j < n; j++) {
+      o[i][j] = P[idx];
+      o[j][i] = P[idx];
+      idx++;
+    }
+  }
+}
+
+void pprz_kf_pack_float(float *P, float **a, int n)
+{
+  int i, j, idx = 0;
+  for (i = 0; i < n; i++) {
+    for (j = i; j < n; j++) {
+      P[idx++] = a[i][j];
+    }
+  }
+}
+
+/*
+ * With P = [ Paa Pab ; Pab^T Pbb ]:
+ *   M = A * Pab + B * Pbb
+ *   T = A * Paa + B * Pab^T
+ *   F * P * F^T = [ T * A^T + M * B^T  M ; M^T  Pbb ]
+ * only the upper triangle of T * A^T + M * B^T is computed.
+ */
+void pprz_kf_propagate_block_float(float *P, const float *A, const float *B, int k, int n)
+{
+  const int m = n - k;
+  float Pk[k][n];   // first k rows of P: [ Paa Pab ]
+  float T[k][k];
+  float M[k][m];
+  int i, j, l;
+
+  for (i = 0; i < k; i++) {
+    for (j = 0; j < n; j++) {
+      Pk[i][j] = pprz_kf_get_float(P, i, j, n);
+    }
+  }
+
+  for (i = 0; i < k; i++) {
+    const float *a = &A[i * k];
+    const float *b = &B[i * m];
+    for (j = 0; j < k; j++) {
+      float s = 0.f;
+      for (l = 0; l < k; l++) {
+        s += a[l] * Pk[l][j];
+      }
+      for (l = 0; l < m; l++) {
+        s += b[l] * Pk[j][k + l];
+      }
+      T[i][j] = s;
+    }
+    for (j = 0; j < m; j++) {
+      float s = 0.f;
+      for (l = 0; l < k; l++) {
+        s += a[l] * Pk[l][k + j];
+      }
+      for (l = 0; l < m; l++) {
+        s += b[l] * pprz_kf_get_float(P, k + l, k + j, n);
+      }
+      M[i][j] = s;
+    }
+  }
+
+  for (i = 0; i < k; i++) {
+    float *row = &P[PPRZ_KF_IDX(i, i, n)] - i;
+    for (j = i; j < k; j++) {
+      const float *a = &A[j * k];
+      const float *b = &B[j * m];
+      float s = 0.f;
+      for (l = 0; l < k; l++) {
+        s += T[i][l] * a[l];
+      }
+      for (l = 0; l < m; l++) {
+        s += M[i][l] * b[l];
+      }
+      row[j] = s;
+    }
+    for (j = 0; j < m; j++) {
+      row[k + j] = M[i][j];
+    }
+  }
+}
+
+/*
+ * With g = P * h^T and K = g / s, the Joseph form
+ *   (I - K h) P (I - K h)^T + r K K^T = P - K g^T - g K^T + s K K^T
+ * is symmetric by construction and valid for any gain K.
+ */
+float pprz_kf_update_scalar_float(float *P, float *K, const float *h, int nh, float r, int n)
+{
+  float g[n];
+  float s = r;
+  int i, j, l;
+
+  for (i = 0; i < n; i++) {
+    float gi = 0.f;
+    for (l = 0; l < nh; l++) {
+      gi += pprz_kf_get_float(P, i, l, n) * h[l];
+    }
+    g[i] = gi;
+  }
+  for (l = 0; l < nh; l++) {
+    s += h[l] * g[l];
+  }
+
+  if (s <= 0.f) {
+    for (i = 0; i < n; i++) {
+      K[i] = 0.f;
+    }
+    return s;
+  }
+
+  const float inv_s = 1.f / s;
+  for (i = 0; i < n; i++) {
+    K[i] = g[i] * inv_s;
+  }
+
+  int idx = 0;
+  for (i = 0; i < n; i++) {
+    const float ki = K[i];
+    const float gi = g[i];
+    const float ski = s * ki;
+    for (j = i; j < n; j++) {
+      P[idx++] += ski * K[j] - ki * g[j] - gi * K[j];
+    }
+  }
+  return s;
+}
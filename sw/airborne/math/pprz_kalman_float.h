@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file math/pprz_kalman_float.h
+ * @brief Covariance propagation and update for float Kalman filters.
+ *
+ * The covariance matrix P (n x n) is stored packed: only the upper triangle,
+ * row by row, in PPRZ_KF_PACKED_SIZE(n) floats. It can't get asymmetric and
+ * only half of the products have to be computed.
+ *
+ * Propagation exploits the structure of the transition matrix of error state
+ * filters (attitude or position errors followed by bias states):
+ * @f[
+ *   F = \left(\begin{array}{cc} A & B \\ 0 & I \end{array}\right)
+ * @f]
+ *
+ * Vector measurements with a diagonal noise covariance are incorporated as a
+ * sequence of scalar updates, which is equivalent to the batch update and
+ * doesn't need the inverse of the innovation covariance.
+ */
+
+#ifndef PPRZ_KALMAN_FLOAT_H
+#define PPRZ_KALMAN_FLOAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of floats of a packed n x n covariance matrix */
+#define PPRZ_KF_PACKED_SIZE(_n) ((_n) * ((_n) + 1) / 2)
+
+/** Index of element (i,j) in a packed n x n covariance matrix
+ * @param i row, must be lower or equal to j
+ * @param j column
+ * @param n size of the matrix
+ */
+#define PPRZ_KF_IDX(_i, _j, _n) ((_i) * (_n) - ((_i) * ((_i) - 1)) / 2 + (_j) - (_i))
+
+/** Get element (i,j) of a packed n x n covariance matrix, for any i and j */
+static inline float pprz_kf_get_float(const float *P, int i, int j, int n)
+{
+  return (i <= j) ? P[PPRZ_KF_IDX(i, j, n)] : P[PPRZ_KF_IDX(j, i, n)];
+}
+
+/** Initialize a diagonal covariance matrix
+ * @param P packed n x n covariance matrix
+ * @param d diagonal, n elements
+ * @param n size of the matrix
+ */
+extern void pprz_kf_init_diag_float(float *P, const float *d, int n);
+
+/** Add a diagonal matrix (usually the process noise) to a covariance matrix
+ * @param P packed n x n covariance matrix
+ * @param q diagonal, n elements
+ * @param n size of the matrix
+ */
+extern void pprz_kf_add_diag_float(float *P, const float *q, int n);
+
+/** Unpack a covariance matrix to a full n x n matrix
+ * @param o output matrix, n x n
+ * @param P packed n x n covariance matrix
+ * @param n size of the matrix
+ */
+extern void pprz_kf_unpack_float(float **o, const float *P, int n);
+
+/** Pack the upper triangle of a full n x n matrix
+ * @param P output packed n x n covariance matrix
+ * @param a input matrix, n x n
+ * @param n size of the matrix
+ */
+extern void pprz_kf_pack_float(float *P, float **a, int n);
+
+/** Covariance propagation P = F * P * F^T with block structured F
+ *
+ * F = [ A B ; 0 I ] where A is k x k and B is k x (n-k).
+ * The lower right block of P is unchanged.
+ *
+ * @param P packed n x n covariance matrix
+ * @param A upper left block of F, k x k row major
+ * @param B upper right block of F, k x (n-k) row major
+ * @param k number of states not propagated by identity
+ * @param n size of the matrix
+ */
+extern void pprz_kf_propagate_block_float(float *P, const float *A, const float *B, int k, int n);
+
+/** Scalar measurement update of the covariance, in Joseph form
+ *
+ * The measurement is z = h * x + v with E(v^2) = r.
+ * Only the first nh elements of h may be non zero, the others are not read.
+ * The gain K = P * h^T / s is returned in K with s = h * P * h^T + r,
+ * the state correction is then K * (z - h * x).
+ * P is replaced by (I - K * h) * P * (I - K * h)^T + K * r * K^T.
+ *
+ * @param P packed n x n covariance matrix
+ * @param K output Kalman gain, n elements
+ * @param h measurement row, nh elements
+ * @param nh number of leading (possibly) non zero elements of h
+ * @param r measurement noise variance
+ * @param n size of the matrix
+ * @return innovation variance s, the covariance is not updated if it is not strictly positive
+ */
+extern float pprz_kf_update_scalar_float(float *P, float *K, const float *h, int nh, float r, int n);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PPRZ_KALMAN_FLOAT_H */
@@ -73,14 +73,15 @@ void pprz_cholesky_float(float **out, float **in, int n)
 void pprz_qr_float(float **Q, float **R, float **in, int m, int n)
 {
   int i, k;
-  float _q[m][m][m];
-  float *q[m][m];
+  float _q[m][m];
   float _z[m][n], _z1[m][n], _z2[m][m];
+  MAKE_MATRIX_PTR(q, _q, m);
   MAKE_MATRIX_PTR(z, _z, m);
   MAKE_MATRIX_PTR(z1, _z1, m);
   MAKE_MATRIX_PTR(z2, _z2, m);
-  for (i = 0;  i < m; i++) for (k = 0; k < m; k++) { q[i][k] = &_q[i][k][0]; }
   float_mat_copy(z, in, m, n);
+  // Q is accumulated as q[k] * ... * q[0] while the reflections are computed,
+  // instead of storing all of them
   for (k = 0; k < n && k < m - 1; k++) {
     float e[m], x[m], a, b;
     float_mat_minor(z1, z, m, n, k);
@@ -93,13 +94,14 @@ void pprz_qr_float(float **Q, float **R, float **in, int m, int n)
     }
     b = float_vect_norm(e, m);
     float_vect_sdiv(e, e, b, m);
-    float_mat_vmul(q[k], e, m);
-    float_mat_mul(z, q[k], z1, m, m, n);
-  }
-  float_mat_copy(Q, q[0], m, m);
-  for (i = 1; i < n && i < m - 1; i++) {
-    float_mat_mul(z2, q[i], Q, m, m, m);
-    float_mat_copy(Q, z2, m, m);
+    float_mat_vmul(q, e, m);
+    float_mat_mul(z, q, z1, m, m, n);
+    if (k == 0) {
+      float_mat_copy(Q, q, m, m);
+    } else {
+      float_mat_mul(z2, q, Q, m, m, m);
+      float_mat_copy(Q, z2, m, m);
+    }
   }
   float_mat_mul(R, Q, in, m, m, n);
   float_mat_transpose(Q, m);
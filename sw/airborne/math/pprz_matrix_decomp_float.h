@@ -32,6 +32,7 @@ extern "C" {
 #endif
 
 #include "std.h"
+#include <math.h>
 
 /** Cholesky decomposition
  *
@@ -103,6 +104,309 @@ int pprz_svd_float(float **a, float *w, float **v, int m, int n);
  */
 void pprz_svd_solve_float(float **x, float **u, float *w, float **v, float **b, int m, int n, int l);
 
+/*
+ * Contiguous fixed size kernels
+ *
+ * The functions above take arrays of row pointers and use variable length
+ * arrays as temporaries. The following ones work on contiguous row-major
+ * matrices (float[n * n], or a float[n][n] passed as &M[0][0]), in place or
+ * with caller provided storage, and don't use any temporary matrix.
+ * They are inline so that, called with a constant dimension, the compiler can
+ * unroll and vectorize the loops. Wrappers with the dimension in the name are
+ * defined for sizes 3 to 12 (e.g. pprz_cholesky_float6).
+ */
+
+/** Cholesky decomposition in place
+ *
+ * A = L * L^T, the lower triangle of A is replaced by L and the strictly upper
+ * triangle is set to zero. Only the lower triangle of A is read.
+ *
+ * @param A symmetric positive definite matrix [n x n], replaced by L
+ * @param n dimension of the matrix
+ * @return FALSE if the matrix is not positive definite
+ */
+static inline bool_t pprz_cholesky_float_n(float *A, const int n)
+{
+  int i, j, k;
+  for (j = 0; j < n; j++) {
+    float *Aj = &A[j * n];
+    float d = Aj[j];
+    for (k = 0; k < j; k++) {
+      d -= Aj[k] * Aj[k];
+    }
+    if (!(d > 0.f)) {
+      return FALSE;
+    }
+    d = sqrtf(d);
+    Aj[j] = d;
+    const float inv_d = 1.f / d;
+    for (i = j + 1; i < n; i++) {
+      float *Ai = &A[i * n];
+      float s = Ai[j];
+      for (k = 0; k < j; k++) {
+        s -= Ai[k] * Aj[k];
+      }
+      Ai[j] = s * inv_d;
+    }
+    for (k = j + 1; k < n; k++) {
+      Aj[k] = 0.f;
+    }
+  }
+  return TRUE;
+}
+
+/** Solve A * x = b in place from the Cholesky factor L of A
+ *
+ * @param L lower triangular factor [n x n] from pprz_cholesky_float_n
+ * @param b right-hand side [n], replaced by the solution x
+ * @param n dimension of the system
+ */
+static inline void pprz_cholesky_solve_float_n(const float *L, float *b, const int n)
+{
+  int i, k;
+  /* L * y = b */
+  for (i = 0; i < n; i++) {
+    float s = b[i];
+    for (k = 0; k < i; k++) {
+      s -= L[i * n + k] * b[k];
+    }
+    b[i] = s / L[i * n + i];
+  }
+  /* L^T * x = y */
+  for (i = n - 1; i >= 0; i--) {
+    float s = b[i];
+    for (k = i + 1; k < n; k++) {
+      s -= L[k * n + i] * b[k];
+    }
+    b[i] = s / L[i * n + i];
+  }
+}
+
+/** Rank-1 update (or downdate) of a Cholesky factor
+ *
+ * Computes the factor of L * L^T + sigma * x * x^T without forming the matrix.
+ *
+ * @param L lower triangular factor [n x n], updated in place
+ * @param x vector [n], destroyed
+ * @param sigma 1 for an update, -1 for a downdate
+ * @param n dimension of the matrix
+ * @return FALSE if the downdated matrix is not positive definite (L is then invalid)
+ */
+static inline bool_t pprz_cholesky_update_float_n(float *L, float *x, const float sigma, const int n)
+{
+  int i, k;
+  for (k = 0; k < n; k++) {
+    const float lkk = L[k * n + k];
+    const float r2 = lkk * lkk + sigma * x[k] * x[k];
+    if (!(r2 > 0.f)) {
+      return FALSE;
+    }
+    const float r = sqrtf(r2);
+    const float c = r / lkk;
+    const float s = x[k] / lkk;
+    const float inv_c = 1.f / c;
+    L[k * n + k] = r;
+    for (i = k + 1; i < n; i++) {
+      const float lik = (L[i * n + k] + sigma * s * x[i]) * inv_c;
+      x[i] = c * x[i] - s * lik;
+      L[i * n + k] = lik;
+    }
+  }
+  return TRUE;
+}
+
+/** LDL^T decomposition in place
+ *
+ * A = L * D * L^T with L unit lower triangular and D diagonal, without square
+ * roots. The strictly lower triangle of A is replaced by L, the diagonal by D
+ * and the strictly upper triangle is set to zero. Only the lower triangle of A
+ * is read.
+ *
+ * @param A symmetric matrix [n x n], replaced by L and D
+ * @param n dimension of the matrix
+ * @return FALSE if a pivot is zero
+ */
+static inline bool_t pprz_ldlt_float_n(float *A, const int n)
+{
+  int i, j, k;
+  float v[n];
+  for (j = 0; j < n; j++) {
+    float *Aj = &A[j * n];
+    float d = Aj[j];
+    for (k = 0; k < j; k++) {
+      v[k] = Aj[k] * A[k * n + k];
+      d -= Aj[k] * v[k];
+    }
+    if (d == 0.f) {
+      return FALSE;
+    }
+    Aj[j] = d;
+    const float inv_d = 1.f / d;
+    for (i = j + 1; i < n; i++) {
+      float *Ai = &A[i * n];
+      float s = Ai[j];
+      for (k = 0; k < j; k++) {
+        s -= Ai[k] * v[k];
+      }
+      Ai[j] = s * inv_d;
+    }
+    for (k = j + 1; k < n; k++) {
+      Aj[k] = 0.f;
+    }
+  }
+  return TRUE;
+}
+
+/** Solve A * x = b in place from the LDL^T decomposition of A
+ *
+ * @param LD L and D [n x n] from pprz_ldlt_float_n
+ * @param b right-hand side [n], replaced by the solution x
+ * @param n dimension of the system
+ */
+static inline void pprz_ldlt_solve_float_n(const float *LD, float *b, const int n)
+{
+  int i, k;
+  /* L * y = b */
+  for (i = 1; i < n; i++) {
+    float s = b[i];
+    for (k = 0; k < i; k++) {
+      s -= LD[i * n + k] * b[k];
+    }
+    b[i] = s;
+  }
+  /* D * z = y */
+  for (i = 0; i < n; i++) {
+    b[i] /= LD[i * n + i];
+  }
+  /* L^T * x = z */
+  for (i = n - 2; i >= 0; i--) {
+    float s = b[i];
+    for (k = i + 1; k < n; k++) {
+      s -= LD[k * n + i] * b[k];
+    }
+    b[i] = s;
+  }
+}
+
+/** Rank-1 update of a LDL^T decomposition
+ *
+ * Computes the decomposition of L * D * L^T + alpha * x * x^T, with a negative
+ * alpha for a downdate. This is the usual covariance update of Kalman filters
+ * (Gill, Golub, Murray and Saunders, method C1).
+ *
+ * @param LD L and D [n x n], updated in place
+ * @param x vector [n], destroyed
+ * @param alpha scale factor
+ * @param n dimension of the matrix
+ * @return FALSE if a pivot of the updated matrix is not positive
+ */
+static inline bool_t pprz_ldlt_update_float_n(float *LD, float *x, float alpha, const int n)
+{
+  int i, j;
+  for (j = 0; j < n; j++) {
+    const float p = x[j];
+    const float dj = LD[j * n + j];
+    const float d = dj + alpha * p * p;
+    if (!(d > 0.f)) {
+      return FALSE;
+    }
+    const float b = p * alpha / d;
+    alpha = dj * alpha / d;
+    LD[j * n + j] = d;
+    for (i = j + 1; i < n; i++) {
+      x[i] -= p * LD[i * n + j];
+      LD[i * n + j] += b * x[i];
+    }
+  }
+  return TRUE;
+}
+
+/** QR decomposition with Householder reflections
+ *
+ * A = Q * R, the reflections are applied directly to R and Q.
+ *
+ * @param Q orthogonal matrix [m x m] (output)
+ * @param R upper triangular matrix [m x n], set to A on input
+ * @param m number of rows
+ * @param n number of columns
+ */
+static inline void pprz_qr_float_n(float *Q, float *R, const int m, const int n)
+{
+  int i, j, k;
+  float v[m];
+  for (i = 0; i < m; i++) {
+    for (j = 0; j < m; j++) {
+      Q[i * m + j] = (i == j) ? 1.f : 0.f;
+    }
+  }
+  for (k = 0; k < n && k < m - 1; k++) {
+    /* Householder vector of column k below the diagonal */
+    float norm2 = 0.f;
+    for (i = k; i < m; i++) {
+      v[i] = R[i * n + k];
+      norm2 += v[i] * v[i];
+    }
+    float a = sqrtf(norm2);
+    if (a == 0.f) {
+      continue;
+    }
+    if (v[k] > 0.f) {
+      a = -a;
+    }
+    v[k] -= a;
+    const float vnorm2 = norm2 - 2.f * a * (v[k] + a) + a * a;
+    const float scale = 2.f / vnorm2;
+    /* R = H * R, H = I - scale * v * v^T */
+    for (j = k; j < n; j++) {
+      float s = 0.f;
+      for (i = k; i < m; i++) {
+        s += v[i] * R[i * n + j];
+      }
+      s *= scale;
+      for (i = k; i < m; i++) {
+        R[i * n + j] -= s * v[i];
+      }
+    }
+    /* Q = Q * H */
+    for (i = 0; i < m; i++) {
+      float *Qi = &Q[i * m];
+      float s = 0.f;
+      for (j = k; j < m; j++) {
+        s += Qi[j] * v[j];
+      }
+      s *= scale;
+      for (j = k; j < m; j++) {
+        Qi[j] -= s * v[j];
+      }
+    }
+  }
+}
+
+/** Fixed size wrappers of the contiguous kernels */
+#define PPRZ_MATRIX_DECOMP_FIXED(_n)                                                                  \
+  static inline bool_t pprz_cholesky_float##_n(float *A) { return pprz_cholesky_float_n(A, _n); }     \
+  static inline void pprz_cholesky_solve_float##_n(const float *L, float *b)                          \
+  { pprz_cholesky_solve_float_n(L, b, _n); }                                                          \
+  static inline bool_t pprz_cholesky_update_float##_n(float *L, float *x, const float sigma)          \
+  { return pprz_cholesky_update_float_n(L, x, sigma, _n); }                                           \
+  static inline bool_t pprz_ldlt_float##_n(float *A) { return pprz_ldlt_float_n(A, _n); }             \
+  static inline void pprz_ldlt_solve_float##_n(const float *LD, float *b)                             \
+  { pprz_ldlt_solve_float_n(LD, b, _n); }                                                             \
+  static inline bool_t pprz_ldlt_update_float##_n(float *LD, float *x, const float alpha)             \
+  { return pprz_ldlt_update_float_n(LD, x, alpha, _n); }                                              \
+  static inline void pprz_qr_float##_n(float *Q, float *R) { pprz_qr_float_n(Q, R, _n, _n); }
+
+PPRZ_MATRIX_DECOMP_FIXED(3)
+PPRZ_MATRIX_DECOMP_FIXED(4)
+PPRZ_MATRIX_DECOMP_FIXED(5)
+PPRZ_MATRIX_DECOMP_FIXED(6)
+PPRZ_MATRIX_DECOMP_FIXED(7)
+PPRZ_MATRIX_DECOMP_FIXED(8)
+PPRZ_MATRIX_DECOMP_FIXED(9)
+PPRZ_MATRIX_DECOMP_FIXED(10)
+PPRZ_MATRIX_DECOMP_FIXED(11)
+PPRZ_MATRIX_DECOMP_FIXED(12)
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
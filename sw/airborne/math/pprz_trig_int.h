@@ -40,11 +40,29 @@ extern "C" {
 #define PPRZ_TRIG_CONST
 #endif
 
-extern PPRZ_TRIG_CONST int16_t pprz_trig_int[];
+/** number of segments of the quarter wave sine table */
+#define PPRZ_TRIG_INT_TABLE_SIZE 256
 
+extern PPRZ_TRIG_CONST uint16_t pprz_trig_int[];
+
+/** Sine and cosine.
+ * Any angle with INT32_ANGLE_FRAC is accepted (no normalization needed),
+ * result with INT32_TRIG_FRAC, error below 1 LSB.
+ */
 extern int32_t pprz_itrig_sin(int32_t angle);
 extern int32_t pprz_itrig_cos(int32_t angle);
+
+/** Sine and cosine of the same angle, sharing the angle reduction */
+extern void pprz_itrig_sincos(int32_t angle, int32_t *s, int32_t *c);
+
+/** Sine and cosine of n angles */
+extern void pprz_itrig_sincos_array(int32_t *s, int32_t *c, const int32_t *angle, int n);
+
+/** Four quadrant arctangent, result with INT32_ANGLE_FRAC, error below 1 LSB.
+ */
 extern int32_t int32_atan2(int32_t y, int32_t x);
+
+/** Same as int32_atan2, kept for backwards compatibility */
 extern int32_t int32_atan2_2(int32_t y, int32_t x);
 
 /* for backwards compatibility */
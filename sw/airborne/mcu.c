@@ -185,6 +185,10 @@ void mcu_event(void)
   uart_event();
 #endif
 
+#if USE_SPI && SPI_MASTER
+  spi_event();
+#endif
+
 #if USE_UDP
   udp_event();
 #endif
@@ -49,6 +49,16 @@ extern void mcu_init(void);
  */
 extern void mcu_event(void);
 
+/**
+ * Wait for the next MCU event.
+ * Called by the main loop after the event functions, architectures where the
+ * main loop can sleep until a timer or peripheral needs it define this.
+ * By default the main loop polls continuously.
+ */
+#ifndef mcu_event_wait
+#define mcu_event_wait() {}
+#endif
+
 /** @}*/
 
 #endif /* MCU_H */
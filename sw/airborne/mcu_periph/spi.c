@@ -84,6 +84,10 @@ void spi_init(struct spi_periph *p)
   p->suspend = FALSE;
 }
 
+void WEAK spi_event(void)
+{
+}
+
 #endif /* SPI_MASTER */
 
 
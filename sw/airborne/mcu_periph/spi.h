@@ -286,6 +286,12 @@ extern bool_t spi_lock(struct spi_periph *p, uint8_t slave);
  */
 extern bool_t spi_resume(struct spi_periph *p, uint8_t slave);
 
+/** SPI event function.
+ * Reports finished transactions on architectures where they are not
+ * handled from interrupts (e.g. linux), empty by default.
+ */
+extern void spi_event(void);
+
 #endif /* SPI_MASTER */
 
 #if SPI_SLAVE
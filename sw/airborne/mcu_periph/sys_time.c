@@ -29,11 +29,49 @@
 
 #include "mcu_periph/sys_time.h"
 #include "mcu.h"
+#include <string.h>
 
 PRINT_CONFIG_VAR(SYS_TIME_FREQUENCY)
+PRINT_CONFIG_VAR(SYS_TIME_PROF)
 
 struct sys_time sys_time;
 
+#if SYS_TIME_PROF
+
+void sys_time_prof_reset(struct sys_time_prof *prof)
+{
+  prof->nb_runs = 0;
+  prof->exec_sum = 0;
+  prof->exec_min = 0;
+  prof->exec_max = 0;
+  prof->latency_sum = 0;
+  prof->latency_max = 0;
+  memset(prof->hist, 0, sizeof(prof->hist));
+}
+
+void sys_time_prof_stop(struct sys_time_prof *prof)
+{
+  uint32_t exec = get_sys_time_cpu_ticks() - prof->start;
+  prof->exec_sum += exec;
+  if (prof->nb_runs++ == 0 || exec < prof->exec_min) {
+    prof->exec_min = exec;
+  }
+  if (exec > prof->exec_max) {
+    prof->exec_max = exec;
+  }
+  /* bin k > 0 holds [MIN * 2^(k-1), MIN * 2^k[ usec */
+  uint32_t n = usec_of_cpu_ticks(exec) / SYS_TIME_PROF_HIST_MIN;
+  uint8_t bin = (n == 0) ? 0 : 32 - __builtin_clz(n);
+  if (bin >= SYS_TIME_PROF_HIST_SIZE) {
+    bin = SYS_TIME_PROF_HIST_SIZE - 1;
+  }
+  if (prof->hist[bin] < UINT16_MAX) {
+    prof->hist[bin]++;
+  }
+}
+
+#endif /* SYS_TIME_PROF */
+
 int sys_time_register_timer(float duration, sys_time_cb cb)
 {
 
@@ -44,6 +82,10 @@ int sys_time_register_timer(float duration, sys_time_cb cb)
       sys_time.timer[i].elapsed    = FALSE;
       sys_time.timer[i].end_time   = start_time + sys_time_ticks_of_sec(duration);
       sys_time.timer[i].duration   = sys_time_ticks_of_sec(duration);
+#if SYS_TIME_PROF
+      sys_time_prof_reset(&sys_time.timer[i].prof);
+      sys_time.timer[i].prof.overruns = 0;
+#endif
       sys_time.timer[i].in_use     = TRUE;
       return i;
     }
@@ -75,6 +117,7 @@ void sys_time_init(void)
   sys_time.nb_sec     = 0;
   sys_time.nb_sec_rem = 0;
   sys_time.nb_tick    = 0;
+  sys_time.nb_missed_tick = 0;
 
   sys_time.ticks_per_sec = SYS_TIME_FREQUENCY;
   sys_time.resolution = 1.0 / sys_time.ticks_per_sec;
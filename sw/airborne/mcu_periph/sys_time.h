@@ -53,16 +53,53 @@
 #endif
 #endif
 
+/**
+ * Execution time, start latency and overrun statistics of the
+ * timers and module functions (see sys_time_prof_start).
+ */
+#ifndef SYS_TIME_PROF
+#define SYS_TIME_PROF 0
+#endif
+
+/** Number of bins of the execution time histograms */
+#ifndef SYS_TIME_PROF_HIST_SIZE
+#define SYS_TIME_PROF_HIST_SIZE 10
+#endif
+
+/** Upper bound of the first histogram bin in usec,
+ * each following bin is twice as large, the last one is unbounded.
+ */
+#ifndef SYS_TIME_PROF_HIST_MIN
+#define SYS_TIME_PROF_HIST_MIN 8
+#endif
+
 
 typedef uint8_t tid_t; ///< sys_time timer id type
 typedef void (*sys_time_cb)(uint8_t id);
 
+/** Statistics of a task, times are in CPU ticks */
+struct sys_time_prof {
+  uint32_t start;         ///< start of the current run
+  uint32_t nb_runs;       ///< number of runs since the last reset
+  uint32_t exec_sum;
+  uint32_t exec_min;
+  uint32_t exec_max;
+  uint32_t latency_sum;   ///< delay between the timer activation and the start
+  uint32_t latency_max;
+  volatile uint32_t overruns; ///< number of activations missed because the previous one was still pending
+  uint16_t hist[SYS_TIME_PROF_HIST_SIZE]; ///< number of runs per execution time bin
+};
+
 struct sys_time_timer {
   bool_t          in_use;
   sys_time_cb     cb;
   volatile bool_t elapsed;
   uint32_t        end_time; ///< in SYS_TIME_TICKS
   uint32_t        duration; ///< in SYS_TIME_TICKS
+#if SYS_TIME_PROF
+  uint32_t        elapsed_cpu_ticks; ///< time of the activation in CPU ticks
+  struct sys_time_prof prof;
+#endif
 };
 
 struct sys_time {
@@ -75,6 +112,7 @@ struct sys_time {
   uint32_t ticks_per_sec;         ///< sys_time ticks per second (SYS_TIME_FREQUENCY)
   uint32_t resolution_cpu_ticks;  ///< sys_time_timer resolution in cpu ticks
   uint32_t cpu_ticks_per_sec;     ///< cpu ticks per second
+  volatile uint32_t nb_missed_tick; ///< sys_time ticks the tick handler was too late for
 };
 
 extern struct sys_time sys_time;
@@ -105,17 +143,19 @@ extern void sys_time_update_timer(tid_t id, float duration);
 
 /**
  * Check if timer has elapsed.
+ * With SYS_TIME_PROF, this is the start of the timer task
+ * (see sys_time_timer_done).
  * @param id Timer id
  * @return TRUE if timer has elapsed
  */
-static inline bool_t sys_time_check_and_ack_timer(tid_t id)
-{
-  if (sys_time.timer[id].elapsed) {
-    sys_time.timer[id].elapsed = FALSE;
-    return TRUE;
-  }
-  return FALSE;
-}
+static inline bool_t sys_time_check_and_ack_timer(tid_t id);
+
+/**
+ * Signal the end of the task run after sys_time_check_and_ack_timer.
+ * Only used for the statistics of SYS_TIME_PROF.
+ * @param id Timer id
+ */
+static inline void sys_time_timer_done(tid_t id);
 
 /**
  * Get the time in seconds since startup.
@@ -209,6 +249,83 @@ static inline uint32_t nsec_of_cpu_ticks(uint32_t cpu_ticks)
 /* architecture specific init implementation */
 extern void sys_time_arch_init(void);
 
+/* CPU ticks counter for the architectures without a faster one */
+#ifndef SYS_TIME_HAS_CPU_TICKS
+/**
+ * Get a free running counter in CPU ticks, wraps around.
+ * @return CPU ticks
+ */
+static inline uint32_t get_sys_time_cpu_ticks(void)
+{
+  return cpu_ticks_of_usec(get_sys_time_usec());
+}
+#endif
+
+#if SYS_TIME_PROF
+
+/** Start a run of a task */
+static inline void sys_time_prof_start(struct sys_time_prof *prof)
+{
+  prof->start = get_sys_time_cpu_ticks();
+}
+
+/** End a run of a task and update its statistics */
+extern void sys_time_prof_stop(struct sys_time_prof *prof);
+
+/** Reset the statistics, except for the overruns */
+extern void sys_time_prof_reset(struct sys_time_prof *prof);
+
+/**
+ * Activation of a timer, to be called by the tick handler
+ * before setting the elapsed flag.
+ */
+static inline void sys_time_prof_elapsed(tid_t id)
+{
+  if (sys_time.timer[id].elapsed) {
+    sys_time.timer[id].prof.overruns++;
+  } else {
+    sys_time.timer[id].elapsed_cpu_ticks = get_sys_time_cpu_ticks();
+  }
+}
+
+static inline bool_t sys_time_check_and_ack_timer(tid_t id)
+{
+  if (sys_time.timer[id].elapsed) {
+    struct sys_time_prof *prof = &sys_time.timer[id].prof;
+    sys_time_prof_start(prof);
+    sys_time.timer[id].elapsed = FALSE;
+    uint32_t latency = prof->start - sys_time.timer[id].elapsed_cpu_ticks;
+    prof->latency_sum += latency;
+    if (latency > prof->latency_max) {
+      prof->latency_max = latency;
+    }
+    return TRUE;
+  }
+  return FALSE;
+}
+
+static inline void sys_time_timer_done(tid_t id)
+{
+  sys_time_prof_stop(&sys_time.timer[id].prof);
+}
+
+#else
+
+static inline void sys_time_prof_elapsed(tid_t id __attribute__((unused))) {}
+
+static inline bool_t sys_time_check_and_ack_timer(tid_t id)
+{
+  if (sys_time.timer[id].elapsed) {
+    sys_time.timer[id].elapsed = FALSE;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+static inline void sys_time_timer_done(tid_t id __attribute__((unused))) {}
+
+#endif /* SYS_TIME_PROF */
+
 /* Generic timer macros */
 #define SysTimeTimerStart(_t) { _t = get_sys_time_usec(); }
 #define SysTimeTimer(_t) ( get_sys_time_usec() - (_t))
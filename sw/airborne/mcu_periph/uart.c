@@ -237,6 +237,19 @@ uint16_t uart_char_available(struct uart_periph *p)
   return (uint16_t)available;
 }
 
+uint16_t uart_rx_peek(struct uart_periph *p, uint8_t **buf)
+{
+  uint16_t insert = p->rx_insert_idx;
+  uint16_t extract = p->rx_extract_idx;
+  *buf = &p->rx_buf[extract];
+  return (insert >= extract ? insert : UART_RX_BUFFER_SIZE) - extract;
+}
+
+void uart_rx_skip(struct uart_periph *p, uint16_t len)
+{
+  p->rx_extract_idx = (p->rx_extract_idx + len) % UART_RX_BUFFER_SIZE;
+}
+
 void WEAK uart_event(void)
 {
 
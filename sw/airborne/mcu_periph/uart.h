@@ -32,8 +32,12 @@
 #include "mcu_periph/link_device.h"
 #include "std.h"
 
+#ifndef UART_RX_BUFFER_SIZE
 #define UART_RX_BUFFER_SIZE 128
+#endif
+#ifndef UART_TX_BUFFER_SIZE
 #define UART_TX_BUFFER_SIZE 128
+#endif
 #define UART_DEV_NAME_SIZE 16
 
 /*
@@ -92,6 +96,22 @@ extern void uart_event(void);
  */
 extern uint16_t uart_char_available(struct uart_periph *p);
 
+/** Get the received bytes without copying them.
+ * Returns the bytes from the oldest one to the newest one or to the end of
+ * the receive buffer, call again after uart_rx_skip() for the bytes
+ * following the end of the buffer.
+ * @param p uart
+ * @param[out] buf first received byte
+ * @return number of contiguous bytes from buf
+ */
+extern uint16_t uart_rx_peek(struct uart_periph *p, uint8_t **buf);
+
+/** Remove bytes from the receive buffer.
+ * @param p uart
+ * @param len number of bytes, at most the number returned by uart_rx_peek()
+ */
+extern void uart_rx_skip(struct uart_periph *p, uint16_t len);
+
 
 #if USE_UART0
 extern struct uart_periph uart0;
@@ -26,6 +26,11 @@
  */
 
 #include "mcu_periph/udp.h"
+#include <string.h>
+
+#if PERIODIC_TELEMETRY
+#include "subsystems/datalink/telemetry.h"
+#endif
 
 /* Print the configurations */
 #if USE_UDP0
@@ -52,6 +57,45 @@ PRINT_CONFIG_VAR(UDP2_PORT_IN)
 PRINT_CONFIG_VAR(UDP2_BROADCAST)
 #endif // USE_UDP2
 
+#if PERIODIC_TELEMETRY
+#if USE_UDP0 || USE_UDP1 || USE_UDP2
+static void send_udp_stats_periph(struct transport_tx *trans, struct link_device *dev,
+                                  struct udp_periph *p, uint8_t nb)
+{
+  pprz_msg_send_UDP_STATS(trans, dev, AC_ID,
+                          &p->stats.rx_rate, &p->stats.tx_rate,
+                          &p->stats.rx_packets, &p->stats.tx_packets,
+                          &p->stats.tx_messages, &p->stats.rx_dropped,
+                          &p->stats.tx_dropped, &p->stats.rx_latency_avg,
+                          &p->stats.rx_latency_max, &nb);
+}
+#endif
+
+static void send_udp_stats(struct transport_tx *trans, struct link_device *dev)
+{
+  static uint8_t udp_nb_cnt = 0;
+  switch (udp_nb_cnt) {
+#if USE_UDP0
+    case 0:
+      send_udp_stats_periph(trans, dev, &udp0, 0); break;
+#endif
+#if USE_UDP1
+    case 1:
+      send_udp_stats_periph(trans, dev, &udp1, 1); break;
+#endif
+#if USE_UDP2
+    case 2:
+      send_udp_stats_periph(trans, dev, &udp2, 2); break;
+#endif
+    default: break;
+  }
+  udp_nb_cnt++;
+  if (udp_nb_cnt == 3) {
+    udp_nb_cnt = 0;
+  }
+}
+#endif
+
 /**
  * Initialize the UDP peripheral
  */
@@ -60,6 +104,7 @@ void udp_periph_init(struct udp_periph *p, char *host, int port_out, int port_in
   p->rx_insert_idx = 0;
   p->rx_extract_idx = 0;
   p->tx_insert_idx = 0;
+  memset(&p->stats, 0, sizeof(struct udp_stats));
   p->device.periph = (void *)p;
   p->device.check_free_space = (check_free_space_t) udp_check_free_space;
   p->device.put_byte = (put_byte_t) udp_transmit;
@@ -69,6 +114,11 @@ void udp_periph_init(struct udp_periph *p, char *host, int port_out, int port_in
 
   // Arch dependent initialization
   udp_arch_periph_init(p, host, port_out, port_in, broadcast);
+
+#if PERIODIC_TELEMETRY
+  // the first to register do it for the others
+  register_periodic_telemetry(DefaultPeriodic, "UDP_STATS", send_udp_stats);
+#endif
 }
 
 /**
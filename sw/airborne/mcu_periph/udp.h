@@ -32,19 +32,36 @@
 #include "mcu_periph/udp_arch.h"
 #include "mcu_periph/link_device.h"
 
+#ifndef UDP_RX_BUFFER_SIZE
 #define UDP_RX_BUFFER_SIZE 256
+#endif
 #define UDP_TX_BUFFER_SIZE 256
 
+/** UDP link statistics, filled by the arch implementation */
+struct udp_stats {
+  uint32_t rx_packets;        ///< number of received datagrams
+  uint32_t tx_packets;        ///< number of sent datagrams
+  uint32_t tx_messages;       ///< number of messages sent (several messages per datagram)
+  uint32_t rx_dropped;        ///< bytes dropped because the rx buffer was full
+  uint32_t tx_dropped;        ///< messages dropped because the tx batch was full or too long
+  uint16_t rx_rate;           ///< received datagrams per second
+  uint16_t tx_rate;           ///< sent datagrams per second
+  uint32_t rx_latency_avg;    ///< average delay between reception and processing in usec
+  uint32_t rx_latency_max;    ///< maximum delay between reception and processing in usec
+};
+
 struct udp_periph {
   /** Receive buffer */
   uint8_t rx_buf[UDP_RX_BUFFER_SIZE];
-  uint16_t rx_insert_idx;
+  volatile uint16_t rx_insert_idx;
   uint16_t rx_extract_idx;
   /** Transmit buffer */
   uint8_t tx_buf[UDP_TX_BUFFER_SIZE];
   uint16_t tx_insert_idx;
   /** UDP network */
   void *network;
+  /** Link statistics */
+  struct udp_stats stats;
   /** Generic device interface */
   struct link_device device;
 };
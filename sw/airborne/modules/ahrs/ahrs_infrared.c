@@ -50,24 +50,28 @@ static float heading;
 #ifndef AHRS_INFRARED_GYRO_ID
 #define AHRS_INFRARED_GYRO_ID ABI_BROADCAST
 #endif
-static abi_event gyro_ev;
 
 #ifndef AHRS_INFRARED_GPS_ID
 #define AHRS_INFRARED_GPS_ID ABI_BROADCAST
 #endif
+
+/* with ABI_STATIC, the callbacks are bound from the module file */
+#ifndef ABI_STATIC
+static abi_event gyro_ev;
 static abi_event gps_ev;
+#endif
 void ahrs_infrared_update_gps(struct GpsState *gps_s);
 
-static void gyro_cb(uint8_t sender_id __attribute__((unused)),
-                    uint32_t stamp __attribute__((unused)),
-                    struct Int32Rates *gyro)
+void ahrs_infrared_gyro_cb(uint8_t sender_id __attribute__((unused)),
+                           uint32_t stamp __attribute__((unused)),
+                           struct Int32Rates *gyro)
 {
   stateSetBodyRates_i(gyro);
 }
 
-static void gps_cb(uint8_t sender_id __attribute__((unused)),
-                   uint32_t stamp __attribute__((unused)),
-                   struct GpsState *gps_s)
+void ahrs_infrared_gps_cb(uint8_t sender_id __attribute__((unused)),
+                          uint32_t stamp __attribute__((unused)),
+                          struct GpsState *gps_s)
 {
   ahrs_infrared_update_gps(gps_s);
 }
@@ -97,8 +101,10 @@ void ahrs_infrared_init(void)
 {
   heading = 0.;
 
-  AbiBindMsgIMU_GYRO_INT32(AHRS_INFRARED_GYRO_ID, &gyro_ev, gyro_cb);
-  AbiBindMsgGPS(AHRS_INFRARED_GPS_ID, &gps_ev, &gps_cb);
+#ifndef ABI_STATIC
+  AbiBindMsgIMU_GYRO_INT32(AHRS_INFRARED_GYRO_ID, &gyro_ev, ahrs_infrared_gyro_cb);
+  AbiBindMsgGPS(AHRS_INFRARED_GPS_ID, &gps_ev, ahrs_infrared_gps_cb);
+#endif
 
 #if PERIODIC_TELEMETRY
   register_periodic_telemetry(DefaultPeriodic, "IR_SENSORS", send_infrared);
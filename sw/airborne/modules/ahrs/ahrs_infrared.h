@@ -30,8 +30,14 @@
 #define AHRS_INFRARED_H
 
 #include "std.h"
+#include "math/pprz_algebra_int.h"
+#include "subsystems/gps.h"
 
 extern void ahrs_infrared_init(void);
 extern void ahrs_infrared_periodic(void);
 
+/** ABI callbacks, called directly with ABI_STATIC */
+extern void ahrs_infrared_gyro_cb(uint8_t sender_id, uint32_t stamp, struct Int32Rates *gyro);
+extern void ahrs_infrared_gps_cb(uint8_t sender_id, uint32_t stamp, struct GpsState *gps_s);
+
 #endif /* AHRS_INFRARED_H */
@@ -30,19 +30,14 @@
 
 #include <stdio.h>
 #include <pthread.h>
-#include "state.h"
-#include "subsystems/abi.h"
+#include <time.h>
+#include "mcu_periph/sys_time.h"
+#include "modules/core/state_snapshot.h"
 
 #include "lib/v4l/v4l2.h"
 #include "lib/encoding/jpeg.h"
 #include "lib/encoding/rtp.h"
 
-/* Default sonar/agl to use in opticflow visual_estimator */
-#ifndef OPTICFLOW_AGL_ID
-#define OPTICFLOW_AGL_ID ABI_BROADCAST    ///< Default sonar/agl to use in opticflow visual_estimator
-#endif
-PRINT_CONFIG_VAR(OPTICFLOW_AGL_ID)
-
 /* The video device */
 #ifndef OPTICFLOW_DEVICE
 #define OPTICFLOW_DEVICE /dev/video2      ///< The video device
@@ -66,16 +61,14 @@ PRINT_CONFIG_VAR(VIEWVIDEO_DEVICE_BUFFERS)
 /* The main opticflow variables */
 struct opticflow_t opticflow;                      ///< Opticflow calculations
 static struct opticflow_result_t opticflow_result; ///< The opticflow result
-static struct opticflow_state_t opticflow_state;   ///< State of the drone to communicate with the opticflow
 static struct v4l2_device *opticflow_dev;          ///< The opticflow camera V4L2 device
-static abi_event opticflow_agl_ev;                 ///< The altitude ABI event
 static pthread_t opticflow_calc_thread;            ///< The optical flow calculation thread
 static bool_t opticflow_got_result;                ///< When we have an optical flow calculation
 static pthread_mutex_t opticflow_mutex;            ///< Mutex lock fo thread safety
 
 /* Static functions */
 static void *opticflow_module_calc(void *data);                   ///< The main optical flow calculation thread
-static void opticflow_agl_cb(uint8_t sender_id, float distance);  ///< Callback function of the ground altitude
+static uint32_t opticflow_image_stamp(struct image_t *img);       ///< Time of an image in sys_time usec
 
 #if PERIODIC_TELEMETRY
 #include "subsystems/datalink/telemetry.h"
@@ -103,14 +96,6 @@ static void opticflow_telem_send(struct transport_tx *trans, struct link_device
  */
 void opticflow_module_init(void)
 {
-  // Subscribe to the altitude above ground level ABI messages
-  AbiBindMsgAGL(OPTICFLOW_AGL_ID, &opticflow_agl_ev, opticflow_agl_cb);
-
-  // Set the opticflow state to 0
-  opticflow_state.phi = 0;
-  opticflow_state.theta = 0;
-  opticflow_state.agl = 0;
-
   // Initialize the opticflow calculation
   opticflow_calc_init(&opticflow, 320, 240);
   opticflow_got_result = FALSE;
@@ -138,16 +123,11 @@ void opticflow_module_init(void)
 }
 
 /**
- * Update the optical flow state for the calculation thread
- * and update the stabilization loops with the newest result
+ * Update the stabilization loops with the newest result
  */
 void opticflow_module_run(void)
 {
   pthread_mutex_lock(&opticflow_mutex);
-  // Send Updated data to thread
-  opticflow_state.phi = stateGetNedToBodyEulers_f()->phi;
-  opticflow_state.theta = stateGetNedToBodyEulers_f()->theta;
-
   // Update the stabilization loops on the current calculation
   if (opticflow_got_result) {
     stabilization_opticflow_update(&opticflow_result);
@@ -215,11 +195,16 @@ static void *opticflow_module_calc(void *data __attribute__((unused)))
     struct image_t img;
     v4l2_image_get(opticflow_dev, &img);
 
-    // Copy the state
-    pthread_mutex_lock(&opticflow_mutex);
+    // Get the state at the time the image was taken, skip the frame if there is none yet
+    struct StateSnapshot snapshot;
+    if (!state_snapshot_at(&snapshot, opticflow_image_stamp(&img))) {
+      v4l2_image_free(opticflow_dev, &img);
+      continue;
+    }
     struct opticflow_state_t temp_state;
-    memcpy(&temp_state, &opticflow_state, sizeof(struct opticflow_state_t));
-    pthread_mutex_unlock(&opticflow_mutex);
+    temp_state.phi = snapshot.ned_to_body_eulers.phi;
+    temp_state.theta = snapshot.ned_to_body_eulers.theta;
+    temp_state.agl = snapshot.agl;
 
     // Do the optical flow calculation
     struct opticflow_result_t temp_result;
@@ -253,14 +238,20 @@ static void *opticflow_module_calc(void *data __attribute__((unused)))
 }
 
 /**
- * Get the altitude above ground of the drone
- * @param[in] sender_id The id that send the ABI message (unused)
- * @param[in] distance The distance above ground level in meters
+ * Get the time an image was taken
+ * The V4L2 buffers are time stamped with the monotonic clock, as sys_time.
+ * If the age of the image doesn't make sense (driver using another clock),
+ * the current time is used.
+ * @param[in] *img The image
+ * @return The time of the image in usec (sys_time)
  */
-static void opticflow_agl_cb(uint8_t sender_id __attribute__((unused)), float distance)
+static uint32_t opticflow_image_stamp(struct image_t *img)
 {
-  // Update the distance if we got a valid measurement
-  if (distance > 0) {
-    opticflow_state.agl = distance;
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  int64_t age = (int64_t)(now.tv_sec - img->ts.tv_sec) * 1000000 + now.tv_nsec / 1000 - img->ts.tv_usec;
+  if (age < 0 || age > 1000000) {
+    age = 0;
   }
+  return get_sys_time_usec() - (uint32_t)age;
 }
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/core/state_snapshot.c
+ *
+ * Thread safe copies of the state interface.
+ */
+
+#include "modules/core/state_snapshot.h"
+#include "state.h"
+#include "mcu_periph/sys_time.h"
+#include "subsystems/abi.h"
+#include <string.h>
+
+/** ABI sender id of the AGL measurements */
+#ifndef STATE_SNAPSHOT_AGL_ID
+#define STATE_SNAPSHOT_AGL_ID ABI_BROADCAST
+#endif
+PRINT_CONFIG_VAR(STATE_SNAPSHOT_AGL_ID)
+
+PRINT_CONFIG_VAR(STATE_SNAPSHOT_HISTORY_SIZE)
+
+/** Snapshot with its sequence counter, odd while it is written */
+struct StateSnapshotSlot {
+  uint32_t seq;
+  struct StateSnapshot s;
+};
+
+static struct StateSnapshotSlot snapshot_slots[STATE_SNAPSHOT_HISTORY_SIZE];
+/** number of published snapshots, the latest one is in slot (count - 1) % size */
+static uint32_t snapshot_count;
+
+static float snapshot_agl;
+static abi_event agl_ev;
+
+static void agl_cb(uint8_t sender_id __attribute__((unused)), float distance)
+{
+  if (distance > 0) {
+    snapshot_agl = distance;
+  }
+}
+
+static void slot_write(struct StateSnapshotSlot *slot, struct StateSnapshot *s)
+{
+  const uint32_t seq = slot->seq;
+  __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+  /* the odd counter is visible before any of the data */
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(&slot->s, s, sizeof(struct StateSnapshot));
+  __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static void slot_read(struct StateSnapshot *s, struct StateSnapshotSlot *slot)
+{
+  uint32_t seq0, seq1;
+  do {
+    seq0 = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    memcpy(s, &slot->s, sizeof(struct StateSnapshot));
+    /* the copy is done before the counter is read again */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    seq1 = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+  } while ((seq0 & 1) || seq0 != seq1);
+}
+
+void state_snapshot_init(void)
+{
+  memset(snapshot_slots, 0, sizeof(snapshot_slots));
+  snapshot_count = 0;
+  snapshot_agl = 0.f;
+
+  AbiBindMsgAGL(STATE_SNAPSHOT_AGL_ID, &agl_ev, agl_cb);
+}
+
+void state_snapshot_publish(void)
+{
+  struct StateSnapshot s;
+  s.stamp = get_sys_time_usec();
+  s.ned_to_body_quat = *stateGetNedToBodyQuat_f();
+  s.ned_to_body_eulers = *stateGetNedToBodyEulers_f();
+  s.body_rates = *stateGetBodyRates_f();
+  s.ned_pos = *stateGetPositionNed_f();
+  s.ned_speed = *stateGetSpeedNed_f();
+  s.agl = snapshot_agl;
+
+  const uint32_t count = snapshot_count;
+  slot_write(&snapshot_slots[count % STATE_SNAPSHOT_HISTORY_SIZE], &s);
+  /* readers only see the new slot once it is complete */
+  __atomic_store_n(&snapshot_count, count + 1, __ATOMIC_RELEASE);
+}
+
+bool_t state_snapshot_get(struct StateSnapshot *s)
+{
+  const uint32_t count = __atomic_load_n(&snapshot_count, __ATOMIC_ACQUIRE);
+  if (count == 0) {
+    return FALSE;
+  }
+  slot_read(s, &snapshot_slots[(count - 1) % STATE_SNAPSHOT_HISTORY_SIZE]);
+  return TRUE;
+}
+
+/** Linear interpolation between two snapshots, t in [0, 1] */
+static void snapshot_interpolate(struct StateSnapshot *s, struct StateSnapshot *s0,
+                                 struct StateSnapshot *s1, float t)
+{
+  /* shortest path between the two attitudes */
+  struct FloatQuat q1 = s1->ned_to_body_quat;
+  if (s0->ned_to_body_quat.qi * q1.qi + s0->ned_to_body_quat.qx * q1.qx +
+      s0->ned_to_body_quat.qy * q1.qy + s0->ned_to_body_quat.qz * q1.qz < 0.f) {
+    QUAT_EXPLEMENTARY(q1, q1);
+  }
+  s->ned_to_body_quat.qi = s0->ned_to_body_quat.qi + t * (q1.qi - s0->ned_to_body_quat.qi);
+  s->ned_to_body_quat.qx = s0->ned_to_body_quat.qx + t * (q1.qx - s0->ned_to_body_quat.qx);
+  s->ned_to_body_quat.qy = s0->ned_to_body_quat.qy + t * (q1.qy - s0->ned_to_body_quat.qy);
+  s->ned_to_body_quat.qz = s0->ned_to_body_quat.qz + t * (q1.qz - s0->ned_to_body_quat.qz);
+  float_quat_normalize(&s->ned_to_body_quat);
+  float_eulers_of_quat(&s->ned_to_body_eulers, &s->ned_to_body_quat);
+
+  s->body_rates.p = s0->body_rates.p + t * (s1->body_rates.p - s0->body_rates.p);
+  s->body_rates.q = s0->body_rates.q + t * (s1->body_rates.q - s0->body_rates.q);
+  s->body_rates.r = s0->body_rates.r + t * (s1->body_rates.r - s0->body_rates.r);
+  struct NedCoor_f diff;
+  VECT3_DIFF(diff, s1->ned_pos, s0->ned_pos);
+  VECT3_SUM_SCALED(s->ned_pos, s0->ned_pos, diff, t);
+  VECT3_DIFF(diff, s1->ned_speed, s0->ned_speed);
+  VECT3_SUM_SCALED(s->ned_speed, s0->ned_speed, diff, t);
+  s->agl = s0->agl + t * (s1->agl - s0->agl);
+}
+
+bool_t state_snapshot_at(struct StateSnapshot *s, uint32_t stamp)
+{
+  const uint32_t count = __atomic_load_n(&snapshot_count, __ATOMIC_ACQUIRE);
+  if (count == 0) {
+    return FALSE;
+  }
+  struct StateSnapshot next, prev;
+  slot_read(&next, &snapshot_slots[(count - 1) % STATE_SNAPSHOT_HISTORY_SIZE]);
+  if ((int32_t)(stamp - next.stamp) >= 0) {
+    memcpy(s, &next, sizeof(struct StateSnapshot));
+    return TRUE;
+  }
+
+  const uint32_t nb = Min(count, STATE_SNAPSHOT_HISTORY_SIZE);
+  for (uint32_t k = 1; k < nb; k++) {
+    slot_read(&prev, &snapshot_slots[(count - 1 - k) % STATE_SNAPSHOT_HISTORY_SIZE]);
+    if ((int32_t)(prev.stamp - next.stamp) > 0) {
+      /* slot already overwritten by a newer snapshot, end of the history */
+      break;
+    }
+    if ((int32_t)(stamp - prev.stamp) >= 0) {
+      const float t = (float)(stamp - prev.stamp) / (float)(next.stamp - prev.stamp);
+      snapshot_interpolate(s, &prev, &next, t);
+      s->stamp = stamp;
+      return TRUE;
+    }
+    memcpy(&next, &prev, sizeof(struct StateSnapshot));
+  }
+  /* older than the history */
+  memcpy(s, &next, sizeof(struct StateSnapshot));
+  return FALSE;
+}
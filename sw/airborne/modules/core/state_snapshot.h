@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/core/state_snapshot.h
+ *
+ * Thread safe copies of the state interface.
+ *
+ * The state interface (state.h) converts coordinates lazily and may
+ * only be used from the main thread. This module publishes a fully
+ * converted copy of the main state fields once per periodic cycle,
+ * which any other thread can read without locking.
+ *
+ * Each snapshot is protected by a sequence counter (seqlock):
+ * the main thread never waits, a reader only retries if the main thread
+ * was writing the same slot during the copy.
+ * The last STATE_SNAPSHOT_HISTORY_SIZE snapshots are kept, so that data
+ * with a time stamp (e.g. a camera image) can be matched with the state
+ * at the time it was taken.
+ */
+
+#ifndef STATE_SNAPSHOT_H
+#define STATE_SNAPSHOT_H
+
+#include "std.h"
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_geodetic_float.h"
+
+/** Number of snapshots kept in the history */
+#ifndef STATE_SNAPSHOT_HISTORY_SIZE
+#define STATE_SNAPSHOT_HISTORY_SIZE 32
+#endif
+
+struct StateSnapshot {
+  uint32_t stamp;                  ///< time of the snapshot in usec (sys_time)
+  struct FloatQuat ned_to_body_quat;
+  struct FloatEulers ned_to_body_eulers;
+  struct FloatRates body_rates;    ///< in rad/s
+  struct NedCoor_f ned_pos;        ///< in m
+  struct NedCoor_f ned_speed;      ///< in m/s
+  float agl;                       ///< height above ground from the last AGL measurement in m
+};
+
+/** Initialize the snapshot history */
+extern void state_snapshot_init(void);
+
+/** Copy the current state to a new snapshot.
+ * Main thread only, to be called once per periodic cycle.
+ */
+extern void state_snapshot_publish(void);
+
+/** Get the latest snapshot, from any thread.
+ * @param[out] s copy of the latest snapshot
+ * @return FALSE if nothing was published yet
+ */
+extern bool_t state_snapshot_get(struct StateSnapshot *s);
+
+/** Get the state at a given time, from any thread.
+ * The state is linearly interpolated between the two snapshots around stamp.
+ * If stamp is after the latest snapshot, the latest snapshot is returned.
+ * @param[out] s state at time stamp
+ * @param[in] stamp time in usec (sys_time)
+ * @return FALSE if stamp is older than the history (s is then the oldest
+ *         snapshot available) or if nothing was published yet
+ */
+extern bool_t state_snapshot_at(struct StateSnapshot *s, uint32_t stamp);
+
+#endif /* STATE_SNAPSHOT_H */
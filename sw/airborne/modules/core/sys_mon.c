@@ -136,3 +136,63 @@ void event_sysmon(void)
   n_event++;
 }
 
+
+#if SYS_TIME_PROF
+
+#include "generated/modules.h"
+#include <string.h>
+
+#define TASK_PROF_NB (SYS_TIME_NB_TIMER + MODULES_PROF_NB)
+
+/** Values of the kind field of the TASK_PROF message */
+#define TASK_PROF_KIND_TIMER  0
+#define TASK_PROF_KIND_MODULE 1
+
+/** Next task to report, timers first then module functions */
+static uint16_t task_prof_idx;
+
+static void send_task_prof(uint8_t kind, uint8_t id, struct sys_time_prof *prof, const char *name)
+{
+  uint32_t nb_runs = prof->nb_runs;
+  uint32_t exec_avg = 0, latency_avg = 0;
+  if (nb_runs > 0) {
+    exec_avg = usec_of_cpu_ticks(prof->exec_sum / nb_runs);
+    latency_avg = usec_of_cpu_ticks(prof->latency_sum / nb_runs);
+  }
+  uint32_t exec_min = usec_of_cpu_ticks(prof->exec_min);
+  uint32_t exec_max = usec_of_cpu_ticks(prof->exec_max);
+  uint32_t latency_max = usec_of_cpu_ticks(prof->latency_max);
+  uint32_t overruns = prof->overruns;
+  uint32_t missed_ticks = sys_time.nb_missed_tick;
+
+  DOWNLINK_SEND_TASK_PROF(DefaultChannel, DefaultDevice, &kind, &id, &nb_runs,
+                          &exec_avg, &exec_min, &exec_max, &latency_avg, &latency_max,
+                          &overruns, &missed_ticks, SYS_TIME_PROF_HIST_SIZE, prof->hist,
+                          strlen(name), name);
+  sys_time_prof_reset(prof);
+}
+
+void periodic_report_task_prof(void)
+{
+  /* one task per call, skip the unused timers and the ones only used with a callback */
+  for (uint16_t n = 0; n < TASK_PROF_NB; n++) {
+    uint16_t i = task_prof_idx;
+    task_prof_idx = (task_prof_idx + 1) % TASK_PROF_NB;
+    if (i < SYS_TIME_NB_TIMER) {
+      if (sys_time.timer[i].in_use && sys_time.timer[i].cb == NULL) {
+        send_task_prof(TASK_PROF_KIND_TIMER, i, &sys_time.timer[i].prof, "");
+        return;
+      }
+    } else {
+      i -= SYS_TIME_NB_TIMER;
+      send_task_prof(TASK_PROF_KIND_MODULE, i, &modules_prof[i], modules_prof_name[i]);
+      return;
+    }
+  }
+}
+
+#else
+
+void periodic_report_task_prof(void) {}
+
+#endif /* SYS_TIME_PROF */
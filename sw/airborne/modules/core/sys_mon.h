@@ -61,4 +61,9 @@ void periodic_sysmon(void);
  */
 void event_sysmon(void);
 
+/** Report the statistics of the next timer or module function
+ *  (only with SYS_TIME_PROF)
+ */
+void periodic_report_task_prof(void);
+
 #endif
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/datalink/telemetry_queue_dl.c
+ *
+ * Telemetry from threads other than the main loop.
+ */
+
+#include "modules/datalink/telemetry_queue_dl.h"
+#include "subsystems/datalink/downlink.h"
+
+struct telemetry_queue telemetry_queue;
+
+void telemetry_queue_dl_init(void)
+{
+  telemetry_queue_init(&telemetry_queue);
+}
+
+void telemetry_queue_dl_event(void)
+{
+  telemetry_queue_flush(&telemetry_queue, &(DefaultDevice).device);
+}
+
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/datalink/telemetry_queue_dl.h
+ *
+ * Telemetry from threads other than the main loop.
+ *
+ * Provides a global telemetry queue that threaded modules can push messages
+ * to (see subsystems/datalink/telemetry_queue.h), and flushes it to the
+ * default downlink device in the event loop.
+ */
+
+#ifndef TELEMETRY_QUEUE_DL_H
+#define TELEMETRY_QUEUE_DL_H
+
+#include "subsystems/datalink/telemetry_queue.h"
+
+/** Queue flushed to the default downlink device */
+extern struct telemetry_queue telemetry_queue;
+
+/** Init function */
+extern void telemetry_queue_dl_init(void);
+
+/** Event function, send all queued messages */
+extern void telemetry_queue_dl_event(void);
+
+#endif /* TELEMETRY_QUEUE_DL_H */
+
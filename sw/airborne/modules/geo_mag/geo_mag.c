@@ -38,33 +38,124 @@
 #define GEO_MAG_SENDER_ID 1
 #endif
 
+/** Use an interpolation grid around the first fix and refresh the field at every GPS fix.
+ * Otherwise the field is only computed once on the ground.
+ */
+#ifndef GEO_MAG_USE_GRID
+#define GEO_MAG_USE_GRID FALSE
+#endif
+
 bool_t geo_mag_calc_flag;
 struct GeoMag geo_mag;
 
+/** Current date in decimal year, for example 2012.68 */
+static double geo_mag_date(void)
+{
+  return GPS_EPOCH_BEGIN +
+         (double)gps.week / WEEKS_IN_YEAR +
+         (double)gps.tow / 1000 / SECS_IN_YEAR;
+}
+
+/** send as normalized float vector via ABI */
+static void geo_mag_send(void)
+{
+  struct FloatVect3 h = { .x = geo_mag.vect.x,
+                          .y = geo_mag.vect.y,
+                          .z = geo_mag.vect.z };
+  float_vect3_normalize(&h);
+  AbiSendMsgGEO_MAG(GEO_MAG_SENDER_ID, &h);
+}
+
+#if GEO_MAG_USE_GRID
+PRINT_CONFIG_MSG("GEO_MAG: using an interpolation grid")
+
+/** grid node spacing in degrees,
+ * the interpolation error is below 20 nT with 2 deg and below 5 nT with 1 deg
+ */
+#ifndef GEO_MAG_GRID_STEP
+#define GEO_MAG_GRID_STEP 2.
+#endif
+
+/** altitude of the upper grid layer above the first fix in meters */
+#ifndef GEO_MAG_GRID_ALT_RANGE
+#define GEO_MAG_GRID_ALT_RANGE 10000.
+#endif
+
+/** number of grid nodes computed per event call */
+#ifndef GEO_MAG_GRID_NODES_PER_CALL
+#define GEO_MAG_GRID_NODES_PER_CALL 1
+#endif
+
+static struct WmmGrid geo_mag_grid;
+static bool_t geo_mag_grid_started;
+static abi_event gps_ev;
+
+/** Interpolate the field at each new fix */
+static void gps_cb(uint8_t sender_id __attribute__((unused)),
+                   uint32_t stamp __attribute__((unused)),
+                   struct GpsState *gps_s)
+{
+  if (gps_s->fix != GPS_FIX_3D) {
+    return;
+  }
+  float field[3];
+  if (wmm_grid_lookup(&geo_mag_grid, gps_s->lla_pos.lat / 1e7, gps_s->lla_pos.lon / 1e7,
+                      gps_s->lla_pos.alt / 1e6, field)) {
+    geo_mag.vect.x = field[0];
+    geo_mag.vect.y = field[1];
+    geo_mag.vect.z = field[2];
+    geo_mag_send();
+    geo_mag.ready = TRUE;
+  } else if (geo_mag_grid.nb_ready == WMM_GRID_NB_NODES) {
+    /* left the grid, build a new one around the current position next time on the ground */
+    geo_mag_grid_started = FALSE;
+  }
+}
+#endif
+
 void geo_mag_init(void)
 {
   geo_mag_calc_flag = FALSE;
   geo_mag.ready = FALSE;
+#if GEO_MAG_USE_GRID
+  geo_mag_grid_started = FALSE;
+  geo_mag_grid.nb_ready = 0;
+  AbiBindMsgGPS(ABI_BROADCAST, &gps_ev, gps_cb);
+#endif
 }
 
 void geo_mag_periodic(void)
 {
+#if GEO_MAG_USE_GRID
+  /* the grid nodes are only computed on the ground, interpolation is cheap enough for flight */
+  if (!geo_mag_grid_started && gps.fix == GPS_FIX_3D && kill_throttle) {
+    wmm_grid_init(&geo_mag_grid, geo_mag_date(), gps.lla_pos.lat / 1e7, gps.lla_pos.lon / 1e7,
+                  GEO_MAG_GRID_STEP, gps.lla_pos.alt / 1e6, (gps.lla_pos.alt / 1e3 + GEO_MAG_GRID_ALT_RANGE) / 1e3);
+    geo_mag_grid_started = TRUE;
+  }
+  geo_mag_calc_flag = geo_mag_grid_started && kill_throttle && geo_mag_grid.nb_ready < WMM_GRID_NB_NODES;
+#else
   if (!geo_mag.ready && gps.fix == GPS_FIX_3D && kill_throttle) {
     geo_mag_calc_flag = TRUE;
   }
+#endif
 }
 
 void geo_mag_event(void)
 {
 
+#if GEO_MAG_USE_GRID
+  if (geo_mag_calc_flag) {
+    if (wmm_grid_build(&geo_mag_grid, GEO_MAG_GRID_NODES_PER_CALL)) {
+      geo_mag_calc_flag = FALSE;
+    }
+  }
+#else
   if (geo_mag_calc_flag) {
     double gha[MAXCOEFF]; // Geomag global variables
     int32_t nmax;
 
-    /* Current date in decimal year, for example 2012.68 */
-    double sdate = GPS_EPOCH_BEGIN +
-                   (double)gps.week / WEEKS_IN_YEAR +
-                   (double)gps.tow / 1000 / SECS_IN_YEAR;
+    double sdate = geo_mag_date();
 
     /* LLA Position in decimal degrees and altitude in km */
     double latitude = (double)gps.lla_pos.lat / 1e7;
@@ -78,14 +169,10 @@ void geo_mag_event(void)
              &geo_mag.vect.x, &geo_mag.vect.y, &geo_mag.vect.z,
              IEXT, EXT_COEFF1, EXT_COEFF2, EXT_COEFF3);
 
-    // send as normalized float vector via ABI
-    struct FloatVect3 h = { .x = geo_mag.vect.x,
-                            .y = geo_mag.vect.y,
-                            .z = geo_mag.vect.z };
-    float_vect3_normalize(&h);
-    AbiSendMsgGEO_MAG(GEO_MAG_SENDER_ID, &h);
+    geo_mag_send();
 
     geo_mag.ready = TRUE;
   }
   geo_mag_calc_flag = FALSE;
+#endif
 }
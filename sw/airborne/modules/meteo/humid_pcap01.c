@@ -50,7 +50,10 @@ PCAP01VALUE pcap01Value;
 
 void writePCAP01_SRAM(uint8_t data, uint16_t s_add)
 {
-  while (pcap01_trans.status == I2CTransPending);
+  // wait for the previous transaction, its status is set by i2c_event on linux
+  while (pcap01_trans.status == I2CTransPending) {
+    i2c_event();
+  }
 
   pcap01_trans.buf[0] = 0x90 + (unsigned char)(s_add >> 8);
   pcap01_trans.buf[1] = (unsigned char)(s_add);
@@ -60,12 +63,16 @@ void writePCAP01_SRAM(uint8_t data, uint16_t s_add)
 
 uint8_t readPCAP01_SRAM(uint16_t s_add)
 {
-  while (pcap01_trans.status == I2CTransPending);
+  while (pcap01_trans.status == I2CTransPending) {
+    i2c_event();
+  }
 
   pcap01_trans.buf[0] = 0x10 + (unsigned char)(s_add >> 8);
   pcap01_trans.buf[1] = (unsigned char)(s_add);
   i2c_transceive(&PCAP01_I2C_DEV, &pcap01_trans, PCAP01_ADDR, 2, 1);
-  while (pcap01_trans.status == I2CTransPending);
+  while (pcap01_trans.status == I2CTransPending) {
+    i2c_event();
+  }
 
   return pcap01_trans.buf[0];
 }
@@ -84,7 +91,9 @@ uint8_t readPCAP01_SRAM(uint16_t s_add)
 */
 void PCAP01_Control(uint8_t control)
 {
-  while (pcap01_trans.status == I2CTransPending);
+  while (pcap01_trans.status == I2CTransPending) {
+    i2c_event();
+  }
 
   pcap01_trans.buf[0] = control;
   pcap01_trans.buf[1] = 0;
@@ -95,7 +104,9 @@ void PCAP01_Control(uint8_t control)
 
 void pcap01writeRegister(uint8_t reg, uint32_t value)
 {
-  while (pcap01_trans.status == I2CTransPending);
+  while (pcap01_trans.status == I2CTransPending) {
+    i2c_event();
+  }
 
   pcap01_trans.buf[0] = PCAP01_WRITE_REG + reg;
   pcap01_trans.buf[1] = (unsigned char)(value >> 16);
@@ -64,7 +64,10 @@ void imu_impl_init(void)
   aspirin2_mpu60x0.buf[0] = MPU60X0_REG_PWR_MGMT_1;
   aspirin2_mpu60x0.buf[1] = 0x01;
   i2c_transmit(&PPZUAVIMU_I2C_DEV, &aspirin2_mpu60x0, MPU60X0_ADDR, 2);
-  while (aspirin2_mpu60x0.status == I2CTransPending);
+  // i2c_event sets the status when the bus runs in a thread (linux)
+  while (aspirin2_mpu60x0.status == I2CTransPending) {
+    i2c_event();
+  }
 
   // MPU60X0_REG_PWR_MGMT_2: Nothing should be in standby: default OK
 
@@ -84,28 +87,36 @@ void imu_impl_init(void)
   aspirin2_mpu60x0.buf[0] = MPU60X0_REG_CONFIG;
   aspirin2_mpu60x0.buf[1] = (2 << 3) | (3 << 0);
   i2c_transmit(&PPZUAVIMU_I2C_DEV, &aspirin2_mpu60x0, MPU60X0_ADDR, 2);
-  while (aspirin2_mpu60x0.status == I2CTransPending);
+  while (aspirin2_mpu60x0.status == I2CTransPending) {
+    i2c_event();
+  }
 
   // MPU60X0_REG_SMPLRT_DIV
   // -100Hz output = 1kHz / (9 + 1)
   aspirin2_mpu60x0.buf[0] = MPU60X0_REG_SMPLRT_DIV;
   aspirin2_mpu60x0.buf[1] = 9;
   i2c_transmit(&PPZUAVIMU_I2C_DEV, &aspirin2_mpu60x0, MPU60X0_ADDR, 2);
-  while (aspirin2_mpu60x0.status == I2CTransPending);
+  while (aspirin2_mpu60x0.status == I2CTransPending) {
+    i2c_event();
+  }
 
   // MPU60X0_REG_GYRO_CONFIG
   // -2000deg/sec
   aspirin2_mpu60x0.buf[0] = MPU60X0_REG_GYRO_CONFIG;
   aspirin2_mpu60x0.buf[1] = (3 << 3);
   i2c_transmit(&PPZUAVIMU_I2C_DEV, &aspirin2_mpu60x0, MPU60X0_ADDR, 2);
-  while (aspirin2_mpu60x0.status == I2CTransPending);
+  while (aspirin2_mpu60x0.status == I2CTransPending) {
+    i2c_event();
+  }
 
   // MPU60X0_REG_ACCEL_CONFIG
   // 16g, no HPFL
   aspirin2_mpu60x0.buf[0] = MPU60X0_REG_ACCEL_CONFIG;
   aspirin2_mpu60x0.buf[1] = (3 << 3);
   i2c_transmit(&PPZUAVIMU_I2C_DEV, &aspirin2_mpu60x0, MPU60X0_ADDR, 2);
-  while (aspirin2_mpu60x0.status == I2CTransPending);
+  while (aspirin2_mpu60x0.status == I2CTransPending) {
+    i2c_event();
+  }
 
 
 
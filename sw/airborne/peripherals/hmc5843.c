@@ -31,21 +31,28 @@ static void send_config(void)
   hmc5843.i2c_trans.buf[1] = 0x00 | (0x06 << 2);
   hmc5843.i2c_trans.len_w = 2;
   i2c_submit(&HMC5843_I2C_DEV, &hmc5843.i2c_trans);
-  while (hmc5843.i2c_trans.status == I2CTransPending);
+  // the status is set by i2c_event on archs running the bus in a thread (linux)
+  while (hmc5843.i2c_trans.status == I2CTransPending) {
+    i2c_event();
+  }
 
   hmc5843.i2c_trans.type = I2CTransTx;
   hmc5843.i2c_trans.buf[0] = HMC5843_REG_CFGB;  // set to gain to 1 Gauss
   hmc5843.i2c_trans.buf[1] = 0x01 << 5;
   hmc5843.i2c_trans.len_w = 2;
   i2c_submit(&HMC5843_I2C_DEV, &hmc5843.i2c_trans);
-  while (hmc5843.i2c_trans.status == I2CTransPending);
+  while (hmc5843.i2c_trans.status == I2CTransPending) {
+    i2c_event();
+  }
 
   hmc5843.i2c_trans.type = I2CTransTx;
   hmc5843.i2c_trans.buf[0] = HMC5843_REG_MODE;  // set to continuous mode
   hmc5843.i2c_trans.buf[1] = 0x00;
   hmc5843.i2c_trans.len_w = 2;
   i2c_submit(&HMC5843_I2C_DEV, &hmc5843.i2c_trans);
-  while (hmc5843.i2c_trans.status == I2CTransPending);
+  while (hmc5843.i2c_trans.status == I2CTransPending) {
+    i2c_event();
+  }
 
 }
 
@@ -113,12 +120,16 @@ void hmc5843_periodic(void)
     hmc5843.i2c_trans.len_w = 1;
     hmc5843.i2c_trans.buf[0] = 0x3;
     i2c_submit(&HMC5843_I2C_DEV, &hmc5843.i2c_trans);
-    while (hmc5843.i2c_trans.status == I2CTransPending || hmc5843.i2c_trans.status == I2CTransRunning);
+    while (hmc5843.i2c_trans.status == I2CTransPending || hmc5843.i2c_trans.status == I2CTransRunning) {
+      i2c_event();
+    }
 
     hmc5843.i2c_trans.type = I2CTransRx;
     hmc5843.i2c_trans.len_r = 6;
     i2c_submit(&HMC5843_I2C_DEV, &hmc5843.i2c_trans);
-    while (hmc5843.i2c_trans.status == I2CTransPending || hmc5843.i2c_trans.status == I2CTransRunning);
+    while (hmc5843.i2c_trans.status == I2CTransPending || hmc5843.i2c_trans.status == I2CTransRunning) {
+      i2c_event();
+    }
     hmc5843.timeout = 0;
   }
 
@@ -46,6 +46,29 @@ void mpu60x0_set_default_config(struct Mpu60x0Config *c)
   c->nb_slaves = 0;
 
   c->i2c_bypass = FALSE;
+  c->fifo_enable = FALSE;
+}
+
+uint32_t mpu60x0_sample_period(struct Mpu60x0Config *c)
+{
+  /* gyro output rate is 8kHz with the largest low pass bandwidths, 1kHz otherwise */
+  uint32_t period = (c->dlpf_cfg == MPU60X0_DLPF_256HZ || c->dlpf_cfg == 7) ? 125 : 1000;
+  return period * (1 + c->smplrt_div);
+}
+
+void mpu60x0_fifo_decode(struct Mpu60x0Fifo *fifo, volatile uint8_t *buf, uint8_t nb, uint32_t period)
+{
+  for (uint8_t i = 0; i < nb; i++) {
+    volatile uint8_t *s = buf + i * MPU60X0_FIFO_SAMPLE_SIZE;
+    for (uint8_t j = 0; j < 3; j++) {
+      fifo->accel[i][j] = (int16_t)((s[2 * j] << 8) | s[2 * j + 1]);
+      fifo->rates[i][j] = (int16_t)((s[6 + 2 * j] << 8) | s[6 + 2 * j + 1]);
+    }
+    /* the last sample of the FIFO was taken at the time of the count */
+    fifo->stamp[i] = fifo->count_stamp - (fifo->nb_available - 1 - i) * period;
+  }
+  fifo->nb_samples = nb;
+  fifo->sample_cnt += nb;
 }
 
 void mpu60x0_send_config(Mpu60x0ConfigSet mpu_set, void *mpu, struct Mpu60x0Config *config)
@@ -104,6 +127,23 @@ void mpu60x0_send_config(Mpu60x0ConfigSet mpu_set, void *mpu, struct Mpu60x0Conf
       mpu_set(mpu, MPU60X0_REG_INT_ENABLE, (config->drdy_int_enable << 0));
       config->init_status++;
       break;
+    case MPU60X0_CONF_FIFO_EN:
+      /* store gyro and accel samples in the FIFO */
+      if (config->fifo_enable) {
+        mpu_set(mpu, MPU60X0_REG_FIFO_EN, ((1 << MPU60X0_XG_FIFO_EN) |
+                                           (1 << MPU60X0_YG_FIFO_EN) |
+                                           (1 << MPU60X0_ZG_FIFO_EN) |
+                                           (1 << MPU60X0_ACCEL_FIFO_EN)));
+      }
+      config->init_status++;
+      break;
+    case MPU60X0_CONF_FIFO_START:
+      /* enable FIFO, already done with the I2C master bits when using slaves */
+      if (config->fifo_enable && config->nb_slaves == 0) {
+        mpu_set(mpu, MPU60X0_REG_USER_CTRL, (1 << MPU60X0_FIFO_EN));
+      }
+      config->init_status++;
+      break;
     case MPU60X0_CONF_DONE:
       config->initialized = TRUE;
       break;
@@ -29,6 +29,7 @@
 #define MPU60X0_H
 
 #include "std.h"
+#include "math/pprz_algebra_int.h"
 
 /* Include address and register definition */
 #include "peripherals/mpu60x0_regs.h"
@@ -57,9 +58,53 @@ enum Mpu60x0ConfStatus {
   MPU60X0_CONF_ACCEL,
   MPU60X0_CONF_I2C_SLAVES,
   MPU60X0_CONF_INT_ENABLE,
+  MPU60X0_CONF_FIFO_EN,
+  MPU60X0_CONF_FIFO_START,
   MPU60X0_CONF_DONE
 };
 
+/// FIFO size in bytes
+#define MPU60X0_FIFO_SIZE 1024
+/// Bytes per sample in the FIFO: accel and gyro
+#define MPU60X0_FIFO_SAMPLE_SIZE 12
+/** Gyro and accel output rate in FIFO mode in Hz.
+ * 2kHz is the default rate of the IMU drivers at PERIODIC_FREQUENCY 512,
+ * set it (IMU_MPU_FIFO_SAMPLE_FREQ) with a different sample rate.
+ */
+#ifndef MPU60X0_FIFO_SAMPLE_FREQ
+#define MPU60X0_FIFO_SAMPLE_FREQ 2000
+#endif
+/** Poll frequency of the FIFO in Hz.
+ * Each poll is a count and a burst read: 32Hz polls are 64 bus transactions
+ * per second instead of 512 in register mode, for up to 31ms of latency.
+ */
+#ifndef MPU60X0_FIFO_POLL_FREQ
+#define MPU60X0_FIFO_POLL_FREQ 32
+#endif
+/// Maximum number of samples read in one burst: the samples between two polls and 25% for late polls
+#ifndef MPU60X0_FIFO_MAX_SAMPLES
+#define MPU60X0_FIFO_MAX_SAMPLES ((5 * MPU60X0_FIFO_SAMPLE_FREQ) / (4 * MPU60X0_FIFO_POLL_FREQ) + 1)
+#endif
+#if MPU60X0_FIFO_MAX_SAMPLES > MPU60X0_FIFO_SIZE / MPU60X0_FIFO_SAMPLE_SIZE
+#error "MPU60X0_FIFO_POLL_FREQ too low for MPU60X0_FIFO_SAMPLE_FREQ, the FIFO would overflow between polls"
+#endif
+
+/** Samples read from the FIFO.
+ * The sample rate of the MPU is used to interpolate the time of each sample
+ * from the time the FIFO count was read.
+ */
+struct Mpu60x0Fifo {
+  int16_t accel[MPU60X0_FIFO_MAX_SAMPLES][3]; ///< accel samples of the last burst
+  int16_t rates[MPU60X0_FIFO_MAX_SAMPLES][3]; ///< gyro samples of the last burst
+  uint32_t stamp[MPU60X0_FIFO_MAX_SAMPLES];   ///< time of each sample in usec
+  uint8_t nb_samples;                         ///< number of samples in the last burst
+  uint16_t nb_available;                      ///< number of samples in the FIFO at the last count
+  uint32_t count_stamp;                       ///< time of the last FIFO count in usec
+  uint32_t sample_cnt;                        ///< total number of samples read
+  uint32_t trans_cnt;                         ///< total number of bus transactions in FIFO mode
+  uint16_t overflow_cnt;                      ///< number of FIFO overflows, samples were lost
+};
+
 /// Configuration function prototype
 typedef void (*Mpu60x0ConfigSet)(void *mpu, uint8_t _reg, uint8_t _val);
 
@@ -90,10 +135,25 @@ struct Mpu60x0Config {
   struct Mpu60x0I2cSlave slaves[5];     ///< I2C slaves
   enum Mpu60x0MstClk i2c_mst_clk;       ///< MPU I2C master clock speed
   uint8_t i2c_mst_delay;                ///< MPU I2C slaves delayed sample rate
+
+  /** Read gyro and accel from the FIFO.
+   * All the samples since the last read are read in one burst.
+   * Only effective if using the SPI implementation.
+   */
+  bool_t fifo_enable;
 };
 
 extern void mpu60x0_set_default_config(struct Mpu60x0Config *c);
 
+/// Sample period in usec from the configured sample rate
+extern uint32_t mpu60x0_sample_period(struct Mpu60x0Config *c);
+
+/** Decode a burst of samples read from the FIFO.
+ * The nb oldest samples of the FIFO are in buf, fifo->nb_available and
+ * fifo->count_stamp must be set from the FIFO count read before.
+ */
+extern void mpu60x0_fifo_decode(struct Mpu60x0Fifo *fifo, volatile uint8_t *buf, uint8_t nb, uint32_t period);
+
 /// Configuration sequence called once before normal use
 extern void mpu60x0_send_config(Mpu60x0ConfigSet mpu_set, void *mpu, struct Mpu60x0Config *config);
 
@@ -127,6 +127,13 @@
 #define MPU60X0_I2C_MST_EN        5
 #define MPU60X0_FIFO_EN             6
 
+// in MPU60X0_REG_FIFO_EN
+#define MPU60X0_TEMP_FIFO_EN        7
+#define MPU60X0_XG_FIFO_EN          6
+#define MPU60X0_YG_FIFO_EN          5
+#define MPU60X0_ZG_FIFO_EN          4
+#define MPU60X0_ACCEL_FIFO_EN       3
+
 // in MPU60X0_REG_I2C_MST_STATUS
 #define MPU60X0_I2C_SLV4_DONE       6
 
@@ -27,6 +27,8 @@
  */
 
 #include "peripherals/mpu60x0_spi.h"
+#include "mcu_periph/sys_time.h"
+#include <string.h>
 
 void mpu60x0_spi_init(struct Mpu60x0_Spi *mpu, struct spi_periph *spi_p, uint8_t slave_idx)
 {
@@ -60,6 +62,9 @@ void mpu60x0_spi_init(struct Mpu60x0_Spi *mpu, struct spi_periph *spi_p, uint8_t
   mpu->config.init_status = MPU60X0_CONF_UNINIT;
 
   mpu->slave_init_status = MPU60X0_SPI_CONF_UNINIT;
+
+  memset(&mpu->fifo, 0, sizeof(struct Mpu60x0Fifo));
+  mpu->fifo_state = MPU60X0_SPI_FIFO_COUNT;
 }
 
 
@@ -84,15 +89,120 @@ void mpu60x0_spi_start_configure(struct Mpu60x0_Spi *mpu)
   }
 }
 
-void mpu60x0_spi_read(struct Mpu60x0_Spi *mpu)
+/// USER_CTRL bits set when using I2C slaves
+static inline uint8_t mpu60x0_spi_user_ctrl(struct Mpu60x0_Spi *mpu)
 {
-  if (mpu->config.initialized && mpu->spi_trans.status == SPITransDone) {
+  if (mpu->config.nb_slaves > 0) {
+    return ((1 << MPU60X0_I2C_IF_DIS) | (1 << MPU60X0_I2C_MST_EN));
+  }
+  return 0;
+}
+
+/** Start reading the FIFO count.
+ * When using I2C slaves, all registers from status to FIFO count are read
+ * to get the slaves data in the same transaction.
+ */
+static void mpu60x0_spi_fifo_read(struct Mpu60x0_Spi *mpu)
+{
+  if (mpu->fifo_state == MPU60X0_SPI_FIFO_RESET || mpu->fifo_state == MPU60X0_SPI_FIFO_ENABLE) {
+    /* reset failed, try again */
+    mpu->fifo_state = MPU60X0_SPI_FIFO_RESET;
+    mpu60x0_spi_write_to_reg(mpu, MPU60X0_REG_USER_CTRL, mpu60x0_spi_user_ctrl(mpu) | (1 << MPU60X0_FIFO_RESET));
+  } else {
+    mpu->fifo_state = MPU60X0_SPI_FIFO_COUNT;
     mpu->spi_trans.output_length = 1;
-    mpu->spi_trans.input_length = 1 + mpu->config.nb_bytes;
-    /* set read bit and multiple byte bit, then address */
-    mpu->tx_buf[0] = MPU60X0_REG_INT_STATUS | MPU60X0_SPI_READ;
+    if (mpu->config.nb_slaves > 0) {
+      mpu->spi_trans.input_length = 2 + MPU60X0_REG_FIFO_COUNT_L - MPU60X0_REG_INT_STATUS;
+      mpu->tx_buf[0] = MPU60X0_REG_INT_STATUS | MPU60X0_SPI_READ;
+    } else {
+      mpu->spi_trans.input_length = 3;
+      mpu->tx_buf[0] = MPU60X0_REG_FIFO_COUNT_H | MPU60X0_SPI_READ;
+    }
     spi_submit(mpu->spi_p, &(mpu->spi_trans));
   }
+  mpu->fifo.trans_cnt++;
+}
+
+/// Handle a successful transaction in FIFO mode
+static void mpu60x0_spi_fifo_event(struct Mpu60x0_Spi *mpu)
+{
+  switch (mpu->fifo_state) {
+    case MPU60X0_SPI_FIFO_COUNT: {
+      uint8_t idx = 1;
+      if (mpu->config.nb_slaves > 0) {
+        /* copy the ext_sens_data, the buffer is only written by the spi driver
+         * before the transaction is done */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+        memcpy(mpu->data_ext, (uint8_t *) & (mpu->rx_buf[16]), mpu->config.nb_bytes - 15);
+#pragma GCC diagnostic pop
+        idx += MPU60X0_REG_FIFO_COUNT_H - MPU60X0_REG_INT_STATUS;
+      }
+      uint16_t count = (mpu->rx_buf[idx] << 8) | mpu->rx_buf[idx + 1];
+      if (count > MPU60X0_FIFO_SIZE - MPU60X0_FIFO_SAMPLE_SIZE) {
+        /* samples were lost and the next ones may not be aligned: reset the FIFO */
+        mpu->fifo.overflow_cnt++;
+        mpu->fifo_state = MPU60X0_SPI_FIFO_RESET;
+        mpu60x0_spi_write_to_reg(mpu, MPU60X0_REG_USER_CTRL, mpu60x0_spi_user_ctrl(mpu) | (1 << MPU60X0_FIFO_RESET));
+        mpu->fifo.trans_cnt++;
+        break;
+      }
+      mpu->fifo.count_stamp = get_sys_time_usec();
+      mpu->fifo.nb_available = count / MPU60X0_FIFO_SAMPLE_SIZE;
+      uint8_t nb = Min(mpu->fifo.nb_available, MPU60X0_FIFO_MAX_SAMPLES);
+      if (nb == 0) {
+        mpu->spi_trans.status = SPITransDone;
+        break;
+      }
+      /* read the oldest samples in one burst */
+      mpu->fifo_state = MPU60X0_SPI_FIFO_DATA;
+      mpu->spi_trans.output_length = 1;
+      mpu->spi_trans.input_length = 1 + nb * MPU60X0_FIFO_SAMPLE_SIZE;
+      mpu->tx_buf[0] = MPU60X0_REG_FIFO_R_W | MPU60X0_SPI_READ;
+      spi_submit(mpu->spi_p, &(mpu->spi_trans));
+      mpu->fifo.trans_cnt++;
+      break;
+    }
+    case MPU60X0_SPI_FIFO_DATA: {
+      uint8_t nb = (mpu->spi_trans.input_length - 1) / MPU60X0_FIFO_SAMPLE_SIZE;
+      mpu60x0_fifo_decode(&mpu->fifo, &mpu->rx_buf[1], nb, mpu60x0_sample_period(&mpu->config));
+      /* latest sample also available as regular data */
+      for (uint8_t i = 0; i < 3; i++) {
+        mpu->data_accel.value[i] = mpu->fifo.accel[nb - 1][i];
+        mpu->data_rates.value[i] = mpu->fifo.rates[nb - 1][i];
+      }
+      mpu->data_available = TRUE;
+      mpu->fifo_state = MPU60X0_SPI_FIFO_COUNT;
+      mpu->spi_trans.status = SPITransDone;
+      break;
+    }
+    case MPU60X0_SPI_FIFO_RESET:
+      /* enable the FIFO again */
+      mpu->fifo_state = MPU60X0_SPI_FIFO_ENABLE;
+      mpu60x0_spi_write_to_reg(mpu, MPU60X0_REG_USER_CTRL, mpu60x0_spi_user_ctrl(mpu) | (1 << MPU60X0_FIFO_EN));
+      mpu->fifo.trans_cnt++;
+      break;
+    case MPU60X0_SPI_FIFO_ENABLE:
+    default:
+      mpu->fifo_state = MPU60X0_SPI_FIFO_COUNT;
+      mpu->spi_trans.status = SPITransDone;
+      break;
+  }
+}
+
+void mpu60x0_spi_read(struct Mpu60x0_Spi *mpu)
+{
+  if (mpu->config.initialized && mpu->spi_trans.status == SPITransDone) {
+    if (mpu->config.fifo_enable) {
+      mpu60x0_spi_fifo_read(mpu);
+    } else {
+      mpu->spi_trans.output_length = 1;
+      mpu->spi_trans.input_length = 1 + mpu->config.nb_bytes;
+      /* set read bit and multiple byte bit, then address */
+      mpu->tx_buf[0] = MPU60X0_REG_INT_STATUS | MPU60X0_SPI_READ;
+      spi_submit(mpu->spi_p, &(mpu->spi_trans));
+    }
+  }
 }
 
 #define Int16FromBuf(_buf,_idx) ((int16_t)((_buf[_idx]<<8) | _buf[_idx+1]))
@@ -101,7 +211,12 @@ void mpu60x0_spi_event(struct Mpu60x0_Spi *mpu)
 {
   if (mpu->config.initialized) {
     if (mpu->spi_trans.status == SPITransFailed) {
+      if (mpu->fifo_state == MPU60X0_SPI_FIFO_DATA) {
+        mpu->fifo_state = MPU60X0_SPI_FIFO_COUNT;
+      }
       mpu->spi_trans.status = SPITransDone;
+    } else if (mpu->spi_trans.status == SPITransSuccess && mpu->config.fifo_enable) {
+      mpu60x0_spi_fifo_event(mpu);
     } else if (mpu->spi_trans.status == SPITransSuccess) {
       // Successfull reading
       if (bit_is_set(mpu->rx_buf[1], 0)) {
@@ -171,7 +286,8 @@ bool_t mpu60x0_configure_i2c_slaves(Mpu60x0ConfigSet mpu_set, void *mpu)
     case MPU60X0_SPI_CONF_I2C_MST_EN:
       /* enable internal I2C master and disable primary I2C interface */
       mpu_set(mpu, MPU60X0_REG_USER_CTRL, ((1 << MPU60X0_I2C_IF_DIS) |
-                                           (1 << MPU60X0_I2C_MST_EN)));
+                                           (1 << MPU60X0_I2C_MST_EN) |
+                                           (mpu_spi->config.fifo_enable << MPU60X0_FIFO_EN)));
       mpu_spi->slave_init_status++;
       break;
     case MPU60X0_SPI_CONF_SLAVES_CONFIGURE:
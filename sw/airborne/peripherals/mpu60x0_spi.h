@@ -38,6 +38,17 @@
 
 #define MPU60X0_BUFFER_LEN 32
 #define MPU60X0_BUFFER_EXT_LEN 16
+/// Buffer length in FIFO mode: a burst of samples, or the registers from status to FIFO count
+#define MPU60X0_FIFO_BUFFER_LEN Max(1 + MPU60X0_FIFO_MAX_SAMPLES * MPU60X0_FIFO_SAMPLE_SIZE, \
+                                    2 + MPU60X0_REG_FIFO_COUNT_L - MPU60X0_REG_INT_STATUS)
+
+/// Transaction in progress in FIFO mode
+enum Mpu60x0SpiFifoState {
+  MPU60X0_SPI_FIFO_COUNT,   ///< read the FIFO count
+  MPU60X0_SPI_FIFO_DATA,    ///< read a burst of samples
+  MPU60X0_SPI_FIFO_RESET,   ///< reset the FIFO after an overflow
+  MPU60X0_SPI_FIFO_ENABLE   ///< enable the FIFO after a reset
+};
 
 enum Mpu60x0SpiSlaveInitStatus {
   MPU60X0_SPI_CONF_UNINIT,
@@ -52,7 +63,7 @@ struct Mpu60x0_Spi {
   struct spi_periph *spi_p;
   struct spi_transaction spi_trans;
   volatile uint8_t tx_buf[2];
-  volatile uint8_t rx_buf[MPU60X0_BUFFER_LEN];
+  volatile uint8_t rx_buf[Max(MPU60X0_BUFFER_LEN, MPU60X0_FIFO_BUFFER_LEN)];
   volatile bool_t data_available;     ///< data ready flag
   union {
     struct Int16Vect3 vect;           ///< accel data vector in accel coordinate system
@@ -66,6 +77,8 @@ struct Mpu60x0_Spi {
   uint8_t data_ext[MPU60X0_BUFFER_EXT_LEN];
   struct Mpu60x0Config config;
   enum Mpu60x0SpiSlaveInitStatus slave_init_status;
+  struct Mpu60x0Fifo fifo;            ///< samples and statistics in FIFO mode
+  enum Mpu60x0SpiFifoState fifo_state;
 };
 
 // Functions
@@ -28,6 +28,7 @@
 #define MPU9250_H
 
 #include "std.h"
+#include "math/pprz_algebra_int.h"
 
 /* Include address and register definition */
 #include "peripherals/mpu9250_regs.h"
@@ -59,9 +60,54 @@ enum Mpu9250ConfStatus {
   MPU9250_CONF_ACCEL,
   MPU9250_CONF_I2C_SLAVES,
   MPU9250_CONF_INT_ENABLE,
+  MPU9250_CONF_FIFO_EN,
+  MPU9250_CONF_FIFO_START,
   MPU9250_CONF_DONE
 };
 
+/// FIFO size in bytes
+#define MPU9250_FIFO_SIZE 512
+/// Bytes per sample in the FIFO: accel and gyro
+#define MPU9250_FIFO_SAMPLE_SIZE 12
+/** Gyro and accel output rate in FIFO mode in Hz.
+ * 2kHz is the default rate of the IMU drivers at PERIODIC_FREQUENCY 512,
+ * set it (IMU_MPU9250_FIFO_SAMPLE_FREQ) with a different sample rate.
+ */
+#ifndef MPU9250_FIFO_SAMPLE_FREQ
+#define MPU9250_FIFO_SAMPLE_FREQ 2000
+#endif
+/** Poll frequency of the FIFO in Hz.
+ * Each poll is a count and a burst read: 64Hz polls are 128 bus transactions
+ * per second instead of 512 in register mode, for up to 16ms of latency.
+ * The 512 bytes FIFO only holds 42 samples, don't poll slower at 2kHz.
+ */
+#ifndef MPU9250_FIFO_POLL_FREQ
+#define MPU9250_FIFO_POLL_FREQ 64
+#endif
+/// Maximum number of samples read in one burst: the samples between two polls and 25% for late polls
+#ifndef MPU9250_FIFO_MAX_SAMPLES
+#define MPU9250_FIFO_MAX_SAMPLES ((5 * MPU9250_FIFO_SAMPLE_FREQ) / (4 * MPU9250_FIFO_POLL_FREQ) + 1)
+#endif
+#if MPU9250_FIFO_MAX_SAMPLES > MPU9250_FIFO_SIZE / MPU9250_FIFO_SAMPLE_SIZE
+#error "MPU9250_FIFO_POLL_FREQ too low for MPU9250_FIFO_SAMPLE_FREQ, the FIFO would overflow between polls"
+#endif
+
+/** Samples read from the FIFO.
+ * The sample rate of the MPU is used to interpolate the time of each sample
+ * from the time the FIFO count was read.
+ */
+struct Mpu9250Fifo {
+  int16_t accel[MPU9250_FIFO_MAX_SAMPLES][3]; ///< accel samples of the last burst
+  int16_t rates[MPU9250_FIFO_MAX_SAMPLES][3]; ///< gyro samples of the last burst
+  uint32_t stamp[MPU9250_FIFO_MAX_SAMPLES];   ///< time of each sample in usec
+  uint8_t nb_samples;                         ///< number of samples in the last burst
+  uint16_t nb_available;                      ///< number of samples in the FIFO at the last count
+  uint32_t count_stamp;                       ///< time of the last FIFO count in usec
+  uint32_t sample_cnt;                        ///< total number of samples read
+  uint32_t trans_cnt;                         ///< total number of bus transactions in FIFO mode
+  uint16_t overflow_cnt;                      ///< number of FIFO overflows, samples were lost
+};
+
 /// Configuration function prototype
 typedef void (*Mpu9250ConfigSet)(void *mpu, uint8_t _reg, uint8_t _val);
 
@@ -93,10 +139,25 @@ struct Mpu9250Config {
   struct Mpu9250I2cSlave slaves[5];     ///< I2C slaves
   enum Mpu9250MstClk i2c_mst_clk;       ///< MPU I2C master clock speed
   uint8_t i2c_mst_delay;                ///< MPU I2C slaves delayed sample rate
+
+  /** Read gyro and accel from the FIFO.
+   * All the samples since the last read are read in one burst.
+   * Only effective if using the SPI implementation.
+   */
+  bool_t fifo_enable;
 };
 
 extern void mpu9250_set_default_config(struct Mpu9250Config *c);
 
+/// Sample period in usec from the configured sample rate
+extern uint32_t mpu9250_sample_period(struct Mpu9250Config *c);
+
+/** Decode a burst of samples read from the FIFO.
+ * The nb oldest samples of the FIFO are in buf, fifo->nb_available and
+ * fifo->count_stamp must be set from the FIFO count read before.
+ */
+extern void mpu9250_fifo_decode(struct Mpu9250Fifo *fifo, volatile uint8_t *buf, uint8_t nb, uint32_t period);
+
 /// Configuration sequence called once before normal use
 extern void mpu9250_send_config(Mpu9250ConfigSet mpu_set, void *mpu, struct Mpu9250Config *config);
 
@@ -38,6 +38,17 @@
 
 #define MPU9250_BUFFER_LEN 32
 #define MPU9250_BUFFER_EXT_LEN 16
+/// Buffer length in FIFO mode: a burst of samples, or the registers from status to FIFO count
+#define MPU9250_FIFO_BUFFER_LEN Max(1 + MPU9250_FIFO_MAX_SAMPLES * MPU9250_FIFO_SAMPLE_SIZE, \
+                                    2 + MPU9250_REG_FIFO_COUNT_L - MPU9250_REG_INT_STATUS)
+
+/// Transaction in progress in FIFO mode
+enum Mpu9250SpiFifoState {
+  MPU9250_SPI_FIFO_COUNT,   ///< read the FIFO count
+  MPU9250_SPI_FIFO_DATA,    ///< read a burst of samples
+  MPU9250_SPI_FIFO_RESET,   ///< reset the FIFO after an overflow
+  MPU9250_SPI_FIFO_ENABLE   ///< enable the FIFO after a reset
+};
 
 enum Mpu9250SpiSlaveInitStatus {
   MPU9250_SPI_CONF_UNINIT,
@@ -52,7 +63,7 @@ struct Mpu9250_Spi {
   struct spi_periph *spi_p;
   struct spi_transaction spi_trans;
   volatile uint8_t tx_buf[2];
-  volatile uint8_t rx_buf[MPU9250_BUFFER_LEN];
+  volatile uint8_t rx_buf[Max(MPU9250_BUFFER_LEN, MPU9250_FIFO_BUFFER_LEN)];
   volatile bool_t data_available;     ///< data ready flag
   union {
     struct Int16Vect3 vect;           ///< accel data vector in accel coordinate system
@@ -65,6 +76,8 @@ struct Mpu9250_Spi {
   uint8_t data_ext[MPU9250_BUFFER_EXT_LEN];
   struct Mpu9250Config config;
   enum Mpu9250SpiSlaveInitStatus slave_init_status;
+  struct Mpu9250Fifo fifo;            ///< samples and statistics in FIFO mode
+  enum Mpu9250SpiFifoState fifo_state;
 };
 
 // Functions
@@ -55,10 +55,13 @@ typedef void (*abi_callback)(void);
  */
 #define ABI_BROADCAST 0
 
+struct abi_ring;
+
 /** Event structure to store callbacks in a linked list */
 struct abi_struct {
   uint8_t id;
   abi_callback cb;
+  struct abi_ring *ring;    ///< NULL if the callback is called by the sender, else ring of message copies
   struct abi_struct *next;
 };
 typedef struct abi_struct abi_event;
@@ -67,5 +70,155 @@ typedef struct abi_struct abi_event;
 #define ABI_FOREACH(head,el) for(el=head; el; el=el->next)
 #define ABI_PREPEND(head,add) { (add)->next = head; head = add; }
 
+/** @defgroup abi_queue Queued ABI events
+ *
+ * Callbacks bound with AbiBindMsg are called by the sender, from its thread.
+ * A subscriber running in another thread binds with AbiBindQueuedMsg instead:
+ * each message is then copied (including the structures passed by pointer)
+ * into a ring owned by this event, and the callback is called when the
+ * subscriber thread calls abi_queue_dispatch() on its queue.
+ *
+ * Each ring has a single producer and a single consumer and needs no lock:
+ * a message bound to a queued event must only be sent from one thread.
+ * When a ring is full, new messages are dropped and counted.
+ * Queued events must be bound before the threads using them are started.
+ *
+ * abi_main_queue is dispatched by the main loop, for main thread modules
+ * receiving messages sent by other threads.
+ * @{
+ */
+
+/** Ordered accesses to the ring indexes.
+ * Rings are shared between threads on Linux, the MCUs are single core
+ * and only need a compiler barrier (no atomic support on all of them).
+ */
+#ifdef __linux__
+#define ABI_LOAD_ACQUIRE(_x) __atomic_load_n(&(_x), __ATOMIC_ACQUIRE)
+#define ABI_STORE_RELEASE(_x, _v) __atomic_store_n(&(_x), (_v), __ATOMIC_RELEASE)
+#else
+#define ABI_LOAD_ACQUIRE(_x) ({ uint32_t _tmp = (_x); __asm__ volatile("" ::: "memory"); _tmp; })
+#define ABI_STORE_RELEASE(_x, _v) { __asm__ volatile("" ::: "memory"); (_x) = (_v); }
+#endif
+
+/** Unpack a message copy and call the callback of the event */
+typedef void (*abi_deliver)(abi_event *ev, void *msg);
+
+struct abi_queue;
+
+/** Ring of message copies of one queued event */
+struct abi_ring {
+  abi_event *ev;                ///< event of the ring
+  abi_deliver deliver;          ///< unpack function of the message
+  struct abi_queue *queue;      ///< queue dispatching this ring
+  uint8_t *buf;                 ///< nb_slots message copies of size bytes
+  uint16_t size;                ///< size of a message copy
+  uint16_t nb_slots;            ///< number of message copies, power of 2
+  volatile uint32_t head;       ///< next slot written by the sender
+  volatile uint32_t tail;       ///< next slot read by the subscriber
+  volatile uint32_t nb_dropped; ///< number of messages dropped because the ring was full
+  struct abi_ring *next;        ///< next ring of the queue
+};
+
+/** Rings dispatched by one thread */
+struct abi_queue {
+  struct abi_ring *rings;       ///< rings of the queued events
+  void (*notify)(void);         ///< if not NULL, called by the sender after a message was queued
+};
+
+/** Queue dispatched by the main loop */
+ABI_EXTERN struct abi_queue abi_main_queue;
+
+/** Initialize a queue
+ * @param q queue
+ * @param notify function waking up the subscriber thread, or NULL
+ */
+static inline void abi_queue_init(struct abi_queue *q, void (*notify)(void))
+{
+  q->rings = NULL;
+  q->notify = notify;
+}
+
+/** Initialize a ring and add it to a queue
+ * Called by the AbiBindQueuedMsg functions.
+ * The number of slots is rounded down to a power of 2.
+ */
+static inline void abi_ring_init(struct abi_ring *r, struct abi_queue *q, abi_event *ev,
+                                 abi_deliver deliver, uint8_t *buf, uint16_t size, uint16_t nb_slots)
+{
+  while (nb_slots & (nb_slots - 1)) {
+    nb_slots &= nb_slots - 1;
+  }
+  r->ev = ev;
+  r->deliver = deliver;
+  r->queue = q;
+  r->buf = buf;
+  r->size = size;
+  r->nb_slots = nb_slots;
+  r->head = 0;
+  r->tail = 0;
+  r->nb_dropped = 0;
+  r->next = q->rings;
+  q->rings = r;
+}
+
+/** Get the next free slot of a ring, sender side
+ * @return slot where the message is copied, NULL if the ring is full
+ */
+static inline void *abi_ring_reserve(struct abi_ring *r)
+{
+  const uint32_t head = r->head;
+  if (head - ABI_LOAD_ACQUIRE(r->tail) >= r->nb_slots) {
+    r->nb_dropped++;
+    return NULL;
+  }
+  return &r->buf[(head & (r->nb_slots - 1)) * r->size];
+}
+
+/** Publish the slot returned by abi_ring_reserve, sender side */
+static inline void abi_ring_commit(struct abi_ring *r)
+{
+  ABI_STORE_RELEASE(r->head, r->head + 1);
+  if (r->queue->notify != NULL) {
+    r->queue->notify();
+  }
+}
+
+/** Call the callbacks of all queued messages, subscriber side
+ * Messages are delivered in order for each event,
+ * but not across the events of the queue.
+ * @param q queue
+ * @return number of delivered messages
+ */
+static inline uint16_t abi_queue_dispatch(struct abi_queue *q)
+{
+  uint16_t nb = 0;
+  struct abi_ring *r;
+  for (r = q->rings; r != NULL; r = r->next) {
+    const uint32_t head = ABI_LOAD_ACQUIRE(r->head);
+    uint32_t tail = r->tail;
+    while (tail != head) {
+      r->deliver(r->ev, &r->buf[(tail & (r->nb_slots - 1)) * r->size]);
+      tail++;
+      /* the slot can be reused once the callback returned */
+      ABI_STORE_RELEASE(r->tail, tail);
+      nb++;
+    }
+  }
+  return nb;
+}
+
+/** Number of messages dropped in all the rings of a queue */
+static inline uint32_t abi_queue_nb_dropped(struct abi_queue *q)
+{
+  uint32_t nb = 0;
+  struct abi_ring *r;
+  for (r = q->rings; r != NULL; r = r->next) {
+    nb += r->nb_dropped;
+  }
+  return nb;
+}
+
+/** @}*/
+
 #endif /* ABI_COMMON_H */
 
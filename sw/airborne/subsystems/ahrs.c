@@ -41,28 +41,110 @@ PRINT_CONFIG_VAR(SECONDARY_AHRS)
 #define _RegisterAhrs(_x) __RegisterAhrs(_x)
 #define RegisterAhrs(_x) _RegisterAhrs(_x)
 
-/** maximum number of AHRS implementations that can register */
-#ifndef AHRS_NB_IMPL
-#define AHRS_NB_IMPL 2
+#include "state.h"
+#include "mcu_periph/sys_time.h"
+
+/** Switch the output automatically when it diverges */
+#ifndef AHRS_BANK_AUTO_SWITCH
+#define AHRS_BANK_AUTO_SWITCH FALSE
+#endif
+PRINT_CONFIG_VAR(AHRS_BANK_AUTO_SWITCH)
+
+/** Standard deviation of the gravity direction error of a healthy AHRS (rad) */
+#ifndef AHRS_BANK_GRAVITY_SIGMA
+#define AHRS_BANK_GRAVITY_SIGMA RadOfDeg(5.)
+#endif
+
+/** Only use accel measurements within this distance of 1g (m/s^2) */
+#ifndef AHRS_BANK_GRAVITY_MAX_ERROR
+#define AHRS_BANK_GRAVITY_MAX_ERROR 0.5
+#endif
+
+/** Only score the health when the gyro norm stays below this rate (rad/s).
+ * In a turn the accel is not aligned with gravity (a coordinated turn at
+ * 25 deg of bank would score about 12 for a correct attitude).
+ */
+#ifndef AHRS_BANK_LOW_DYNAMICS_RATE
+#define AHRS_BANK_LOW_DYNAMICS_RATE RadOfDeg(3.)
+#endif
+
+/** Duration of the low dynamics window before the health is scored (s) */
+#ifndef AHRS_BANK_LOW_DYNAMICS_TIME
+#define AHRS_BANK_LOW_DYNAMICS_TIME 0.5
+#endif
+
+/** Low pass coefficient of the health score */
+#ifndef AHRS_BANK_HEALTH_ALPHA
+#define AHRS_BANK_HEALTH_ALPHA 0.02
+#endif
+
+/** An AHRS is unhealthy above this score */
+#ifndef AHRS_BANK_HEALTH_THRESHOLD
+#define AHRS_BANK_HEALTH_THRESHOLD 9.
+#endif
+
+/** Score of an AHRS which didn't report yet or diverged */
+#define AHRS_BANK_HEALTH_MAX 1000.
+
+/** Number of consecutive unhealthy reports of the output before switching */
+#ifndef AHRS_BANK_SWITCH_DELAY
+#define AHRS_BANK_SWITCH_DELAY 50
+#endif
+
+/** Maximum propagation rate divider of the secondary implementations */
+#ifndef AHRS_BANK_MAX_DECIMATION
+#define AHRS_BANK_MAX_DECIMATION 8
 #endif
 
+/** Nominal frequency of the gyro measurements, for overrun detection */
+#ifndef AHRS_BANK_IMU_FREQUENCY
+#ifdef AHRS_PROPAGATE_FREQUENCY
+#define AHRS_BANK_IMU_FREQUENCY AHRS_PROPAGATE_FREQUENCY
+#else
+#define AHRS_BANK_IMU_FREQUENCY PERIODIC_FREQUENCY
+#endif
+#endif
+
+/** a gyro sample arriving 1.5 periods after the previous one is an overrun */
+#define AHRS_BANK_OVERRUN_USEC (1500000 / (AHRS_BANK_IMU_FREQUENCY))
+
+/** number of consecutive low dynamics gyro samples before the health is scored */
+#define AHRS_BANK_LOW_DYNAMICS_SAMPLES ((uint16_t)(AHRS_BANK_LOW_DYNAMICS_TIME * (AHRS_BANK_IMU_FREQUENCY)))
+
 /** references a registered AHRS implementation */
 struct AhrsImpl {
   AhrsEnableOutput enable;
+  AhrsResetState reset;
+  bool_t reporting;           ///< health was reported at least once
+  bool_t reset_pending;       ///< reset to the output attitude on the next report of the output
+  uint8_t nb_samples;         ///< gyro samples since the last propagation
+  uint16_t unhealthy_cnt;     ///< consecutive unhealthy reports
 };
 
 struct AhrsImpl ahrs_impls[AHRS_NB_IMPL];
 uint8_t ahrs_output_idx;
+struct AhrsBank ahrs_bank;
+
+/** consecutive gyro samples of the output below AHRS_BANK_LOW_DYNAMICS_RATE */
+static uint16_t ahrs_bank_low_dyn_cnt;
 
-void ahrs_register_impl(AhrsEnableOutput enable)
+uint8_t ahrs_register_impl(AhrsEnableOutput enable)
 {
   int i;
   for (i=0; i < AHRS_NB_IMPL; i++) {
     if (ahrs_impls[i].enable == NULL) {
       ahrs_impls[i].enable = enable;
-      break;
+      return i;
     }
   }
+  return AHRS_NB_IMPL;
+}
+
+void ahrs_register_reset(uint8_t idx, AhrsResetState reset)
+{
+  if (idx < AHRS_NB_IMPL) {
+    ahrs_impls[idx].reset = reset;
+  }
 }
 
 void ahrs_init(void)
@@ -70,7 +152,17 @@ void ahrs_init(void)
   int i;
   for (i=0; i < AHRS_NB_IMPL; i++) {
     ahrs_impls[i].enable = NULL;
+    ahrs_impls[i].reset = NULL;
+    ahrs_impls[i].reporting = FALSE;
+    ahrs_impls[i].reset_pending = FALSE;
+    ahrs_impls[i].nb_samples = 0;
+    ahrs_impls[i].unhealthy_cnt = 0;
+    ahrs_bank.health[i] = AHRS_BANK_HEALTH_MAX;
   }
+  ahrs_bank.auto_switch = AHRS_BANK_AUTO_SWITCH;
+  ahrs_bank.decimation = 1;
+  ahrs_bank.nb_switch = 0;
+  ahrs_bank_low_dyn_cnt = 0;
 
   RegisterAhrs(PRIMARY_AHRS);
 #ifdef SECONDARY_AHRS
@@ -97,3 +189,157 @@ int ahrs_switch(uint8_t idx)
   ahrs_output_idx = idx;
   return ahrs_output_idx;
 }
+
+/**
+ * CPU budget governor.
+ * Called on the gyro samples of the output implementation, counts the late
+ * ones over one second. The secondary implementations are slowed down if
+ * more than 10% are late, and sped up again after a second without overrun.
+ */
+static void ahrs_bank_governor(void)
+{
+  static uint32_t last_us = 0;
+  static uint16_t nb = 0, nb_overrun = 0;
+  uint32_t now = get_sys_time_usec();
+
+  if (last_us != 0) {
+    if (now - last_us > AHRS_BANK_OVERRUN_USEC) {
+      nb_overrun++;
+    }
+    if (++nb >= AHRS_BANK_IMU_FREQUENCY) {
+      if (nb_overrun * 10 > nb) {
+        if (ahrs_bank.decimation < AHRS_BANK_MAX_DECIMATION) {
+          ahrs_bank.decimation *= 2;
+        }
+      } else if (nb_overrun == 0 && ahrs_bank.decimation > 1) {
+        ahrs_bank.decimation /= 2;
+      }
+      nb = 0;
+      nb_overrun = 0;
+    }
+  }
+  last_us = now;
+}
+
+/** Count the low dynamics gyro samples, called on the samples of the output implementation */
+static void ahrs_bank_low_dynamics(struct Int32Rates *gyro)
+{
+  struct FloatRates gyro_f;
+  RATES_FLOAT_OF_BFP(gyro_f, *gyro);
+  if (FLOAT_RATES_NORM(gyro_f) > AHRS_BANK_LOW_DYNAMICS_RATE) {
+    ahrs_bank_low_dyn_cnt = 0;
+  } else if (ahrs_bank_low_dyn_cnt < AHRS_BANK_LOW_DYNAMICS_SAMPLES) {
+    ahrs_bank_low_dyn_cnt++;
+  }
+}
+
+uint8_t ahrs_bank_run(uint8_t idx, struct Int32Rates *gyro)
+{
+  if (idx >= AHRS_NB_IMPL) { return 1; }
+  struct AhrsImpl *impl = &ahrs_impls[idx];
+  if (impl->nb_samples < 255) {
+    impl->nb_samples++;
+  }
+  if (idx == ahrs_output_idx) {
+    ahrs_bank_governor();
+    ahrs_bank_low_dynamics(gyro);
+  } else if (impl->nb_samples < ahrs_bank.decimation) {
+    return 0;
+  }
+  uint8_t n = impl->nb_samples;
+  impl->nb_samples = 0;
+  return n;
+}
+
+/** Index of the healthiest implementation other than the output, AHRS_NB_IMPL if none is healthy */
+static uint8_t ahrs_bank_best(void)
+{
+  uint8_t i, best = AHRS_NB_IMPL;
+  float best_health = AHRS_BANK_HEALTH_THRESHOLD;
+  for (i = 0; i < AHRS_NB_IMPL; i++) {
+    if (i != ahrs_output_idx && ahrs_impls[i].enable != NULL && ahrs_bank.health[i] < best_health) {
+      best = i;
+      best_health = ahrs_bank.health[i];
+    }
+  }
+  return best;
+}
+
+/** Called on each report of the output implementation */
+static void ahrs_bank_check_output(void)
+{
+  uint8_t i;
+  /* the output attitude is now set by the new output, reset the diverged ones */
+  for (i = 0; i < AHRS_NB_IMPL; i++) {
+    if (ahrs_impls[i].reset_pending) {
+      ahrs_impls[i].reset(stateGetNedToBodyQuat_f());
+      ahrs_impls[i].reset_pending = FALSE;
+      ahrs_impls[i].unhealthy_cnt = 0;
+      ahrs_bank.health[i] = 1.;
+    }
+  }
+
+  struct AhrsImpl *out = &ahrs_impls[ahrs_output_idx];
+  /* ahrs_switch may have been called from the settings */
+  if (!out->reporting) {
+    return;
+  }
+  if (ahrs_bank.health[ahrs_output_idx] < AHRS_BANK_HEALTH_THRESHOLD) {
+    out->unhealthy_cnt = 0;
+    return;
+  }
+  if (out->unhealthy_cnt < AHRS_BANK_SWITCH_DELAY) {
+    out->unhealthy_cnt++;
+    return;
+  }
+  uint8_t best = ahrs_bank_best();
+  if (ahrs_bank.auto_switch && best < AHRS_NB_IMPL) {
+    uint8_t old = ahrs_output_idx;
+    ahrs_switch(best);
+    ahrs_impls[old].reset_pending = (ahrs_impls[old].reset != NULL);
+    ahrs_impls[old].unhealthy_cnt = 0;
+    ahrs_bank.nb_switch++;
+  }
+}
+
+void ahrs_bank_gravity_innovation(uint8_t idx, struct FloatQuat *ltp_to_imu, struct Int32Vect3 *accel)
+{
+  if (idx >= AHRS_NB_IMPL) { return; }
+
+  struct AhrsImpl *impl = &ahrs_impls[idx];
+  float *health = &ahrs_bank.health[idx];
+  if (isnan(ltp_to_imu->qi) || isnan(ltp_to_imu->qx) || isnan(ltp_to_imu->qy) || isnan(ltp_to_imu->qz)) {
+    *health = AHRS_BANK_HEALTH_MAX;
+  } else {
+    struct FloatVect3 accel_f;
+    ACCELS_FLOAT_OF_BFP(accel_f, *accel);
+    const float norm = float_vect3_norm(&accel_f);
+    /* the accel is only the gravity without rotation nor linear acceleration */
+    if (fabsf(norm - 9.81f) > AHRS_BANK_GRAVITY_MAX_ERROR ||
+        ahrs_bank_low_dyn_cnt < AHRS_BANK_LOW_DYNAMICS_SAMPLES) {
+      return;
+    }
+    /* expected accel direction in imu frame: up (-z in LTP) */
+    const struct FloatVect3 up = { 0., 0., -1. };
+    struct FloatVect3 expected, cross;
+    float_quat_vmult(&expected, ltp_to_imu, &up);
+    VECT3_CROSS_PRODUCT(cross, expected, accel_f);
+    /* squared sine of the angle between expected and measured direction */
+    const float err2 = VECT3_NORM2(cross) / (norm * norm);
+    float nis = err2 / (AHRS_BANK_GRAVITY_SIGMA * AHRS_BANK_GRAVITY_SIGMA) / 2.;
+    if (VECT3_DOT_PRODUCT(expected, accel_f) < 0. || nis > AHRS_BANK_HEALTH_MAX) {
+      /* upside down */
+      nis = AHRS_BANK_HEALTH_MAX;
+    }
+    if (!impl->reporting) {
+      *health = nis;
+      impl->reporting = TRUE;
+    } else {
+      *health += AHRS_BANK_HEALTH_ALPHA * (nis - *health);
+    }
+  }
+
+  if (idx == ahrs_output_idx) {
+    ahrs_bank_check_output();
+  }
+}
@@ -39,17 +39,81 @@
 #include AHRS_SECONDARY_TYPE_H
 #endif
 
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_algebra_int.h"
+
+/** maximum number of AHRS implementations that can register */
+#ifndef AHRS_NB_IMPL
+#define AHRS_NB_IMPL 2
+#endif
+
 typedef bool_t (*AhrsEnableOutput)(bool_t);
 
+/** Reset the attitude of an AHRS implementation
+ * @param ltp_to_body new attitude
+ */
+typedef void (*AhrsResetState)(struct FloatQuat *ltp_to_body);
+
 /* for settings when using secondary AHRS */
 extern uint8_t ahrs_output_idx;
 
+/**
+ * Estimator bank.
+ *
+ * All registered implementations run on the same IMU stream. Their health
+ * is a low pass filtered normalized innovation squared (NIS) of the gravity
+ * direction, computed the same way for all of them so the scores can be
+ * compared (about 1 for a consistent filter). It is only scored in low
+ * dynamics windows (small gyro norm and accel norm close to 1g), where the
+ * accel measures the gravity.
+ * If auto_switch is set (FALSE by default) and the output implementation
+ * stays unhealthy while another one is healthy, the output is switched to
+ * the healthiest one and the diverged one is reset to the new output attitude.
+ * When the IMU callbacks arrive late (the main loop overruns), the
+ * implementations that are not the output are propagated at a lower rate.
+ */
+struct AhrsBank {
+  float health[AHRS_NB_IMPL];       ///< health score of each implementation, lower is better
+  bool_t auto_switch;               ///< switch output automatically on divergence
+  uint8_t decimation;               ///< propagation rate divider of the secondary implementations
+  uint8_t nb_switch;                ///< number of automatic switches
+};
+
+extern struct AhrsBank ahrs_bank;
+
 /**
  * Register an AHRS implementation.
  * Adds it to an internal list.
  * @param enable pointer to function to enable/disable the output of registering AHRS
+ * @return index of the implementation, used for the estimator bank functions
+ */
+extern uint8_t ahrs_register_impl(AhrsEnableOutput enable);
+
+/**
+ * Register the reset function of an AHRS implementation.
+ * Without it, a diverged implementation is not reset after a switch.
+ * @param idx index returned by ahrs_register_impl
+ * @param reset reset function
+ */
+extern void ahrs_register_reset(uint8_t idx, AhrsResetState reset);
+
+/**
+ * To be called by an implementation for each gyro measurement.
+ * @param idx index returned by ahrs_register_impl
+ * @param gyro gyro measurement in imu frame
+ * @return 0 if the propagation should be skipped, else the number of gyro
+ *         samples since the last propagation (usually 1)
+ */
+extern uint8_t ahrs_bank_run(uint8_t idx, struct Int32Rates *gyro);
+
+/**
+ * Update the health of an implementation after an accel update.
+ * @param idx index returned by ahrs_register_impl
+ * @param ltp_to_imu current estimate
+ * @param accel accel measurement in imu frame
  */
-extern void ahrs_register_impl(AhrsEnableOutput enable);
+extern void ahrs_bank_gravity_innovation(uint8_t idx, struct FloatQuat *ltp_to_imu,
+    struct Int32Vect3 *accel);
 
 /** AHRS initialization. Called at startup.
  * Registers/initializes the default AHRS.
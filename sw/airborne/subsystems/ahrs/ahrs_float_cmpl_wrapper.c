@@ -37,6 +37,8 @@ PRINT_CONFIG_VAR(AHRS_FC_OUTPUT_ENABLED)
 /** if TRUE with push the estimation results to the state interface */
 static bool_t ahrs_fc_output_enabled;
 static uint32_t ahrs_fc_last_stamp;
+/** index in the estimator bank */
+static uint8_t ahrs_fc_idx;
 
 static void compute_body_orientation_and_rates(void);
 
@@ -104,6 +106,10 @@ static void gyro_cb(uint8_t __attribute__((unused)) sender_id,
                     uint32_t stamp, struct Int32Rates *gyro)
 {
   ahrs_fc_last_stamp = stamp;
+  uint8_t nb_samples = ahrs_bank_run(ahrs_fc_idx, gyro);
+  if (nb_samples == 0) {
+    return;
+  }
 #if USE_AUTO_AHRS_FREQ || !defined(AHRS_PROPAGATE_FREQUENCY)
   PRINT_CONFIG_MSG("Calculating dt for AHRS_FC propagation.")
   /* timestamp in usec when last callback was received */
@@ -119,7 +125,7 @@ static void gyro_cb(uint8_t __attribute__((unused)) sender_id,
   PRINT_CONFIG_MSG("Using fixed AHRS_PROPAGATE_FREQUENCY for AHRS_FC propagation.")
   PRINT_CONFIG_VAR(AHRS_PROPAGATE_FREQUENCY)
   if (ahrs_fc.status == AHRS_FC_RUNNING) {
-    const float dt = 1. / (AHRS_PROPAGATE_FREQUENCY);
+    const float dt = (float)nb_samples / (AHRS_PROPAGATE_FREQUENCY);
     ahrs_fc_propagate(gyro, dt);
     compute_body_orientation_and_rates();
   }
@@ -146,6 +152,9 @@ static void accel_cb(uint8_t __attribute__((unused)) sender_id,
     ahrs_fc_update_accel((struct Int32Vect3 *)accel, dt);
   }
 #endif
+  if (ahrs_fc.is_aligned) {
+    ahrs_bank_gravity_innovation(ahrs_fc_idx, &ahrs_fc.ltp_to_imu_quat, accel);
+  }
 }
 
 static void mag_cb(uint8_t __attribute__((unused)) sender_id,
@@ -207,6 +216,13 @@ static bool_t ahrs_fc_enable_output(bool_t enable)
   return ahrs_fc_output_enabled;
 }
 
+/** Reset the attitude to the one given in body frame (estimator bank) */
+static void ahrs_fc_reset_state(struct FloatQuat *ltp_to_body)
+{
+  float_quat_comp(&ahrs_fc.ltp_to_imu_quat, ltp_to_body, orientationGetQuat_f(&ahrs_fc.body_to_imu));
+  float_rmat_of_quat(&ahrs_fc.ltp_to_imu_rmat, &ahrs_fc.ltp_to_imu_quat);
+}
+
 /**
  * Compute body orientation and rates from imu orientation and rates
  */
@@ -232,7 +248,8 @@ void ahrs_fc_register(void)
 {
   ahrs_fc_output_enabled = AHRS_FC_OUTPUT_ENABLED;
   ahrs_fc_init();
-  ahrs_register_impl(ahrs_fc_enable_output);
+  ahrs_fc_idx = ahrs_register_impl(ahrs_fc_enable_output);
+  ahrs_register_reset(ahrs_fc_idx, ahrs_fc_reset_state);
 
   /*
    * Subscribe to scaled IMU measurements and attach callbacks
@@ -35,7 +35,7 @@
 
 #include "math/pprz_algebra_float.h"
 #include "math/pprz_algebra_int.h"
-#include "math/pprz_simple_matrix.h"
+#include "math/pprz_kalman_float.h"
 #include "generated/airframe.h"
 
 //#include <stdio.h>
@@ -62,6 +62,7 @@ struct AhrsMlkf ahrs_mlkf;
 void ahrs_mlkf_init(void)
 {
 
+  ahrs_mlkf.status = AHRS_MLKF_UNINIT;
   ahrs_mlkf.is_aligned = FALSE;
 
   /* init ltp_to_imu quaternion as zero/identity rotation */
@@ -76,14 +77,8 @@ void ahrs_mlkf_init(void)
   FLOAT_RATES_ZERO(ahrs_mlkf.gyro_bias);
   const float P0_a = 1.;
   const float P0_b = 1e-4;
-  float P0[6][6] = {{ P0_a, 0.,   0.,   0.,   0.,   0.  },
-    { 0.,   P0_a, 0.,   0.,   0.,   0.  },
-    { 0.,   0.,   P0_a, 0.,   0.,   0.  },
-    { 0.,   0.,   0.,   P0_b, 0.,   0.  },
-    { 0.,   0.,   0.,   0.,   P0_b, 0.  },
-    { 0.,   0.,   0.,   0.,   0.,   P0_b}
-  };
-  memcpy(ahrs_mlkf.P, P0, sizeof(P0));
+  const float P0[AHRS_MLKF_NB_STATES] = { P0_a, P0_a, P0_a, P0_b, P0_b, P0_b };
+  pprz_kf_init_diag_float(ahrs_mlkf.P, P0, AHRS_MLKF_NB_STATES);
 
   VECT3_ASSIGN(ahrs_mlkf.mag_noise, AHRS_MAG_NOISE_X, AHRS_MAG_NOISE_Y, AHRS_MAG_NOISE_Z);
 }
@@ -105,6 +100,21 @@ void ahrs_mlkf_set_body_to_imu_quat(struct FloatQuat *q_b2i)
 }
 
 
+/**
+ * Reset the attitude, keeping the gyro bias estimate.
+ * The attitude covariance is set back to its initial value.
+ */
+void ahrs_mlkf_reset_attitude(struct FloatQuat *ltp_to_imu)
+{
+  ahrs_mlkf.ltp_to_imu_quat = *ltp_to_imu;
+  float_quat_normalize(&ahrs_mlkf.ltp_to_imu_quat);
+  float P0[AHRS_MLKF_NB_STATES];
+  for (int i = 0; i < AHRS_MLKF_NB_STATES; i++) {
+    P0[i] = i < 3 ? 1. : pprz_kf_get_float(ahrs_mlkf.P, i, i, AHRS_MLKF_NB_STATES);
+  }
+  pprz_kf_init_diag_float(ahrs_mlkf.P, P0, AHRS_MLKF_NB_STATES);
+}
+
 bool_t ahrs_mlkf_align(struct Int32Rates *lp_gyro, struct Int32Vect3 *lp_accel,
                        struct Int32Vect3 *lp_mag)
 {
@@ -117,6 +127,7 @@ bool_t ahrs_mlkf_align(struct Int32Rates *lp_gyro, struct Int32Vect3 *lp_accel,
   RATES_COPY(bias0, *lp_gyro);
   RATES_FLOAT_OF_BFP(ahrs_mlkf.gyro_bias, bias0);
 
+  ahrs_mlkf.status = AHRS_MLKF_RUNNING;
   ahrs_mlkf.is_aligned = TRUE;
 
   return TRUE;
@@ -203,26 +214,58 @@ static inline void propagate_state(float dt)
   const float dq = ahrs_mlkf.imu_rate.q * dt;
   const float dr = ahrs_mlkf.imu_rate.r * dt;
 
-  float F[6][6] = {{  1.,   dr,  -dq,  -dt,   0.,   0.  },
-    { -dr,   1.,   dp,   0.,  -dt,   0.  },
-    {  dq,  -dp,   1.,   0.,   0.,  -dt  },
-    {  0.,   0.,   0.,   1.,   0.,   0.  },
-    {  0.,   0.,   0.,   0.,   1.,   0.  },
-    {  0.,   0.,   0.,   0.,   0.,   1.  }
+  /* F = [ A B ; 0 I ] */
+  const float A[3][3] = {{  1.,   dr,  -dq },
+    { -dr,   1.,   dp },
+    {  dq,  -dp,   1. }
+  };
+  const float B[3][3] = {{ -dt,   0.,   0. },
+    {  0.,  -dt,   0. },
+    {  0.,   0.,  -dt }
   };
   // P = FPF' + GQG
-  float tmp[6][6];
-  MAT_MUL(6, 6, 6, tmp, F, ahrs_mlkf.P);
-  MAT_MUL_T(6, 6, 6,  ahrs_mlkf.P, tmp, F);
+  pprz_kf_propagate_block_float(ahrs_mlkf.P, &A[0][0], &B[0][0], 3, AHRS_MLKF_NB_STATES);
   const float dt2 = dt * dt;
-  const float GQG[6] = {dt2 * 10e-3, dt2 * 10e-3, dt2 * 10e-3, dt2 * 9e-6, dt2 * 9e-6, dt2 * 9e-6 };
-  for (int i = 0; i < 6; i++) {
-    ahrs_mlkf.P[i][i] += GQG[i];
-  }
+  const float GQG[AHRS_MLKF_NB_STATES] = {dt2 * 10e-3, dt2 * 10e-3, dt2 * 10e-3, dt2 * 9e-6, dt2 * 9e-6, dt2 * 9e-6 };
+  pprz_kf_add_diag_float(ahrs_mlkf.P, GQG, AHRS_MLKF_NB_STATES);
 
 }
 
 
+/**
+ * Incorporate the three components of a vector measurement one after the other.
+ * Equivalent to the update with the full 3x3 innovation covariance
+ * since the noise is uncorrelated, without inverting it.
+ * The residual of each component takes the correction of the previous ones into account.
+ * @param H measurement matrix for the attitude error states (other columns are zero)
+ * @param e measurement residual
+ * @param noise measurement noise vector (diagonal of covariance)
+ */
+static inline void update_state_sequential(const float H[3][3], struct FloatVect3 *e,
+                                           struct FloatVect3 *noise)
+{
+  const float res[3] = { e->x, e->y, e->z };
+  const float r[3] = { noise->x, noise->y, noise->z };
+  float x[AHRS_MLKF_NB_STATES] = { 0., 0., 0., 0., 0., 0. };
+  float K[AHRS_MLKF_NB_STATES];
+
+  for (int m = 0; m < 3; m++) {
+    const float res_m = res[m] - (H[m][0] * x[0] + H[m][1] * x[1] + H[m][2] * x[2]);
+    pprz_kf_update_scalar_float(ahrs_mlkf.P, K, H[m], 3, r[m], AHRS_MLKF_NB_STATES);
+    for (int i = 0; i < AHRS_MLKF_NB_STATES; i++) {
+      x[i] += K[i] * res_m;
+    }
+  }
+
+  // X = X + Ke
+  ahrs_mlkf.gibbs_cor.qx += x[0];
+  ahrs_mlkf.gibbs_cor.qy += x[1];
+  ahrs_mlkf.gibbs_cor.qz += x[2];
+  ahrs_mlkf.gyro_bias.p  += x[3];
+  ahrs_mlkf.gyro_bias.q  += x[4];
+  ahrs_mlkf.gyro_bias.r  += x[5];
+}
+
 /**
  * Incorporate one 3D vector measurement.
  * @param i_expected expected 3d vector in inertial frame
@@ -237,55 +280,14 @@ static inline void update_state(const struct FloatVect3 *i_expected, struct Floa
   struct FloatVect3 b_expected;
   float_quat_vmult(&b_expected, &ahrs_mlkf.ltp_to_imu_quat, i_expected);
 
-  // S = HPH' + JRJ
-  float H[3][6] = {{           0., -b_expected.z,  b_expected.y, 0., 0., 0.},
-                   { b_expected.z,            0., -b_expected.x, 0., 0., 0.},
-                   { -b_expected.y, b_expected.x,            0., 0., 0., 0.}
+  /* only the attitude error states are observed */
+  const float H[3][3] = {{           0., -b_expected.z,  b_expected.y },
+                         { b_expected.z,            0., -b_expected.x },
+                         { -b_expected.y, b_expected.x,            0. }
   };
-  float tmp[3][6];
-  MAT_MUL(3, 6, 6, tmp, H, ahrs_mlkf.P);
-  float S[3][3];
-  MAT_MUL_T(3, 6, 3, S, tmp, H);
-
-  /* add the measurement noise */
-  S[0][0] += noise->x;
-  S[1][1] += noise->y;
-  S[2][2] += noise->z;
-
-  float invS[3][3];
-  MAT_INV33(invS, S);
-
-  // K = PH'invS
-  float tmp2[6][3];
-  MAT_MUL_T(6, 6, 3, tmp2, ahrs_mlkf.P, H);
-  float K[6][3];
-  MAT_MUL(6, 3, 3, K, tmp2, invS);
-
-  // P = (I-KH)P
-  float tmp3[6][6];
-  MAT_MUL(6, 3, 6, tmp3, K, H);
-  float I6[6][6] = {{ 1., 0., 0., 0., 0., 0. },
-    {  0., 1., 0., 0., 0., 0. },
-    {  0., 0., 1., 0., 0., 0. },
-    {  0., 0., 0., 1., 0., 0. },
-    {  0., 0., 0., 0., 1., 0. },
-    {  0., 0., 0., 0., 0., 1. }
-  };
-  float tmp4[6][6];
-  MAT_SUB(6, 6, tmp4, I6, tmp3);
-  float tmp5[6][6];
-  MAT_MUL(6, 6, 6, tmp5, tmp4, ahrs_mlkf.P);
-  memcpy(ahrs_mlkf.P, tmp5, sizeof(ahrs_mlkf.P));
-
-  // X = X + Ke
   struct FloatVect3 e;
   VECT3_DIFF(e, *b_measured, b_expected);
-  ahrs_mlkf.gibbs_cor.qx += K[0][0] * e.x + K[0][1] * e.y + K[0][2] * e.z;
-  ahrs_mlkf.gibbs_cor.qy += K[1][0] * e.x + K[1][1] * e.y + K[1][2] * e.z;
-  ahrs_mlkf.gibbs_cor.qz += K[2][0] * e.x + K[2][1] * e.y + K[2][2] * e.z;
-  ahrs_mlkf.gyro_bias.p  += K[3][0] * e.x + K[3][1] * e.y + K[3][2] * e.z;
-  ahrs_mlkf.gyro_bias.q  += K[4][0] * e.x + K[4][1] * e.y + K[4][2] * e.z;
-  ahrs_mlkf.gyro_bias.r  += K[5][0] * e.x + K[5][1] * e.y + K[5][2] * e.z;
+  update_state_sequential(H, &e, noise);
 
 }
 
@@ -295,7 +297,6 @@ static inline void update_state(const struct FloatVect3 *i_expected, struct Floa
  * @param i_expected expected 3d vector in inertial frame
  * @param b_measured measured 3d vector in body/imu frame
  * @param noise measurement noise vector (diagonal of covariance)
- * TODO: optimize
  */
 static inline void update_state_heading(const struct FloatVect3 *i_expected,
                                         struct FloatVect3 *b_measured,
@@ -310,55 +311,13 @@ static inline void update_state_heading(const struct FloatVect3 *i_expected,
   struct FloatVect3 i_h_2d = {i_expected->y, -i_expected->x, 0.f};
   struct FloatVect3 b_yaw;
   float_quat_vmult(&b_yaw, &ahrs_mlkf.ltp_to_imu_quat, &i_h_2d);
-  // S = HPH' + JRJ
-  float H[3][6] = {{ 0., 0., b_yaw.x, 0., 0., 0.},
-                   { 0., 0., b_yaw.y, 0., 0., 0.},
-                   { 0., 0., b_yaw.z, 0., 0., 0.}
+  const float H[3][3] = {{ 0., 0., b_yaw.x },
+                         { 0., 0., b_yaw.y },
+                         { 0., 0., b_yaw.z }
   };
-  float tmp[3][6];
-  MAT_MUL(3, 6, 6, tmp, H, ahrs_mlkf.P);
-  float S[3][3];
-  MAT_MUL_T(3, 6, 3, S, tmp, H);
-
-  /* add the measurement noise */
-  S[0][0] += noise->x;
-  S[1][1] += noise->y;
-  S[2][2] += noise->z;
-
-  float invS[3][3];
-  MAT_INV33(invS, S);
-
-  // K = PH'invS
-  float tmp2[6][3];
-  MAT_MUL_T(6, 6, 3, tmp2, ahrs_mlkf.P, H);
-  float K[6][3];
-  MAT_MUL(6, 3, 3, K, tmp2, invS);
-
-  // P = (I-KH)P
-  float tmp3[6][6];
-  MAT_MUL(6, 3, 6, tmp3, K, H);
-  float I6[6][6] = {{ 1., 0., 0., 0., 0., 0. },
-    {  0., 1., 0., 0., 0., 0. },
-    {  0., 0., 1., 0., 0., 0. },
-    {  0., 0., 0., 1., 0., 0. },
-    {  0., 0., 0., 0., 1., 0. },
-    {  0., 0., 0., 0., 0., 1. }
-  };
-  float tmp4[6][6];
-  MAT_SUB(6, 6, tmp4, I6, tmp3);
-  float tmp5[6][6];
-  MAT_MUL(6, 6, 6, tmp5, tmp4, ahrs_mlkf.P);
-  memcpy(ahrs_mlkf.P, tmp5, sizeof(ahrs_mlkf.P));
-
-  // X = X + Ke
   struct FloatVect3 e;
   VECT3_DIFF(e, *b_measured, b_expected);
-  ahrs_mlkf.gibbs_cor.qx += K[0][0] * e.x + K[0][1] * e.y + K[0][2] * e.z;
-  ahrs_mlkf.gibbs_cor.qy += K[1][0] * e.x + K[1][1] * e.y + K[1][2] * e.z;
-  ahrs_mlkf.gibbs_cor.qz += K[2][0] * e.x + K[2][1] * e.y + K[2][2] * e.z;
-  ahrs_mlkf.gyro_bias.p  += K[3][0] * e.x + K[3][1] * e.y + K[3][2] * e.z;
-  ahrs_mlkf.gyro_bias.q  += K[4][0] * e.x + K[4][1] * e.y + K[4][2] * e.z;
-  ahrs_mlkf.gyro_bias.r  += K[5][0] * e.x + K[5][1] * e.y + K[5][2] * e.z;
+  update_state_sequential(H, &e, noise);
 
 }
 /**
@@ -34,6 +34,10 @@
 #include "std.h"
 #include "math/pprz_algebra_float.h"
 #include "math/pprz_orientation_conversion.h"
+#include "math/pprz_kalman_float.h"
+
+/** Error states: attitude (3) and gyro bias (3) */
+#define AHRS_MLKF_NB_STATES 6
 
 enum AhrsMlkfStatus {
   AHRS_MLKF_UNINIT,
@@ -51,7 +55,7 @@ struct AhrsMlkf {
   struct FloatVect3  mag_noise;
 
   struct FloatQuat  gibbs_cor;
-  float P[6][6];
+  float P[PPRZ_KF_PACKED_SIZE(AHRS_MLKF_NB_STATES)]; ///< packed covariance, see pprz_kalman_float.h
   float lp_accel;
 
   /** body_to_imu rotation */
@@ -66,6 +70,7 @@ extern struct AhrsMlkf ahrs_mlkf;
 extern void ahrs_mlkf_init(void);
 extern void ahrs_mlkf_set_body_to_imu(struct OrientationReps *body_to_imu);
 extern void ahrs_mlkf_set_body_to_imu_quat(struct FloatQuat *q_b2i);
+extern void ahrs_mlkf_reset_attitude(struct FloatQuat *ltp_to_imu);
 extern bool_t ahrs_mlkf_align(struct Int32Rates *lp_gyro, struct Int32Vect3 *lp_accel,
                               struct Int32Vect3 *lp_mag);
 extern void ahrs_mlkf_propagate(struct Int32Rates *gyro, float dt);
@@ -38,6 +38,8 @@ PRINT_CONFIG_VAR(AHRS_MLKF_OUTPUT_ENABLED)
 /** if TRUE with push the estimation results to the state interface */
 static bool_t ahrs_mlkf_output_enabled;
 static uint32_t ahrs_mlkf_last_stamp;
+/** index in the estimator bank */
+static uint8_t ahrs_mlkf_idx;
 
 static void set_body_state_from_quat(void);
 
@@ -87,6 +89,10 @@ static void gyro_cb(uint8_t __attribute__((unused)) sender_id,
                     uint32_t stamp, struct Int32Rates *gyro)
 {
   ahrs_mlkf_last_stamp = stamp;
+  uint8_t nb_samples = ahrs_bank_run(ahrs_mlkf_idx, gyro);
+  if (nb_samples == 0) {
+    return;
+  }
 #if USE_AUTO_AHRS_FREQ || !defined(AHRS_PROPAGATE_FREQUENCY)
   PRINT_CONFIG_MSG("Calculating dt for AHRS_MLKF propagation.")
   /* timestamp in usec when last callback was received */
@@ -102,7 +108,7 @@ static void gyro_cb(uint8_t __attribute__((unused)) sender_id,
   PRINT_CONFIG_MSG("Using fixed AHRS_PROPAGATE_FREQUENCY for AHRS_MLKF propagation.")
   PRINT_CONFIG_VAR(AHRS_PROPAGATE_FREQUENCY)
   if (ahrs_mlkf.status == AHRS_MLKF_RUNNING) {
-    const float dt = 1. / (AHRS_PROPAGATE_FREQUENCY);
+    const float dt = (float)nb_samples / (AHRS_PROPAGATE_FREQUENCY);
     ahrs_mlkf_propagate(gyro, dt);
     set_body_state_from_quat();
   }
@@ -116,6 +122,7 @@ static void accel_cb(uint8_t sender_id __attribute__((unused)),
   if (ahrs_mlkf.is_aligned) {
     ahrs_mlkf_update_accel(accel);
     set_body_state_from_quat();
+    ahrs_bank_gravity_innovation(ahrs_mlkf_idx, &ahrs_mlkf.ltp_to_imu_quat, accel);
   }
 }
 
@@ -159,6 +166,14 @@ static bool_t ahrs_mlkf_enable_output(bool_t enable)
   return ahrs_mlkf_output_enabled;
 }
 
+/** Reset the attitude to the one given in body frame (estimator bank) */
+static void ahrs_mlkf_reset_state(struct FloatQuat *ltp_to_body)
+{
+  struct FloatQuat ltp_to_imu_quat;
+  float_quat_comp(&ltp_to_imu_quat, ltp_to_body, orientationGetQuat_f(&ahrs_mlkf.body_to_imu));
+  ahrs_mlkf_reset_attitude(&ltp_to_imu_quat);
+}
+
 /**
  * Compute body orientation and rates from imu orientation and rates
  */
@@ -186,7 +201,8 @@ void ahrs_mlkf_register(void)
 {
   ahrs_mlkf_output_enabled = AHRS_MLKF_OUTPUT_ENABLED;
   ahrs_mlkf_init();
-  ahrs_register_impl(ahrs_mlkf_enable_output);
+  ahrs_mlkf_idx = ahrs_register_impl(ahrs_mlkf_enable_output);
+  ahrs_register_reset(ahrs_mlkf_idx, ahrs_mlkf_reset_state);
 
   /*
    * Subscribe to scaled IMU measurements and attach callbacks
@@ -37,6 +37,8 @@ PRINT_CONFIG_VAR(AHRS_ICQ_OUTPUT_ENABLED)
 /** if TRUE with push the estimation results to the state interface */
 static bool_t ahrs_icq_output_enabled;
 static uint32_t ahrs_icq_last_stamp;
+/** index in the estimator bank */
+static uint8_t ahrs_icq_idx;
 
 static void set_body_state_from_quat(void);
 
@@ -127,6 +129,10 @@ static void gyro_cb(uint8_t __attribute__((unused)) sender_id,
                     uint32_t stamp, struct Int32Rates *gyro)
 {
   ahrs_icq_last_stamp = stamp;
+  uint8_t nb_samples = ahrs_bank_run(ahrs_icq_idx, gyro);
+  if (nb_samples == 0) {
+    return;
+  }
 #if USE_AUTO_AHRS_FREQ || !defined(AHRS_PROPAGATE_FREQUENCY)
   PRINT_CONFIG_MSG("Calculating dt for AHRS_ICQ propagation.")
   /* timestamp in usec when last callback was received */
@@ -142,7 +148,7 @@ static void gyro_cb(uint8_t __attribute__((unused)) sender_id,
   PRINT_CONFIG_MSG("Using fixed AHRS_PROPAGATE_FREQUENCY for AHRS_ICQ propagation.")
   PRINT_CONFIG_VAR(AHRS_PROPAGATE_FREQUENCY)
   if (ahrs_icq.status == AHRS_ICQ_RUNNING) {
-    const float dt = 1. / (AHRS_PROPAGATE_FREQUENCY);
+    const float dt = (float)nb_samples / (AHRS_PROPAGATE_FREQUENCY);
     ahrs_icq_propagate(gyro, dt);
     set_body_state_from_quat();
   }
@@ -171,6 +177,11 @@ static void accel_cb(uint8_t __attribute__((unused)) sender_id,
     set_body_state_from_quat();
   }
 #endif
+  if (ahrs_icq.is_aligned) {
+    struct FloatQuat ltp_to_imu_quat;
+    QUAT_FLOAT_OF_BFP(ltp_to_imu_quat, ahrs_icq.ltp_to_imu_quat);
+    ahrs_bank_gravity_innovation(ahrs_icq_idx, &ltp_to_imu_quat, accel);
+  }
 }
 
 static void mag_cb(uint8_t __attribute__((unused)) sender_id,
@@ -234,6 +245,15 @@ static bool_t ahrs_icq_enable_output(bool_t enable)
   return ahrs_icq_output_enabled;
 }
 
+/** Reset the attitude to the one given in body frame (estimator bank) */
+static void ahrs_icq_reset_state(struct FloatQuat *ltp_to_body)
+{
+  struct FloatQuat ltp_to_imu_quat;
+  float_quat_comp(&ltp_to_imu_quat, ltp_to_body, orientationGetQuat_f(&ahrs_icq.body_to_imu));
+  QUAT_BFP_OF_REAL(ahrs_icq.ltp_to_imu_quat, ltp_to_imu_quat);
+  INT_RATES_ZERO(ahrs_icq.rate_correction);
+}
+
 /** Rotate angles and rates from imu to body frame and set state */
 static void set_body_state_from_quat(void)
 {
@@ -258,7 +278,8 @@ void ahrs_icq_register(void)
 {
   ahrs_icq_output_enabled = AHRS_ICQ_OUTPUT_ENABLED;
   ahrs_icq_init();
-  ahrs_register_impl(ahrs_icq_enable_output);
+  ahrs_icq_idx = ahrs_register_impl(ahrs_icq_enable_output);
+  ahrs_register_reset(ahrs_icq_idx, ahrs_icq_reset_state);
 
   /*
    * Subscribe to scaled IMU measurements and attach callbacks
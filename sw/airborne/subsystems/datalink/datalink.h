@@ -59,6 +59,9 @@ EXTERN uint8_t dl_buffer[MSG_SIZE]  __attribute__((aligned));
 EXTERN void dl_parse_msg(void);
 /** Should be called when chars are available in dl_buffer */
 
+/** Bind the datalink handlers (fixedwing and rotorcraft firmwares) */
+EXTERN void datalink_init(void);
+
 /** Check for new message and parse */
 #define DlCheckAndParse() {   \
     if (dl_msg_available) {      \
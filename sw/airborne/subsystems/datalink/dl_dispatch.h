@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * @file subsystems/datalink/dl_dispatch.h
+ *
+ * Registration based dispatch of uplink messages.
+ *
+ * Handlers are bound to a datalink message ID, the same way ABI callbacks
+ * are bound to an ABI message. The table is directly indexed by the message
+ * ID (which is a single byte), so finding the handlers of a message is O(1)
+ * whatever the number of messages known by the firmware.
+ *
+ * Handlers receive a pointer to the message in the transport buffer
+ * (dl_buffer), the payload is never copied. The buffer is only valid during
+ * the call.
+ *
+ * Usage from a module:
+ * @code
+ * static struct dl_msg_event my_ev;
+ * static bool_t my_cb(uint8_t *buf) { foo = DL_MY_MSG_foo(buf); return FALSE; }
+ * ...
+ * DlBindMsg(DL_MY_MSG, &my_ev, my_cb);
+ * @endcode
+ *
+ * The handlers of a message are called from the last bound one, until one
+ * of them returns TRUE. The firmware binds its handlers in datalink_init()
+ * after the modules, so the modules only get the messages not handled by
+ * the firmware.
+ *
+ * Modules declaring a <datalink> node in their xml file are bound
+ * automatically by the generated modules_datalink_init() function.
+ */
+
+#ifndef DL_DISPATCH_H
+#define DL_DISPATCH_H
+
+#include "std.h"
+
+#ifdef DATALINK_C
+#define DL_DISPATCH_EXTERN
+#else
+#define DL_DISPATCH_EXTERN extern
+#endif
+
+/** Number of entries in the dispatch table (one per possible message ID) */
+#define DL_DISPATCH_NB 256
+
+/** Message ID is the second byte of the datalink buffer */
+#define DlDispatchIdOfMsg(_buf) ((_buf)[1])
+
+/** Datalink handler
+ * @param buf pointer to the message (sender_id, msg_id, payload)
+ * @return TRUE if the message was handled, the next handlers are not called
+ */
+typedef bool_t (*dl_msg_callback)(uint8_t *buf);
+
+/** Handler structure stored in a linked list for each message ID */
+struct dl_msg_event {
+  dl_msg_callback cb;
+  struct dl_msg_event *next;
+};
+
+/** Dispatch table, indexed by message ID */
+DL_DISPATCH_EXTERN struct dl_msg_event *dl_dispatch_table[DL_DISPATCH_NB];
+
+/** Bind a handler to a datalink message
+ * @param msg_id datalink message ID (DL_xxx)
+ * @param ev pointer to a statically allocated event structure
+ * @param cb handler called on reception of the message
+ */
+static inline void DlBindMsg(uint8_t msg_id, struct dl_msg_event *ev, dl_msg_callback cb)
+{
+  ev->cb = cb;
+  ev->next = dl_dispatch_table[msg_id];
+  dl_dispatch_table[msg_id] = ev;
+}
+
+/** Call the handlers bound to the message in buf until one handles it
+ * @param buf pointer to the message in the transport buffer
+ */
+static inline void dl_dispatch(uint8_t *buf)
+{
+  struct dl_msg_event *ev;
+  for (ev = dl_dispatch_table[DlDispatchIdOfMsg(buf)]; ev; ev = ev->next) {
+    if (ev->cb(buf)) {
+      break;
+    }
+  }
+}
+
+#endif /* DL_DISPATCH_H */
+
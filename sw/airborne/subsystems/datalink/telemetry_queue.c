@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file subsystems/datalink/telemetry_queue.c
+ *
+ * Lock-free multi-producer/single-consumer queue of telemetry messages.
+ */
+
+#include "subsystems/datalink/telemetry_queue.h"
+#include <string.h>
+
+#define TELEMETRY_QUEUE_MASK (TELEMETRY_QUEUE_SIZE - 1)
+
+void telemetry_queue_init(struct telemetry_queue *q)
+{
+  uint32_t i;
+  for (i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+    q->slots[i].seq = i;
+    q->slots[i].len = 0;
+  }
+  q->head = 0;
+  q->tail = 0;
+  q->nb_dropped = 0;
+}
+
+bool_t telemetry_queue_push(struct telemetry_queue *q, uint8_t *buf, uint16_t len)
+{
+  struct telemetry_queue_slot *slot;
+  uint32_t pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+
+  if (len > TELEMETRY_QUEUE_MAX_LEN) {
+    __atomic_fetch_add(&q->nb_dropped, 1, __ATOMIC_RELAXED);
+    return FALSE;
+  }
+
+  /* reserve a slot */
+  while (TRUE) {
+    slot = &q->slots[pos & TELEMETRY_QUEUE_MASK];
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    int32_t dif = (int32_t)(seq - pos);
+    if (dif == 0) {
+      /* slot is free, try to take it */
+      if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1, TRUE,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+      /* pos has been updated with the current head */
+    } else if (dif < 0) {
+      /* slot not yet consumed: queue is full */
+      __atomic_fetch_add(&q->nb_dropped, 1, __ATOMIC_RELAXED);
+      return FALSE;
+    } else {
+      /* another producer took it, reload */
+      pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    }
+  }
+
+  memcpy(slot->buf, buf, len);
+  slot->len = len;
+  /* publish the slot to the consumer */
+  __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+  return TRUE;
+}
+
+uint16_t telemetry_queue_flush(struct telemetry_queue *q, struct link_device *dev)
+{
+  uint16_t nb = 0;
+  while (TRUE) {
+    struct telemetry_queue_slot *slot = &q->slots[q->tail & TELEMETRY_QUEUE_MASK];
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    if ((int32_t)(seq - (q->tail + 1)) < 0) {
+      break; // empty
+    }
+    if (!dev->check_free_space(dev->periph, slot->len)) {
+      break; // no more space in device, try again later
+    }
+    uint16_t i;
+    for (i = 0; i < slot->len; i++) {
+      dev->put_byte(dev->periph, slot->buf[i]);
+    }
+    dev->send_message(dev->periph);
+    /* give the slot back to the producers */
+    __atomic_store_n(&slot->seq, q->tail + TELEMETRY_QUEUE_SIZE, __ATOMIC_RELEASE);
+    q->tail++;
+    nb++;
+  }
+  return nb;
+}
+
+/*
+ * Producer link device functions, called by the transport in the producer thread
+ */
+
+static int producer_check_free_space(struct telemetry_queue_producer *p, uint8_t len)
+{
+  return (TELEMETRY_QUEUE_MAX_LEN - p->len) >= len;
+}
+
+static void producer_put_byte(struct telemetry_queue_producer *p, uint8_t data)
+{
+  if (p->len >= TELEMETRY_QUEUE_MAX_LEN) {
+    p->overflow = TRUE;
+    return;
+  }
+  p->buf[p->len++] = data;
+}
+
+static void producer_send_message(struct telemetry_queue_producer *p)
+{
+  if (p->overflow) {
+    /* too long for the queue, counted as dropped */
+    __atomic_fetch_add(&p->queue->nb_dropped, 1, __ATOMIC_RELAXED);
+    p->nb_dropped++;
+  } else if (telemetry_queue_push(p->queue, p->buf, p->len)) {
+    p->nb_msgs++;
+  } else {
+    p->nb_dropped++;
+  }
+  p->len = 0;
+  p->overflow = FALSE;
+}
+
+static int producer_char_available(struct telemetry_queue_producer *p __attribute__((unused)))
+{
+  return 0;
+}
+
+static uint8_t producer_get_byte(struct telemetry_queue_producer *p __attribute__((unused)))
+{
+  return 0;
+}
+
+void telemetry_queue_producer_init(struct telemetry_queue_producer *p, struct telemetry_queue *q)
+{
+  p->queue = q;
+  p->len = 0;
+  p->overflow = FALSE;
+  p->nb_msgs = 0;
+  p->nb_dropped = 0;
+  p->device.periph = (void *)p;
+  p->device.check_free_space = (check_free_space_t) producer_check_free_space;
+  p->device.put_byte = (put_byte_t) producer_put_byte;
+  p->device.send_message = (send_message_t) producer_send_message;
+  p->device.char_available = (char_available_t) producer_char_available;
+  p->device.get_byte = (get_byte_t) producer_get_byte;
+}
+
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file subsystems/datalink/telemetry_queue.h
+ *
+ * Lock-free multi-producer/single-consumer queue of telemetry messages.
+ *
+ * Transports and link devices are not thread safe, so threads other than
+ * the main loop can not send telemetry directly. Instead, each thread owns a
+ * producer, which is a link_device building the message in a private buffer.
+ * When the transport calls send_message, the complete frame is pushed to the
+ * queue without locking. The main loop then flushes all queued frames to the
+ * real link device with telemetry_queue_flush().
+ *
+ * Each producer also needs its own transport structure (checksum state):
+ * @code
+ * static struct pprz_transport my_tp;
+ * static struct telemetry_queue_producer my_prod;
+ * pprz_transport_init(&my_tp);
+ * telemetry_queue_producer_init(&my_prod, &telemetry_queue);
+ * // from the thread
+ * pprz_msg_send_FOO(&my_tp.trans_tx, &my_prod.device, AC_ID, &foo);
+ * @endcode
+ *
+ * The queue is a bounded array of slots with sequence numbers, producers
+ * reserve a slot with a compare-and-swap on the head index. When the queue is
+ * full the message is dropped and counted in the producer.
+ */
+
+#ifndef TELEMETRY_QUEUE_H
+#define TELEMETRY_QUEUE_H
+
+#include "std.h"
+#include "mcu_periph/link_device.h"
+
+/** Number of slots in the queue, must be a power of 2 */
+#ifndef TELEMETRY_QUEUE_SIZE
+#define TELEMETRY_QUEUE_SIZE 64
+#endif
+
+/** Maximum size of a message (complete frame) */
+#ifndef TELEMETRY_QUEUE_MSG_SIZE
+#define TELEMETRY_QUEUE_MSG_SIZE 256
+#endif
+
+/** Maximum length of a queued message,
+ * the link devices check their free space with an uint8_t length
+ */
+#define TELEMETRY_QUEUE_MAX_LEN (TELEMETRY_QUEUE_MSG_SIZE < 255 ? TELEMETRY_QUEUE_MSG_SIZE : 255)
+
+#if (TELEMETRY_QUEUE_SIZE & (TELEMETRY_QUEUE_SIZE - 1)) != 0
+#error "TELEMETRY_QUEUE_SIZE must be a power of 2"
+#endif
+
+struct telemetry_queue_slot {
+  volatile uint32_t seq;                  ///< sequence number of the slot
+  uint16_t len;                           ///< message length
+  uint8_t buf[TELEMETRY_QUEUE_MSG_SIZE];  ///< message
+};
+
+struct telemetry_queue {
+  struct telemetry_queue_slot slots[TELEMETRY_QUEUE_SIZE];
+  volatile uint32_t head;                 ///< next slot to reserve (producers)
+  uint32_t tail;                          ///< next slot to read (consumer only)
+  volatile uint32_t nb_dropped;           ///< total number of dropped messages
+};
+
+struct telemetry_queue_producer {
+  struct telemetry_queue *queue;          ///< queue where messages are pushed
+  uint8_t buf[TELEMETRY_QUEUE_MSG_SIZE];  ///< message being built
+  uint16_t len;                           ///< current message length
+  bool_t overflow;                        ///< current message is too long
+  volatile uint32_t nb_msgs;              ///< number of queued messages
+  volatile uint32_t nb_dropped;           ///< number of dropped messages
+  struct link_device device;              ///< device to pass to the transport
+};
+
+/** Initialize an empty queue
+ * Must be called before any producer uses it.
+ * @param q queue
+ */
+extern void telemetry_queue_init(struct telemetry_queue *q);
+
+/** Initialize a producer, one per thread
+ * @param p producer
+ * @param q queue where the messages are pushed
+ */
+extern void telemetry_queue_producer_init(struct telemetry_queue_producer *p, struct telemetry_queue *q);
+
+/** Push a complete message to the queue
+ * Can be called from any thread.
+ * @param q queue
+ * @param buf message
+ * @param len message length
+ * @return TRUE if queued, FALSE if the queue is full or the message too long
+ */
+extern bool_t telemetry_queue_push(struct telemetry_queue *q, uint8_t *buf, uint16_t len);
+
+/** Flush queued messages to a link device
+ * Must only be called from a single thread (usually the main loop).
+ * Messages are sent one by one with the device send_message function,
+ * flushing stops if there is not enough space left in the device.
+ * @param q queue
+ * @param dev link device
+ * @return number of messages sent
+ */
+extern uint16_t telemetry_queue_flush(struct telemetry_queue *q, struct link_device *dev);
+
+#endif /* TELEMETRY_QUEUE_H */
+
@@ -23,6 +23,7 @@
 #include "subsystems/gps.h"
 #include "subsystems/abi.h"
 #include "led.h"
+#include <string.h>
 
 #if GPS_USE_LATLONG
 /* currently needed to get nav_utm_zone0 */
@@ -76,8 +77,8 @@ void gps_ubx_read_message(void)
 
   if (gps_ubx.msg_class == UBX_NAV_ID) {
     if (gps_ubx.msg_id == UBX_NAV_SOL_ID) {
-      /* get hardware clock ticks */
-      gps_time_sync.t0_ticks      = sys_time.nb_tick;
+      /* hardware clock ticks when the message started to be received */
+      gps_time_sync.t0_ticks      = gps_ubx.msg_ticks;
       gps_time_sync.t0_tow        = UBX_NAV_SOL_ITOW(gps_ubx.msg_buf);
       gps_time_sync.t0_tow_frac   = UBX_NAV_SOL_Frac(gps_ubx.msg_buf);
       gps.tow        = UBX_NAV_SOL_ITOW(gps_ubx.msg_buf);
@@ -188,12 +189,9 @@ void gps_ubx_read_message(void)
 #include "subsystems/chibios-libopencm3/chibios_sdlog.h"
 #endif
 
-/* UBX parsing */
-void gps_ubx_parse(uint8_t c)
+/* UBX parsing of one byte */
+static void ubx_parse_byte(uint8_t c)
 {
-#if LOG_RAW_GPS
-  sdLogWriteByte(pprzLogFile, c);
-#endif
   if (gps_ubx.status < GOT_PAYLOAD) {
     gps_ubx.ck_a += c;
     gps_ubx.ck_b += gps_ubx.ck_a;
@@ -237,7 +235,8 @@ void gps_ubx_parse(uint8_t c)
         goto error;
       }
       gps_ubx.msg_idx = 0;
-      gps_ubx.status++;
+      /* no payload, checksum is next */
+      gps_ubx.status = (gps_ubx.len == 0) ? GOT_PAYLOAD : GOT_LEN2;
       break;
     case GOT_LEN2:
       gps_ubx.msg_buf[gps_ubx.msg_idx] = c;
@@ -273,6 +272,69 @@ restart:
   return;
 }
 
+void gps_ubx_parse(uint8_t c)
+{
+#if LOG_RAW_GPS
+  sdLogWriteByte(pprzLogFile, c);
+#endif
+  if (gps_ubx.status == UNINIT && c == UBX_SYNC1) {
+    gps_ubx.msg_stamp = get_sys_time_usec();
+    gps_ubx.msg_ticks = sys_time.nb_tick;
+  }
+  ubx_parse_byte(c);
+}
+
+/* Copy a part of the payload and update the checksum */
+static void ubx_parse_payload(uint8_t *buf, uint16_t len)
+{
+  uint8_t ck_a = gps_ubx.ck_a;
+  uint8_t ck_b = gps_ubx.ck_b;
+  uint16_t i;
+  memcpy(&gps_ubx.msg_buf[gps_ubx.msg_idx], buf, len);
+  for (i = 0; i < len; i++) {
+    ck_a += buf[i];
+    ck_b += ck_a;
+  }
+  gps_ubx.ck_a = ck_a;
+  gps_ubx.ck_b = ck_b;
+  gps_ubx.msg_idx += len;
+  if (gps_ubx.msg_idx >= gps_ubx.len) {
+    gps_ubx.status = GOT_PAYLOAD;
+  }
+}
+
+uint16_t gps_ubx_parse_buffer(uint8_t *buf, uint16_t len, uint32_t stamp)
+{
+  uint16_t i = 0;
+  while (i < len && !gps_ubx.msg_available) {
+    if (gps_ubx.status == UNINIT) {
+      /* skip everything until the next sync byte */
+      uint8_t *sync = memchr(&buf[i], UBX_SYNC1, len - i);
+      if (sync == NULL) {
+        i = len;
+        break;
+      }
+      i = sync - buf;
+      gps_ubx.msg_stamp = stamp;
+      gps_ubx.msg_ticks = sys_time.nb_tick;
+    } else if (gps_ubx.status == GOT_LEN2) {
+      /* payload in one block */
+      uint16_t n = Min(len - i, gps_ubx.len - gps_ubx.msg_idx);
+      ubx_parse_payload(&buf[i], n);
+      i += n;
+      continue;
+    }
+    ubx_parse_byte(buf[i++]);
+  }
+#if LOG_RAW_GPS
+  uint16_t j;
+  for (j = 0; j < i; j++) {
+    sdLogWriteByte(pprzLogFile, buf[j]);
+  }
+#endif
+  return i;
+}
+
 static void ubx_send_1byte(struct link_device *dev, uint8_t byte)
 {
   dev->put_byte(dev->periph, byte);
@@ -322,9 +384,6 @@ void ubx_send_cfg_rst(struct link_device *dev, uint16_t bbr , uint8_t reset_mode
 
 void gps_ubx_msg(void)
 {
-  // current timestamp
-  uint32_t now_ts = get_sys_time_usec();
-
   gps.last_msg_ticks = sys_time.nb_sec_rem;
   gps.last_msg_time = sys_time.nb_sec;
   gps_ubx_read_message();
@@ -337,7 +396,8 @@ void gps_ubx_msg(void)
       gps.last_3dfix_ticks = sys_time.nb_sec_rem;
       gps.last_3dfix_time = sys_time.nb_sec;
     }
-    AbiSendMsgGPS(GPS_UBX_ID, now_ts, &gps);
+    /* time stamped with the reception of the first byte */
+    AbiSendMsgGPS(GPS_UBX_ID, gps_ubx.msg_stamp, &gps);
   }
   gps_ubx.msg_available = FALSE;
 }
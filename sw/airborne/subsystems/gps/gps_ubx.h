@@ -32,6 +32,7 @@
 #endif
 
 #include "mcu_periph/uart.h"
+#include "mcu_periph/sys_time.h"
 
 #define GPS_NB_CHANNELS 16
 
@@ -49,6 +50,8 @@ struct GpsUbx {
   uint8_t send_ck_a, send_ck_b;
   uint8_t error_cnt;
   uint8_t error_last;
+  uint32_t msg_stamp;       ///< time the first byte of the message was read in usec
+  uint32_t msg_ticks;       ///< time the first byte of the message was read in sys_time ticks
 
   uint8_t status_flags;
   uint8_t sol_flags;
@@ -93,6 +96,16 @@ extern void gps_ubx_read_message(void);
 extern void gps_ubx_parse(uint8_t c);
 extern void gps_ubx_msg(void);
 
+/** Parse a buffer of received bytes.
+ * Parsing stops after a complete message, which must then be handled with
+ * gps_ubx_msg() before parsing the remaining bytes.
+ * @param buf received bytes
+ * @param len number of bytes
+ * @param stamp time the bytes were read in usec, recorded for a message starting in buf
+ * @return number of parsed bytes
+ */
+extern uint16_t gps_ubx_parse_buffer(uint8_t *buf, uint16_t len, uint32_t stamp);
+
 
 /* Gps callback is called when receiving a VELNED or a SOL message
  * All position/speed messages are sent in one shot and VELNED is the last one on fixedwing
@@ -100,6 +113,17 @@ extern void gps_ubx_msg(void);
  */
 static inline void GpsEvent(void)
 {
+#if GPS_UBX_UART_BUFFER
+  /* parse the receive buffer of the uart in place */
+  uint8_t *buf;
+  uint16_t len = uart_rx_peek(&(GPS_LINK), &buf);
+  if (len > 0) {
+    uint32_t stamp = get_sys_time_usec();
+    do {
+      uart_rx_skip(&(GPS_LINK), gps_ubx_parse_buffer(buf, len, stamp));
+    } while (!gps_ubx.msg_available && (len = uart_rx_peek(&(GPS_LINK), &buf)) > 0);
+  }
+#else
   struct link_device *dev = &((GPS_LINK).device);
 
   if (dev->char_available(dev->periph)) {
@@ -107,6 +131,7 @@ static inline void GpsEvent(void)
       gps_ubx_parse(dev->get_byte(dev->periph));
     }
   }
+#endif
   if (gps_ubx.msg_available) {
     gps_ubx_msg();
   }
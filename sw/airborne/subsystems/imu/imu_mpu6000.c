@@ -66,6 +66,24 @@ PRINT_CONFIG_VAR(IMU_MPU_GYRO_RANGE)
 #endif
 PRINT_CONFIG_VAR(IMU_MPU_ACCEL_RANGE)
 
+/** Read all gyro and accel samples from the MPU FIFO.
+ * Each sample is sent with its own time stamp,
+ * use it with an AHRS computing dt from the time stamps (USE_AUTO_AHRS_FREQ).
+ * The FIFO is polled at MPU60X0_FIFO_POLL_FREQ (configure IMU_MPU_FIFO_POLL_FREQ).
+ */
+#ifndef IMU_MPU_FIFO
+#define IMU_MPU_FIFO FALSE
+#endif
+PRINT_CONFIG_VAR(IMU_MPU_FIFO)
+
+#if IMU_MPU_FIFO
+#if !USE_AUTO_AHRS_FREQ
+#error "IMU_MPU_FIFO sends several samples per event, a fixed AHRS propagation dt would integrate the wrong angle: set USE_AUTO_AHRS_FREQ"
+#endif
+PRINT_CONFIG_VAR(MPU60X0_FIFO_SAMPLE_FREQ)
+PRINT_CONFIG_VAR(MPU60X0_FIFO_POLL_FREQ)
+#endif
+
 
 struct ImuMpu6000 imu_mpu_spi;
 
@@ -77,12 +95,22 @@ void imu_impl_init(void)
   imu_mpu_spi.mpu.config.dlpf_cfg = IMU_MPU_LOWPASS_FILTER;
   imu_mpu_spi.mpu.config.gyro_range = IMU_MPU_GYRO_RANGE;
   imu_mpu_spi.mpu.config.accel_range = IMU_MPU_ACCEL_RANGE;
+  imu_mpu_spi.mpu.config.fifo_enable = IMU_MPU_FIFO;
 }
 
 
 void imu_periodic(void)
 {
+#if IMU_MPU_FIFO
+  /* configure at full rate, then poll the FIFO at MPU60X0_FIFO_POLL_FREQ */
+  if (!imu_mpu_spi.mpu.config.initialized) {
+    mpu60x0_spi_periodic(&imu_mpu_spi.mpu);
+  } else {
+    RunOnceEvery((PERIODIC_FREQUENCY / MPU60X0_FIFO_POLL_FREQ), mpu60x0_spi_periodic(&imu_mpu_spi.mpu));
+  }
+#else
   mpu60x0_spi_periodic(&imu_mpu_spi.mpu);
+#endif
 }
 
 void imu_mpu_spi_event(void)
@@ -90,12 +118,24 @@ void imu_mpu_spi_event(void)
   mpu60x0_spi_event(&imu_mpu_spi.mpu);
   if (imu_mpu_spi.mpu.data_available) {
     uint32_t now_ts = get_sys_time_usec();
-    RATES_COPY(imu.gyro_unscaled, imu_mpu_spi.mpu.data_rates.rates);
-    VECT3_COPY(imu.accel_unscaled, imu_mpu_spi.mpu.data_accel.vect);
+    if (imu_mpu_spi.mpu.config.fifo_enable) {
+      struct Mpu60x0Fifo *fifo = &imu_mpu_spi.mpu.fifo;
+      for (uint8_t i = 0; i < fifo->nb_samples; i++) {
+        RATES_ASSIGN(imu.gyro_unscaled, fifo->rates[i][0], fifo->rates[i][1], fifo->rates[i][2]);
+        VECT3_ASSIGN(imu.accel_unscaled, fifo->accel[i][0], fifo->accel[i][1], fifo->accel[i][2]);
+        imu_scale_gyro(&imu);
+        imu_scale_accel(&imu);
+        AbiSendMsgIMU_GYRO_INT32(IMU_MPU6000_ID, fifo->stamp[i], &imu.gyro);
+        AbiSendMsgIMU_ACCEL_INT32(IMU_MPU6000_ID, fifo->stamp[i], &imu.accel);
+      }
+    } else {
+      RATES_COPY(imu.gyro_unscaled, imu_mpu_spi.mpu.data_rates.rates);
+      VECT3_COPY(imu.accel_unscaled, imu_mpu_spi.mpu.data_accel.vect);
+      imu_scale_gyro(&imu);
+      imu_scale_accel(&imu);
+      AbiSendMsgIMU_GYRO_INT32(IMU_MPU6000_ID, now_ts, &imu.gyro);
+      AbiSendMsgIMU_ACCEL_INT32(IMU_MPU6000_ID, now_ts, &imu.accel);
+    }
     imu_mpu_spi.mpu.data_available = FALSE;
-    imu_scale_gyro(&imu);
-    imu_scale_accel(&imu);
-    AbiSendMsgIMU_GYRO_INT32(IMU_MPU6000_ID, now_ts, &imu.gyro);
-    AbiSendMsgIMU_ACCEL_INT32(IMU_MPU6000_ID, now_ts, &imu.accel);
   }
 }
@@ -91,6 +91,24 @@ PRINT_CONFIG_VAR(IMU_MPU9250_CHAN_Y)
 #endif
 PRINT_CONFIG_VAR(IMU_MPU9250_CHAN_Z)
 
+/** Read all gyro and accel samples from the MPU FIFO.
+ * Each sample is sent with its own time stamp,
+ * use it with an AHRS computing dt from the time stamps (USE_AUTO_AHRS_FREQ).
+ * The FIFO is polled at MPU9250_FIFO_POLL_FREQ (configure IMU_MPU9250_FIFO_POLL_FREQ).
+ */
+#ifndef IMU_MPU9250_FIFO
+#define IMU_MPU9250_FIFO FALSE
+#endif
+PRINT_CONFIG_VAR(IMU_MPU9250_FIFO)
+
+#if IMU_MPU9250_FIFO
+#if !USE_AUTO_AHRS_FREQ
+#error "IMU_MPU9250_FIFO sends several samples per event, a fixed AHRS propagation dt would integrate the wrong angle: set USE_AUTO_AHRS_FREQ"
+#endif
+PRINT_CONFIG_VAR(MPU9250_FIFO_SAMPLE_FREQ)
+PRINT_CONFIG_VAR(MPU9250_FIFO_POLL_FREQ)
+#endif
+
 #ifndef IMU_MPU9250_READ_MAG
 #define IMU_MPU9250_READ_MAG TRUE
 #endif
@@ -115,6 +133,7 @@ void imu_impl_init(void)
   imu_mpu9250.mpu.config.dlpf_accel_cfg = IMU_MPU9250_ACCEL_LOWPASS_FILTER;
   imu_mpu9250.mpu.config.gyro_range = IMU_MPU9250_GYRO_RANGE;
   imu_mpu9250.mpu.config.accel_range = IMU_MPU9250_ACCEL_RANGE;
+  imu_mpu9250.mpu.config.fifo_enable = IMU_MPU9250_FIFO;
 
 
   /* "internal" ak8963 magnetometer as I2C slave */
@@ -154,7 +173,16 @@ void imu_impl_init(void)
 
 void imu_periodic(void)
 {
+#if IMU_MPU9250_FIFO
+  /* configure at full rate, then poll the FIFO at MPU9250_FIFO_POLL_FREQ */
+  if (!imu_mpu9250.mpu.config.initialized) {
+    mpu9250_spi_periodic(&imu_mpu9250.mpu);
+  } else {
+    RunOnceEvery((PERIODIC_FREQUENCY / MPU9250_FIFO_POLL_FREQ), mpu9250_spi_periodic(&imu_mpu9250.mpu));
+  }
+#else
   mpu9250_spi_periodic(&imu_mpu9250.mpu);
+#endif
 }
 
 #define Int16FromBuf(_buf,_idx) ((int16_t)(_buf[_idx] | (_buf[_idx+1] << 8)))
@@ -196,10 +224,24 @@ void imu_mpu9250_event(void)
 
     imu_mpu9250.mpu.data_available = FALSE;
 
-    imu_scale_gyro(&imu);
-    imu_scale_accel(&imu);
-    AbiSendMsgIMU_GYRO_INT32(IMU_MPU9250_ID, now_ts, &imu.gyro);
-    AbiSendMsgIMU_ACCEL_INT32(IMU_MPU9250_ID, now_ts, &imu.accel);
+    if (imu_mpu9250.mpu.config.fifo_enable) {
+      struct Mpu9250Fifo *fifo = &imu_mpu9250.mpu.fifo;
+      for (uint8_t i = 0; i < fifo->nb_samples; i++) {
+        VECT3_ASSIGN(imu.accel_unscaled, fifo->accel[i][IMU_MPU9250_CHAN_X],
+                     fifo->accel[i][IMU_MPU9250_CHAN_Y], fifo->accel[i][IMU_MPU9250_CHAN_Z]);
+        RATES_ASSIGN(imu.gyro_unscaled, fifo->rates[i][IMU_MPU9250_CHAN_X],
+                     fifo->rates[i][IMU_MPU9250_CHAN_Y], fifo->rates[i][IMU_MPU9250_CHAN_Z]);
+        imu_scale_gyro(&imu);
+        imu_scale_accel(&imu);
+        AbiSendMsgIMU_GYRO_INT32(IMU_MPU9250_ID, fifo->stamp[i], &imu.gyro);
+        AbiSendMsgIMU_ACCEL_INT32(IMU_MPU9250_ID, fifo->stamp[i], &imu.accel);
+      }
+    } else {
+      imu_scale_gyro(&imu);
+      imu_scale_accel(&imu);
+      AbiSendMsgIMU_GYRO_INT32(IMU_MPU9250_ID, now_ts, &imu.gyro);
+      AbiSendMsgIMU_ACCEL_INT32(IMU_MPU9250_ID, now_ts, &imu.accel);
+    }
   }
 
 }
@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file subsystems/ins/ins_qkf.c
+ *
+ * Paparazzi wrapper of the libeknav quaternion Kalman filter.
+ *
+ * The filter is started when both the initial attitude from the aligner
+ * and a 3D GPS fix are available. The local frame is only used for the
+ * output to the state interface, the filter itself runs in ECEF.
+ */
+
+#include "subsystems/ins/ins_qkf.h"
+#include "fms/libeknav/ins_qkf_api.h"
+
+#include "subsystems/ins.h"
+#include "subsystems/gps.h"
+#include "subsystems/abi.h"
+#include "subsystems/ahrs/ahrs_float_utils.h"
+#include "mcu_periph/sys_time.h"
+#include "math/pprz_isa.h"
+#include "state.h"
+#include "generated/airframe.h"
+
+#ifndef USE_INS_NAV_INIT
+#define USE_INS_NAV_INIT TRUE
+PRINT_CONFIG_MSG("USE_INS_NAV_INIT defaulting to TRUE")
+#endif
+
+#if USE_INS_NAV_INIT
+#include "generated/flight_plan.h"
+#endif
+
+/** Process noises, see basic_ins_qkf */
+#ifndef INS_QKF_GYRO_WHITE_NOISE
+#define INS_QKF_GYRO_WHITE_NOISE 1e-4
+#endif
+#ifndef INS_QKF_GYRO_STABILITY_NOISE
+#define INS_QKF_GYRO_STABILITY_NOISE 1e-8
+#endif
+#ifndef INS_QKF_ACCEL_WHITE_NOISE
+#define INS_QKF_ACCEL_WHITE_NOISE 1e-2
+#endif
+
+/** Observation variances */
+#ifndef INS_QKF_MAG_NOISE
+#define INS_QKF_MAG_NOISE 1e-3
+#endif
+#ifndef INS_QKF_GRAVITY_NOISE
+#define INS_QKF_GRAVITY_NOISE 1e-2
+#endif
+#ifndef INS_QKF_BARO_NOISE
+#define INS_QKF_BARO_NOISE 0.25
+#endif
+
+/** Gravity is used as a vector observation if |accel| is within this range of 9.81 (m/s^2) */
+#ifndef INS_QKF_GRAVITY_THRESHOLD
+#define INS_QKF_GRAVITY_THRESHOLD 0.5
+#endif
+
+/** Initial one sigma errors */
+#ifndef INS_QKF_INIT_GYRO_BIAS_ERROR
+#define INS_QKF_INIT_GYRO_BIAS_ERROR 0.05
+#endif
+#ifndef INS_QKF_INIT_ATTITUDE_ERROR
+#define INS_QKF_INIT_ATTITUDE_ERROR 0.3
+#endif
+
+#ifndef INS_QKF_FILTER_ID
+#define INS_QKF_FILTER_ID 3
+#endif
+
+/** baro */
+#ifndef INS_QKF_BARO_ID
+#if USE_BARO_BOARD
+#define INS_QKF_BARO_ID BARO_BOARD_SENDER_ID
+#else
+#define INS_QKF_BARO_ID ABI_BROADCAST
+#endif
+#endif
+PRINT_CONFIG_VAR(INS_QKF_BARO_ID)
+
+/** IMU (gyro, accel) */
+#ifndef INS_QKF_IMU_ID
+#define INS_QKF_IMU_ID ABI_BROADCAST
+#endif
+PRINT_CONFIG_VAR(INS_QKF_IMU_ID)
+
+/** magnetometer */
+#ifndef INS_QKF_MAG_ID
+#define INS_QKF_MAG_ID ABI_BROADCAST
+#endif
+PRINT_CONFIG_VAR(INS_QKF_MAG_ID)
+
+struct InsQkf ins_qkf;
+
+/** last gyro msg timestamp */
+static uint32_t ins_qkf_last_stamp = 0;
+
+#if PERIODIC_TELEMETRY
+#include "subsystems/datalink/telemetry.h"
+
+static void send_ins_ref(struct transport_tx *trans, struct link_device *dev)
+{
+  float foo = 0.;
+  if (state.ned_initialized_i) {
+    pprz_msg_send_INS_REF(trans, dev, AC_ID,
+                          &state.ned_origin_i.ecef.x, &state.ned_origin_i.ecef.y,
+                          &state.ned_origin_i.ecef.z, &state.ned_origin_i.lla.lat,
+                          &state.ned_origin_i.lla.lon, &state.ned_origin_i.lla.alt,
+                          &state.ned_origin_i.hmsl, &foo);
+  }
+}
+
+static void send_filter_status(struct transport_tx *trans, struct link_device *dev)
+{
+  uint8_t id = INS_QKF_FILTER_ID;
+  uint8_t mde = 3;
+  uint16_t val = 0;
+  if (!ins_qkf.is_running) { mde = 2; }
+  uint32_t t_diff = get_sys_time_usec() - ins_qkf_last_stamp;
+  /* set lost if no new gyro measurements for 50ms */
+  if (t_diff > 50000) { mde = 5; }
+  pprz_msg_send_STATE_FILTER_STATUS(trans, dev, AC_ID, &id, &mde, &val);
+}
+#endif
+
+/** Set the local frame from an integer one and cache its rotation */
+static void ins_qkf_set_ltp(struct LtpDef_i *def)
+{
+  struct EcefCoor_d ecef = { def->ecef.x / 100., def->ecef.y / 100., def->ecef.z / 100. };
+  ltp_def_from_ecef_d(&ins_qkf.ltp_def, &ecef);
+  /* ltp_of_ecef is ENU */
+  const double *m = ins_qkf.ltp_def.ltp_of_ecef.m;
+  struct FloatRMat *r = &ins_qkf.ned_of_ecef;
+  MAT33_ELMT(*r, 0, 0) = m[3]; MAT33_ELMT(*r, 0, 1) = m[4]; MAT33_ELMT(*r, 0, 2) = m[5];
+  MAT33_ELMT(*r, 1, 0) = m[0]; MAT33_ELMT(*r, 1, 1) = m[1]; MAT33_ELMT(*r, 1, 2) = m[2];
+  MAT33_ELMT(*r, 2, 0) = -m[6]; MAT33_ELMT(*r, 2, 1) = -m[7]; MAT33_ELMT(*r, 2, 2) = -m[8];
+  float_quat_of_rmat(&ins_qkf.q_ecef2ned, r);
+  stateSetLocalOrigin_i(def);
+}
+
+void ins_qkf_init(void)
+{
+#if USE_INS_NAV_INIT
+  struct LlaCoor_i llh_nav0; /* Height above the ellipsoid */
+  llh_nav0.lat = NAV_LAT0;
+  llh_nav0.lon = NAV_LON0;
+  /* NAV_ALT0 = ground alt above msl, NAV_MSL0 = geoid-height (msl) over ellipsoid */
+  llh_nav0.alt = NAV_ALT0 + NAV_MSL0;
+
+  struct EcefCoor_i ecef_nav0;
+  ecef_of_lla_i(&ecef_nav0, &llh_nav0);
+
+  struct LtpDef_i ltp_def;
+  ltp_def_from_ecef_i(&ltp_def, &ecef_nav0);
+  ltp_def.hmsl = NAV_ALT0;
+  ins_qkf_set_ltp(&ltp_def);
+#endif
+
+  ins_qkf.is_aligned = FALSE;
+  ins_qkf.is_running = FALSE;
+  ins_qkf.baro_initialized = FALSE;
+  FLOAT_VECT3_ZERO(ins_qkf.accel);
+
+  /* Default magnetic field, normalized */
+  VECT3_ASSIGN(ins_qkf.mag_h, INS_H_X, INS_H_Y, INS_H_Z);
+  float_vect3_normalize(&ins_qkf.mag_h);
+
+  ins_qkf_api_init(INS_QKF_GYRO_WHITE_NOISE, INS_QKF_GYRO_STABILITY_NOISE, INS_QKF_ACCEL_WHITE_NOISE);
+}
+
+void ins_reset_local_origin(void)
+{
+  struct LtpDef_i ltp_def;
+  ltp_def_from_ecef_i(&ltp_def, &gps.ecef_pos);
+  ltp_def.lla.alt = gps.lla_pos.alt;
+  ltp_def.hmsl = gps.hmsl;
+  ins_qkf_set_ltp(&ltp_def);
+}
+
+void ins_reset_altitude_ref(void)
+{
+  struct LlaCoor_i lla = {
+    .lat = state.ned_origin_i.lla.lat,
+    .lon = state.ned_origin_i.lla.lon,
+    .alt = gps.lla_pos.alt
+  };
+  struct LtpDef_i ltp_def;
+  ltp_def_from_lla_i(&ltp_def, &lla);
+  ltp_def.hmsl = gps.hmsl;
+  ins_qkf_set_ltp(&ltp_def);
+  ins_qkf.baro_initialized = FALSE;
+}
+
+/** Start the filter at the GPS position with the aligner attitude */
+static void ins_qkf_start(struct GpsState *gps_s)
+{
+  struct EcefCoor_d pos = { gps_s->ecef_pos.x / 100., gps_s->ecef_pos.y / 100., gps_s->ecef_pos.z / 100. };
+  struct FloatVect3 vel = { gps_s->ecef_vel.x / 100.f, gps_s->ecef_vel.y / 100.f, gps_s->ecef_vel.z / 100.f };
+  struct FloatQuat q_ecef2body;
+  float_quat_comp(&q_ecef2body, &ins_qkf.q_ecef2ned, &ins_qkf.align_quat);
+  struct InsQkfInitErrors err = {
+    .gyro_bias = INS_QKF_INIT_GYRO_BIAS_ERROR,
+    .attitude = INS_QKF_INIT_ATTITUDE_ERROR,
+    .position = gps_s->pacc / 100.f,
+    .velocity = gps_s->sacc / 100.f
+  };
+  ins_qkf_api_reset(&pos, &vel, &q_ecef2body, &err);
+  ins_qkf.is_running = TRUE;
+}
+
+/** Publish the filter state in the local frame */
+static void ins_qkf_output(struct FloatRates *gyro)
+{
+  struct EcefCoor_d pos_ecef;
+  struct FloatVect3 vel_ecef;
+  struct FloatQuat q_ecef2body, q_ned2body;
+  struct FloatRates bias, rates;
+  ins_qkf_api_get_state(&pos_ecef, &vel_ecef, &q_ecef2body, &bias);
+
+  struct NedCoor_d pos_d;
+  ned_of_ecef_point_d(&pos_d, &ins_qkf.ltp_def, &pos_ecef);
+  struct NedCoor_f pos = { pos_d.x, pos_d.y, pos_d.z };
+  struct NedCoor_f speed;
+  float_rmat_vmult((struct FloatVect3 *)&speed, &ins_qkf.ned_of_ecef, &vel_ecef);
+  float_quat_inv_comp(&q_ned2body, &ins_qkf.q_ecef2ned, &q_ecef2body);
+  RATES_DIFF(rates, *gyro, bias);
+
+  /* NED acceleration: rotated specific force plus gravity */
+  struct FloatQuat q_body2ned;
+  struct NedCoor_f accel;
+  float_quat_invert(&q_body2ned, &q_ned2body);
+  float_quat_vmult((struct FloatVect3 *)&accel, &q_body2ned, &ins_qkf.accel);
+  accel.z += 9.81f;
+
+  stateSetNedToBodyQuat_f(&q_ned2body);
+  stateSetBodyRates_f(&rates);
+  stateSetPositionNed_f(&pos);
+  stateSetSpeedNed_f(&speed);
+  stateSetAccelNed_f(&accel);
+}
+
+
+/*
+ * ABI bindings
+ */
+static abi_event baro_ev;
+static abi_event mag_ev;
+static abi_event gyro_ev;
+static abi_event accel_ev;
+static abi_event aligner_ev;
+static abi_event body_to_imu_ev;
+static abi_event geo_mag_ev;
+static abi_event gps_ev;
+
+/**
+ * Incorporate the observations received since the last propagation,
+ * then propagate on new gyro measurements with the last stored accel.
+ * The gravity observation is computed from the propagated state and
+ * queued for the update of the next gyro measurement.
+ */
+static void gyro_cb(uint8_t sender_id __attribute__((unused)),
+                    uint32_t stamp, struct Int32Rates *gyro)
+{
+  static uint32_t last_stamp = 0;
+  struct FloatRates gyro_imu, gyro_body;
+  RATES_FLOAT_OF_BFP(gyro_imu, *gyro);
+  float_rmat_transp_ratemult(&gyro_body, orientationGetRMat_f(&ins_qkf.body_to_imu), &gyro_imu);
+
+  if (ins_qkf.is_running && last_stamp > 0) {
+    if (!ins_qkf_api_update()) {
+      /* diverged, restart on the next GPS fix */
+      ins_qkf.is_running = FALSE;
+    } else {
+      float dt = (float)(stamp - last_stamp) * 1e-6;
+      ins_qkf_api_predict(&gyro_body, &ins_qkf.accel, dt);
+
+      /* gravity direction when not accelerating */
+      const float norm = float_vect3_norm(&ins_qkf.accel);
+      if (fabsf(norm - 9.81f) < INS_QKF_GRAVITY_THRESHOLD) {
+        struct EcefCoor_d pos;
+        struct FloatVect3 vel, up;
+        struct FloatQuat q;
+        ins_qkf_api_get_state(&pos, &vel, &q, NULL);
+        const double r = sqrt(pos.x * pos.x + pos.y * pos.y + pos.z * pos.z);
+        VECT3_ASSIGN(up, pos.x / r, pos.y / r, pos.z / r);
+        ins_qkf_api_add_vector(&up, &ins_qkf.accel, INS_QKF_GRAVITY_NOISE);
+      }
+
+      ins_qkf_output(&gyro_body);
+    }
+  }
+  last_stamp = stamp;
+  ins_qkf_last_stamp = stamp;
+}
+
+static void accel_cb(uint8_t sender_id __attribute__((unused)),
+                     uint32_t stamp __attribute__((unused)),
+                     struct Int32Vect3 *accel)
+{
+  struct FloatVect3 accel_imu;
+  ACCELS_FLOAT_OF_BFP(accel_imu, *accel);
+  float_rmat_transp_vmult(&ins_qkf.accel, orientationGetRMat_f(&ins_qkf.body_to_imu), &accel_imu);
+}
+
+static void mag_cb(uint8_t sender_id __attribute__((unused)),
+                   uint32_t stamp __attribute__((unused)),
+                   struct Int32Vect3 *mag)
+{
+  if (ins_qkf.is_running) {
+    struct FloatVect3 mag_imu, mag_body, mag_ecef;
+    MAGS_FLOAT_OF_BFP(mag_imu, *mag);
+    float_rmat_transp_vmult(&mag_body, orientationGetRMat_f(&ins_qkf.body_to_imu), &mag_imu);
+    float_vect3_normalize(&mag_body);
+    float_rmat_transp_vmult(&mag_ecef, &ins_qkf.ned_of_ecef, &ins_qkf.mag_h);
+    ins_qkf_api_add_vector(&mag_ecef, &mag_body, INS_QKF_MAG_NOISE);
+  }
+}
+
+static void baro_cb(uint8_t __attribute__((unused)) sender_id, float pressure)
+{
+  if (!ins_qkf.is_running) {
+    return;
+  }
+  const float height = pprz_isa_height_of_pressure(pressure, PPRZ_ISA_SEA_LEVEL_PRESSURE);
+  struct EcefCoor_d pos;
+  struct FloatVect3 vel;
+  struct FloatQuat q;
+  ins_qkf_api_get_state(&pos, &vel, &q, NULL);
+  const double r = sqrt(pos.x * pos.x + pos.y * pos.y + pos.z * pos.z);
+  if (!ins_qkf.baro_initialized) {
+    /* baro only observes the altitude changes */
+    ins_qkf.baro_offset = r - height;
+    ins_qkf.baro_initialized = TRUE;
+  } else {
+    ins_qkf_api_add_baro(ins_qkf.baro_offset + height, INS_QKF_BARO_NOISE);
+  }
+}
+
+static void aligner_cb(uint8_t __attribute__((unused)) sender_id,
+                       uint32_t stamp __attribute__((unused)),
+                       struct Int32Rates *lp_gyro __attribute__((unused)),
+                       struct Int32Vect3 *lp_accel, struct Int32Vect3 *lp_mag)
+{
+  if (!ins_qkf.is_aligned) {
+    struct FloatQuat q_ned2imu;
+    ahrs_float_get_quat_from_accel_mag(&q_ned2imu, lp_accel, lp_mag);
+    float_quat_comp_inv(&ins_qkf.align_quat, &q_ned2imu, orientationGetQuat_f(&ins_qkf.body_to_imu));
+    ins_qkf.is_aligned = TRUE;
+  }
+}
+
+static void body_to_imu_cb(uint8_t sender_id __attribute__((unused)),
+                           struct FloatQuat *q_b2i_f)
+{
+  orientationSetQuat_f(&ins_qkf.body_to_imu, q_b2i_f);
+}
+
+static void geo_mag_cb(uint8_t sender_id __attribute__((unused)), struct FloatVect3 *h)
+{
+  ins_qkf.mag_h = *h;
+  float_vect3_normalize(&ins_qkf.mag_h);
+}
+
+static void gps_cb(uint8_t sender_id __attribute__((unused)),
+                   uint32_t stamp __attribute__((unused)),
+                   struct GpsState *gps_s)
+{
+  if (gps_s->fix != GPS_FIX_3D) {
+    return;
+  }
+  if (!state.ned_initialized_i) {
+    ins_reset_local_origin();
+  }
+  if (!ins_qkf.is_running) {
+    if (ins_qkf.is_aligned) {
+      ins_qkf_start(gps_s);
+    }
+    return;
+  }
+  struct EcefCoor_d pos = { gps_s->ecef_pos.x / 100., gps_s->ecef_pos.y / 100., gps_s->ecef_pos.z / 100. };
+  struct FloatVect3 vel = { gps_s->ecef_vel.x / 100.f, gps_s->ecef_vel.y / 100.f, gps_s->ecef_vel.z / 100.f };
+  const float pacc = gps_s->pacc / 100.f;
+  const float sacc = gps_s->sacc / 100.f;
+  ins_qkf_api_add_gps(&pos, &vel, pacc * pacc, sacc * sacc);
+}
+
+
+void ins_qkf_register(void)
+{
+  ins_register_impl(ins_qkf_init);
+
+  AbiBindMsgBARO_ABS(INS_QKF_BARO_ID, &baro_ev, baro_cb);
+  AbiBindMsgIMU_MAG_INT32(INS_QKF_MAG_ID, &mag_ev, mag_cb);
+  AbiBindMsgIMU_GYRO_INT32(INS_QKF_IMU_ID, &gyro_ev, gyro_cb);
+  AbiBindMsgIMU_ACCEL_INT32(INS_QKF_IMU_ID, &accel_ev, accel_cb);
+  AbiBindMsgIMU_LOWPASSED(INS_QKF_IMU_ID, &aligner_ev, aligner_cb);
+  AbiBindMsgBODY_TO_IMU_QUAT(INS_QKF_IMU_ID, &body_to_imu_ev, body_to_imu_cb);
+  AbiBindMsgGEO_MAG(ABI_BROADCAST, &geo_mag_ev, geo_mag_cb);
+  AbiBindMsgGPS(ABI_BROADCAST, &gps_ev, gps_cb);
+
+#if PERIODIC_TELEMETRY
+  register_periodic_telemetry(DefaultPeriodic, "INS_REF", send_ins_ref);
+  register_periodic_telemetry(DefaultPeriodic, "STATE_FILTER_STATUS", send_filter_status);
+#endif
+}
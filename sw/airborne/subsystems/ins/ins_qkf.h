@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file subsystems/ins/ins_qkf.h
+ *
+ * INS based on the libeknav quaternion Kalman filter (Linux targets only).
+ *
+ * Full ECEF state (gyro bias, attitude, position, velocity) estimated
+ * by fms/libeknav/ins_qkf_fast.hpp. Magnetometer, gravity, GPS and baro
+ * observations received between two IMU samples are incorporated in a
+ * single batched update before the next propagation, so the residuals
+ * are computed from the state at the time of the observations.
+ */
+
+#ifndef INS_QKF_H
+#define INS_QKF_H
+
+#include "std.h"
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_geodetic_double.h"
+#include "math/pprz_orientation_conversion.h"
+
+#define DefaultInsImpl ins_qkf
+
+struct InsQkf {
+  bool_t is_aligned;          ///< initial attitude from the aligner is available
+  bool_t is_running;          ///< filter initialized with a GPS fix
+  struct LtpDef_d ltp_def;    ///< local frame in double precision
+  struct FloatRMat ned_of_ecef;
+  struct FloatQuat q_ecef2ned;
+  struct FloatQuat align_quat; ///< initial NED to body attitude from the aligner
+  struct OrientationReps body_to_imu;
+  struct FloatVect3 accel;    ///< last accel measurement in body frame
+  struct FloatVect3 mag_h;    ///< local earth magnetic field (NED)
+  double baro_offset;         ///< geocentric altitude of the ISA reference pressure
+  bool_t baro_initialized;
+};
+
+extern struct InsQkf ins_qkf;
+
+extern void ins_qkf_init(void);
+extern void ins_qkf_register(void);
+
+#endif /* INS_QKF_H */
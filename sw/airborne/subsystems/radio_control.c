@@ -26,9 +26,34 @@
  */
 
 #include "subsystems/radio_control.h"
+#include "mcu_periph/sys_time.h"
 
 struct RadioControl radio_control;
 
+#if RADIO_CONTROL_LATENCY
+static void latency_reset(void)
+{
+  radio_control.latency.nb_frames = 0;
+  radio_control.latency.min = UINT32_MAX;
+  radio_control.latency.max = 0;
+  radio_control.latency.sum = 0;
+}
+
+#if PERIODIC_TELEMETRY
+#include "subsystems/datalink/telemetry.h"
+
+static void send_rc_latency(struct transport_tx *trans, struct link_device *dev)
+{
+  uint32_t min = radio_control.latency.nb_frames > 0 ? radio_control.latency.min : 0;
+  uint32_t avg = radio_control.latency.nb_frames > 0 ?
+                 radio_control.latency.sum / radio_control.latency.nb_frames : 0;
+  pprz_msg_send_RC_LATENCY(trans, dev, AC_ID, &radio_control.latency.nb_frames,
+                           &radio_control.latency.last, &min, &radio_control.latency.max, &avg);
+  latency_reset();
+}
+#endif
+#endif
+
 void radio_control_init(void)
 {
   uint8_t i;
@@ -40,9 +65,41 @@ void radio_control_init(void)
   radio_control.radio_ok_cpt = 0;
   radio_control.frame_rate = 0;
   radio_control.frame_cpt = 0;
+  radio_control.frame_stamp = 0;
+#if RADIO_CONTROL_LATENCY
+  radio_control.latency.pending = FALSE;
+  radio_control.latency.last = 0;
+  latency_reset();
+#if PERIODIC_TELEMETRY
+  register_periodic_telemetry(DefaultPeriodic, "RC_LATENCY", send_rc_latency);
+#endif
+#endif
   radio_control_impl_init();
 }
 
+void radio_control_latency_update(void)
+{
+#if RADIO_CONTROL_LATENCY
+  if (radio_control.latency.pending) {
+    radio_control.latency.pending = FALSE;
+    if (radio_control.latency.nb_frames == UINT16_MAX) {
+      /* not sent for a long time */
+      latency_reset();
+    }
+    uint32_t latency = get_sys_time_usec() - radio_control.frame_stamp;
+    radio_control.latency.last = latency;
+    radio_control.latency.sum += latency;
+    if (latency < radio_control.latency.min) {
+      radio_control.latency.min = latency;
+    }
+    if (latency > radio_control.latency.max) {
+      radio_control.latency.max = latency;
+    }
+    radio_control.latency.nb_frames++;
+  }
+#endif
+}
+
 void radio_control_periodic_task(void)
 {
   static uint8_t _1Hz;
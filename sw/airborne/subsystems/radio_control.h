@@ -49,6 +49,24 @@ extern void radio_control_impl_init(void);
 #define RC_LOST        1
 #define RC_REALLY_LOST 2
 
+/**
+ * Measure the delay between the reception of a frame
+ * and the actuators set from it (see radio_control_latency_update).
+ */
+#ifndef RADIO_CONTROL_LATENCY
+#define RADIO_CONTROL_LATENCY 0
+#endif
+
+/** Latency statistics in usec since the last RC_LATENCY message */
+struct RadioControlLatency {
+  bool_t pending;         ///< last frame not used by the actuators yet
+  uint16_t nb_frames;
+  uint32_t last;
+  uint32_t min;
+  uint32_t max;
+  uint32_t sum;
+};
+
 struct RadioControl {
   uint8_t status;
   uint8_t time_since_last_frame;
@@ -56,6 +74,10 @@ struct RadioControl {
   uint8_t frame_rate;
   uint8_t frame_cpt;
   pprz_t  values[RADIO_CONTROL_NB_CHANNEL];
+  uint32_t frame_stamp;   ///< reception time of the last frame in usec
+#if RADIO_CONTROL_LATENCY
+  struct RadioControlLatency latency;
+#endif
 };
 
 extern struct RadioControl radio_control;
@@ -65,6 +87,26 @@ extern void radio_control_init(void);
 
 extern void radio_control_periodic_task(void);
 
+/**
+ * Set the reception time of the frame passed to the frame handler.
+ * Called by the implementations before the frame handler.
+ * @param stamp time the first byte of the frame was received in usec
+ */
+static inline void radio_control_set_frame_stamp(uint32_t stamp)
+{
+  radio_control.frame_stamp = stamp;
+#if RADIO_CONTROL_LATENCY
+  radio_control.latency.pending = TRUE;
+#endif
+}
+
+/**
+ * Update the latency statistics when the actuators are set.
+ * Called after SetActuatorsFromCommands, only the first call after
+ * a frame is counted.
+ */
+extern void radio_control_latency_update(void);
+
 // Event implemented in radio_control/*.h
 
 
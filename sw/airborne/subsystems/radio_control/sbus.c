@@ -74,6 +74,7 @@ void radio_control_impl_event(void (* _received_frame_handler)(void))
     } else {
       radio_control.status = RC_OK;
       NormalizePpmIIR(sbus.pulses, radio_control);
+      radio_control_set_frame_stamp(sbus.frame_stamp);
       _received_frame_handler();
     }
     sbus.frame_available = FALSE;
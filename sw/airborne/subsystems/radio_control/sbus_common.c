@@ -27,6 +27,7 @@
 #include "subsystems/radio_control/sbus_common.h"
 #include BOARD_CONFIG
 #include "mcu_periph/gpio.h"
+#include "mcu_periph/sys_time.h"
 #include <string.h>
 
 /*
@@ -72,75 +73,77 @@ void sbus_common_init(struct Sbus *sbus_p, struct uart_periph *dev)
 }
 
 
-/** Decode the raw buffer */
+/** Decode the raw buffer
+ * The 11 bits channels are packed from the least significant bit,
+ * bytes are shifted in a word until a channel can be extracted.
+ */
 static void decode_sbus_buffer(const uint8_t *src, uint16_t *dst, bool_t *available,
                                uint16_t *dstppm)
 {
-  // reset counters
-  uint8_t byteInRawBuf = 0;
-  uint8_t bitInRawBuf = 0;
-  uint8_t channel = 0;
-  uint8_t bitInChannel = 0;
-
-  // clear bits
-  memset(dst, 0, SBUS_NB_CHANNEL * sizeof(uint16_t));
+  const uint8_t *byte = src;
+  uint32_t bits = 0;
+  uint8_t nb_bits = 0;
 
   // decode sbus data
-  for (uint8_t i = 0; i < (SBUS_NB_CHANNEL * SBUS_BIT_PER_CHANNEL); i++) {
-    if (src[byteInRawBuf] & (1 << bitInRawBuf)) {
-      dst[channel] |= (1 << bitInChannel);
+  for (uint8_t channel = 0; channel < SBUS_NB_CHANNEL; channel++) {
+    while (nb_bits < SBUS_BIT_PER_CHANNEL) {
+      bits |= (uint32_t)(*byte++) << nb_bits;
+      nb_bits += SBUS_BIT_PER_BYTE;
     }
-
-    bitInRawBuf++;
-    bitInChannel++;
-
-    if (bitInRawBuf == SBUS_BIT_PER_BYTE) {
-      bitInRawBuf = 0;
-      byteInRawBuf++;
-    }
-    if (bitInChannel == SBUS_BIT_PER_CHANNEL) {
-      bitInChannel = 0;
+    dst[channel] = bits & ((1 << SBUS_BIT_PER_CHANNEL) - 1);
+    bits >>= SBUS_BIT_PER_CHANNEL;
+    nb_bits -= SBUS_BIT_PER_CHANNEL;
 #if PERIODIC_TELEMETRY
-      dstppm[channel] = USEC_OF_RC_PPM_TICKS(dst[channel]);
+    dstppm[channel] = USEC_OF_RC_PPM_TICKS(dst[channel]);
 #endif
-      channel++;
-    }
   }
   // test frame lost flag
   *available = !bit_is_set(src[SBUS_FLAGS_BYTE], SBUS_FRAME_LOST_BIT);
 }
 
+void sbus_common_parse_buffer(struct Sbus *sbus_p, const uint8_t *buf, uint16_t len, uint32_t stamp)
+{
+  uint16_t i = 0;
+  while (i < len) {
+    if (sbus_p->status == SBUS_STATUS_UNINIT) {
+      // Wait for the start byte
+      const uint8_t *start = memchr(&buf[i], SBUS_START_BYTE, len - i);
+      if (start == NULL) {
+        return;
+      }
+      i = start - buf + 1;
+      sbus_p->status = SBUS_STATUS_GOT_START;
+      sbus_p->idx = 0;
+      sbus_p->start_stamp = stamp;
+    } else {
+      // Store the rest of the frame in one block
+      uint8_t n = Min(len - i, SBUS_BUF_LENGTH - sbus_p->idx);
+      memcpy(&sbus_p->buffer[sbus_p->idx], &buf[i], n);
+      sbus_p->idx += n;
+      i += n;
+      if (sbus_p->idx == SBUS_BUF_LENGTH) {
+        // Decode if last byte is the correct end byte
+        if (sbus_p->buffer[SBUS_BUF_LENGTH - 1] == SBUS_END_BYTE) {
+          decode_sbus_buffer(sbus_p->buffer, sbus_p->pulses, &sbus_p->frame_available, sbus_p->ppm);
+          sbus_p->frame_stamp = sbus_p->start_stamp;
+        }
+        sbus_p->status = SBUS_STATUS_UNINIT;
+      }
+    }
+  }
+}
+
 // Decoding event function
-// Reading from UART
+// Reading the UART receive buffer in place
 void sbus_common_decode_event(struct Sbus *sbus_p, struct uart_periph *dev)
 {
-  uint8_t rbyte;
-  if (uart_char_available(dev)) {
+  uint8_t *buf;
+  uint16_t len = uart_rx_peek(dev, &buf);
+  if (len > 0) {
+    uint32_t stamp = get_sys_time_usec();
     do {
-      rbyte = uart_getch(dev);
-      switch (sbus_p->status) {
-        case SBUS_STATUS_UNINIT:
-          // Wait for the start byte
-          if (rbyte == SBUS_START_BYTE) {
-            sbus_p->status++;
-            sbus_p->idx = 0;
-          }
-          break;
-        case SBUS_STATUS_GOT_START:
-          // Store buffer
-          sbus_p->buffer[sbus_p->idx] = rbyte;
-          sbus_p->idx++;
-          if (sbus_p->idx == SBUS_BUF_LENGTH) {
-            // Decode if last byte is the correct end byte
-            if (rbyte == SBUS_END_BYTE) {
-              decode_sbus_buffer(sbus_p->buffer, sbus_p->pulses, &sbus_p->frame_available, sbus_p->ppm);
-            }
-            sbus_p->status = SBUS_STATUS_UNINIT;
-          }
-          break;
-        default:
-          break;
-      }
-    } while (uart_char_available(dev));
+      sbus_common_parse_buffer(sbus_p, buf, len, stamp);
+      uart_rx_skip(dev, len);
+    } while ((len = uart_rx_peek(dev, &buf)) > 0);
   }
 }
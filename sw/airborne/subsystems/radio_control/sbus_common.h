@@ -82,6 +82,8 @@ struct Sbus {
   uint8_t buffer[SBUS_BUF_LENGTH];  ///< input buffer
   uint8_t idx;                      ///< input index
   uint8_t status;                   ///< decoder state machine status
+  uint32_t start_stamp;             ///< time the start byte of the current frame was read in usec
+  uint32_t frame_stamp;             ///< time the start byte of the decoded frame was read in usec
 };
 
 /**
@@ -94,6 +96,16 @@ void sbus_common_init(struct Sbus *sbus, struct uart_periph *dev);
  */
 void sbus_common_decode_event(struct Sbus *sbus, struct uart_periph *dev);
 
+/**
+ * Decode a buffer of received bytes.
+ * All the bytes are parsed, the last complete frame is decoded.
+ * @param sbus sbus structure
+ * @param buf received bytes
+ * @param len number of bytes
+ * @param stamp time the bytes were read in usec
+ */
+void sbus_common_parse_buffer(struct Sbus *sbus, const uint8_t *buf, uint16_t len, uint32_t stamp);
+
 
 /**
  * RC event function with handler callback.
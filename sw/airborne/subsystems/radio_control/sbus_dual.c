@@ -76,6 +76,7 @@ void radio_control_impl_event(void (* _received_frame_handler)(void))
     } else {
       radio_control.status = RC_OK;
       NormalizePpmIIR(sbus2.pulses, radio_control);
+      radio_control_set_frame_stamp(sbus2.frame_stamp);
       _received_frame_handler();
     }
     sbus2.frame_available = FALSE;
@@ -88,6 +89,7 @@ void radio_control_impl_event(void (* _received_frame_handler)(void))
     } else {
       radio_control.status = RC_OK;
       NormalizePpmIIR(sbus1.pulses, radio_control);
+      radio_control_set_frame_stamp(sbus1.frame_stamp);
       _received_frame_handler();
     }
     sbus1.frame_available = FALSE;
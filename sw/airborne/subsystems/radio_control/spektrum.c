@@ -20,10 +20,34 @@
  */
 
 #include "spektrum.h"
+#include "paparazzi.h"
 
-/* Currently the functionality has been pushed into the arch directories
- * both arch directories contain essentially the original parser.
- * The next step is to implement a new parser for lisa. Once this is complete
- * hardware dependent functions will be written for booz then the lisa parser
- * will end up in here
+/* The frame synchronisation uses the time between the received bytes,
+ * it is done by the parsers of the arch directories.
+ * The channel words of the complete frames are decoded here.
  */
+
+uint8_t spektrum_decode_channels(int16_t *values, const uint8_t *data, uint8_t nb_words,
+                                 uint8_t encoding, uint8_t *max_channel)
+{
+  /* 10 bit: [F 0 C3 C2 C1 C0 D9..D0], 11 bit: [F C3 C2 C1 C0 D10..D0] */
+  const uint8_t shift = 10 + encoding;
+  const uint16_t mask = (1 << shift) - 1;
+  const int16_t center = 1 << (shift - 1);
+  const int16_t scale = encoding ? MAX_PPRZ / 0x2AC : MAX_PPRZ / 0x156;
+  uint8_t nb = 0;
+
+  for (uint8_t i = 0; i < nb_words; i++, data += 2) {
+    const uint16_t word = ((uint16_t)data[0] << 8) | data[1];
+    const uint8_t channel = (word >> shift) & 0x0f;
+    /* don't bother decoding unused channels */
+    if (channel < SPEKTRUM_NB_CHANNEL) {
+      values[channel] = ((int16_t)(word & mask) - center) * scale;
+      nb++;
+    }
+    if (channel != 0x0f && channel > *max_channel) {
+      *max_channel = channel;
+    }
+  }
+  return nb;
+}
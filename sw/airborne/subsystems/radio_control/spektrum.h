@@ -35,4 +35,28 @@ extern void radio_control_spektrum_try_bind(void);
 
 #define RadioControlEvent(_received_frame_handler) RadioControlEventImp(_received_frame_handler)
 
+#include "std.h"
+
+/** Frames are made of 2 bytes of header and 7 big endian channel words */
+#define SPEKTRUM_FRAME_LENGTH 16
+#define SPEKTRUM_CHANNELS_PER_FRAME 7
+
+#ifndef SPEKTRUM_NB_CHANNEL
+#define SPEKTRUM_NB_CHANNEL 12
+#endif
+
+/**
+ * Decode a block of channel words.
+ * The channel number of each word is read from the word itself,
+ * unused words (channel number 15) are skipped.
+ * @param[out] values channel values centered on 0 in pprz units, indexed by channel number
+ * @param data channel words as received, big endian
+ * @param nb_words number of words
+ * @param encoding 0 for 10 bit, 1 for 11 bit resolution
+ * @param[in,out] max_channel highest channel number received
+ * @return number of decoded channels
+ */
+extern uint8_t spektrum_decode_channels(int16_t *values, const uint8_t *data, uint8_t nb_words,
+                                        uint8_t encoding, uint8_t *max_channel);
+
 #endif /* RADIO_CONTROL_SPEKTRUM_H */
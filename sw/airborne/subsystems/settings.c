@@ -41,6 +41,8 @@ bool_t settings_store_flag;
 void settings_init(void)
 {
 #if USE_PERSISTENT_SETTINGS
+  /* start from current values, so settings missing from the stored ones keep their default */
+  persistent_settings_store();
   if (persistent_read((void *)&pers_settings, sizeof(struct PersistentSettings))) {
     return;  // return -1 ?
   }
@@ -37,6 +37,15 @@ extern bool_t settings_store_flag;
 
 #define settings_StoreSettings(_v) { settings_store_flag = _v; settings_store(); }
 
+/** Description of a persistent setting in the PersistentSettings struct.
+ * Generated in PERSISTENT_SETTINGS_DESC, allows to store settings by name.
+ */
+struct persistent_setting_desc {
+  const char *name;   ///< setting variable name
+  uint16_t offset;    ///< offset in PersistentSettings struct
+  uint8_t size;       ///< size in bytes
+};
+
 /* implemented in arch dependant code */
 int32_t persistent_write(void *ptr, uint32_t size);
 int32_t persistent_read(void *ptr, uint32_t size);
@@ -0,0 +1,13 @@
+/* fake generated flight plan file */
+
+#ifndef FLIGHT_PLAN_H
+#define FLIGHT_PLAN_H
+
+/* local origin of the INS before the first GPS fix (Toulouse) */
+#define NAV_LAT0 434622300
+#define NAV_LON0 12729500
+#define NAV_ALT0 185000
+#define NAV_MSL0 51850
+#define GROUND_ALT 185.
+
+#endif // FLIGHT_PLAN_H
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test/ahrs/replay.h
+ *
+ * Offline replay of recorded sensors through the AHRS and INS filters.
+ *
+ * Sensor events are streamed from a log, either a binary pprzlog (SD card
+ * logger) or a text .data log from the ground server (flights or NPS
+ * simulations). The messages used are:
+ *  - IMU_GYRO_SCALED, IMU_ACCEL_SCALED, IMU_MAG_SCALED: IMU measurements
+ *  - GPS_INT: GPS measurements
+ *  - BARO_RAW: absolute pressure
+ *  - NPS_RATE_ATTITUDE, NPS_SPEED_POS: reference attitude, speed and position
+ *    (only available in simulation)
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "std.h"
+#include "math/pprz_algebra_int.h"
+#include "math/pprz_algebra_float.h"
+#include "subsystems/gps.h"
+
+#include <stdio.h>
+#include "pprzlog.h"
+
+enum replay_event_type {
+  REPLAY_GYRO,
+  REPLAY_ACCEL,
+  REPLAY_MAG,
+  REPLAY_GPS,
+  REPLAY_BARO,
+  REPLAY_REF_ATT,
+  REPLAY_REF_POS,
+  REPLAY_NB_EVENTS
+};
+
+/** One sensor or reference sample */
+struct replay_event {
+  double time;                      ///< time in seconds
+  enum replay_event_type type;
+  union {
+    struct Int32Rates gyro;         ///< REPLAY_GYRO, BFP rad/s
+    struct Int32Vect3 accel;        ///< REPLAY_ACCEL, BFP m/s2
+    struct Int32Vect3 mag;          ///< REPLAY_MAG, BFP normalized
+    struct GpsState gps;            ///< REPLAY_GPS
+    float pressure;                 ///< REPLAY_BARO, Pa
+    struct FloatQuat ref_quat;      ///< REPLAY_REF_ATT, ltp to body
+    struct {
+      struct FloatVect3 pos;        ///< NED position in m
+      struct FloatVect3 speed;      ///< NED speed in m/s
+    } ref;                          ///< REPLAY_REF_POS
+  } data;
+};
+
+enum replay_format {
+  REPLAY_PPRZLOG,                   ///< binary log from the onboard logger
+  REPLAY_DATA                       ///< text log from the ground server
+};
+
+/** Sequential reader of a log
+ * Each thread uses its own reader on the same file.
+ */
+struct replay_reader {
+  enum replay_format format;
+  uint8_t ac_id;                    ///< only read this aircraft, 0 for any
+  struct pprzlog log;               ///< REPLAY_PPRZLOG: mapped file
+  size_t offset;                    ///< REPLAY_PPRZLOG: next frame
+  FILE *file;                       ///< REPLAY_DATA: text file
+  int8_t type_of_id[256];           ///< event type of each telemetry message ID, -1 if unused
+};
+
+/** Open a log, the format is found from the extension (.data or binary)
+ * @return 0 on success, -1 on error
+ */
+extern int replay_reader_open(struct replay_reader *r, const char *path, uint8_t ac_id);
+
+/** Read the next sensor or reference event
+ * @return TRUE if an event was read, FALSE at the end of the log
+ */
+extern bool_t replay_reader_next(struct replay_reader *r, struct replay_event *ev);
+
+extern void replay_reader_close(struct replay_reader *r);
+
+/** Group of the filters using the gps and state globals.
+ * These globals are only read and written by the thread running this group,
+ * the other filters only use the GPS state of their own events.
+ */
+#define REPLAY_GROUP_GLOBALS 2
+
+/** Filter adapter
+ * Filters are singletons working on global structures, filters sharing some
+ * globals (state interface, ahrs_icq for ins_int) have the same group and
+ * are always run by the same thread, in table order.
+ * Unused callbacks are NULL.
+ */
+struct replay_filter {
+  const char *name;
+  uint8_t group;
+  void (*init)(void);
+  void (*align)(struct Int32Rates *lp_gyro, struct Int32Vect3 *lp_accel, struct Int32Vect3 *lp_mag);
+  void (*propagate)(struct Int32Rates *gyro, struct Int32Vect3 *accel, float dt);
+  void (*update_accel)(struct Int32Vect3 *accel, float dt);
+  void (*update_mag)(struct Int32Vect3 *mag, float dt);
+  void (*update_gps)(struct GpsState *gps_s);
+  void (*update_baro)(float pressure);
+  /** estimated attitude (ltp to body) */
+  void (*get_quat)(struct FloatQuat *q);
+  /** estimated NED position and speed, NULL for AHRS
+   * @return FALSE if the filter has no valid position yet
+   */
+  bool_t (*get_ned)(struct FloatVect3 *pos, struct FloatVect3 *speed);
+};
+
+extern const struct replay_filter replay_filters[];
+extern const uint8_t replay_filters_nb;
+
+#endif /* REPLAY_H */
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test/ahrs/replay_filters.c
+ *
+ * Adapters of the AHRS and INS filters for the log replay.
+ *
+ * The body to IMU rotation is set to identity, the logged IMU measurements
+ * are used as body measurements.
+ *
+ * ins_int and ins_float_invariant can't be linked together, ins_int is only
+ * replayed when built with REPLAY_INS_INT. It uses the attitude of ahrs_icq
+ * through the state interface, both are in the same group.
+ *
+ * The INS filters read the gps and state globals, they are in
+ * REPLAY_GROUP_GLOBALS so that only one thread accesses these globals.
+ */
+
+#include "replay.h"
+
+#include "subsystems/ahrs/ahrs_float_cmpl.h"
+#include "subsystems/ahrs/ahrs_float_mlkf.h"
+#include "subsystems/ahrs/ahrs_int_cmpl_quat.h"
+#if REPLAY_INS_INT
+#define ABI_C 1
+#include "subsystems/abi.h"
+#include "subsystems/imu.h"
+#include "subsystems/ins/ins_int.h"
+#else
+#include "subsystems/ins/ins_float_invariant.h"
+#endif
+#include "state.h"
+
+/** GPS state used by the INS filters (normally from gps.c),
+ * only accessed by the thread of REPLAY_GROUP_GLOBALS
+ */
+struct GpsState gps;
+
+static struct FloatQuat q_identity = { 1., 0., 0., 0. };
+
+/*
+ * Float complementary filter
+ */
+static void fc_init(void)
+{
+  ahrs_fc_init();
+  ahrs_fc_set_body_to_imu_quat(&q_identity);
+}
+
+static void fc_align(struct Int32Rates *lp_gyro, struct Int32Vect3 *lp_accel, struct Int32Vect3 *lp_mag)
+{
+  ahrs_fc_align(lp_gyro, lp_accel, lp_mag);
+}
+
+static void fc_propagate(struct Int32Rates *gyro, struct Int32Vect3 *accel __attribute__((unused)), float dt)
+{
+  ahrs_fc_propagate(gyro, dt);
+}
+
+static void fc_get_quat(struct FloatQuat *q)
+{
+  QUAT_COPY(*q, ahrs_fc.ltp_to_imu_quat);
+}
+
+/*
+ * Float multiplicative linearized Kalman filter
+ */
+static void mlkf_init(void)
+{
+  ahrs_mlkf_init();
+  ahrs_mlkf_set_body_to_imu_quat(&q_identity);
+}
+
+static void mlkf_align(struct Int32Rates *lp_gyro, struct Int32Vect3 *lp_accel, struct Int32Vect3 *lp_mag)
+{
+  ahrs_mlkf_align(lp_gyro, lp_accel, lp_mag);
+}
+
+static void mlkf_propagate(struct Int32Rates *gyro, struct Int32Vect3 *accel __attribute__((unused)), float dt)
+{
+  ahrs_mlkf_propagate(gyro, dt);
+}
+
+static void mlkf_update_accel(struct Int32Vect3 *accel, float dt __attribute__((unused)))
+{
+  ahrs_mlkf_update_accel(accel);
+}
+
+static void mlkf_update_mag(struct Int32Vect3 *mag, float dt __attribute__((unused)))
+{
+  ahrs_mlkf_update_mag(mag);
+}
+
+static void mlkf_get_quat(struct FloatQuat *q)
+{
+  QUAT_COPY(*q, ahrs_mlkf.ltp_to_imu_quat);
+}
+
+/*
+ * Integer complementary filter
+ */
+static void icq_init(void)
+{
+  ahrs_icq_init();
+  ahrs_icq_set_body_to_imu_quat(&q_identity);
+}
+
+static void icq_align(struct Int32Rates *lp_gyro, struct Int32Vect3 *lp_accel, struct Int32Vect3 *lp_mag)
+{
+  ahrs_icq_align(lp_gyro, lp_accel, lp_mag);
+}
+
+static void icq_propagate(struct Int32Rates *gyro, struct Int32Vect3 *accel __attribute__((unused)), float dt)
+{
+  ahrs_icq_propagate(gyro, dt);
+}
+
+static void icq_get_quat(struct FloatQuat *q)
+{
+  QUAT_FLOAT_OF_BFP(*q, ahrs_icq.ltp_to_imu_quat);
+}
+
+#if REPLAY_INS_INT
+/*
+ * Integer INS (vertical filter) with the attitude of ahrs_icq
+ */
+
+/** IMU used by ins_int for the body to IMU rotation (normally from imu.c) */
+struct Imu imu;
+
+/** filters are initialized by the replay, not registered (normally from ins.c) */
+void ins_register_impl(InsInit init __attribute__((unused))) {}
+
+static void ins_int_replay_init(void)
+{
+  orientationSetQuat_f(&imu.body_to_imu, &q_identity);
+  ins_int_init();
+}
+
+static void ins_int_replay_propagate(struct Int32Rates *gyro __attribute__((unused)),
+                                     struct Int32Vect3 *accel, float dt)
+{
+  stateSetNedToBodyQuat_i(&ahrs_icq.ltp_to_imu_quat);
+  ins_int_propagate(accel, dt);
+}
+
+static void ins_int_replay_update_gps(struct GpsState *gps_s)
+{
+  gps = *gps_s;
+  ins_int_update_gps(gps_s);
+}
+
+static void ins_int_replay_update_baro(float pressure)
+{
+  AbiSendMsgBARO_ABS(ABI_BROADCAST, pressure);
+}
+
+static bool_t ins_int_replay_get_ned(struct FloatVect3 *pos, struct FloatVect3 *speed)
+{
+  VECT3_COPY(*pos, *stateGetPositionNed_f());
+  VECT3_COPY(*speed, *stateGetSpeedNed_f());
+  return ins_int.ltp_initialized;
+}
+#else
+/*
+ * Float invariant INS
+ */
+static void finv_init(void)
+{
+  ins_float_invariant_init();
+  ins_float_inv_set_body_to_imu_quat(&q_identity);
+}
+
+static void finv_update_mag(struct Int32Vect3 *mag, float dt __attribute__((unused)))
+{
+  if (ins_float_inv.is_aligned) {
+    ins_float_invariant_update_mag(mag);
+  }
+}
+
+/** the local origin is set on the first 3D fix, like the ground reset of a flight */
+static void finv_update_gps(struct GpsState *gps_s)
+{
+  static bool_t origin_set = FALSE;
+  gps = *gps_s;
+  if (!origin_set && gps.fix == GPS_FIX_3D) {
+    ins_reset_local_origin();
+    origin_set = TRUE;
+  }
+  ins_float_invariant_update_gps(gps_s);
+}
+
+static void finv_get_quat(struct FloatQuat *q)
+{
+  QUAT_COPY(*q, ins_float_inv.state.quat);
+}
+
+static bool_t finv_get_ned(struct FloatVect3 *pos, struct FloatVect3 *speed)
+{
+  VECT3_COPY(*pos, ins_float_inv.state.pos);
+  VECT3_COPY(*speed, ins_float_inv.state.speed);
+  return ins_float_inv.is_aligned && state.ned_initialized_f;
+}
+#endif
+
+const struct replay_filter replay_filters[] = {
+  {
+    .name = "ahrs_fc", .group = 0,
+    .init = fc_init, .align = fc_align, .propagate = fc_propagate,
+    .update_accel = ahrs_fc_update_accel, .update_mag = ahrs_fc_update_mag,
+    .update_gps = ahrs_fc_update_gps, .update_baro = NULL,
+    .get_quat = fc_get_quat, .get_ned = NULL
+  },
+  {
+    .name = "ahrs_mlkf", .group = 1,
+    .init = mlkf_init, .align = mlkf_align, .propagate = mlkf_propagate,
+    .update_accel = mlkf_update_accel, .update_mag = mlkf_update_mag,
+    .update_gps = NULL, .update_baro = NULL,
+    .get_quat = mlkf_get_quat, .get_ned = NULL
+  },
+  {
+    .name = "ahrs_icq", .group = REPLAY_GROUP_GLOBALS,
+    .init = icq_init, .align = icq_align, .propagate = icq_propagate,
+    .update_accel = ahrs_icq_update_accel, .update_mag = ahrs_icq_update_mag,
+    .update_gps = ahrs_icq_update_gps, .update_baro = NULL,
+    .get_quat = icq_get_quat, .get_ned = NULL
+  },
+#if REPLAY_INS_INT
+  {
+    .name = "ins_int", .group = REPLAY_GROUP_GLOBALS,
+    .init = ins_int_replay_init, .align = NULL, .propagate = ins_int_replay_propagate,
+    .update_accel = NULL, .update_mag = NULL,
+    .update_gps = ins_int_replay_update_gps, .update_baro = ins_int_replay_update_baro,
+    .get_quat = icq_get_quat, .get_ned = ins_int_replay_get_ned
+  },
+#else
+  {
+    .name = "ins_finv", .group = REPLAY_GROUP_GLOBALS,
+    .init = finv_init, .align = ins_float_invariant_align, .propagate = ins_float_invariant_propagate,
+    .update_accel = NULL, .update_mag = finv_update_mag,
+    .update_gps = finv_update_gps, .update_baro = ins_float_invariant_update_baro,
+    .get_quat = finv_get_quat, .get_ned = finv_get_ned
+  },
+#endif
+};
+
+const uint8_t replay_filters_nb = sizeof(replay_filters) / sizeof(replay_filters[0]);
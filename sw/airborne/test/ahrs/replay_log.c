@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test/ahrs/replay_log.c
+ *
+ * Stream sensor events from pprzlog or .data log files.
+ */
+
+#include "replay.h"
+#include "pprzlog_msgs.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/** Maximum number of values in a used message */
+#define REPLAY_MAX_VALUES 32
+
+/** Messages used by the replay, by event type */
+static const char *replay_msg_names[REPLAY_NB_EVENTS] = {
+  [REPLAY_GYRO] = "IMU_GYRO_SCALED",
+  [REPLAY_ACCEL] = "IMU_ACCEL_SCALED",
+  [REPLAY_MAG] = "IMU_MAG_SCALED",
+  [REPLAY_GPS] = "GPS_INT",
+  [REPLAY_BARO] = "BARO_RAW",
+  [REPLAY_REF_ATT] = "NPS_RATE_ATTITUDE",
+  [REPLAY_REF_POS] = "NPS_SPEED_POS"
+};
+
+/** Minimum number of values of each message */
+static const uint8_t replay_msg_nb_values[REPLAY_NB_EVENTS] = {
+  [REPLAY_GYRO] = 3,
+  [REPLAY_ACCEL] = 3,
+  [REPLAY_MAG] = 3,
+  [REPLAY_GPS] = 16,
+  [REPLAY_BARO] = 1,
+  [REPLAY_REF_ATT] = 6,
+  [REPLAY_REF_POS] = 9
+};
+
+static int type_of_name(const char *name)
+{
+  int t;
+  for (t = 0; t < REPLAY_NB_EVENTS; t++) {
+    if (strcmp(name, replay_msg_names[t]) == 0) {
+      return t;
+    }
+  }
+  return -1;
+}
+
+/** Fill an event from the decoded values of its message
+ * @return FALSE if there are not enough values
+ */
+static bool_t event_of_values(struct replay_event *ev, const double *v, int nb)
+{
+  if (nb < replay_msg_nb_values[ev->type]) {
+    return FALSE;
+  }
+  switch (ev->type) {
+    case REPLAY_GYRO:
+      RATES_ASSIGN(ev->data.gyro, v[0], v[1], v[2]);
+      break;
+    case REPLAY_ACCEL:
+      VECT3_ASSIGN(ev->data.accel, v[0], v[1], v[2]);
+      break;
+    case REPLAY_MAG:
+      VECT3_ASSIGN(ev->data.mag, v[0], v[1], v[2]);
+      break;
+    case REPLAY_GPS: {
+      struct GpsState *g = &ev->data.gps;
+      memset(g, 0, sizeof(struct GpsState));
+      VECT3_ASSIGN(g->ecef_pos, v[0], v[1], v[2]);
+      LLA_ASSIGN(g->lla_pos, v[3], v[4], v[5]);
+      g->hmsl = v[6];
+      VECT3_ASSIGN(g->ecef_vel, v[7], v[8], v[9]);
+      g->pacc = v[10];
+      g->sacc = v[11];
+      g->tow = v[12];
+      g->pdop = v[13];
+      g->num_sv = v[14];
+      g->fix = v[15];
+      g->speed_3d = sqrt(v[7] * v[7] + v[8] * v[8] + v[9] * v[9]);
+      break;
+    }
+    case REPLAY_BARO:
+      ev->data.pressure = v[0];
+      break;
+    case REPLAY_REF_ATT: {
+      struct FloatEulers e = { RadOfDeg(v[3]), RadOfDeg(v[4]), RadOfDeg(v[5]) };
+      float_quat_of_eulers(&ev->data.ref_quat, &e);
+      break;
+    }
+    case REPLAY_REF_POS:
+      VECT3_ASSIGN(ev->data.ref.speed, v[3], v[4], v[5]);
+      VECT3_ASSIGN(ev->data.ref.pos, v[6], v[7], v[8]);
+      break;
+    default:
+      return FALSE;
+  }
+  return TRUE;
+}
+
+int replay_reader_open(struct replay_reader *r, const char *path, uint8_t ac_id)
+{
+  size_t len = strlen(path);
+  int i;
+
+  memset(r, 0, sizeof(struct replay_reader));
+  r->ac_id = ac_id;
+  if (len > 5 && strcmp(path + len - 5, ".data") == 0) {
+    r->format = REPLAY_DATA;
+    r->file = fopen(path, "r");
+    return (r->file != NULL) ? 0 : -1;
+  }
+
+  r->format = REPLAY_PPRZLOG;
+  for (i = 0; i < 256; i++) {
+    const struct pprzlog_msg_desc *desc = pprzlog_msgs[PPRZLOG_SOURCE_TELEMETRY][i];
+    r->type_of_id[i] = (desc != NULL) ? type_of_name(desc->name) : -1;
+  }
+  return pprzlog_open(&r->log, path);
+}
+
+void replay_reader_close(struct replay_reader *r)
+{
+  if (r->format == REPLAY_DATA) {
+    if (r->file != NULL) {
+      fclose(r->file);
+    }
+  } else {
+    pprzlog_close(&r->log);
+  }
+}
+
+static bool_t next_pprzlog(struct replay_reader *r, struct replay_event *ev)
+{
+  double values[REPLAY_MAX_VALUES];
+  size_t len;
+
+  while ((len = pprzlog_next_frame(&r->log, &r->offset)) > 0) {
+    const uint8_t *f = r->log.data + r->offset;
+    const uint8_t *pprz_data = f + PPRZLOG_DATA_OFFSET;
+    r->offset += len;
+    if (f[2] != PPRZLOG_SOURCE_TELEMETRY || r->type_of_id[pprz_data[1]] < 0 ||
+        (r->ac_id != 0 && pprz_data[0] != r->ac_id)) {
+      continue;
+    }
+    uint32_t ts = f[3] | (f[4] << 8) | (f[5] << 16) | ((uint32_t)f[6] << 24);
+    ev->time = ts * PPRZLOG_TIME_UNIT;
+    ev->type = r->type_of_id[pprz_data[1]];
+    int nb = pprzlog_decode(pprzlog_msgs[PPRZLOG_SOURCE_TELEMETRY][pprz_data[1]], pprz_data, f[1],
+                            values, REPLAY_MAX_VALUES, NULL);
+    if (event_of_values(ev, values, nb)) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/** Read events from a .data file
+ * Lines are: time ac_id MSG_NAME value1 value2 ...
+ */
+static bool_t next_data(struct replay_reader *r, struct replay_event *ev)
+{
+  char line[1024];
+  double values[REPLAY_MAX_VALUES];
+
+  while (fgets(line, sizeof(line), r->file) != NULL) {
+    char *p = line, *end;
+    double t = strtod(p, &end);
+    if (end == p) {
+      continue;
+    }
+    long ac_id = strtol(end, &p, 10);
+    if (r->ac_id != 0 && ac_id != r->ac_id) {
+      continue;
+    }
+    while (*p == ' ') {
+      p++;
+    }
+    char *name = p;
+    while (*p != ' ' && *p != '\0' && *p != '\n') {
+      p++;
+    }
+    if (*p == '\0' || *p == '\n') {
+      continue;
+    }
+    *p++ = '\0';
+    int type = type_of_name(name);
+    if (type < 0) {
+      continue;
+    }
+    int nb = 0;
+    while (nb < REPLAY_MAX_VALUES) {
+      values[nb] = strtod(p, &end);
+      if (end == p) {
+        break;
+      }
+      p = end;
+      nb++;
+    }
+    ev->time = t;
+    ev->type = type;
+    if (event_of_values(ev, values, nb)) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+bool_t replay_reader_next(struct replay_reader *r, struct replay_event *ev)
+{
+  if (r->format == REPLAY_DATA) {
+    return next_data(r, ev);
+  }
+  return next_pprzlog(r, ev);
+}
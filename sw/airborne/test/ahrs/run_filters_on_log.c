@@ -0,0 +1,472 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test/ahrs/run_filters_on_log.c
+ *
+ * Replay a log through several AHRS/INS filters and compare them.
+ *
+ * The filter groups are spread over worker threads, each thread streams the
+ * log with its own reader and feeds its filters. For each filter the time
+ * spent in each update is measured, and when the log comes from a simulation
+ * the attitude, speed and position errors are computed against the NPS
+ * reference. The estimates can be written as text files for plotting.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "replay.h"
+
+#define REPLAY_MAX_FILTERS 8
+#define REPLAY_MAX_THREADS 8
+
+/** Timed filter calls */
+enum replay_call {
+  CALL_PROPAGATE,
+  CALL_ACCEL,
+  CALL_MAG,
+  CALL_GPS,
+  CALL_BARO,
+  NB_CALLS
+};
+
+static const char *call_names[NB_CALLS] = { "propagate", "accel", "mag", "gps", "baro" };
+
+/** Results of one filter */
+struct replay_stats {
+  uint32_t nb_calls[NB_CALLS];
+  double sum_ns[NB_CALLS];
+  double max_ns[NB_CALLS];
+  uint32_t nb_att;
+  double sum_att_err2;          ///< sum of the squared attitude errors (rad2)
+  double max_att_err;           ///< max attitude error (rad)
+  uint32_t nb_ned;
+  double sum_speed_err2;        ///< sum of the squared speed errors (m2/s2)
+  double sum_pos_err2;          ///< sum of the squared position errors (m2)
+  bool_t pos_offset_set;
+  struct FloatVect3 pos_offset; ///< difference of local origins, from the first comparison
+  FILE *out;
+};
+
+struct replay_worker {
+  pthread_t thread;
+  uint8_t id;
+  uint8_t nb_filters;
+  uint8_t filters[REPLAY_MAX_FILTERS];  ///< index of the filters in replay_filters
+  double cpu_time;                     ///< thread CPU time in seconds
+  uint32_t nb_events;
+  int error;
+};
+
+/* options */
+static const char *log_path;
+static uint8_t ac_id = 0;
+static double align_time = 2.;
+static const char *out_dir = NULL;
+static uint32_t decimation = 10;
+static uint8_t nb_threads = 1;
+
+static struct replay_stats stats[REPLAY_MAX_FILTERS];
+static bool_t filter_selected[REPLAY_MAX_FILTERS];
+static struct replay_worker workers[REPLAY_MAX_THREADS];
+
+static inline double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/** Call a filter callback and account its execution time */
+#define TIMED_CALL(_s, _c, _call) {                             \
+    double _t0 = now_ns();                                      \
+    _call;                                                      \
+    double _dt = now_ns() - _t0;                                \
+    (_s)->nb_calls[_c]++;                                       \
+    (_s)->sum_ns[_c] += _dt;                                    \
+    if (_dt > (_s)->max_ns[_c]) { (_s)->max_ns[_c] = _dt; }     \
+  }
+
+/** Attitude error angle between the estimation and the reference */
+static double attitude_error(struct FloatQuat *q_ref, struct FloatQuat *q_est)
+{
+  struct FloatQuat q_err;
+  float_quat_inv_comp(&q_err, q_ref, q_est);
+  double qi = fabs(q_err.qi);
+  if (qi > 1.) {
+    qi = 1.;
+  }
+  return 2. * acos(qi);
+}
+
+static void compare_attitude(const struct replay_filter *f, struct replay_stats *s, struct FloatQuat *q_ref)
+{
+  struct FloatQuat q;
+  f->get_quat(&q);
+  double err = attitude_error(q_ref, &q);
+  s->nb_att++;
+  s->sum_att_err2 += err * err;
+  if (err > s->max_att_err) {
+    s->max_att_err = err;
+  }
+}
+
+static void compare_ned(const struct replay_filter *f, struct replay_stats *s, struct FloatVect3 *ref_pos,
+                        struct FloatVect3 *ref_speed)
+{
+  struct FloatVect3 pos, speed, diff;
+  if (f->get_ned == NULL || !f->get_ned(&pos, &speed)) {
+    return;
+  }
+  if (!s->pos_offset_set) {
+    VECT3_DIFF(s->pos_offset, pos, *ref_pos);
+    s->pos_offset_set = TRUE;
+  }
+  VECT3_DIFF(diff, speed, *ref_speed);
+  s->sum_speed_err2 += VECT3_NORM2(diff);
+  VECT3_DIFF(diff, pos, *ref_pos);
+  VECT3_SUB(diff, s->pos_offset);
+  s->sum_pos_err2 += VECT3_NORM2(diff);
+  s->nb_ned++;
+}
+
+static void output_estimate(const struct replay_filter *f, struct replay_stats *s, double time)
+{
+  struct FloatQuat q;
+  struct FloatEulers e;
+  struct FloatVect3 pos, speed;
+  f->get_quat(&q);
+  float_eulers_of_quat(&e, &q);
+  fprintf(s->out, "%f %f %f %f", time, DegOfRad(e.phi), DegOfRad(e.theta), DegOfRad(e.psi));
+  if (f->get_ned != NULL) {
+    f->get_ned(&pos, &speed);
+    fprintf(s->out, " %f %f %f %f %f %f", pos.x, pos.y, pos.z, speed.x, speed.y, speed.z);
+  }
+  fprintf(s->out, "\n");
+}
+
+static void *worker_run(void *arg)
+{
+  struct replay_worker *w = (struct replay_worker *)arg;
+  struct replay_reader reader;
+  struct replay_event ev;
+  struct Int32Rates sum_gyro = { 0, 0, 0 };
+  struct Int32Vect3 sum_accel = { 0, 0, 0 }, sum_mag = { 0, 0, 0 };
+  uint32_t nb_gyro = 0, nb_accel = 0, nb_mag = 0, nb_propagate = 0;
+  struct Int32Vect3 last_accel = { 0, 0, ACCEL_BFP_OF_REAL(-9.81) };
+  double t_start = -1., t_gyro = -1., t_accel = -1., t_mag = -1.;
+  bool_t aligned = FALSE;
+  uint8_t i;
+
+  if (replay_reader_open(&reader, log_path, ac_id) < 0) {
+    perror(log_path);
+    w->error = 1;
+    return NULL;
+  }
+
+  for (i = 0; i < w->nb_filters; i++) {
+    replay_filters[w->filters[i]].init();
+  }
+
+  while (replay_reader_next(&reader, &ev)) {
+    w->nb_events++;
+    if (t_start < 0.) {
+      t_start = ev.time;
+    }
+
+    if (!aligned) {
+      /* average the sensors until the end of the alignment period */
+      switch (ev.type) {
+        case REPLAY_GYRO: RATES_ADD(sum_gyro, ev.data.gyro); nb_gyro++; break;
+        case REPLAY_ACCEL: VECT3_ADD(sum_accel, ev.data.accel); nb_accel++; break;
+        case REPLAY_MAG: VECT3_ADD(sum_mag, ev.data.mag); nb_mag++; break;
+        default: break;
+      }
+      if (ev.time - t_start < align_time || nb_gyro == 0 || nb_accel == 0) {
+        continue;
+      }
+      RATES_SDIV(sum_gyro, sum_gyro, (int32_t)nb_gyro);
+      VECT3_SDIV(sum_accel, sum_accel, (int32_t)nb_accel);
+      if (nb_mag > 0) {
+        VECT3_SDIV(sum_mag, sum_mag, (int32_t)nb_mag);
+      } else {
+        /* no magnetometer, align on north */
+        VECT3_ASSIGN(sum_mag, MAG_BFP_OF_REAL(1.), 0, 0);
+      }
+      for (i = 0; i < w->nb_filters; i++) {
+        const struct replay_filter *f = &replay_filters[w->filters[i]];
+        if (f->align != NULL) {
+          f->align(&sum_gyro, &sum_accel, &sum_mag);
+        }
+      }
+      VECT3_COPY(last_accel, sum_accel);
+      aligned = TRUE;
+      continue;
+    }
+
+    float dt;
+    switch (ev.type) {
+      case REPLAY_GYRO:
+        dt = (t_gyro < 0.) ? 0. : ev.time - t_gyro;
+        t_gyro = ev.time;
+        /* skip the first sample and gaps in the log */
+        if (dt <= 0. || dt > 0.1) {
+          break;
+        }
+        nb_propagate++;
+        for (i = 0; i < w->nb_filters; i++) {
+          const struct replay_filter *f = &replay_filters[w->filters[i]];
+          struct replay_stats *s = &stats[w->filters[i]];
+          TIMED_CALL(s, CALL_PROPAGATE, f->propagate(&ev.data.gyro, &last_accel, dt));
+          if (s->out != NULL && nb_propagate % decimation == 0) {
+            output_estimate(f, s, ev.time);
+          }
+        }
+        break;
+      case REPLAY_ACCEL:
+        dt = (t_accel < 0.) ? 0. : ev.time - t_accel;
+        t_accel = ev.time;
+        VECT3_COPY(last_accel, ev.data.accel);
+        for (i = 0; i < w->nb_filters; i++) {
+          const struct replay_filter *f = &replay_filters[w->filters[i]];
+          if (f->update_accel != NULL && dt > 0.) {
+            TIMED_CALL(&stats[w->filters[i]], CALL_ACCEL, f->update_accel(&ev.data.accel, dt));
+          }
+        }
+        break;
+      case REPLAY_MAG:
+        dt = (t_mag < 0.) ? 0. : ev.time - t_mag;
+        t_mag = ev.time;
+        for (i = 0; i < w->nb_filters; i++) {
+          const struct replay_filter *f = &replay_filters[w->filters[i]];
+          if (f->update_mag != NULL && dt > 0.) {
+            TIMED_CALL(&stats[w->filters[i]], CALL_MAG, f->update_mag(&ev.data.mag, dt));
+          }
+        }
+        break;
+      case REPLAY_GPS:
+        for (i = 0; i < w->nb_filters; i++) {
+          const struct replay_filter *f = &replay_filters[w->filters[i]];
+          if (f->update_gps != NULL) {
+            TIMED_CALL(&stats[w->filters[i]], CALL_GPS, f->update_gps(&ev.data.gps));
+          }
+        }
+        break;
+      case REPLAY_BARO:
+        for (i = 0; i < w->nb_filters; i++) {
+          const struct replay_filter *f = &replay_filters[w->filters[i]];
+          if (f->update_baro != NULL) {
+            TIMED_CALL(&stats[w->filters[i]], CALL_BARO, f->update_baro(ev.data.pressure));
+          }
+        }
+        break;
+      case REPLAY_REF_ATT:
+        for (i = 0; i < w->nb_filters; i++) {
+          compare_attitude(&replay_filters[w->filters[i]], &stats[w->filters[i]], &ev.data.ref_quat);
+        }
+        break;
+      case REPLAY_REF_POS:
+        for (i = 0; i < w->nb_filters; i++) {
+          compare_ned(&replay_filters[w->filters[i]], &stats[w->filters[i]], &ev.data.ref.pos,
+                      &ev.data.ref.speed);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  struct timespec cpu;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+  w->cpu_time = cpu.tv_sec + cpu.tv_nsec * 1e-9;
+  replay_reader_close(&reader);
+  return NULL;
+}
+
+static void print_results(void)
+{
+  uint8_t i, c, t;
+
+  printf("%-10s %6s", "filter", "thread");
+  for (c = 0; c < NB_CALLS; c++) {
+    printf(" %9s %8s", call_names[c], "max");
+  }
+  printf(" %9s %9s %9s %9s\n", "att (deg)", "max", "speed", "pos");
+  printf("%-10s %6s", "", "");
+  for (c = 0; c < NB_CALLS; c++) {
+    printf(" %9s %8s", "(us)", "(us)");
+  }
+  printf(" %9s %9s %9s %9s\n", "rms", "", "rms (m/s)", "rms (m)");
+
+  for (t = 0; t < nb_threads; t++) {
+    for (i = 0; i < workers[t].nb_filters; i++) {
+      uint8_t f = workers[t].filters[i];
+      struct replay_stats *s = &stats[f];
+      printf("%-10s %6d", replay_filters[f].name, t);
+      for (c = 0; c < NB_CALLS; c++) {
+        if (s->nb_calls[c] > 0) {
+          printf(" %9.3f %8.1f", s->sum_ns[c] / s->nb_calls[c] * 1e-3, s->max_ns[c] * 1e-3);
+        } else {
+          printf(" %9s %8s", "-", "-");
+        }
+      }
+      if (s->nb_att > 0) {
+        printf(" %9.3f %9.3f", DegOfRad(sqrt(s->sum_att_err2 / s->nb_att)), DegOfRad(s->max_att_err));
+      } else {
+        printf(" %9s %9s", "-", "-");
+      }
+      if (s->nb_ned > 0) {
+        printf(" %9.3f %9.3f\n", sqrt(s->sum_speed_err2 / s->nb_ned), sqrt(s->sum_pos_err2 / s->nb_ned));
+      } else {
+        printf(" %9s %9s\n", "-", "-");
+      }
+    }
+  }
+  for (t = 0; t < nb_threads; t++) {
+    printf("thread %d: %u events, %.3f s CPU\n", t, workers[t].nb_events, workers[t].cpu_time);
+  }
+}
+
+static void usage(const char *name)
+{
+  uint8_t i;
+  fprintf(stderr, "usage: %s [options] <log file (.data or pprzlog)>\n"
+          "  -f <names>  comma separated list of filters (default all)\n"
+          "  -j <n>      number of threads (default 1)\n"
+          "  -a <id>     aircraft ID (default any)\n"
+          "  -l <time>   alignment time in seconds (default 2)\n"
+          "  -o <dir>    write the estimates in dir/<filter>.txt\n"
+          "  -d <n>      only write one propagation out of n (default 10)\n"
+          "filters:", name);
+  for (i = 0; i < replay_filters_nb; i++) {
+    fprintf(stderr, " %s", replay_filters[i].name);
+  }
+  fprintf(stderr, "\n");
+}
+
+static int select_filters(char *names)
+{
+  char *name;
+  uint8_t i;
+
+  for (name = strtok(names, ","); name != NULL; name = strtok(NULL, ",")) {
+    for (i = 0; i < replay_filters_nb; i++) {
+      if (strcmp(name, replay_filters[i].name) == 0) {
+        filter_selected[i] = TRUE;
+        break;
+      }
+    }
+    if (i == replay_filters_nb) {
+      fprintf(stderr, "unknown filter %s\n", name);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  char *names = NULL;
+  uint8_t i, t;
+  int opt, ret = EXIT_SUCCESS;
+
+  while ((opt = getopt(argc, argv, "f:j:a:l:o:d:h")) != -1) {
+    switch (opt) {
+      case 'f': names = optarg; break;
+      case 'j': nb_threads = atoi(optarg); break;
+      case 'a': ac_id = atoi(optarg); break;
+      case 'l': align_time = atof(optarg); break;
+      case 'o': out_dir = optarg; break;
+      case 'd': decimation = atoi(optarg); break;
+      default: usage(argv[0]); return EXIT_FAILURE;
+    }
+  }
+  if (optind != argc - 1 || nb_threads < 1 || nb_threads > REPLAY_MAX_THREADS || decimation < 1) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  log_path = argv[optind];
+
+  if (names != NULL) {
+    if (select_filters(names) < 0) {
+      return EXIT_FAILURE;
+    }
+  } else {
+    for (i = 0; i < replay_filters_nb; i++) {
+      filter_selected[i] = TRUE;
+    }
+  }
+
+  /* filters of the same group are run by the same thread, groups are spread
+   * over the threads in table order */
+  int8_t thread_of_group[256];
+  uint8_t next_thread = 0;
+  memset(thread_of_group, -1, sizeof(thread_of_group));
+  for (i = 0; i < replay_filters_nb; i++) {
+    if (!filter_selected[i]) {
+      continue;
+    }
+    uint8_t group = replay_filters[i].group;
+    if (thread_of_group[group] < 0) {
+      thread_of_group[group] = next_thread;
+      next_thread = (next_thread + 1) % nb_threads;
+    }
+    struct replay_worker *w = &workers[thread_of_group[group]];
+    w->filters[w->nb_filters++] = i;
+    if (out_dir != NULL) {
+      char path[1024];
+      snprintf(path, sizeof(path), "%s/%s.txt", out_dir, replay_filters[i].name);
+      if ((stats[i].out = fopen(path, "w")) == NULL) {
+        perror(path);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  for (t = 0; t < nb_threads; t++) {
+    workers[t].id = t;
+    if (pthread_create(&workers[t].thread, NULL, worker_run, &workers[t]) != 0) {
+      perror("pthread_create");
+      return EXIT_FAILURE;
+    }
+  }
+  for (t = 0; t < nb_threads; t++) {
+    pthread_join(workers[t].thread, NULL);
+    if (workers[t].error) {
+      ret = EXIT_FAILURE;
+    }
+  }
+
+  for (i = 0; i < replay_filters_nb; i++) {
+    if (stats[i].out != NULL) {
+      fclose(stats[i].out);
+    }
+  }
+  if (ret == EXIT_SUCCESS) {
+    print_results();
+  }
+  return ret;
+}
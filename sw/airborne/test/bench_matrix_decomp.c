@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file bench_matrix_decomp.c
+ *
+ * Compare the execution time of the row pointer matrix decompositions with
+ * the contiguous fixed size kernels, for a few matrix sizes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_matrix_decomp_float.h"
+
+#define NB_RUNS 20000
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/** random symmetric positive definite matrix */
+static void random_spd(float *A, int n)
+{
+  float B[n * n];
+  int i, j, k;
+  for (i = 0; i < n * n; i++) {
+    B[i] = (float)rand() / RAND_MAX - 0.5f;
+  }
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      float s = (i == j) ? 1.f : 0.f;
+      for (k = 0; k < n; k++) {
+        s += B[i * n + k] * B[j * n + k];
+      }
+      A[i * n + j] = s;
+    }
+  }
+}
+
+/* keep the results alive */
+static volatile float sink;
+
+/** Time a call over NB_RUNS, in ns per call
+ * the setup (copy of the input) is included, it is the same for both versions
+ */
+#define BENCH(_res, _setup, _call) {                  \
+    int _r;                                           \
+    double _t0 = now_ns();                            \
+    for (_r = 0; _r < NB_RUNS; _r++) {                \
+      _setup;                                         \
+      _call;                                          \
+    }                                                 \
+    _res = (now_ns() - _t0) / NB_RUNS;                \
+  }
+
+#define BENCH_SIZE(_n) {                                                                  \
+    float A[_n * _n], W[_n * _n], Q[_n * _n], b[_n], x[_n], w[_n];                        \
+    float _p[_n][_n], _o[_n][_n], _q[_n][_n], _v[_n][_n], _b[_n][1], _x[_n][1];           \
+    MAKE_MATRIX_PTR(p, _p, _n);                                                           \
+    MAKE_MATRIX_PTR(o, _o, _n);                                                           \
+    MAKE_MATRIX_PTR(q, _q, _n);                                                           \
+    MAKE_MATRIX_PTR(v, _v, _n);                                                           \
+    MAKE_MATRIX_PTR(pb, _b, _n);                                                          \
+    MAKE_MATRIX_PTR(px, _x, _n);                                                          \
+    double t_ptr, t_fixed;                                                                \
+    int i;                                                                                \
+    random_spd(A, _n);                                                                    \
+    for (i = 0; i < _n; i++) { b[i] = i; _b[i][0] = i; }                                  \
+    BENCH(t_ptr, memcpy(_p, A, sizeof(A)), pprz_cholesky_float(o, p, _n));                \
+    BENCH(t_fixed, memcpy(W, A, sizeof(A)), pprz_cholesky_float##_n(W));                  \
+    sink = _o[_n - 1][_n - 1] + W[_n * _n - 1];                                           \
+    printf("%2d  %-26s %10.1f %10.1f %6.1fx\n", _n, "cholesky", t_ptr, t_fixed, t_ptr / t_fixed); \
+    BENCH(t_ptr, memcpy(_p, A, sizeof(A)), pprz_qr_float(q, o, p, _n, _n));               \
+    BENCH(t_fixed, memcpy(W, A, sizeof(A)), pprz_qr_float##_n(Q, W));                     \
+    sink = _o[_n - 1][_n - 1] + W[_n * _n - 1];                                           \
+    printf("%2d  %-26s %10.1f %10.1f %6.1fx\n", _n, "qr", t_ptr, t_fixed, t_ptr / t_fixed); \
+    BENCH(t_ptr, memcpy(_p, A, sizeof(A)),                                                \
+          pprz_svd_float(p, w, v, _n, _n); pprz_svd_solve_float(px, p, w, v, pb, _n, _n, 1)); \
+    BENCH(t_fixed, memcpy(W, A, sizeof(A)); memcpy(x, b, sizeof(b)),                      \
+          pprz_ldlt_float##_n(W); pprz_ldlt_solve_float##_n(W, x));                       \
+    sink = _x[_n - 1][0] + x[_n - 1];                                                     \
+    printf("%2d  %-26s %10.1f %10.1f %6.1fx\n", _n, "solve (svd / ldlt)", t_ptr, t_fixed, t_ptr / t_fixed); \
+    memcpy(W, A, sizeof(A));                                                              \
+    pprz_cholesky_float##_n(W);                                                           \
+    BENCH(t_ptr, memcpy(_p, A, sizeof(A)), pprz_cholesky_float(o, p, _n));                \
+    BENCH(t_fixed, memcpy(x, b, sizeof(b)), pprz_cholesky_update_float##_n(W, x, 1e-3f)); \
+    sink = _o[_n - 1][_n - 1] + W[_n * _n - 1];                                           \
+    printf("%2d  %-26s %10.1f %10.1f %6.1fx\n", _n, "refactor / rank-1 update", t_ptr, t_fixed, t_ptr / t_fixed); \
+  }
+
+int main(void)
+{
+  printf("%2s  %-26s %10s %10s %7s\n", "n", "", "ptr (ns)", "fixed (ns)", "speedup");
+  BENCH_SIZE(3);
+  BENCH_SIZE(6);
+  BENCH_SIZE(9);
+  BENCH_SIZE(12);
+  return 0;
+}
@@ -31,4 +31,4 @@ cdef extern from "math/pprz_algebra_int.h":
         int32_t m[3*3]
 
 cdef extern from "math/pprz_trig_int.h":
-    int16_t pprz_trig_int[]
+    uint16_t pprz_trig_int[]
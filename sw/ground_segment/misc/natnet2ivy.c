@@ -662,13 +662,11 @@ static void parse_options(int argc, char** argv) {
     else if (strcmp(argv[i], "-lla") == 0) {
       check_argcount(argc, argv, i, 3);
 
-      struct EcefCoor_d tracking_ecef;
       struct LlaCoor_d tracking_lla;
       tracking_lla.lat  = atof(argv[++i]);
       tracking_lla.lon  = atof(argv[++i]);
       tracking_lla.alt  = atof(argv[++i]);
-      ecef_of_lla_d(&tracking_ecef, &tracking_lla);
-      ltp_def_from_ecef_d(&tracking_ltp, &tracking_ecef);
+      ltp_def_from_lla_d(&tracking_ltp, &tracking_lla);
     }
     // Set the tracking system offset angle in degrees
     else if(strcmp(argv[i], "-offset_angle") == 0) {
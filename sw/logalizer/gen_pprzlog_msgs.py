@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2015 The Paparazzi Team
+#
+# This file is part of paparazzi.
+#
+# paparazzi is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# paparazzi is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with paparazzi; see the file COPYING.  If not, see
+# <http://www.gnu.org/licenses/>.
+
+"""
+Generate the message description tables used by the pprzlog decoder
+(pprzlog.h) from messages.xml.
+
+usage: gen_pprzlog_msgs.py messages.xml pprzlog_msgs.h
+"""
+
+from __future__ import print_function
+
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+# (class name, source index in pprzlog.h)
+CLASSES = [("telemetry", "PPRZLOG_SOURCE_TELEMETRY"), ("datalink", "PPRZLOG_SOURCE_DATALINK")]
+
+TYPES = {
+    "uint8": "PPRZLOG_UINT8", "int8": "PPRZLOG_INT8",
+    "uint16": "PPRZLOG_UINT16", "int16": "PPRZLOG_INT16",
+    "uint32": "PPRZLOG_UINT32", "int32": "PPRZLOG_INT32",
+    "uint64": "PPRZLOG_UINT64", "int64": "PPRZLOG_INT64",
+    "float": "PPRZLOG_FLOAT", "double": "PPRZLOG_DOUBLE",
+    "char": "PPRZLOG_CHAR", "string": "PPRZLOG_STRING"
+}
+
+TYPE_RE = re.compile(r"^(\w+)(\[(\d*)\])?$")
+
+
+def field_desc(field):
+    m = TYPE_RE.match(field.get("type"))
+    if m is None or m.group(1) not in TYPES:
+        raise ValueError("unknown type '%s' for field %s" % (field.get("type"), field.get("name")))
+    if m.group(2) is None:
+        array = "PPRZLOG_SCALAR"
+    elif m.group(3) == "":
+        array = "PPRZLOG_VAR_ARRAY"
+    else:
+        array = m.group(3)
+    return '  { "%s", %s, %s },\n' % (field.get("name"), TYPES[m.group(1)], array)
+
+
+def generate(xml_file, out):
+    tree = ET.parse(xml_file)
+    out.write("/* This file has been generated by gen_pprzlog_msgs.py from %s */\n" % xml_file)
+    out.write("/* Please DO NOT EDIT */\n\n")
+    out.write("#ifndef PPRZLOG_MSGS_H\n#define PPRZLOG_MSGS_H\n\n")
+    out.write('#include "pprzlog.h"\n\n')
+
+    tables = []
+    for (class_name, source) in CLASSES:
+        the_class = None
+        for c in tree.getroot().iter("msg_class"):
+            if c.get("name") == class_name:
+                the_class = c
+        if the_class is None:
+            raise ValueError("msg_class %s not found" % class_name)
+        entries = []
+        for msg in the_class.findall("message"):
+            name = msg.get("name")
+            msg_id = int(msg.get("id"), 0)
+            fields = msg.findall("field")
+            var = "pprzlog_%s_%s" % (class_name, name)
+            if fields:
+                out.write("static const struct pprzlog_field_desc %s_fields[] = {\n" % var)
+                for f in fields:
+                    out.write(field_desc(f))
+                out.write("};\n")
+                fields_var = var + "_fields"
+            else:
+                fields_var = "NULL"
+            out.write('static const struct pprzlog_msg_desc %s = { "%s", %d, %d, %s };\n\n'
+                      % (var, name, msg_id, len(fields), fields_var))
+            entries.append((msg_id, var))
+        tables.append((source, entries))
+
+    out.write("/** Message descriptions indexed by source and message ID */\n")
+    out.write("static const struct pprzlog_msg_desc *const pprzlog_msgs[PPRZLOG_NB_SOURCES][256] = {\n")
+    for (source, entries) in tables:
+        out.write("  [%s] = {\n" % source)
+        for (msg_id, var) in entries:
+            out.write("    [%d] = &%s,\n" % (msg_id, var))
+        out.write("  },\n")
+    out.write("};\n\n#endif /* PPRZLOG_MSGS_H */\n")
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        print(__doc__.strip())
+        sys.exit(1)
+    with open(sys.argv[2], "w") as out:
+        generate(sys.argv[1], out)
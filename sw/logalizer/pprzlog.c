@@ -0,0 +1,442 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pprzlog.c
+ *
+ * Reading, indexing and decoding of binary pprzlog files.
+ */
+
+#include "pprzlog.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/** Initial number of entries allocated for a message */
+#define PPRZLOG_INDEX_MIN 64
+
+static const uint8_t type_size[] = {
+  [PPRZLOG_UINT8] = 1, [PPRZLOG_INT8] = 1,
+  [PPRZLOG_UINT16] = 2, [PPRZLOG_INT16] = 2,
+  [PPRZLOG_UINT32] = 4, [PPRZLOG_INT32] = 4,
+  [PPRZLOG_UINT64] = 8, [PPRZLOG_INT64] = 8,
+  [PPRZLOG_FLOAT] = 4, [PPRZLOG_DOUBLE] = 8,
+  [PPRZLOG_CHAR] = 1, [PPRZLOG_STRING] = 1
+};
+
+static void reset(struct pprzlog *log)
+{
+  memset(log, 0, sizeof(struct pprzlog));
+  log->fd = -1;
+}
+
+int pprzlog_open(struct pprzlog *log, const char *path)
+{
+  struct stat st;
+
+  reset(log);
+  log->fd = open(path, O_RDONLY);
+  if (log->fd < 0) {
+    return -1;
+  }
+  if (fstat(log->fd, &st) < 0) {
+    close(log->fd);
+    log->fd = -1;
+    return -1;
+  }
+  log->size = st.st_size;
+  if (log->size == 0) {
+    return 0;
+  }
+  void *m = mmap(NULL, log->size, PROT_READ, MAP_PRIVATE, log->fd, 0);
+  if (m == MAP_FAILED) {
+    close(log->fd);
+    log->fd = -1;
+    return -1;
+  }
+  /* the index is built in a single forward pass */
+  madvise(m, log->size, MADV_SEQUENTIAL);
+  log->data = (const uint8_t *)m;
+  return 0;
+}
+
+void pprzlog_open_buffer(struct pprzlog *log, const uint8_t *data, size_t size)
+{
+  reset(log);
+  log->data = data;
+  log->size = size;
+}
+
+void pprzlog_close(struct pprzlog *log)
+{
+  int s, i;
+  for (s = 0; s < PPRZLOG_NB_SOURCES; s++) {
+    for (i = 0; i < 256; i++) {
+      free(log->index[s][i].entries);
+    }
+  }
+  if (log->fd >= 0) {
+    if (log->data != NULL) {
+      munmap((void *)log->data, log->size);
+    }
+    close(log->fd);
+  }
+  reset(log);
+}
+
+size_t pprzlog_check_frame(const uint8_t *data, size_t size, size_t offset)
+{
+  if (offset + PPRZLOG_OVERHEAD > size || data[offset] != PPRZLOG_STX) {
+    return 0;
+  }
+  const uint8_t *f = data + offset;
+  size_t len = f[1];
+  if (len < 2 || offset + len + PPRZLOG_OVERHEAD > size || f[2] >= PPRZLOG_NB_SOURCES) {
+    return 0;
+  }
+  uint8_t ck = 0;
+  size_t i;
+  for (i = 1; i < PPRZLOG_DATA_OFFSET + len; i++) {
+    ck += f[i];
+  }
+  if (ck != f[PPRZLOG_DATA_OFFSET + len]) {
+    return 0;
+  }
+  return len + PPRZLOG_OVERHEAD;
+}
+
+size_t pprzlog_next_frame(const struct pprzlog *log, size_t *offset)
+{
+  size_t i = *offset;
+  while (i + PPRZLOG_OVERHEAD <= log->size) {
+    const uint8_t *p = memchr(log->data + i, PPRZLOG_STX, log->size - i);
+    if (p == NULL) {
+      break;
+    }
+    i = p - log->data;
+    size_t len = pprzlog_check_frame(log->data, log->size, i);
+    if (len > 0) {
+      *offset = i;
+      return len;
+    }
+    i++;
+  }
+  *offset = log->size;
+  return 0;
+}
+
+static int add_entry(struct pprzlog_msg_index *idx, uint64_t offset, uint32_t ts)
+{
+  if (idx->nb == idx->size) {
+    uint32_t size = idx->size ? 2 * idx->size : PPRZLOG_INDEX_MIN;
+    struct pprzlog_entry *e = realloc(idx->entries, size * sizeof(struct pprzlog_entry));
+    if (e == NULL) {
+      return -1;
+    }
+    idx->entries = e;
+    idx->size = size;
+  }
+  idx->entries[idx->nb].offset = offset;
+  idx->entries[idx->nb].timestamp = ts;
+  idx->nb++;
+  return 0;
+}
+
+int64_t pprzlog_index(struct pprzlog *log)
+{
+  size_t i = 0;
+  size_t last_end = 0;
+  int in_sync = 1;
+
+  while (i + PPRZLOG_OVERHEAD <= log->size) {
+    const uint8_t *p = memchr(log->data + i, PPRZLOG_STX, log->size - i);
+    if (p == NULL) {
+      break;
+    }
+    if ((size_t)(p - log->data) != i) {
+      /* garbage where a frame was expected */
+      if (in_sync) {
+        log->nb_errors++;
+        in_sync = 0;
+      }
+      i = p - log->data;
+    }
+    size_t len = pprzlog_check_frame(log->data, log->size, i);
+    if (len == 0) {
+      /* not a valid frame, try again from the next byte */
+      if (in_sync) {
+        log->nb_errors++;
+        in_sync = 0;
+      }
+      i++;
+      continue;
+    }
+    const uint8_t *f = log->data + i;
+    uint32_t ts = (uint32_t)f[3] | ((uint32_t)f[4] << 8) | ((uint32_t)f[5] << 16) | ((uint32_t)f[6] << 24);
+    uint8_t msg_id = f[PPRZLOG_DATA_OFFSET + 1];
+    if (add_entry(&log->index[f[2]][msg_id], i, ts) < 0) {
+      return -1;
+    }
+    if (log->nb_msgs == 0) {
+      log->first_ts = ts;
+    }
+    log->last_ts = ts;
+    log->nb_msgs++;
+    log->nb_skipped += i - last_end;
+    i += len;
+    last_end = i;
+    in_sync = 1;
+  }
+  if (last_end < log->size) {
+    /* truncated frame or garbage at the end of the file */
+    if (in_sync) {
+      log->nb_errors++;
+    }
+    log->nb_skipped += log->size - last_end;
+  }
+  return log->nb_msgs;
+}
+
+uint32_t pprzlog_find_time(const struct pprzlog_msg_index *idx, uint32_t ts)
+{
+  uint32_t lo = 0, hi = idx->nb;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (idx->entries[mid].timestamp < ts) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static double read_value(enum pprzlog_type type, const uint8_t *p)
+{
+  switch (type) {
+    case PPRZLOG_UINT8: return *p;
+    case PPRZLOG_INT8: return (int8_t)*p;
+    case PPRZLOG_UINT16: { uint16_t v; memcpy(&v, p, 2); return v; }
+    case PPRZLOG_INT16: { int16_t v; memcpy(&v, p, 2); return v; }
+    case PPRZLOG_UINT32: { uint32_t v; memcpy(&v, p, 4); return v; }
+    case PPRZLOG_INT32: { int32_t v; memcpy(&v, p, 4); return v; }
+    case PPRZLOG_UINT64: { uint64_t v; memcpy(&v, p, 8); return (double)v; }
+    case PPRZLOG_INT64: { int64_t v; memcpy(&v, p, 8); return (double)v; }
+    case PPRZLOG_FLOAT: { float v; memcpy(&v, p, 4); return v; }
+    case PPRZLOG_DOUBLE: { double v; memcpy(&v, p, 8); return v; }
+    default: return NAN;
+  }
+}
+
+static inline int is_numeric(enum pprzlog_type type)
+{
+  return type != PPRZLOG_CHAR && type != PPRZLOG_STRING;
+}
+
+static inline int is_var_length(const struct pprzlog_field_desc *f)
+{
+  return f->array == PPRZLOG_VAR_ARRAY || f->type == PPRZLOG_STRING;
+}
+
+int pprzlog_decode(const struct pprzlog_msg_desc *desc, const uint8_t *pprz_data, uint8_t len,
+                   double *values, int max_values, uint8_t *nb_values)
+{
+  size_t pos = 2; // skip sender_id and msg_id
+  int n = 0, k = 0;
+  uint8_t i;
+
+  for (i = 0; i < desc->nb_fields; i++) {
+    const struct pprzlog_field_desc *f = &desc->fields[i];
+    size_t size = type_size[f->type];
+    size_t nb;
+    if (is_var_length(f)) {
+      if (pos >= len) {
+        return -1;
+      }
+      nb = pprz_data[pos++];
+      if (nb_values != NULL) {
+        nb_values[k] = nb;
+      }
+      k++;
+    } else if (f->array == PPRZLOG_SCALAR) {
+      nb = 1;
+    } else {
+      nb = f->array;
+    }
+    if (pos + nb * size > len) {
+      return -1;
+    }
+    if (is_numeric(f->type)) {
+      size_t j;
+      for (j = 0; j < nb; j++, n++) {
+        if (n < max_values) {
+          values[n] = read_value(f->type, pprz_data + pos + j * size);
+        }
+      }
+    }
+    pos += nb * size;
+  }
+  if (pos != len) {
+    return -1;
+  }
+  return n;
+}
+
+/** Number of variable length fields of a message */
+static int nb_var_fields(const struct pprzlog_msg_desc *desc)
+{
+  int k = 0;
+  uint8_t i;
+  for (i = 0; i < desc->nb_fields; i++) {
+    if (is_var_length(&desc->fields[i])) {
+      k++;
+    }
+  }
+  return k;
+}
+
+void pprzlog_columns_free(struct pprzlog_columns *cols)
+{
+  free(cols->time);
+  if (cols->data != NULL) {
+    free(cols->data[0]);
+  }
+  free(cols->data);
+  free(cols->names);
+  memset(cols, 0, sizeof(struct pprzlog_columns));
+}
+
+int pprzlog_export(const struct pprzlog *log, uint8_t source, const struct pprzlog_msg_desc *desc,
+                   uint32_t ts_start, uint32_t ts_end, struct pprzlog_columns *cols)
+{
+  const struct pprzlog_msg_index *idx = &log->index[source][desc->id];
+  uint32_t first = pprzlog_find_time(idx, ts_start);
+  uint32_t last = first;
+  uint32_t r;
+  int nb_var = nb_var_fields(desc);
+  uint8_t max_nb[256], nb[256];
+  double values[256];
+  uint16_t col_start[256];
+  uint8_t i;
+
+  memset(cols, 0, sizeof(struct pprzlog_columns));
+  while (last < idx->nb && idx->entries[last].timestamp <= ts_end) {
+    last++;
+  }
+
+  /* first pass: check the frames and find the longest variable arrays */
+  memset(max_nb, 0, sizeof(max_nb));
+  for (r = first; r < last; r++) {
+    const struct pprzlog_entry *e = &idx->entries[r];
+    if (pprzlog_decode(desc, pprzlog_pprz_data(log, e), pprzlog_pprz_len(log, e), values, 0, nb) < 0) {
+      cols->nb_invalid++;
+      continue;
+    }
+    int k;
+    for (k = 0; k < nb_var; k++) {
+      if (nb[k] > max_nb[k]) { max_nb[k] = nb[k]; }
+    }
+    cols->nb_rows++;
+  }
+
+  /* column layout and names */
+  int k = 0;
+  uint16_t nb_cols = 0;
+  for (i = 0; i < desc->nb_fields; i++) {
+    const struct pprzlog_field_desc *f = &desc->fields[i];
+    col_start[i] = nb_cols;
+    if (!is_numeric(f->type)) {
+      if (is_var_length(f)) { k++; }
+      continue;
+    }
+    if (f->array == PPRZLOG_SCALAR) {
+      nb_cols += 1;
+    } else if (f->array == PPRZLOG_VAR_ARRAY) {
+      nb_cols += max_nb[k++];
+    } else {
+      nb_cols += f->array;
+    }
+  }
+  cols->nb_cols = nb_cols;
+
+  cols->time = malloc((cols->nb_rows + 1) * sizeof(double));
+  cols->data = malloc((nb_cols + 1) * sizeof(double *));
+  cols->names = malloc((nb_cols + 1) * PPRZLOG_NAME_LEN);
+  if (cols->data != NULL) {
+    cols->data[0] = malloc(((size_t)nb_cols * cols->nb_rows + 1) * sizeof(double));
+  }
+  if (cols->time == NULL || cols->data == NULL || cols->names == NULL || cols->data[0] == NULL) {
+    pprzlog_columns_free(cols);
+    return -1;
+  }
+  uint16_t c;
+  for (c = 1; c < nb_cols; c++) {
+    cols->data[c] = cols->data[0] + (size_t)c * cols->nb_rows;
+  }
+  for (i = 0; i < desc->nb_fields; i++) {
+    const struct pprzlog_field_desc *f = &desc->fields[i];
+    uint16_t end = (i + 1 < desc->nb_fields) ? col_start[i + 1] : nb_cols;
+    for (c = col_start[i]; c < end; c++) {
+      if (f->array == PPRZLOG_SCALAR) {
+        snprintf(cols->names[c], PPRZLOG_NAME_LEN, "%s", f->name);
+      } else {
+        snprintf(cols->names[c], PPRZLOG_NAME_LEN, "%s[%d]", f->name, c - col_start[i]);
+      }
+    }
+  }
+
+  /* second pass: decode */
+  uint32_t row = 0;
+  for (r = first; r < last; r++) {
+    const struct pprzlog_entry *e = &idx->entries[r];
+    if (pprzlog_decode(desc, pprzlog_pprz_data(log, e), pprzlog_pprz_len(log, e), values, 256, nb) < 0) {
+      continue;
+    }
+    cols->time[row] = e->timestamp * PPRZLOG_TIME_UNIT;
+    int v = 0;
+    k = 0;
+    for (i = 0; i < desc->nb_fields; i++) {
+      const struct pprzlog_field_desc *f = &desc->fields[i];
+      int n;
+      if (is_var_length(f)) {
+        n = nb[k++];
+      } else if (f->array == PPRZLOG_SCALAR) {
+        n = 1;
+      } else {
+        n = f->array;
+      }
+      if (!is_numeric(f->type)) {
+        continue;
+      }
+      uint16_t end = (i + 1 < desc->nb_fields) ? col_start[i + 1] : nb_cols;
+      for (c = col_start[i]; c < end; c++) {
+        cols->data[c][row] = (c - col_start[i] < n) ? values[v++] : NAN;
+      }
+    }
+    row++;
+  }
+  return 0;
+}
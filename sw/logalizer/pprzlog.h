@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pprzlog.h
+ *
+ * Reading, indexing and decoding of binary pprzlog files.
+ *
+ * The log is the output of the on-board pprzlog transport
+ * (sw/airborne/subsystems/datalink/pprzlog_transport.c):
+ *
+ *   STX (0x99), LENGTH, SOURCE, TIMESTAMP (4 bytes, 100us), PPRZ_DATA, CHECKSUM
+ *
+ * where LENGTH is the size of PPRZ_DATA (sender_id, msg_id, payload) and
+ * CHECKSUM the 8 bits sum of the bytes from LENGTH to the end of PPRZ_DATA.
+ * SOURCE is 0 for telemetry and 1 for datalink messages.
+ *
+ * The file is memory mapped and scanned once to build a time index for each
+ * (source, message ID). Corrupted frames are skipped and the parser
+ * synchronizes again on the next valid frame. Messages are then decoded
+ * directly from the mapped file, using the message descriptions generated
+ * from messages.xml by gen_pprzlog_msgs.py.
+ */
+
+#ifndef PPRZLOG_H
+#define PPRZLOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PPRZLOG_STX 0x99
+/** Size of a frame without PPRZ_DATA (stx, length, source, timestamp, checksum) */
+#define PPRZLOG_OVERHEAD 8
+/** Offset of PPRZ_DATA in a frame */
+#define PPRZLOG_DATA_OFFSET 7
+/** Number of known sources (telemetry, datalink) */
+#define PPRZLOG_NB_SOURCES 2
+#define PPRZLOG_SOURCE_TELEMETRY 0
+#define PPRZLOG_SOURCE_DATALINK 1
+/** Timestamp resolution in seconds */
+#define PPRZLOG_TIME_UNIT 1e-4
+/** Maximum length of a column name */
+#define PPRZLOG_NAME_LEN 64
+
+/** Field types, as in messages.xml */
+enum pprzlog_type {
+  PPRZLOG_UINT8,
+  PPRZLOG_INT8,
+  PPRZLOG_UINT16,
+  PPRZLOG_INT16,
+  PPRZLOG_UINT32,
+  PPRZLOG_INT32,
+  PPRZLOG_UINT64,
+  PPRZLOG_INT64,
+  PPRZLOG_FLOAT,
+  PPRZLOG_DOUBLE,
+  PPRZLOG_CHAR,
+  PPRZLOG_STRING
+};
+
+/** Array kind of a field */
+#define PPRZLOG_SCALAR 0
+#define PPRZLOG_VAR_ARRAY -1
+/* any positive value is the length of a fixed array */
+
+struct pprzlog_field_desc {
+  const char *name;
+  enum pprzlog_type type;
+  int16_t array;            ///< PPRZLOG_SCALAR, PPRZLOG_VAR_ARRAY or fixed length
+};
+
+struct pprzlog_msg_desc {
+  const char *name;
+  uint8_t id;
+  uint8_t nb_fields;
+  const struct pprzlog_field_desc *fields;
+};
+
+/** One indexed frame */
+struct pprzlog_entry {
+  uint64_t offset;          ///< offset of the STX byte in the file
+  uint32_t timestamp;       ///< timestamp in 100us
+};
+
+/** All frames of a message, in file order */
+struct pprzlog_msg_index {
+  uint32_t nb;
+  uint32_t size;            ///< allocated entries
+  struct pprzlog_entry *entries;
+};
+
+struct pprzlog {
+  int fd;
+  const uint8_t *data;      ///< mapped file
+  size_t size;              ///< file size
+  struct pprzlog_msg_index index[PPRZLOG_NB_SOURCES][256];
+  uint64_t nb_msgs;         ///< number of valid frames
+  uint64_t nb_errors;       ///< number of corrupted parts (loss of synchronization)
+  uint64_t nb_skipped;      ///< number of bytes not part of a valid frame
+  uint32_t first_ts;        ///< timestamp of the first valid frame
+  uint32_t last_ts;         ///< timestamp of the last valid frame
+};
+
+/** Decoded columns of a message
+ * Each column holds one value per indexed frame. Variable length arrays
+ * use as many columns as the longest array found, missing values are NaN.
+ * Char arrays and strings are not exported.
+ */
+struct pprzlog_columns {
+  uint32_t nb_rows;
+  uint16_t nb_cols;
+  double *time;                       ///< time of each row in seconds
+  double **data;                      ///< data[col][row]
+  char (*names)[PPRZLOG_NAME_LEN];    ///< column names
+  uint32_t nb_invalid;                ///< frames not matching the description
+};
+
+/** Map a log file
+ * @return 0 on success, -1 on error (errno is set)
+ */
+extern int pprzlog_open(struct pprzlog *log, const char *path);
+
+/** Initialize a log from a buffer already in memory
+ * The buffer is not copied and must stay valid until pprzlog_close.
+ */
+extern void pprzlog_open_buffer(struct pprzlog *log, const uint8_t *data, size_t size);
+
+/** Unmap the file and free the index */
+extern void pprzlog_close(struct pprzlog *log);
+
+/** Scan the whole log and build the index
+ * @return number of valid frames, -1 on allocation failure
+ */
+extern int64_t pprzlog_index(struct pprzlog *log);
+
+/** Check a frame candidate at a given offset
+ * @return frame length if a valid frame starts at offset, 0 otherwise
+ */
+extern size_t pprzlog_check_frame(const uint8_t *data, size_t size, size_t offset);
+
+/** Find the next valid frame, synchronizing again after corrupted parts
+ * Allows to stream a log in file order without building the index.
+ * @param log log
+ * @param offset start offset, set to the beginning of the frame (output)
+ * @return frame length, 0 if there is no more valid frame
+ */
+extern size_t pprzlog_next_frame(const struct pprzlog *log, size_t *offset);
+
+/** Pointer to PPRZ_DATA (sender_id, msg_id, payload) of an indexed frame */
+static inline const uint8_t *pprzlog_pprz_data(const struct pprzlog *log, const struct pprzlog_entry *e)
+{
+  return log->data + e->offset + PPRZLOG_DATA_OFFSET;
+}
+
+/** Length of PPRZ_DATA of an indexed frame */
+static inline uint8_t pprzlog_pprz_len(const struct pprzlog *log, const struct pprzlog_entry *e)
+{
+  return log->data[e->offset + 1];
+}
+
+/** Find the first entry of a message with a timestamp greater or equal to ts
+ * Timestamps are assumed to be increasing in the file.
+ * @return index of the entry, idx->nb if none
+ */
+extern uint32_t pprzlog_find_time(const struct pprzlog_msg_index *idx, uint32_t ts);
+
+/** Decode a message payload
+ * Numerical values are written in field order, with array elements expanded.
+ * Char arrays and strings are skipped.
+ * @param desc message description
+ * @param pprz_data sender_id, msg_id, payload
+ * @param len length of pprz_data
+ * @param values output values
+ * @param max_values size of values, extra values are not written
+ * @param nb_values length of each variable array or string field (output, may be NULL)
+ * @return number of values in the message, -1 if the length doesn't match the description
+ */
+extern int pprzlog_decode(const struct pprzlog_msg_desc *desc, const uint8_t *pprz_data, uint8_t len,
+                          double *values, int max_values, uint8_t *nb_values);
+
+/** Decode all frames of a message between two timestamps into columns
+ * @param log indexed log
+ * @param source PPRZLOG_SOURCE_TELEMETRY or PPRZLOG_SOURCE_DATALINK
+ * @param desc message description
+ * @param ts_start first timestamp (100us)
+ * @param ts_end last timestamp (100us), included
+ * @param cols output columns, to free with pprzlog_columns_free
+ * @return 0 on success, -1 on allocation failure
+ */
+extern int pprzlog_export(const struct pprzlog *log, uint8_t source, const struct pprzlog_msg_desc *desc,
+                          uint32_t ts_start, uint32_t ts_end, struct pprzlog_columns *cols);
+
+extern void pprzlog_columns_free(struct pprzlog_columns *cols);
+
+#endif /* PPRZLOG_H */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pprzlog_index.c
+ *
+ * Index a binary pprzlog file (SD card or onboard logger) and export the
+ * decoded messages as columns.
+ *
+ * Without options, a summary of the log is printed (number of frames per
+ * message, rate, first and last time). With -e, each message is written in
+ * the output directory as:
+ *  - MSG.cols: number of rows and column names, one per line
+ *  - MSG.f64: columns of native doubles, the time column first
+ * which can be loaded in python with
+ * numpy.fromfile("MSG.f64").reshape(nb_cols + 1, nb_rows)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "pprzlog.h"
+#include "pprzlog_msgs.h"
+
+static const char *source_name[PPRZLOG_NB_SOURCES] = { "telemetry", "datalink" };
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [options] <log file>\n"
+          "  -e <dir>  export decoded messages as columns in dir\n"
+          "  -m <name> only export this message\n"
+          "  -s <time> start time in seconds\n"
+          "  -t <time> end time in seconds\n", name);
+}
+
+static void print_summary(const struct pprzlog *log)
+{
+  int s, i;
+
+  printf("%" PRIu64 " frames, %" PRIu64 " corrupted parts, %" PRIu64 " bytes skipped\n",
+         log->nb_msgs, log->nb_errors, log->nb_skipped);
+  printf("time %.4f to %.4f s\n", log->first_ts * PPRZLOG_TIME_UNIT, log->last_ts * PPRZLOG_TIME_UNIT);
+  printf("%-10s %4s %-28s %10s %10s %12s %12s\n", "class", "id", "name", "count", "rate (Hz)", "first (s)", "last (s)");
+  for (s = 0; s < PPRZLOG_NB_SOURCES; s++) {
+    for (i = 0; i < 256; i++) {
+      const struct pprzlog_msg_index *idx = &log->index[s][i];
+      if (idx->nb == 0) {
+        continue;
+      }
+      const struct pprzlog_msg_desc *desc = pprzlog_msgs[s][i];
+      double t0 = idx->entries[0].timestamp * PPRZLOG_TIME_UNIT;
+      double t1 = idx->entries[idx->nb - 1].timestamp * PPRZLOG_TIME_UNIT;
+      double rate = (t1 > t0) ? (idx->nb - 1) / (t1 - t0) : 0.;
+      printf("%-10s %4d %-28s %10u %10.2f %12.4f %12.4f\n", source_name[s], i,
+             desc ? desc->name : "unknown", idx->nb, rate, t0, t1);
+    }
+  }
+}
+
+static int export_msg(const struct pprzlog *log, uint8_t source, const struct pprzlog_msg_desc *desc,
+                      uint32_t ts_start, uint32_t ts_end, const char *dir)
+{
+  struct pprzlog_columns cols;
+  char path[1024];
+  FILE *f;
+  uint16_t c;
+
+  if (pprzlog_export(log, source, desc, ts_start, ts_end, &cols) < 0) {
+    fprintf(stderr, "%s: out of memory\n", desc->name);
+    return -1;
+  }
+  if (cols.nb_invalid > 0) {
+    fprintf(stderr, "%s: %u frames don't match messages.xml\n", desc->name, cols.nb_invalid);
+  }
+
+  snprintf(path, sizeof(path), "%s/%s.cols", dir, desc->name);
+  if ((f = fopen(path, "w")) == NULL) {
+    perror(path);
+    pprzlog_columns_free(&cols);
+    return -1;
+  }
+  fprintf(f, "%u\ntime\n", cols.nb_rows);
+  for (c = 0; c < cols.nb_cols; c++) {
+    fprintf(f, "%s\n", cols.names[c]);
+  }
+  fclose(f);
+
+  snprintf(path, sizeof(path), "%s/%s.f64", dir, desc->name);
+  if ((f = fopen(path, "wb")) == NULL) {
+    perror(path);
+    pprzlog_columns_free(&cols);
+    return -1;
+  }
+  int ok = (fwrite(cols.time, sizeof(double), cols.nb_rows, f) == cols.nb_rows);
+  for (c = 0; c < cols.nb_cols && ok; c++) {
+    ok = (fwrite(cols.data[c], sizeof(double), cols.nb_rows, f) == cols.nb_rows);
+  }
+  if (fclose(f) != 0 || !ok) {
+    perror(path);
+    ok = 0;
+  }
+  pprzlog_columns_free(&cols);
+  return ok ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+  struct pprzlog log;
+  const char *dir = NULL, *msg_name = NULL;
+  uint32_t ts_start = 0, ts_end = UINT32_MAX;
+  int opt, s, i, ret = EXIT_SUCCESS;
+
+  while ((opt = getopt(argc, argv, "e:m:s:t:h")) != -1) {
+    switch (opt) {
+      case 'e': dir = optarg; break;
+      case 'm': msg_name = optarg; break;
+      case 's': ts_start = (uint32_t)(atof(optarg) / PPRZLOG_TIME_UNIT); break;
+      case 't': ts_end = (uint32_t)(atof(optarg) / PPRZLOG_TIME_UNIT); break;
+      default: usage(argv[0]); return EXIT_FAILURE;
+    }
+  }
+  if (optind != argc - 1) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (pprzlog_open(&log, argv[optind]) < 0) {
+    fprintf(stderr, "%s: %s\n", argv[optind], strerror(errno));
+    return EXIT_FAILURE;
+  }
+  if (pprzlog_index(&log) < 0) {
+    fprintf(stderr, "out of memory while indexing\n");
+    pprzlog_close(&log);
+    return EXIT_FAILURE;
+  }
+
+  if (dir == NULL) {
+    print_summary(&log);
+  } else {
+    mkdir(dir, 0755);
+    for (s = 0; s < PPRZLOG_NB_SOURCES; s++) {
+      for (i = 0; i < 256; i++) {
+        const struct pprzlog_msg_desc *desc = pprzlog_msgs[s][i];
+        if (log.index[s][i].nb == 0 || desc == NULL) {
+          continue;
+        }
+        if (msg_name != NULL && strcmp(msg_name, desc->name) != 0) {
+          continue;
+        }
+        if (export_msg(&log, s, desc, ts_start, ts_end, dir) < 0) {
+          ret = EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  pprzlog_close(&log);
+  return ret;
+}
@@ -114,12 +114,49 @@ module Gen_onboard = struct
       Printf.fprintf h ";\n";
     ) messages
 
+  (* Include the static bindings of the modules *)
+  let print_static_bindings = fun h ->
+    Printf.fprintf h "\n/* Static bindings generated from the modules of the aircraft\n";
+    Printf.fprintf h " * ABI_STATIC_<message>(sender_id, ...) directly calls their callbacks\n";
+    Printf.fprintf h " */\n";
+    Printf.fprintf h "#ifdef ABI_STATIC\n";
+    Printf.fprintf h "#include \"generated/abi_bindings.h\"\n";
+    Printf.fprintf h "#endif\n"
+
   (* Print a bind function *)
   let print_msg_bind = fun h msg ->
     let name = String.capitalize msg.name in
     Printf.fprintf h "\nstatic inline void AbiBindMsg%s(uint8_t sender_id, abi_event * ev, abi_callback%s cb) {\n" name name;
     Printf.fprintf h "  ev->id = sender_id;\n";
     Printf.fprintf h "  ev->cb = (abi_callback)cb;\n";
+    Printf.fprintf h "  ev->ring = NULL;\n";
+    Printf.fprintf h "  ABI_PREPEND(abi_queues[ABI_%s_ID],ev);\n" name;
+    Printf.fprintf h "}\n"
+
+  (* Fields passed by pointer are copied by value in the queued messages *)
+  let is_pointer = fun t -> String.length t > 0 && t.[String.length t - 1] = '*'
+  let value_type = fun t ->
+    if is_pointer t then String.trim (String.sub t 0 (String.length t - 1)) else t
+
+  (* Print the message copy, its unpack function and the queued bind function *)
+  let print_msg_queued = fun h msg ->
+    let name = String.capitalize msg.name in
+    Printf.fprintf h "\nstruct abi_msg_%s {\n" name;
+    Printf.fprintf h "  uint8_t sender_id;\n";
+    List.iter (fun (n, t) -> Printf.fprintf h "  %s %s;\n" (value_type t) n) msg.fields;
+    Printf.fprintf h "};\n";
+    Printf.fprintf h "\nstatic inline void abi_deliver_%s(abi_event * ev, void * msg) {\n" name;
+    Printf.fprintf h "  struct abi_msg_%s * m = (struct abi_msg_%s *)msg;\n" name name;
+    Printf.fprintf h "  abi_callback%s cb = (abi_callback%s)(ev->cb);\n" name name;
+    Printf.fprintf h "  cb(m->sender_id";
+    List.iter (fun (n, t) -> Printf.fprintf h ", %sm->%s" (if is_pointer t then "&" else "") n) msg.fields;
+    Printf.fprintf h ");\n";
+    Printf.fprintf h "}\n";
+    Printf.fprintf h "\nstatic inline void AbiBindQueuedMsg%s(uint8_t sender_id, abi_event * ev, abi_callback%s cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_%s * buf, uint16_t nb) {\n" name name name;
+    Printf.fprintf h "  abi_ring_init(r, q, ev, abi_deliver_%s, (uint8_t *)buf, sizeof(struct abi_msg_%s), nb);\n" name name;
+    Printf.fprintf h "  ev->id = sender_id;\n";
+    Printf.fprintf h "  ev->cb = (abi_callback)cb;\n";
+    Printf.fprintf h "  ev->ring = r;\n";
     Printf.fprintf h "  ABI_PREPEND(abi_queues[ABI_%s_ID],ev);\n" name;
     Printf.fprintf h "}\n"
 
@@ -136,12 +173,25 @@ module Gen_onboard = struct
     Printf.fprintf h "\nstatic inline void AbiSendMsg%s" name;
     print_args h msg.fields;
     Printf.fprintf h " {\n";
+    Printf.fprintf h "#ifdef ABI_STATIC_%s\n" name;
+    Printf.fprintf h "  ABI_STATIC_%s(sender_id" name;
+    args h msg.fields;
+    Printf.fprintf h "#endif\n";
     Printf.fprintf h "  abi_event* e;\n";
     Printf.fprintf h "  ABI_FOREACH(abi_queues[ABI_%s_ID],e) {\n" name;
     Printf.fprintf h "    if (e->id == ABI_BROADCAST || e->id == sender_id) {\n";
-    Printf.fprintf h "      abi_callback%s cb = (abi_callback%s)(e->cb);\n" name name;
-    Printf.fprintf h "      cb(sender_id";
+    Printf.fprintf h "      if (e->ring == NULL) {\n";
+    Printf.fprintf h "        abi_callback%s cb = (abi_callback%s)(e->cb);\n" name name;
+    Printf.fprintf h "        cb(sender_id";
     args h msg.fields;
+    Printf.fprintf h "      } else {\n";
+    Printf.fprintf h "        struct abi_msg_%s * m = (struct abi_msg_%s *)abi_ring_reserve(e->ring);\n" name name;
+    Printf.fprintf h "        if (m != NULL) {\n";
+    Printf.fprintf h "          m->sender_id = sender_id;\n";
+    List.iter (fun (n, t) -> Printf.fprintf h "          m->%s = %s%s;\n" n (if is_pointer t then "*" else "") n) msg.fields;
+    Printf.fprintf h "          abi_ring_commit(e->ring);\n";
+    Printf.fprintf h "        }\n";
+    Printf.fprintf h "      }\n";
     Printf.fprintf h "    }\n";
     Printf.fprintf h "  }\n";
     Printf.fprintf h "}\n"
@@ -151,6 +201,7 @@ module Gen_onboard = struct
     Printf.fprintf h "\n/* Bind and Send functions */\n";
     List.iter (fun msg ->
       print_msg_bind h msg;
+      print_msg_queued h msg;
       print_msg_send h msg
     ) messages
 
@@ -191,6 +242,9 @@ let () =
     (** Print Messages callbacks definition *)
     Gen_onboard.print_callbacks h messages;
 
+    (** Print static bindings include *)
+    Gen_onboard.print_static_bindings h;
+
     (** Print Bind and Send functions for all messages *)
     Gen_onboard.print_bind_send h messages;
 
@@ -116,6 +116,54 @@ let print_status = fun modules ->
       (Xml.children m))
     modules
 
+(** Periodic and event functions with execution time statistics (SYS_TIME_PROF) *)
+let prof_functions = fun modules ->
+  List.flatten (List.map (fun m ->
+    List.filter (fun i -> Xml.tag i = "periodic" || Xml.tag i = "event") (Xml.children m))
+                  modules)
+
+let prof_index = fun modules f ->
+  let rec find = fun i l ->
+    match l with
+      [] -> failwith "Gen_modules: unknown function"
+    | x :: l' -> if x == f then i else find (i+1) l' in
+  find 0 (prof_functions modules)
+
+let print_prof_declarations = fun modules ->
+  nl ();
+  lprintf out_h "#define MODULES_PROF_NB %d\n" (List.length (prof_functions modules));
+  lprintf out_h "#if SYS_TIME_PROF\n";
+  lprintf out_h "#include \"mcu_periph/sys_time.h\"\n";
+  lprintf out_h "extern struct sys_time_prof modules_prof[];\n";
+  lprintf out_h "extern const char *modules_prof_name[];\n";
+  lprintf out_h "#endif\n"
+
+let print_prof = fun modules ->
+  let functions = prof_functions modules in
+  nl ();
+  lprintf out_h "#if SYS_TIME_PROF\n";
+  if functions <> [] then begin
+    lprintf out_h "struct sys_time_prof modules_prof[MODULES_PROF_NB];\n";
+    lprintf out_h "const char *modules_prof_name[MODULES_PROF_NB] = {\n";
+    right ();
+    List.iter (fun f -> lprintf out_h "\"%s\",\n" (get_status_shortname f)) functions;
+    left ();
+    lprintf out_h "};\n"
+  end;
+  lprintf out_h "#define ModulesProfStart(_i) sys_time_prof_start(&modules_prof[_i])\n";
+  lprintf out_h "#define ModulesProfStop(_i) sys_time_prof_stop(&modules_prof[_i])\n";
+  lprintf out_h "#else\n";
+  lprintf out_h "#define ModulesProfStart(_i) {}\n";
+  lprintf out_h "#define ModulesProfStop(_i) {}\n";
+  lprintf out_h "#endif\n"
+
+(** Print a function call with its statistics *)
+let print_prof_call = fun modules f ->
+  let idx = prof_index modules f in
+  lprintf out_h "ModulesProfStart(%d);\n" idx;
+  lprintf out_h "%s;\n" (Xml.attrib f "fun");
+  lprintf out_h "ModulesProfStop(%d);\n" idx
+
 let print_init_functions = fun modules ->
   lprintf out_h "\nstatic inline void modules_init(void) {\n";
   right ();
@@ -136,14 +184,112 @@ let print_init_functions = fun modules ->
   left ();
   lprintf out_h "}\n"
 
-let print_periodic_functions = fun modules ->
+(** Cost of a periodic function in usec (cost attribute, e.g. exec_avg
+ * of the TASK_PROF message of sys_mon),
+ * functions without a declared cost count as 1us for the balancing *)
+let get_cost = fun f ->
+  try Some (float_of_string (Xml.attrib f "cost")) with _ -> None
+
+let balancing_cost = fun f ->
+  match get_cost f with Some c -> c | None -> 1.
+
+let test_delay = fun x -> try let _ = Xml.attrib x "delay" in true with _ -> false
+
+let rec gcd = fun a b -> if b = 0 then a else gcd b (a mod b)
+
+(** Max number of ticks of the simulated schedule *)
+let max_hyperperiod = 65536
+
+(** Compute the phase of each periodic function.
+ * Functions are placed by decreasing cost, each one at the phase where
+ * the most loaded of the ticks it runs in is the least loaded.
+ * The load is simulated over the least common multiple of the periods,
+ * or over the first max_hyperperiod ticks when it is larger (only an
+ * estimate of the load then, as the schedule repeats after the lcm).
+ * Returns the list of ((function, module name), period, phase) in the
+ * order of the modules, the load of each simulated tick in usec (declared
+ * costs only) and true if the simulation covers the complete schedule
+ *)
+let schedule_periodic = fun functions ->
+  let lcm = List.fold_left (fun h (_, p) ->
+    if h > max_hyperperiod then h else h / (gcd h p) * p) 1 functions in
+  let exact = lcm <= max_hyperperiod in
+  let h = if exact then lcm else max_hyperperiod in
+  let load = Array.make h 0.
+  and load_us = Array.make h 0. in
+  (** ticks of the simulated schedule where a function runs *)
+  let ticks = fun p phase ->
+    let rec loop = fun k l -> if k >= h then l else loop (k + p) (k :: l) in
+    loop phase [] in
+  let indexed = Array.to_list (Array.mapi (fun i x -> (i, x)) (Array.of_list functions)) in
+  (** functions with a delay set by the user are placed first *)
+  let sorted = List.stable_sort (fun (_, ((f, _), p)) (_, ((f', _), p')) ->
+    let d = compare (test_delay f') (test_delay f) in
+    let c = compare (balancing_cost f') (balancing_cost f) in
+    if d <> 0 then d else if c <> 0 then c else compare p p') indexed in
+  let scheduled = List.map (fun (i, ((f, name), p)) ->
+    let phase =
+      if test_delay f then begin
+        (** Delay is set by user *)
+        let delay = int_of_string (Xml.attrib f "delay") in
+        if delay >= p then
+          fprintf stderr "Warning: delay is bound between 0 and %d for function %s\n" (p-1) (Xml.attrib f "fun");
+        delay mod p
+      end
+      else begin
+        (** Least loaded phase, first compare the max then the sum of the loads *)
+        let best = ref 0 and best_max = ref infinity and best_sum = ref infinity in
+        for phase = 0 to p - 1 do
+          let l = ticks p phase in
+          let m = List.fold_left (fun m k -> max m load.(k)) 0. l
+          and s = List.fold_left (fun s k -> s +. load.(k)) 0. l in
+          if m < !best_max || (m = !best_max && s < !best_sum) then begin
+            best := phase;
+            best_max := m;
+            best_sum := s
+          end
+        done;
+        !best
+      end in
+    List.iter (fun k ->
+      load.(k) <- load.(k) +. balancing_cost f;
+      load_us.(k) <- load_us.(k) +. (match get_cost f with Some c -> c | None -> 0.))
+      (ticks p phase);
+    (i, ((f, name), p, phase))) sorted in
+  let scheduled = List.map snd (List.sort (fun (i, _) (i', _) -> compare i i') scheduled) in
+  (scheduled, load_us, exact)
+
+(** Print the predicted load at build time,
+ * and in the header when it was simulated over the complete schedule *)
+let print_periodic_load = fun functions load exact ->
+  let tick_us = 1e6 /. float !freq in
+  let nb = Array.length load in
+  let max_tick = ref 0 in
+  Array.iteri (fun k l -> if l > load.(!max_tick) then max_tick := k) load;
+  let max_load = if nb > 0 then load.(!max_tick) else 0.
+  and avg_load = if nb > 0 then (Array.fold_left (+.) 0. load) /. float nb else 0. in
+  let no_cost = List.length (List.filter (fun ((f, _), _) -> get_cost f = None) functions) in
+  if exact then begin
+    nl ();
+    lprintf out_h "/** Predicted load of modules_periodic_task in usec, from the declared costs */\n";
+    lprintf out_h "#define MODULES_PERIODIC_LOAD_MAX %.1f\n" max_load;
+    lprintf out_h "#define MODULES_PERIODIC_LOAD_AVG %.1f\n" avg_load
+  end;
+  fprintf stderr "Info: modules periodic load %.1fus max (tick %d), %.1fus average, %.1fus per tick" max_load !max_tick avg_load tick_us;
+  if not exact then fprintf stderr ", estimated over the first %d ticks" nb;
+  if no_cost > 0 then fprintf stderr " (%d functions without cost)" no_cost;
+  fprintf stderr "\n%!";
+  (** the max of the simulated ticks is reached even when not exact *)
+  if max_load > tick_us then
+    fprintf stderr "Warning: the predicted modules periodic load is larger than the tick period\n%!"
+
+(** Periodic functions with their period in ticks of the main frequency *)
+let get_functions_modulo = fun modules ->
   let min_period = 1. /. float !freq
   and max_period = 65536. /. float !freq
   and min_freq   = float !freq /. 65536.
   and max_freq   = float !freq in
 
-  lprintf out_h "\nstatic inline void modules_periodic_task(void) {\n";
-  right ();
   (** Computes the required modulos *)
   let functions_modulo = List.flatten (List.map (fun m ->
     let periodic = List.filter (fun i -> (String.compare (Xml.tag i) "periodic") == 0) (Xml.children m) in
@@ -156,12 +302,19 @@ let print_periodic_functions = fun modules ->
       ((x, module_name), min 65535 (max 1 (int_of_float (p *. float_of_int !freq))))
     ) periodic)
                                          modules) in
+  functions_modulo
+
+let print_periodic_functions = fun modules functions_modulo scheduled ->
+  lprintf out_h "\nstatic inline void modules_periodic_task(void) {\n";
+  right ();
   let modulos = GC.singletonize (List.map snd functions_modulo) in
   (** Print modulos *)
   List.iter (fun modulo ->
-    let v = sprintf "i%d" modulo in
-    let _type = if modulo >= 256 then "uint16_t" else "uint8_t" in
-    lprintf out_h "static %s %s; %s++; if (%s>=%d) %s=0;\n" _type v v v modulo v;)
+    if modulo > 1 then begin
+      let v = sprintf "i%d" modulo in
+      let _type = if modulo >= 256 then "uint16_t" else "uint8_t" in
+      lprintf out_h "static %s %s; %s++; if (%s>=%d) %s=0;\n" _type v v v modulo v
+    end)
     modulos;
   (** Print start and stop functions *)
   List.iter (fun m ->
@@ -191,59 +344,42 @@ let print_periodic_functions = fun modules ->
     )
       periodic)
     modules;
-  (** Print periodic functions *)
-  let functions = List.sort (fun (_,p) (_,p') -> compare p p') functions_modulo in
-  let i = ref 0 in (** Basic balancing:1 function every 10Hz FIXME *)
-  let l = ref [] in
-  nl ();
-  let test_delay = fun x -> try let _ = Xml.attrib x "delay" in true with _ -> false in
-  List.iter (fun ((func, name), p) ->
-    let function_name = ExtXml.attrib func "fun" in
-    if p = 1 then
-      begin
-        if (is_status_lock func) then
-          lprintf out_h "%s;\n" function_name
-        else begin
-          lprintf out_h "if (%s == MODULES_RUN) {\n" (get_status_name func name);
-          right ();
-          lprintf out_h "%s;\n" function_name;
-          left ();
-          lprintf out_h "}\n";
-        end
-      end
-    else
-      begin
-        if (test_delay func) then begin
-          (** Delay is set by user *)
-          let delay = int_of_string (Xml.attrib func "delay") in
-          if delay >= p then fprintf stderr "Warning: delay is bound between 0 and %d for function %s\n" (p-1) function_name;
-          let delay_p = delay mod p in
-          let else_ = if List.mem_assoc p !l && not (List.mem (p, delay_p) !l) then
-              "else " else "" in
-          if (is_status_lock func) then
-            lprintf out_h "%sif (i%d == %d) {\n" else_ p delay_p
-          else
-            lprintf out_h "%sif (i%d == %d && %s == MODULES_RUN) {\n" else_ p delay_p (get_status_name func name);
-          l := (p, delay_p) :: !l;
-        end
-        else begin
-          (** Delay is automtically set *)
-          i := !i mod p;
-          let else_ = if List.mem_assoc p !l && not (List.mem (p, !i) !l) then "else " else "" in
-          if (is_status_lock func) then
-            lprintf out_h "%sif (i%d == %d) {\n" else_ p !i
-          else
-            lprintf out_h "%sif (i%d == %d && %s == MODULES_RUN) {\n" else_ p !i (get_status_name func name);
-          l := (p, !i) :: !l;
-          let incr = p / ((List.length (List.filter (fun (_,p') -> compare p p' == 0) functions)) + 1) in
-          i := !i + incr;
-        end;
+  (** Print a function call, checking its status *)
+  let print_call = fun (func, name) ->
+    if (is_status_lock func) then
+      print_prof_call modules func
+    else begin
+      lprintf out_h "if (%s == MODULES_RUN) {\n" (get_status_name func name);
+      right ();
+      print_prof_call modules func;
+      left ();
+      lprintf out_h "}\n"
+    end in
+  (** Print the dispatch table of each rate, one case per phase *)
+  List.iter (fun modulo ->
+    let functions = List.filter (fun (_, p, _) -> p = modulo) scheduled in
+    nl ();
+    if modulo = 1 then
+      List.iter (fun (f, _, _) -> print_call f) functions
+    else begin
+      let phases = GC.singletonize (List.map (fun (_, _, phase) -> phase) functions) in
+      lprintf out_h "switch (i%d) {\n" modulo;
+      right ();
+      List.iter (fun phase ->
+        lprintf out_h "case %d:\n" phase;
         right ();
-        lprintf out_h "%s;\n" function_name;
-        left ();
-        lprintf out_h "}\n"
-      end;
-  ) functions;
+        List.iter (fun (f, _, phase') -> if phase' = phase then print_call f) functions;
+        lprintf out_h "break;\n";
+        left ())
+        phases;
+      lprintf out_h "default:\n";
+      right ();
+      lprintf out_h "break;\n";
+      left ();
+      left ();
+      lprintf out_h "}\n"
+    end)
+    modulos;
   left ();
   lprintf out_h "}\n"
 
@@ -253,7 +389,7 @@ let print_event_functions = fun modules ->
   List.iter (fun m ->
     List.iter (fun i ->
       match Xml.tag i with
-          "event" -> lprintf out_h "%s;\n" (Xml.attrib i "fun")
+          "event" -> print_prof_call modules i
         | _ -> ())
       (Xml.children m))
     modules;
@@ -263,29 +399,79 @@ let print_event_functions = fun modules ->
 let print_datalink_functions = fun modules ->
   lprintf out_h "\n#include \"messages.h\"\n";
   lprintf out_h "#include \"generated/airframe.h\"\n";
-  lprintf out_h "static inline void modules_parse_datalink(uint8_t msg_id __attribute__ ((unused))) {\n";
+  lprintf out_h "#include \"subsystems/datalink/dl_dispatch.h\"\n";
+  (** Collect datalink nodes, each one gets its own handler and event *)
+  let dl = List.flatten (List.map (fun m ->
+    List.filter (fun i -> Xml.tag i = "datalink") (Xml.children m))
+                           modules) in
+  let idx = ref 0 in
+  List.iter (fun i ->
+    lprintf out_h "static struct dl_msg_event modules_dl_ev_%d;\n" !idx;
+    lprintf out_h "static bool_t modules_dl_cb_%d(uint8_t *buf __attribute__ ((unused))) { %s; return FALSE; }\n" !idx (ExtXml.attrib i "fun");
+    incr idx)
+    dl;
+  lprintf out_h "\nstatic inline void modules_datalink_init(void) {\n";
   right ();
-  let else_ = ref "" in
-  List.iter (fun m ->
-    List.iter (fun i ->
-      match Xml.tag i with
-          "datalink" ->
-            lprintf out_h "%sif (msg_id == DL_%s) { %s; }\n" !else_ (ExtXml.attrib i "message") (ExtXml.attrib i "fun");
-            else_ := "else "
-        | _ -> ())
-      (Xml.children m))
-    modules;
+  idx := 0;
+  List.iter (fun i ->
+    lprintf out_h "DlBindMsg(DL_%s, &modules_dl_ev_%d, modules_dl_cb_%d);\n" (ExtXml.attrib i "message") !idx !idx;
+    incr idx)
+    dl;
   left ();
   lprintf out_h "}\n"
 
+(** Static ABI bindings, included by abi_messages.h with ABI_STATIC
+ * the callbacks are called directly by the send functions instead of
+ * going through the list of dynamic bindings *)
+let print_abi_bindings = fun out modules ->
+  let bindings = fun m -> List.filter (fun i -> Xml.tag i = "abi_bind") (Xml.children m) in
+  let modules = List.filter (fun m -> bindings m <> []) modules in
+  let all = List.flatten (List.map bindings modules) in
+  let sender = fun b -> ExtXml.attrib_or_default b "sender" "ABI_BROADCAST" in
+  let is_define = fun s -> s <> "ABI_BROADCAST" && (try ignore (int_of_string s); false with _ -> true) in
+  fprintf out "/* This file has been generated by gen_modules */\n";
+  fprintf out "/* Please DO NOT EDIT */\n\n";
+  fprintf out "#ifndef ABI_BINDINGS_H\n";
+  fprintf out "#define ABI_BINDINGS_H\n\n";
+  fprintf out "#include \"generated/airframe.h\"\n";
+  (** the module headers declare the callbacks *)
+  List.iter (fun m ->
+    let dir_name = try Xml.attrib m "dir" with _ -> Xml.attrib m "name" in
+    try
+      List.iter (fun h ->
+        let dir = ExtXml.attrib_or_default h "dir" dir_name in
+        fprintf out "#include \"%s/%s\"\n" dir (Xml.attrib h "name"))
+        (Xml.children (ExtXml.child m "header"))
+    with _ -> ())
+    modules;
+  (** sender ids not set in the airframe *)
+  List.iter (fun s ->
+    fprintf out "\n#ifndef %s\n#define %s ABI_BROADCAST\n#endif\n" s s)
+    (GC.singletonize (List.filter is_define (List.map sender all)));
+  List.iter (fun msg ->
+    fprintf out "\n#define ABI_STATIC_%s(_sender_id, ...) { \\\n" msg;
+    List.iter (fun b ->
+      if Xml.attrib b "message" = msg then
+        fprintf out "    if ((%s) == ABI_BROADCAST || (%s) == (_sender_id)) { %s(_sender_id, ##__VA_ARGS__); } \\\n"
+          (sender b) (sender b) (Xml.attrib b "fun"))
+      all;
+    fprintf out "  }\n")
+    (GC.singletonize (List.map (fun b -> Xml.attrib b "message") all));
+  fprintf out "\n#endif // ABI_BINDINGS_H\n"
+
 let parse_modules modules =
   print_headers modules;
   print_function_freq modules;
   print_status modules;
+  print_prof_declarations modules;
+  let functions_modulo = get_functions_modulo modules in
+  let scheduled, load, exact = schedule_periodic functions_modulo in
+  print_periodic_load functions_modulo load exact;
   nl ();
   fprintf out_h "#ifdef MODULES_C\n";
+  print_prof modules;
   print_init_functions modules;
-  print_periodic_functions modules;
+  print_periodic_functions modules functions_modulo scheduled;
   print_event_functions modules;
   nl ();
   fprintf out_h "#endif // MODULES_C\n";
@@ -377,8 +563,8 @@ let write_settings = fun xml_file out_set modules ->
 let h_name = "MODULES_H"
 
 let () =
-  if Array.length Sys.argv <> 4 then
-    failwith (Printf.sprintf "Usage: %s out_settings_file default_freq xml_file" Sys.argv.(0));
+  if Array.length Sys.argv <> 4 && Array.length Sys.argv <> 5 then
+    failwith (Printf.sprintf "Usage: %s out_settings_file default_freq xml_file [out_abi_bindings_file]" Sys.argv.(0));
   let xml_file = Sys.argv.(3)
   and default_freq = int_of_string(Sys.argv.(2))
   and out_set = open_out Sys.argv.(1) in
@@ -415,6 +601,11 @@ let () =
     finish h_name;
     write_settings xml_file out_set modules_list;
     close_out out_set;
+    if Array.length Sys.argv = 5 then begin
+      let out_abi = open_out Sys.argv.(4) in
+      print_abi_bindings out_abi modules_list;
+      close_out out_abi
+    end
   with
       Xml.Error e -> fprintf stderr "%s: XML error:%s\n" xml_file (Xml.error e); exit 1
     | Dtd.Prove_error e -> fprintf stderr "%s: DTD error:%s\n%!" xml_file (Dtd.prove_error e); exit 1
@@ -195,6 +195,17 @@ let print_persistent_settings = fun settings ->
   left();
   lprintf "};\n\n";
   lprintf "extern struct PersistentSettings pers_settings;\n\n";
+  (* description of the structure, used to store the settings by name *)
+  Xml2h.define "PERSISTENT_SETTINGS_NB" (string_of_int (List.length pers_settings));
+  lprintf "#define PERSISTENT_SETTINGS_DESC { \\\n";
+  idx := 0;
+  List.iter
+    (fun s ->
+      let v = ExtXml.attrib s "var" in
+      printf " { \"%s\", offsetof(struct PersistentSettings, s_%d), sizeof(pers_settings.s_%d) }, \\\n" v !idx !idx;
+      incr idx)
+    pers_settings;
+  lprintf "}\n\n";
   (*  Inline function to store persistent settings *)
   idx := 0;
   lprintf "static inline void persistent_settings_store( void ) {\n";
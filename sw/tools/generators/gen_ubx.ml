@@ -48,7 +48,7 @@ let c_type = fun format ->
     | "U1" -> "uint8_t"
     | _ -> failwith (sprintf "Gen_ubx.c_type: unknown format '%s'" format)
 
-let get_at = fun offset format block_size ->
+let get_at_bytes = fun offset format block_size ->
   let t = c_type format in
   let block_offset =
     if block_size = 0 then "" else sprintf "+%d*_ubx_block" block_size in
@@ -65,6 +65,16 @@ let get_at = fun offset format block_size ->
     | "U1" | "I1" -> sprintf "(%s)(*((uint8_t*)_ubx_payload+%d%s))" t offset block_offset
     | _ -> failwith (sprintf "Gen_ubx.c_type: unknown format '%s'" format)
 
+(** Fields of more than one byte are read with UbxGetField, a single load on
+ * little endian targets, the byte by byte version otherwise *)
+let get_at = fun offset format block_size ->
+  let bytes = get_at_bytes offset format block_size in
+  if sizeof format = 1 then bytes
+  else
+    let block_offset =
+      if block_size = 0 then "" else sprintf "+%d*_ubx_block" block_size in
+    sprintf "UbxGetField(%s, _ubx_payload, %d%s, %s)" (c_type format) offset block_offset bytes
+
 let define = fun x y ->
   fprintf out "#define %s %s\n" x y
 
@@ -165,6 +175,15 @@ let _ =
     define "UBX_SYNC1" "0xB5";
     define "UBX_SYNC2" "0x62";
 
+    fprintf out "\n/* UBX is little endian: fields are copied directly from the payload on\n";
+    fprintf out " * little endian targets, which is a single load when the field is aligned\n";
+    fprintf out " * or the target supports unaligned accesses */\n";
+    fprintf out "#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__\n";
+    define "UbxGetField(_type, _payload, _offset, _bytes)" "({ _type _v; __builtin_memcpy(&_v, (uint8_t*)(_payload)+(_offset), sizeof(_type)); _v; })";
+    fprintf out "#else\n";
+    define "UbxGetField(_type, _payload, _offset, _bytes)" "(_bytes)";
+    fprintf out "#endif\n";
+
     List.iter parse_class (Xml.children xml)
   with
       Xml.Error (em, ep) ->
@@ -0,0 +1,595 @@
+/* fake generated ABI messages file shared by the tests, output of gen_abi for conf/abi.xml */
+/* Please DO NOT EDIT */
+
+/* Onboard middleware library ABI
+ * send and receive messages of class airborne
+ */
+
+#ifndef ABI_MESSAGES_H
+#define ABI_MESSAGES_H
+
+#include "subsystems/abi_common.h"
+
+/* Messages IDs */
+#define ABI_BARO_ABS_ID 0
+#define ABI_BARO_DIFF_ID 1
+#define ABI_AGL_ID 2
+#define ABI_TEMPERATURE_ID 3
+#define ABI_IMU_GYRO_INT32_ID 4
+#define ABI_IMU_ACCEL_INT32_ID 5
+#define ABI_IMU_MAG_INT32_ID 6
+#define ABI_IMU_LOWPASSED_ID 7
+#define ABI_BODY_TO_IMU_QUAT_ID 8
+#define ABI_GEO_MAG_ID 9
+#define ABI_GPS_ID 10
+
+/* Array and linked list structure */
+#define ABI_MESSAGE_NB 11
+
+ABI_EXTERN abi_event* abi_queues[ABI_MESSAGE_NB];
+
+/* Callbacks */
+typedef void (*abi_callbackBARO_ABS)(uint8_t sender_id, float pressure);
+typedef void (*abi_callbackBARO_DIFF)(uint8_t sender_id, float pressure);
+typedef void (*abi_callbackAGL)(uint8_t sender_id, float distance);
+typedef void (*abi_callbackTEMPERATURE)(uint8_t sender_id, float temp);
+typedef void (*abi_callbackIMU_GYRO_INT32)(uint8_t sender_id, uint32_t stamp, struct Int32Rates * gyro);
+typedef void (*abi_callbackIMU_ACCEL_INT32)(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 * accel);
+typedef void (*abi_callbackIMU_MAG_INT32)(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 * mag);
+typedef void (*abi_callbackIMU_LOWPASSED)(uint8_t sender_id, uint32_t stamp, struct Int32Rates * gyro, struct Int32Vect3 * accel, struct Int32Vect3 * mag);
+typedef void (*abi_callbackBODY_TO_IMU_QUAT)(uint8_t sender_id, struct FloatQuat * q_b2i_f);
+typedef void (*abi_callbackGEO_MAG)(uint8_t sender_id, struct FloatVect3 * h);
+typedef void (*abi_callbackGPS)(uint8_t sender_id, uint32_t stamp, struct GpsState * gps_s);
+
+/* Static bindings generated from the modules of the aircraft
+ * ABI_STATIC_<message>(sender_id, ...) directly calls their callbacks
+ */
+#ifdef ABI_STATIC
+#include "generated/abi_bindings.h"
+#endif
+
+/* Bind and Send functions */
+
+static inline void AbiBindMsgBARO_ABS(uint8_t sender_id, abi_event * ev, abi_callbackBARO_ABS cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_BARO_ABS_ID],ev);
+}
+
+struct abi_msg_BARO_ABS {
+  uint8_t sender_id;
+  float pressure;
+};
+
+static inline void abi_deliver_BARO_ABS(abi_event * ev, void * msg) {
+  struct abi_msg_BARO_ABS * m = (struct abi_msg_BARO_ABS *)msg;
+  abi_callbackBARO_ABS cb = (abi_callbackBARO_ABS)(ev->cb);
+  cb(m->sender_id, m->pressure);
+}
+
+static inline void AbiBindQueuedMsgBARO_ABS(uint8_t sender_id, abi_event * ev, abi_callbackBARO_ABS cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_BARO_ABS * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_BARO_ABS, (uint8_t *)buf, sizeof(struct abi_msg_BARO_ABS), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_BARO_ABS_ID],ev);
+}
+
+static inline void AbiSendMsgBARO_ABS(uint8_t sender_id, float pressure) {
+#ifdef ABI_STATIC_BARO_ABS
+  ABI_STATIC_BARO_ABS(sender_id, pressure);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_BARO_ABS_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackBARO_ABS cb = (abi_callbackBARO_ABS)(e->cb);
+        cb(sender_id, pressure);
+      } else {
+        struct abi_msg_BARO_ABS * m = (struct abi_msg_BARO_ABS *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->pressure = pressure;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgBARO_DIFF(uint8_t sender_id, abi_event * ev, abi_callbackBARO_DIFF cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_BARO_DIFF_ID],ev);
+}
+
+struct abi_msg_BARO_DIFF {
+  uint8_t sender_id;
+  float pressure;
+};
+
+static inline void abi_deliver_BARO_DIFF(abi_event * ev, void * msg) {
+  struct abi_msg_BARO_DIFF * m = (struct abi_msg_BARO_DIFF *)msg;
+  abi_callbackBARO_DIFF cb = (abi_callbackBARO_DIFF)(ev->cb);
+  cb(m->sender_id, m->pressure);
+}
+
+static inline void AbiBindQueuedMsgBARO_DIFF(uint8_t sender_id, abi_event * ev, abi_callbackBARO_DIFF cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_BARO_DIFF * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_BARO_DIFF, (uint8_t *)buf, sizeof(struct abi_msg_BARO_DIFF), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_BARO_DIFF_ID],ev);
+}
+
+static inline void AbiSendMsgBARO_DIFF(uint8_t sender_id, float pressure) {
+#ifdef ABI_STATIC_BARO_DIFF
+  ABI_STATIC_BARO_DIFF(sender_id, pressure);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_BARO_DIFF_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackBARO_DIFF cb = (abi_callbackBARO_DIFF)(e->cb);
+        cb(sender_id, pressure);
+      } else {
+        struct abi_msg_BARO_DIFF * m = (struct abi_msg_BARO_DIFF *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->pressure = pressure;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgAGL(uint8_t sender_id, abi_event * ev, abi_callbackAGL cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_AGL_ID],ev);
+}
+
+struct abi_msg_AGL {
+  uint8_t sender_id;
+  float distance;
+};
+
+static inline void abi_deliver_AGL(abi_event * ev, void * msg) {
+  struct abi_msg_AGL * m = (struct abi_msg_AGL *)msg;
+  abi_callbackAGL cb = (abi_callbackAGL)(ev->cb);
+  cb(m->sender_id, m->distance);
+}
+
+static inline void AbiBindQueuedMsgAGL(uint8_t sender_id, abi_event * ev, abi_callbackAGL cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_AGL * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_AGL, (uint8_t *)buf, sizeof(struct abi_msg_AGL), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_AGL_ID],ev);
+}
+
+static inline void AbiSendMsgAGL(uint8_t sender_id, float distance) {
+#ifdef ABI_STATIC_AGL
+  ABI_STATIC_AGL(sender_id, distance);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_AGL_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackAGL cb = (abi_callbackAGL)(e->cb);
+        cb(sender_id, distance);
+      } else {
+        struct abi_msg_AGL * m = (struct abi_msg_AGL *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->distance = distance;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgTEMPERATURE(uint8_t sender_id, abi_event * ev, abi_callbackTEMPERATURE cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_TEMPERATURE_ID],ev);
+}
+
+struct abi_msg_TEMPERATURE {
+  uint8_t sender_id;
+  float temp;
+};
+
+static inline void abi_deliver_TEMPERATURE(abi_event * ev, void * msg) {
+  struct abi_msg_TEMPERATURE * m = (struct abi_msg_TEMPERATURE *)msg;
+  abi_callbackTEMPERATURE cb = (abi_callbackTEMPERATURE)(ev->cb);
+  cb(m->sender_id, m->temp);
+}
+
+static inline void AbiBindQueuedMsgTEMPERATURE(uint8_t sender_id, abi_event * ev, abi_callbackTEMPERATURE cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_TEMPERATURE * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_TEMPERATURE, (uint8_t *)buf, sizeof(struct abi_msg_TEMPERATURE), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_TEMPERATURE_ID],ev);
+}
+
+static inline void AbiSendMsgTEMPERATURE(uint8_t sender_id, float temp) {
+#ifdef ABI_STATIC_TEMPERATURE
+  ABI_STATIC_TEMPERATURE(sender_id, temp);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_TEMPERATURE_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackTEMPERATURE cb = (abi_callbackTEMPERATURE)(e->cb);
+        cb(sender_id, temp);
+      } else {
+        struct abi_msg_TEMPERATURE * m = (struct abi_msg_TEMPERATURE *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->temp = temp;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgIMU_GYRO_INT32(uint8_t sender_id, abi_event * ev, abi_callbackIMU_GYRO_INT32 cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_IMU_GYRO_INT32_ID],ev);
+}
+
+struct abi_msg_IMU_GYRO_INT32 {
+  uint8_t sender_id;
+  uint32_t stamp;
+  struct Int32Rates gyro;
+};
+
+static inline void abi_deliver_IMU_GYRO_INT32(abi_event * ev, void * msg) {
+  struct abi_msg_IMU_GYRO_INT32 * m = (struct abi_msg_IMU_GYRO_INT32 *)msg;
+  abi_callbackIMU_GYRO_INT32 cb = (abi_callbackIMU_GYRO_INT32)(ev->cb);
+  cb(m->sender_id, m->stamp, &m->gyro);
+}
+
+static inline void AbiBindQueuedMsgIMU_GYRO_INT32(uint8_t sender_id, abi_event * ev, abi_callbackIMU_GYRO_INT32 cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_IMU_GYRO_INT32 * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_IMU_GYRO_INT32, (uint8_t *)buf, sizeof(struct abi_msg_IMU_GYRO_INT32), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_IMU_GYRO_INT32_ID],ev);
+}
+
+static inline void AbiSendMsgIMU_GYRO_INT32(uint8_t sender_id, uint32_t stamp, struct Int32Rates * gyro) {
+#ifdef ABI_STATIC_IMU_GYRO_INT32
+  ABI_STATIC_IMU_GYRO_INT32(sender_id, stamp, gyro);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_IMU_GYRO_INT32_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackIMU_GYRO_INT32 cb = (abi_callbackIMU_GYRO_INT32)(e->cb);
+        cb(sender_id, stamp, gyro);
+      } else {
+        struct abi_msg_IMU_GYRO_INT32 * m = (struct abi_msg_IMU_GYRO_INT32 *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->stamp = stamp;
+          m->gyro = *gyro;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgIMU_ACCEL_INT32(uint8_t sender_id, abi_event * ev, abi_callbackIMU_ACCEL_INT32 cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_IMU_ACCEL_INT32_ID],ev);
+}
+
+struct abi_msg_IMU_ACCEL_INT32 {
+  uint8_t sender_id;
+  uint32_t stamp;
+  struct Int32Vect3 accel;
+};
+
+static inline void abi_deliver_IMU_ACCEL_INT32(abi_event * ev, void * msg) {
+  struct abi_msg_IMU_ACCEL_INT32 * m = (struct abi_msg_IMU_ACCEL_INT32 *)msg;
+  abi_callbackIMU_ACCEL_INT32 cb = (abi_callbackIMU_ACCEL_INT32)(ev->cb);
+  cb(m->sender_id, m->stamp, &m->accel);
+}
+
+static inline void AbiBindQueuedMsgIMU_ACCEL_INT32(uint8_t sender_id, abi_event * ev, abi_callbackIMU_ACCEL_INT32 cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_IMU_ACCEL_INT32 * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_IMU_ACCEL_INT32, (uint8_t *)buf, sizeof(struct abi_msg_IMU_ACCEL_INT32), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_IMU_ACCEL_INT32_ID],ev);
+}
+
+static inline void AbiSendMsgIMU_ACCEL_INT32(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 * accel) {
+#ifdef ABI_STATIC_IMU_ACCEL_INT32
+  ABI_STATIC_IMU_ACCEL_INT32(sender_id, stamp, accel);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_IMU_ACCEL_INT32_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackIMU_ACCEL_INT32 cb = (abi_callbackIMU_ACCEL_INT32)(e->cb);
+        cb(sender_id, stamp, accel);
+      } else {
+        struct abi_msg_IMU_ACCEL_INT32 * m = (struct abi_msg_IMU_ACCEL_INT32 *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->stamp = stamp;
+          m->accel = *accel;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgIMU_MAG_INT32(uint8_t sender_id, abi_event * ev, abi_callbackIMU_MAG_INT32 cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_IMU_MAG_INT32_ID],ev);
+}
+
+struct abi_msg_IMU_MAG_INT32 {
+  uint8_t sender_id;
+  uint32_t stamp;
+  struct Int32Vect3 mag;
+};
+
+static inline void abi_deliver_IMU_MAG_INT32(abi_event * ev, void * msg) {
+  struct abi_msg_IMU_MAG_INT32 * m = (struct abi_msg_IMU_MAG_INT32 *)msg;
+  abi_callbackIMU_MAG_INT32 cb = (abi_callbackIMU_MAG_INT32)(ev->cb);
+  cb(m->sender_id, m->stamp, &m->mag);
+}
+
+static inline void AbiBindQueuedMsgIMU_MAG_INT32(uint8_t sender_id, abi_event * ev, abi_callbackIMU_MAG_INT32 cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_IMU_MAG_INT32 * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_IMU_MAG_INT32, (uint8_t *)buf, sizeof(struct abi_msg_IMU_MAG_INT32), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_IMU_MAG_INT32_ID],ev);
+}
+
+static inline void AbiSendMsgIMU_MAG_INT32(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 * mag) {
+#ifdef ABI_STATIC_IMU_MAG_INT32
+  ABI_STATIC_IMU_MAG_INT32(sender_id, stamp, mag);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_IMU_MAG_INT32_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackIMU_MAG_INT32 cb = (abi_callbackIMU_MAG_INT32)(e->cb);
+        cb(sender_id, stamp, mag);
+      } else {
+        struct abi_msg_IMU_MAG_INT32 * m = (struct abi_msg_IMU_MAG_INT32 *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->stamp = stamp;
+          m->mag = *mag;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgIMU_LOWPASSED(uint8_t sender_id, abi_event * ev, abi_callbackIMU_LOWPASSED cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_IMU_LOWPASSED_ID],ev);
+}
+
+struct abi_msg_IMU_LOWPASSED {
+  uint8_t sender_id;
+  uint32_t stamp;
+  struct Int32Rates gyro;
+  struct Int32Vect3 accel;
+  struct Int32Vect3 mag;
+};
+
+static inline void abi_deliver_IMU_LOWPASSED(abi_event * ev, void * msg) {
+  struct abi_msg_IMU_LOWPASSED * m = (struct abi_msg_IMU_LOWPASSED *)msg;
+  abi_callbackIMU_LOWPASSED cb = (abi_callbackIMU_LOWPASSED)(ev->cb);
+  cb(m->sender_id, m->stamp, &m->gyro, &m->accel, &m->mag);
+}
+
+static inline void AbiBindQueuedMsgIMU_LOWPASSED(uint8_t sender_id, abi_event * ev, abi_callbackIMU_LOWPASSED cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_IMU_LOWPASSED * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_IMU_LOWPASSED, (uint8_t *)buf, sizeof(struct abi_msg_IMU_LOWPASSED), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_IMU_LOWPASSED_ID],ev);
+}
+
+static inline void AbiSendMsgIMU_LOWPASSED(uint8_t sender_id, uint32_t stamp, struct Int32Rates * gyro, struct Int32Vect3 * accel, struct Int32Vect3 * mag) {
+#ifdef ABI_STATIC_IMU_LOWPASSED
+  ABI_STATIC_IMU_LOWPASSED(sender_id, stamp, gyro, accel, mag);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_IMU_LOWPASSED_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackIMU_LOWPASSED cb = (abi_callbackIMU_LOWPASSED)(e->cb);
+        cb(sender_id, stamp, gyro, accel, mag);
+      } else {
+        struct abi_msg_IMU_LOWPASSED * m = (struct abi_msg_IMU_LOWPASSED *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->stamp = stamp;
+          m->gyro = *gyro;
+          m->accel = *accel;
+          m->mag = *mag;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgBODY_TO_IMU_QUAT(uint8_t sender_id, abi_event * ev, abi_callbackBODY_TO_IMU_QUAT cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_BODY_TO_IMU_QUAT_ID],ev);
+}
+
+struct abi_msg_BODY_TO_IMU_QUAT {
+  uint8_t sender_id;
+  struct FloatQuat q_b2i_f;
+};
+
+static inline void abi_deliver_BODY_TO_IMU_QUAT(abi_event * ev, void * msg) {
+  struct abi_msg_BODY_TO_IMU_QUAT * m = (struct abi_msg_BODY_TO_IMU_QUAT *)msg;
+  abi_callbackBODY_TO_IMU_QUAT cb = (abi_callbackBODY_TO_IMU_QUAT)(ev->cb);
+  cb(m->sender_id, &m->q_b2i_f);
+}
+
+static inline void AbiBindQueuedMsgBODY_TO_IMU_QUAT(uint8_t sender_id, abi_event * ev, abi_callbackBODY_TO_IMU_QUAT cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_BODY_TO_IMU_QUAT * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_BODY_TO_IMU_QUAT, (uint8_t *)buf, sizeof(struct abi_msg_BODY_TO_IMU_QUAT), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_BODY_TO_IMU_QUAT_ID],ev);
+}
+
+static inline void AbiSendMsgBODY_TO_IMU_QUAT(uint8_t sender_id, struct FloatQuat * q_b2i_f) {
+#ifdef ABI_STATIC_BODY_TO_IMU_QUAT
+  ABI_STATIC_BODY_TO_IMU_QUAT(sender_id, q_b2i_f);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_BODY_TO_IMU_QUAT_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackBODY_TO_IMU_QUAT cb = (abi_callbackBODY_TO_IMU_QUAT)(e->cb);
+        cb(sender_id, q_b2i_f);
+      } else {
+        struct abi_msg_BODY_TO_IMU_QUAT * m = (struct abi_msg_BODY_TO_IMU_QUAT *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->q_b2i_f = *q_b2i_f;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgGEO_MAG(uint8_t sender_id, abi_event * ev, abi_callbackGEO_MAG cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_GEO_MAG_ID],ev);
+}
+
+struct abi_msg_GEO_MAG {
+  uint8_t sender_id;
+  struct FloatVect3 h;
+};
+
+static inline void abi_deliver_GEO_MAG(abi_event * ev, void * msg) {
+  struct abi_msg_GEO_MAG * m = (struct abi_msg_GEO_MAG *)msg;
+  abi_callbackGEO_MAG cb = (abi_callbackGEO_MAG)(ev->cb);
+  cb(m->sender_id, &m->h);
+}
+
+static inline void AbiBindQueuedMsgGEO_MAG(uint8_t sender_id, abi_event * ev, abi_callbackGEO_MAG cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_GEO_MAG * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_GEO_MAG, (uint8_t *)buf, sizeof(struct abi_msg_GEO_MAG), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_GEO_MAG_ID],ev);
+}
+
+static inline void AbiSendMsgGEO_MAG(uint8_t sender_id, struct FloatVect3 * h) {
+#ifdef ABI_STATIC_GEO_MAG
+  ABI_STATIC_GEO_MAG(sender_id, h);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_GEO_MAG_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackGEO_MAG cb = (abi_callbackGEO_MAG)(e->cb);
+        cb(sender_id, h);
+      } else {
+        struct abi_msg_GEO_MAG * m = (struct abi_msg_GEO_MAG *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->h = *h;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+static inline void AbiBindMsgGPS(uint8_t sender_id, abi_event * ev, abi_callbackGPS cb) {
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = NULL;
+  ABI_PREPEND(abi_queues[ABI_GPS_ID],ev);
+}
+
+struct abi_msg_GPS {
+  uint8_t sender_id;
+  uint32_t stamp;
+  struct GpsState gps_s;
+};
+
+static inline void abi_deliver_GPS(abi_event * ev, void * msg) {
+  struct abi_msg_GPS * m = (struct abi_msg_GPS *)msg;
+  abi_callbackGPS cb = (abi_callbackGPS)(ev->cb);
+  cb(m->sender_id, m->stamp, &m->gps_s);
+}
+
+static inline void AbiBindQueuedMsgGPS(uint8_t sender_id, abi_event * ev, abi_callbackGPS cb, struct abi_queue * q, struct abi_ring * r, struct abi_msg_GPS * buf, uint16_t nb) {
+  abi_ring_init(r, q, ev, abi_deliver_GPS, (uint8_t *)buf, sizeof(struct abi_msg_GPS), nb);
+  ev->id = sender_id;
+  ev->cb = (abi_callback)cb;
+  ev->ring = r;
+  ABI_PREPEND(abi_queues[ABI_GPS_ID],ev);
+}
+
+static inline void AbiSendMsgGPS(uint8_t sender_id, uint32_t stamp, struct GpsState * gps_s) {
+#ifdef ABI_STATIC_GPS
+  ABI_STATIC_GPS(sender_id, stamp, gps_s);
+#endif
+  abi_event* e;
+  ABI_FOREACH(abi_queues[ABI_GPS_ID],e) {
+    if (e->id == ABI_BROADCAST || e->id == sender_id) {
+      if (e->ring == NULL) {
+        abi_callbackGPS cb = (abi_callbackGPS)(e->cb);
+        cb(sender_id, stamp, gps_s);
+      } else {
+        struct abi_msg_GPS * m = (struct abi_msg_GPS *)abi_ring_reserve(e->ring);
+        if (m != NULL) {
+          m->sender_id = sender_id;
+          m->stamp = stamp;
+          m->gps_s = *gps_s;
+          abi_ring_commit(e->ring);
+        }
+      }
+    }
+  }
+}
+
+#endif // ABI_MESSAGES_H
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file abi_static.c
+ * @brief Sender compiled with ABI_STATIC, like an IMU driver of an aircraft
+ * using the static bindings.
+ */
+
+#include "subsystems/abi.h"
+#include "abi_test.h"
+
+void abi_static_send(uint8_t sender_id, uint32_t n)
+{
+  struct Int32Rates gyro = { 1, 2, 3 };
+  for (uint32_t i = 0; i < n; i++) {
+    AbiSendMsgIMU_GYRO_INT32(sender_id, i, &gyro);
+  }
+}
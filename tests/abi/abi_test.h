@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file abi_test.h
+ * @brief Callbacks of the ABI dispatch test, as declared by a module header.
+ */
+
+#ifndef ABI_TEST_H
+#define ABI_TEST_H
+
+#include "std.h"
+#include "math/pprz_algebra_int.h"
+
+extern uint32_t test_gyro_nb;
+extern uint32_t test_gyro_filtered_nb;
+
+extern void test_gyro_cb(uint8_t sender_id, uint32_t stamp, struct Int32Rates *gyro);
+extern void test_gyro_filtered_cb(uint8_t sender_id, uint32_t stamp, struct Int32Rates *gyro);
+
+/** Send n messages with the static bindings */
+extern void abi_static_send(uint8_t sender_id, uint32_t n);
+
+#endif /* ABI_TEST_H */
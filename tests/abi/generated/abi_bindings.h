@@ -0,0 +1,21 @@
+/* fake generated file, output of gen_modules for a module with:
+ *   <abi_bind message="IMU_GYRO_INT32" fun="test_gyro_cb"/>
+ *   <abi_bind message="IMU_GYRO_INT32" sender="TEST_GYRO_ID" fun="test_gyro_filtered_cb"/>
+ */
+
+#ifndef ABI_BINDINGS_H
+#define ABI_BINDINGS_H
+
+#include "generated/airframe.h"
+#include "abi_test.h"
+
+#ifndef TEST_GYRO_ID
+#define TEST_GYRO_ID ABI_BROADCAST
+#endif
+
+#define ABI_STATIC_IMU_GYRO_INT32(_sender_id, ...) { \
+    if ((ABI_BROADCAST) == ABI_BROADCAST || (ABI_BROADCAST) == (_sender_id)) { test_gyro_cb(_sender_id, ##__VA_ARGS__); } \
+    if ((TEST_GYRO_ID) == ABI_BROADCAST || (TEST_GYRO_ID) == (_sender_id)) { test_gyro_filtered_cb(_sender_id, ##__VA_ARGS__); } \
+  }
+
+#endif // ABI_BINDINGS_H
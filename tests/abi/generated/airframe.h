@@ -0,0 +1,8 @@
+/* fake generated airframe file */
+
+#ifndef AIRFRAME_H
+#define AIRFRAME_H
+
+#define TEST_GYRO_ID 2
+
+#endif // AIRFRAME_H
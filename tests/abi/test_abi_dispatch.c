@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_abi_dispatch.c
+ * @brief Tests and benchmark of the ABI static and dynamic bindings.
+ *
+ * The same two callbacks (one for all senders, one for sender TEST_GYRO_ID)
+ * are called through the static bindings of abi_static.c, then through
+ * dynamic bindings, and the dispatch time per message is reported.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#define ABI_C 1
+#include "tap.h"
+#include "subsystems/abi.h"
+#include "generated/airframe.h"
+#include "abi_test.h"
+#include <time.h>
+
+#define NB_MSG 1000000
+
+#define ELAPSED_NS(_start, _n) ((double)(clock() - (_start)) / CLOCKS_PER_SEC / (_n) * 1e9)
+
+uint32_t test_gyro_nb;
+uint32_t test_gyro_filtered_nb;
+static int32_t gyro_sum;
+
+void test_gyro_cb(uint8_t sender_id __attribute__((unused)), uint32_t stamp __attribute__((unused)),
+                  struct Int32Rates *gyro)
+{
+  test_gyro_nb++;
+  gyro_sum += gyro->p;
+}
+
+void test_gyro_filtered_cb(uint8_t sender_id __attribute__((unused)), uint32_t stamp __attribute__((unused)),
+                           struct Int32Rates *gyro)
+{
+  test_gyro_filtered_nb++;
+  gyro_sum += gyro->q;
+}
+
+static abi_event gyro_ev, gyro_filtered_ev;
+
+static void dynamic_send(uint8_t sender_id, uint32_t n)
+{
+  struct Int32Rates gyro = { 1, 2, 3 };
+  for (uint32_t i = 0; i < n; i++) {
+    AbiSendMsgIMU_GYRO_INT32(sender_id, i, &gyro);
+  }
+}
+
+static void reset_counters(void)
+{
+  test_gyro_nb = 0;
+  test_gyro_filtered_nb = 0;
+}
+
+int main()
+{
+  note("running ABI dispatch tests");
+  plan(4);
+
+  /* static bindings, no dynamic binding yet */
+  reset_counters();
+  clock_t start = clock();
+  abi_static_send(1, NB_MSG);
+  double t_static = ELAPSED_NS(start, NB_MSG);
+  abi_static_send(TEST_GYRO_ID, 10);
+  ok(test_gyro_nb == NB_MSG + 10 && test_gyro_filtered_nb == 10, "static bindings filter the sender");
+
+  /* same bindings, dynamic */
+  AbiBindMsgIMU_GYRO_INT32(ABI_BROADCAST, &gyro_ev, test_gyro_cb);
+  AbiBindMsgIMU_GYRO_INT32(TEST_GYRO_ID, &gyro_filtered_ev, test_gyro_filtered_cb);
+  reset_counters();
+  start = clock();
+  dynamic_send(1, NB_MSG);
+  double t_dynamic = ELAPSED_NS(start, NB_MSG);
+  dynamic_send(TEST_GYRO_ID, 10);
+  ok(test_gyro_nb == NB_MSG + 10 && test_gyro_filtered_nb == 10, "dynamic bindings filter the sender");
+
+  /* dynamic bindings are still called with ABI_STATIC */
+  reset_counters();
+  abi_static_send(TEST_GYRO_ID, 10);
+  ok(test_gyro_nb == 20 && test_gyro_filtered_nb == 20, "static and dynamic bindings both called");
+
+  note("dispatch time per message: static %.1f ns, dynamic %.1f ns", t_static, t_dynamic);
+  ok(gyro_sum != 0, "callbacks received the data");
+
+  done_testing();
+}
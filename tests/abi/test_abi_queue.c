@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_abi_queue.c
+ * @brief Tests of the queued ABI events.
+ *
+ * A publisher thread sends messages received by a synchronous event,
+ * by a queued event dispatched in a subscriber thread and by a queued
+ * event of the main loop queue.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#define ABI_C 1
+#include "tap.h"
+#include "subsystems/abi.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NB_MSG 100000
+#define RING_SIZE 16
+
+/** Messages received by a callback */
+struct test_sub {
+  pthread_t thread;         ///< thread the callback must be called from
+  uint32_t nb;              ///< number of received messages
+  uint32_t wrong_thread;    ///< messages received in another thread
+  uint32_t corrupted;       ///< messages with wrong data
+  uint32_t unordered;       ///< messages received out of order
+  uint32_t last_stamp;
+};
+
+static struct test_sub sync_sub, thread_sub, main_sub;
+
+static void check_msg(struct test_sub *s, uint32_t stamp, struct Int32Rates *gyro)
+{
+  if (!pthread_equal(pthread_self(), s->thread)) {
+    s->wrong_thread++;
+  }
+  if (gyro->p != (int32_t)stamp || gyro->q != -(int32_t)stamp || gyro->r != (int32_t)(stamp * 3)) {
+    s->corrupted++;
+  }
+  if (s->nb > 0 && stamp <= s->last_stamp) {
+    s->unordered++;
+  }
+  s->last_stamp = stamp;
+  s->nb++;
+}
+
+static void sync_cb(uint8_t sender_id __attribute__((unused)), uint32_t stamp, struct Int32Rates *gyro)
+{
+  check_msg(&sync_sub, stamp, gyro);
+}
+
+static void thread_cb(uint8_t sender_id __attribute__((unused)), uint32_t stamp, struct Int32Rates *gyro)
+{
+  check_msg(&thread_sub, stamp, gyro);
+}
+
+static void main_cb(uint8_t sender_id __attribute__((unused)), uint32_t stamp, struct Int32Rates *gyro)
+{
+  check_msg(&main_sub, stamp, gyro);
+}
+
+static abi_event sync_ev, thread_ev, main_ev;
+static struct abi_queue thread_queue;
+static struct abi_ring thread_ring, main_ring;
+static struct abi_msg_IMU_GYRO_INT32 thread_msgs[RING_SIZE], main_msgs[RING_SIZE];
+static volatile uint32_t thread_notified;
+static volatile bool_t publisher_done;
+
+static void thread_notify(void)
+{
+  thread_notified++;
+}
+
+static void *publisher(void *arg __attribute__((unused)))
+{
+  sync_sub.thread = pthread_self();
+  for (uint32_t i = 1; i <= NB_MSG; i++) {
+    struct Int32Rates gyro = { i, -i, i * 3 };
+    AbiSendMsgIMU_GYRO_INT32(1, i, &gyro);
+    /* the gyro is a local of the sender, it must be copied */
+    gyro.p = gyro.q = gyro.r = 0;
+    if ((i & 0xff) == 0) {
+      usleep(10);
+    }
+  }
+  __atomic_store_n(&publisher_done, TRUE, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+static void *subscriber(void *arg __attribute__((unused)))
+{
+  while (!__atomic_load_n(&publisher_done, __ATOMIC_ACQUIRE)) {
+    abi_queue_dispatch(&thread_queue);
+  }
+  abi_queue_dispatch(&thread_queue);
+  return NULL;
+}
+
+static void test_threads(void)
+{
+  note("--- publisher and subscribers in different threads");
+  abi_queue_init(&thread_queue, thread_notify);
+  main_sub.thread = pthread_self();
+  AbiBindMsgIMU_GYRO_INT32(ABI_BROADCAST, &sync_ev, sync_cb);
+  AbiBindQueuedMsgIMU_GYRO_INT32(ABI_BROADCAST, &thread_ev, thread_cb, &thread_queue,
+                                 &thread_ring, thread_msgs, RING_SIZE);
+  AbiBindQueuedMsgIMU_GYRO_INT32(ABI_BROADCAST, &main_ev, main_cb, &abi_main_queue,
+                                 &main_ring, main_msgs, RING_SIZE);
+
+  pthread_t pub, sub;
+  pthread_create(&sub, NULL, subscriber, NULL);
+  thread_sub.thread = sub;
+  pthread_create(&pub, NULL, publisher, NULL);
+  /* main loop */
+  while (!__atomic_load_n(&publisher_done, __ATOMIC_ACQUIRE)) {
+    abi_queue_dispatch(&abi_main_queue);
+  }
+  abi_queue_dispatch(&abi_main_queue);
+  pthread_join(pub, NULL);
+  pthread_join(sub, NULL);
+
+  note("subscriber thread: %u received, %u dropped", thread_sub.nb, thread_ring.nb_dropped);
+  note("main loop: %u received, %u dropped", main_sub.nb, main_ring.nb_dropped);
+  ok(sync_sub.nb == NB_MSG && sync_sub.wrong_thread == 0, "synchronous callback called by the publisher");
+  ok(thread_sub.wrong_thread == 0 && main_sub.wrong_thread == 0, "queued callbacks called by their own thread");
+  ok(thread_sub.corrupted == 0 && main_sub.corrupted == 0, "queued messages copied");
+  ok(thread_sub.unordered == 0 && main_sub.unordered == 0, "queued messages delivered in order");
+  ok(thread_sub.nb + thread_ring.nb_dropped == NB_MSG && main_sub.nb + main_ring.nb_dropped == NB_MSG,
+     "all messages received or counted as dropped");
+  cmp_ok(thread_notified, "==", NB_MSG - thread_ring.nb_dropped, "subscriber notified for each queued message");
+}
+
+static void test_overflow(void)
+{
+  note("--- overflow");
+  struct abi_queue q;
+  struct abi_ring r;
+  abi_event ev;
+  abi_queues[ABI_IMU_GYRO_INT32_ID] = NULL;
+  abi_queue_init(&q, NULL);
+  memset(&thread_sub, 0, sizeof(thread_sub));
+  thread_sub.thread = pthread_self();
+  /* rounded down to 8 slots */
+  AbiBindQueuedMsgIMU_GYRO_INT32(ABI_BROADCAST, &ev, thread_cb, &q, &r, thread_msgs, 12);
+  cmp_ok(r.nb_slots, "==", 8, "number of slots rounded down to a power of 2");
+
+  for (uint32_t i = 1; i <= 20; i++) {
+    struct Int32Rates gyro = { i, -i, i * 3 };
+    AbiSendMsgIMU_GYRO_INT32(1, i, &gyro);
+  }
+  ok(r.nb_dropped == 12 && abi_queue_nb_dropped(&q) == 12, "messages over the ring size dropped");
+  cmp_ok(abi_queue_dispatch(&q), "==", 8, "first messages delivered");
+  ok(thread_sub.last_stamp == 8 && thread_sub.corrupted == 0, "oldest messages kept");
+  struct Int32Rates gyro = { 21, -21, 63 };
+  AbiSendMsgIMU_GYRO_INT32(1, 21, &gyro);
+  ok(abi_queue_dispatch(&q) == 1 && thread_sub.last_stamp == 21, "ring reused after dispatch");
+}
+
+int main()
+{
+  note("running ABI queue tests");
+  plan(11);
+
+  test_threads();
+  test_overflow();
+
+  done_testing();
+}
@@ -0,0 +1,11 @@
+/* fake generated airframe file */
+
+#ifndef AIRFRAME_H
+#define AIRFRAME_H
+
+/* magnetic field along the north axis */
+#define AHRS_H_X 1.
+#define AHRS_H_Y 0.
+#define AHRS_H_Z 0.
+
+#endif // AIRFRAME_H
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_ahrs_bank.c
+ * @brief Tests of the AHRS estimator bank with fixed propagation frequency.
+ *
+ * The float complementary filter (output) and the float MLKF (secondary)
+ * are registered in the bank and fed through ABI with IMU measurements at
+ * AHRS_PROPAGATE_FREQUENCY, as the IMU drivers do. The attitude must
+ * integrate the gyros, and the health of the filters must only be scored
+ * when the accel measures the gravity, not in a coordinated turn.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#define ABI_C 1
+#include "tap.h"
+#include "subsystems/ahrs.h"
+#include "subsystems/abi.h"
+#include "state.h"
+#include "mcu_periph/sys_time.h"
+#include <math.h>
+
+#define TEST_IMU_ID 1
+#define GRAVITY 9.81
+
+/* stubs of the autopilot */
+struct sys_time sys_time;
+struct GpsState gps;
+
+static uint32_t stamp;
+
+/** Advance the time by one IMU period */
+static void tick(void)
+{
+  stamp += 1000000 / AHRS_PROPAGATE_FREQUENCY;
+  sys_time.nb_sec = stamp / 1000000;
+  sys_time.nb_sec_rem = stamp % 1000000;
+}
+
+/** Align both filters level and heading north, IMU aligned with the body */
+static void align(void)
+{
+  struct FloatQuat q_b2i = { 1., 0., 0., 0. };
+  AbiSendMsgBODY_TO_IMU_QUAT(TEST_IMU_ID, &q_b2i);
+  struct Int32Rates gyro = { 0, 0, 0 };
+  struct Int32Vect3 accel = { 0, 0, ACCEL_BFP_OF_REAL(-GRAVITY) };
+  struct Int32Vect3 mag = { MAG_BFP_OF_REAL(1.), 0, 0 };
+  AbiSendMsgIMU_LOWPASSED(TEST_IMU_ID, stamp, &gyro, &accel, &mag);
+}
+
+static float mlkf_psi(void)
+{
+  struct FloatEulers e;
+  float_eulers_of_quat(&e, &ahrs_mlkf.ltp_to_imu_quat);
+  return e.psi;
+}
+
+static void test_propagation(void)
+{
+  note("--- propagation at the fixed frequency");
+  align();
+  ok(ahrs_fc.status == AHRS_FC_RUNNING && ahrs_mlkf.status == AHRS_MLKF_RUNNING, "filters aligned");
+
+  /* constant yaw rate for one second */
+  const float r = 0.5;
+  struct Int32Rates gyro = { 0, 0, RATE_BFP_OF_REAL(r) };
+  for (int i = 0; i < AHRS_PROPAGATE_FREQUENCY; i++) {
+    tick();
+    AbiSendMsgIMU_GYRO_INT32(TEST_IMU_ID, stamp, &gyro);
+  }
+  float psi = stateGetNedToBodyEulers_f()->psi;
+  note("heading after 1s at %.2f rad/s: output %.4f rad, mlkf %.4f rad", r, psi, mlkf_psi());
+  ok(fabsf(psi - r) < 0.01, "output attitude integrates a constant rate");
+  ok(fabsf(mlkf_psi() - r) < 0.01, "secondary attitude integrates a constant rate");
+}
+
+/** Send one IMU sample */
+static void imu_sample(struct FloatRates *rates, struct FloatVect3 *accel)
+{
+  struct Int32Rates gyro;
+  struct Int32Vect3 accel_i;
+  RATES_BFP_OF_REAL(gyro, *rates);
+  ACCELS_BFP_OF_REAL(accel_i, *accel);
+  tick();
+  AbiSendMsgIMU_GYRO_INT32(TEST_IMU_ID, stamp, &gyro);
+  AbiSendMsgIMU_ACCEL_INT32(TEST_IMU_ID, stamp, &accel_i);
+}
+
+static void test_health(void)
+{
+  note("--- health of the filters");
+  ok(!ahrs_bank.auto_switch, "automatic switch disabled by default");
+
+  /* at rest, level */
+  struct FloatRates rates = { 0., 0., 0. };
+  struct FloatVect3 accel = { 0., 0., -GRAVITY };
+  for (int i = 0; i < 2 * AHRS_PROPAGATE_FREQUENCY; i++) {
+    imu_sample(&rates, &accel);
+  }
+  note("health at rest: output %.3f, secondary %.3f", ahrs_bank.health[0], ahrs_bank.health[1]);
+  ok(ahrs_bank.health[0] < 1. && ahrs_bank.health[1] < 1., "health scored at rest");
+
+  /* roll to 25 deg, then coordinated turn at 20 m/s for 10 s */
+  ahrs_bank.auto_switch = TRUE;
+  const float health_out = ahrs_bank.health[0], health_sec = ahrs_bank.health[1];
+  const float phi = RadOfDeg(25.);
+  rates.p = phi / 0.5;
+  for (int i = 0; i < AHRS_PROPAGATE_FREQUENCY / 2; i++) {
+    imu_sample(&rates, &accel);
+  }
+  const float omega = GRAVITY * tanf(phi) / 20.;
+  rates.p = 0.;
+  rates.q = omega * sinf(phi);
+  rates.r = omega * cosf(phi);
+  accel.z = -GRAVITY / cosf(phi);
+  for (int i = 0; i < 10 * AHRS_PROPAGATE_FREQUENCY; i++) {
+    imu_sample(&rates, &accel);
+  }
+  note("bank angle after the turn: %.1f deg", DegOfRad(stateGetNedToBodyEulers_f()->phi));
+  ok(ahrs_bank.health[0] == health_out && ahrs_bank.health[1] == health_sec,
+     "health not scored in a coordinated turn");
+  cmp_ok(ahrs_bank.nb_switch, "==", 0, "no switch in a coordinated turn");
+}
+
+int main()
+{
+  note("running AHRS estimator bank tests");
+  plan(7);
+
+  sys_time.cpu_ticks_per_sec = 1000000;
+  ahrs_init();
+
+  test_propagation();
+  test_health();
+
+  done_testing();
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_telemetry_queue.c
+ * @brief Tests for the multi-producer telemetry queue.
+ *
+ * Several producer threads push messages while the main thread flushes them
+ * to a fake link device checking integrity and per producer ordering.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "subsystems/datalink/telemetry_queue.h"
+#include <pthread.h>
+#include <string.h>
+
+#define NB_PRODUCERS 4
+#define NB_MSGS 200000
+
+static struct telemetry_queue queue;
+static struct telemetry_queue_producer producers[NB_PRODUCERS];
+static volatile int producers_done;
+
+/** Fake link device checking the received messages */
+struct check_device {
+  uint8_t buf[TELEMETRY_QUEUE_MSG_SIZE];
+  uint16_t len;
+  uint32_t received[NB_PRODUCERS];
+  int32_t last_seq[NB_PRODUCERS];
+  uint32_t corrupted;
+  uint32_t unordered;
+  struct link_device device;
+};
+
+static struct check_device check;
+
+static int check_free_space(struct check_device *d __attribute__((unused)), uint8_t len __attribute__((unused)))
+{
+  return TRUE;
+}
+
+static void check_put_byte(struct check_device *d, uint8_t byte)
+{
+  if (d->len < TELEMETRY_QUEUE_MSG_SIZE) {
+    d->buf[d->len++] = byte;
+  }
+}
+
+/* message: producer id, 4 bytes sequence, length, length bytes of (seq + i) */
+static void check_send_message(struct check_device *d)
+{
+  uint8_t id = d->buf[0];
+  int32_t seq;
+  memcpy(&seq, &d->buf[1], 4);
+  uint8_t n = d->buf[5];
+  int i, ok = (id < NB_PRODUCERS && d->len == 6 + n);
+  for (i = 0; ok && i < n; i++) {
+    if (d->buf[6 + i] != (uint8_t)(seq + i)) {
+      ok = 0;
+    }
+  }
+  if (!ok) {
+    d->corrupted++;
+  } else {
+    if (seq <= d->last_seq[id]) {
+      d->unordered++;
+    }
+    d->last_seq[id] = seq;
+    d->received[id]++;
+  }
+  d->len = 0;
+}
+
+static void reset_message(struct check_device *d)
+{
+  d->len = 0;
+}
+
+static void *producer_thread(void *data)
+{
+  uint8_t id = (uint8_t)(long)data;
+  struct link_device *dev = &producers[id].device;
+  int32_t seq;
+  for (seq = 0; seq < NB_MSGS; seq++) {
+    uint8_t n = (uint8_t)(seq % 200);
+    int i;
+    dev->put_byte(dev->periph, id);
+    for (i = 0; i < 4; i++) {
+      dev->put_byte(dev->periph, ((uint8_t *)&seq)[i]);
+    }
+    dev->put_byte(dev->periph, n);
+    for (i = 0; i < n; i++) {
+      dev->put_byte(dev->periph, (uint8_t)(seq + i));
+    }
+    dev->send_message(dev->periph);
+  }
+  __sync_fetch_and_add(&producers_done, 1);
+  return NULL;
+}
+
+int main()
+{
+  note("running telemetry queue tests");
+  plan(7);
+
+  telemetry_queue_init(&queue);
+  memset(&check, 0, sizeof(check));
+  check.device.periph = (void *)&check;
+  check.device.check_free_space = (check_free_space_t) check_free_space;
+  check.device.put_byte = (put_byte_t) check_put_byte;
+  check.device.send_message = (send_message_t) check_send_message;
+
+  /* single thread: push until full then flush */
+  uint8_t msg[4] = {1, 2, 3, 4};
+  int i, nb = 0;
+  for (i = 0; i < TELEMETRY_QUEUE_SIZE + 10; i++) {
+    if (telemetry_queue_push(&queue, msg, 4)) { nb++; }
+  }
+  ok(nb == TELEMETRY_QUEUE_SIZE && queue.nb_dropped == 10,
+     "queue accepts %d messages and drops the others (got %d, dropped %d)",
+     TELEMETRY_QUEUE_SIZE, nb, queue.nb_dropped);
+  struct check_device dummy = check;
+  dummy.device.periph = (void *)&dummy;
+  dummy.device.send_message = (send_message_t) reset_message; // don't check content
+  ok(telemetry_queue_flush(&queue, &dummy.device) == TELEMETRY_QUEUE_SIZE,
+     "flush sends all queued messages");
+
+  /* messages too long for the link devices */
+  static uint8_t big[TELEMETRY_QUEUE_MSG_SIZE];
+  telemetry_queue_init(&queue);
+  ok(!telemetry_queue_push(&queue, big, 256) && queue.nb_dropped == 1 && telemetry_queue_push(&queue, big, 255),
+     "messages longer than 255 bytes are rejected and counted as dropped");
+  struct telemetry_queue_producer big_producer;
+  telemetry_queue_producer_init(&big_producer, &queue);
+  for (i = 0; i < 256; i++) {
+    big_producer.device.put_byte(big_producer.device.periph, 0);
+  }
+  big_producer.device.send_message(big_producer.device.periph);
+  ok(big_producer.nb_dropped == 1 && queue.nb_dropped == 2 && telemetry_queue_push(&queue, msg, 4) &&
+     telemetry_queue_flush(&queue, &dummy.device) == 2,
+     "producer drops a message longer than 255 bytes and the queue is not blocked");
+
+  /* multiple producers stress test */
+  telemetry_queue_init(&queue);
+  for (i = 0; i < NB_PRODUCERS; i++) {
+    telemetry_queue_producer_init(&producers[i], &queue);
+    check.last_seq[i] = -1;
+  }
+  pthread_t threads[NB_PRODUCERS];
+  for (i = 0; i < NB_PRODUCERS; i++) {
+    pthread_create(&threads[i], NULL, producer_thread, (void *)(long)i);
+  }
+  while (producers_done < NB_PRODUCERS) {
+    telemetry_queue_flush(&queue, &check.device);
+  }
+  for (i = 0; i < NB_PRODUCERS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  telemetry_queue_flush(&queue, &check.device);
+
+  uint32_t total_rx = 0, total_drop = 0;
+  int counts_ok = 1;
+  for (i = 0; i < NB_PRODUCERS; i++) {
+    note("producer %d: queued %u, dropped %u, received %u", i,
+         producers[i].nb_msgs, producers[i].nb_dropped, check.received[i]);
+    if (producers[i].nb_msgs != check.received[i] ||
+        producers[i].nb_msgs + producers[i].nb_dropped != NB_MSGS) {
+      counts_ok = 0;
+    }
+    total_rx += check.received[i];
+    total_drop += producers[i].nb_dropped;
+  }
+  ok(check.corrupted == 0, "no corrupted message (%u)", check.corrupted);
+  ok(check.unordered == 0, "messages of each producer are received in order (%u)", check.unordered);
+  ok(counts_ok && total_drop == queue.nb_dropped,
+     "every queued message is received and drops are counted per producer (rx %u, dropped %u)",
+     total_rx, total_drop);
+
+  done_testing();
+}
@@ -0,0 +1,436 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_gps_ubx.c
+ * @brief Tests and benchmark of the UBX parser.
+ *
+ * A receiver stream is generated as a u-blox receiver outputs it at 10 or
+ * 20 Hz (NAV-SOL, NAV-POSLLH, NAV-STATUS, NAV-VELNED every epoch, NAV-SVINFO
+ * every second, NMEA sentences in between). It is parsed byte per byte and
+ * by buffers, the decoded states and the time stamps are compared and the
+ * parsing time is reported. The field accessors generated by gen_ubx are
+ * checked against their byte per byte version.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#define ABI_C 1
+#include "tap.h"
+#include "subsystems/gps.h"
+#include "subsystems/abi.h"
+#include "ubx_protocol.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STREAM_DURATION 60
+#define STREAM_MAX (STREAM_DURATION * 20 * 600)
+#define NB_EPOCH_MAX (STREAM_DURATION * 20 * 6)
+
+/* stubs of the autopilot */
+struct GpsState gps;
+struct GpsTimeSync gps_time_sync;
+struct sys_time sys_time;
+
+void uart_transmit(struct uart_periph *p __attribute__((unused)), uint8_t data __attribute__((unused))) {}
+
+/** Receiver stream and position of the first byte of the messages sending the GPS state */
+static uint8_t stream[STREAM_MAX];
+static uint32_t stream_len;
+static uint32_t gps_msg_pos[NB_EPOCH_MAX];
+static uint32_t nb_gps_msg;
+
+/** Number of decoded messages, states and time stamps of the GPS messages */
+static uint32_t nb_msgs;
+static struct GpsState states[2][NB_EPOCH_MAX];
+static uint32_t stamps[NB_EPOCH_MAX];
+static uint32_t nb_gps[2];
+static int run;
+
+static abi_event gps_ev;
+
+static void gps_cb(uint8_t sender_id __attribute__((unused)), uint32_t stamp, struct GpsState *gps_s)
+{
+  if (nb_gps[run] < NB_EPOCH_MAX) {
+    memcpy(&states[run][nb_gps[run]], gps_s, sizeof(struct GpsState));
+    /* reception times depend on the run */
+    states[run][nb_gps[run]].last_msg_time = 0;
+    states[run][nb_gps[run]].last_3dfix_time = 0;
+    stamps[nb_gps[run]] = stamp;
+  }
+  nb_gps[run]++;
+}
+
+static void handle_msg(void)
+{
+  gps_ubx_msg();
+  nb_msgs++;
+}
+
+/** Reset the parser, run 0 is the reference */
+static void reset_parser(int r)
+{
+  memset(&gps, 0, sizeof(gps));
+  gps_impl_init();
+  run = r;
+  nb_msgs = 0;
+  nb_gps[r] = 0;
+}
+
+/*
+ * Stream generation
+ */
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+  put_u16(p, v);
+  put_u16(p + 2, v >> 16);
+}
+
+static void add_ubx(uint8_t cls, uint8_t id, uint8_t *payload, uint16_t len)
+{
+  uint8_t *p = &stream[stream_len];
+  p[0] = UBX_SYNC1;
+  p[1] = UBX_SYNC2;
+  p[2] = cls;
+  p[3] = id;
+  put_u16(&p[4], len);
+  memcpy(&p[6], payload, len);
+  uint8_t ck_a = 0, ck_b = 0;
+  for (int i = 2; i < 6 + len; i++) {
+    ck_a += p[i];
+    ck_b += ck_a;
+  }
+  p[6 + len] = ck_a;
+  p[7 + len] = ck_b;
+  stream_len += 8 + len;
+}
+
+static void generate_stream(int rate)
+{
+  uint8_t pl[256];
+  stream_len = 0;
+  nb_gps_msg = 0;
+  for (int k = 0; k < STREAM_DURATION * rate; k++) {
+    uint32_t tow = 100000000 + k * 1000 / rate;
+    int32_t d = k * 37;
+    /* NAV-SOL, sends the state until the first VELNED is received */
+    if (k == 0) {
+      gps_msg_pos[nb_gps_msg++] = stream_len;
+    }
+    memset(pl, 0, 52);
+    put_u32(&pl[0], tow);
+    put_u32(&pl[4], -1234 + k);
+    put_u16(&pl[8], 1850);
+    pl[10] = GPS_FIX_3D;
+    pl[11] = 0xDD;
+    put_u32(&pl[12], 462000000 + d);
+    put_u32(&pl[16], 11700000 - d);
+    put_u32(&pl[20], 463800000 + 2 * d);
+    put_u32(&pl[24], 250);
+    put_u32(&pl[28], 100 + k % 50);
+    put_u32(&pl[32], -20 - k % 30);
+    put_u32(&pl[36], 5);
+    put_u32(&pl[40], 40);
+    put_u16(&pl[44], 150);
+    pl[47] = 9 + k % 4;
+    add_ubx(UBX_NAV_ID, UBX_NAV_SOL_ID, pl, 52);
+    /* NAV-POSLLH */
+    put_u32(&pl[0], tow);
+    put_u32(&pl[4], 14500000 + d);
+    put_u32(&pl[8], 436000000 - d);
+    put_u32(&pl[12], 185000 + k);
+    put_u32(&pl[16], 135000 + k);
+    put_u32(&pl[20], 2500);
+    put_u32(&pl[24], 4000);
+    add_ubx(UBX_NAV_ID, UBX_NAV_POSLLH_ID, pl, 28);
+    /* NAV-STATUS */
+    memset(pl, 0, 16);
+    put_u32(&pl[0], tow);
+    pl[4] = GPS_FIX_3D;
+    pl[5] = 0x0D;
+    put_u32(&pl[12], k * 100);
+    add_ubx(UBX_NAV_ID, UBX_NAV_STATUS_ID, pl, 16);
+    /* NMEA sentence also enabled on the port */
+    int n = sprintf((char *)&stream[stream_len],
+                    "$GPGGA,%06d.%02d,4336.0000,N,00127.0000,E,1,%02d,0.9,135.%d,M,48.0,M,,*47\r\n",
+                    k / rate, (k % rate) * 100 / rate, 9 + k % 4, k % 10);
+    stream_len += n;
+    /* NAV-VELNED, last message of the epoch */
+    put_u32(&pl[0], tow);
+    put_u32(&pl[4], 500 + k % 100);
+    put_u32(&pl[8], -300 + k % 70);
+    put_u32(&pl[12], 12);
+    put_u32(&pl[16], 600);
+    put_u32(&pl[20], 590);
+    put_u32(&pl[24], 31000000 + k * 1000);
+    put_u32(&pl[28], 30);
+    put_u32(&pl[32], 200000);
+    gps_msg_pos[nb_gps_msg++] = stream_len;
+    add_ubx(UBX_NAV_ID, UBX_NAV_VELNED_ID, pl, 36);
+    /* NAV-SVINFO once per second */
+    if (k % rate == 0) {
+      memset(pl, 0, 8 + 12 * 12);
+      put_u32(&pl[0], tow);
+      pl[4] = 12;
+      for (int i = 0; i < 12; i++) {
+        uint8_t *b = &pl[8 + 12 * i];
+        b[0] = i;
+        b[1] = 2 + 3 * i;
+        b[2] = 0x0D;
+        b[3] = 7;
+        b[4] = 30 + i;
+        b[5] = 10 + 5 * i;
+        put_u16(&b[6], 20 * i);
+      }
+      add_ubx(UBX_NAV_ID, UBX_NAV_SVINFO_ID, pl, 8 + 12 * 12);
+    }
+  }
+}
+
+/*
+ * Parsers
+ */
+
+static void parse_bytes(void)
+{
+  reset_parser(0);
+  for (uint32_t i = 0; i < stream_len; i++) {
+    gps_ubx_parse(stream[i]);
+    if (gps_ubx.msg_available) {
+      handle_msg();
+    }
+  }
+}
+
+/** Chunk size of the reads, as the spans of a uart receive buffer */
+static uint16_t chunk_len(uint32_t i)
+{
+  return 1 + (i * 7919) % 96;
+}
+
+/** Parse by buffers, the stamp of a buffer is its index */
+static void parse_buffers(void)
+{
+  reset_parser(1);
+  uint32_t pos = 0;
+  for (uint32_t i = 0; pos < stream_len; i++) {
+    uint16_t len = Min(chunk_len(i), stream_len - pos);
+    uint16_t done = 0;
+    while (done < len) {
+      done += gps_ubx_parse_buffer(&stream[pos + done], len - done, i);
+      if (gps_ubx.msg_available) {
+        handle_msg();
+      }
+    }
+    pos += len;
+  }
+}
+
+/** Check the stamps of the GPS messages against the buffer of their first byte */
+static bool_t check_stamps(void)
+{
+  uint32_t pos = 0, v = 0;
+  for (uint32_t i = 0; pos < stream_len && v < nb_gps_msg; i++) {
+    uint16_t len = Min(chunk_len(i), stream_len - pos);
+    while (v < nb_gps_msg && gps_msg_pos[v] < pos + len) {
+      if (stamps[v] != i) {
+        return FALSE;
+      }
+      v++;
+    }
+    pos += len;
+  }
+  return v == nb_gps[1];
+}
+
+/** Feed the stream through the uart receive buffer and run GpsEvent */
+static void parse_uart(void)
+{
+  reset_parser(1);
+  uart_periph_init(&uart0);
+  uint32_t pos = 0;
+  for (uint32_t n = 0; pos < stream_len || uart_char_available(&uart0); n++) {
+    uint16_t space = UART_RX_BUFFER_SIZE - 1 - uart_char_available(&uart0);
+    uint16_t len = Min(Min(space, chunk_len(n)), stream_len - pos);
+    for (uint16_t i = 0; i < len; i++) {
+      uart0.rx_buf[uart0.rx_insert_idx] = stream[pos++];
+      uart0.rx_insert_idx = (uart0.rx_insert_idx + 1) % UART_RX_BUFFER_SIZE;
+    }
+    sys_time.nb_sec++;
+    GpsEvent();
+  }
+}
+
+static bool_t same_states(void)
+{
+  return nb_gps[0] == nb_gps[1] &&
+         memcmp(states[0], states[1], Min(nb_gps[0], NB_EPOCH_MAX) * sizeof(struct GpsState)) == 0;
+}
+
+static void test_parser(void)
+{
+  note("--- byte and buffer parsers");
+  generate_stream(10);
+  parse_bytes();
+  cmp_ok(nb_msgs, "==", STREAM_DURATION * 10 * 4 + STREAM_DURATION, "all UBX messages decoded byte per byte");
+  ok(gps_ubx.error_cnt == 0, "NMEA sentences skipped without errors");
+  ok(gps.fix == GPS_FIX_3D && gps.num_sv == 9 + (STREAM_DURATION * 10 - 1) % 4 && gps.nb_channels == 12 &&
+     gps.svinfos[11].svid == 35 && gps.svinfos[11].azim == 220, "fields decoded");
+  cmp_ok(gps.lla_pos.lat, "==", 436000000 - (STREAM_DURATION * 10 - 1) * 37, "signed fields decoded");
+
+  parse_buffers();
+  ok(same_states(), "buffer parser decodes the same states");
+  ok(gps_ubx.error_cnt == 0 && nb_gps[1] == nb_gps_msg, "one GPS message per epoch");
+  ok(check_stamps(), "GPS messages stamped with the buffer of their first byte");
+  cmp_ok(gps_time_sync.t0_tow, "==", 100000000 + (STREAM_DURATION * 10 - 1) * 100, "time sync updated");
+
+  parse_uart();
+  ok(same_states(), "GpsEvent decodes the same states from the uart buffer");
+}
+
+static void test_errors(void)
+{
+  note("--- errors");
+  /* corrupted checksum of the first message */
+  generate_stream(10);
+  stream[20] ^= 0x40;
+  parse_buffers();
+  ok(gps_ubx.error_cnt == 1 && nb_msgs == STREAM_DURATION * 10 * 4 + STREAM_DURATION - 1,
+     "corrupted message dropped and counted");
+
+  /* message without payload */
+  stream_len = 0;
+  add_ubx(UBX_NAV_ID, UBX_NAV_SOL_ID, NULL, 0);
+  uint8_t pl[16] = { 0 };
+  pl[4] = GPS_FIX_2D;
+  add_ubx(UBX_NAV_ID, UBX_NAV_STATUS_ID, pl, 16);
+  parse_buffers();
+  ok(nb_msgs == 2 && gps_ubx.error_cnt == 0 && gps.fix == GPS_FIX_2D, "empty payload parsed");
+}
+
+/** Fields of the accessors generated by gen_ubx, over a few messages with
+ * blocks and with every field format */
+#define READ_UBX_FIELDS(_p, _v) {             \
+    int _n = 0;                               \
+    _v[_n++] = UBX_NAV_SOL_ITOW(_p);          \
+    _v[_n++] = UBX_NAV_SOL_Frac(_p);          \
+    _v[_n++] = UBX_NAV_SOL_week(_p);          \
+    _v[_n++] = UBX_NAV_SOL_GPSfix(_p);        \
+    _v[_n++] = UBX_NAV_SOL_ECEF_X(_p);        \
+    _v[_n++] = UBX_NAV_SOL_ECEF_Y(_p);        \
+    _v[_n++] = UBX_NAV_SOL_ECEF_Z(_p);        \
+    _v[_n++] = UBX_NAV_SOL_Pacc(_p);          \
+    _v[_n++] = UBX_NAV_SOL_ECEFVX(_p);        \
+    _v[_n++] = UBX_NAV_SOL_PDOP(_p);          \
+    _v[_n++] = UBX_NAV_SOL_numSV(_p);         \
+    _v[_n++] = UBX_NAV_POSLLH_LON(_p);        \
+    _v[_n++] = UBX_NAV_POSLLH_HMSL(_p);       \
+    _v[_n++] = UBX_NAV_VELNED_VEL_D(_p);      \
+    _v[_n++] = UBX_NAV_VELNED_Heading(_p);    \
+    _v[_n++] = UBX_RXM_RAW_iTOW(_p);          \
+    _v[_n++] = UBX_RXM_RAW_week(_p);          \
+    for (int _i = 0; _i < 2; _i++) {          \
+      _v[_n++] = UBX_NAV_SVINFO_QI(_p, _i);   \
+      _v[_n++] = UBX_NAV_SVINFO_Azim(_p, _i); \
+      _v[_n++] = UBX_NAV_SVINFO_PRRes(_p, _i);\
+      _v[_n++] = UBX_RXM_RAW_cpMes(_p, _i);   \
+      _v[_n++] = UBX_RXM_RAW_prMes(_p, _i);   \
+      _v[_n++] = UBX_RXM_RAW_doMes(_p, _i);   \
+    }                                         \
+  }
+#define NB_UBX_FIELDS (17 + 2 * 6)
+
+/** Fields read with UbxGetField, direct loads on little endian hosts */
+static void read_fields_load(uint8_t *p, double *v)
+READ_UBX_FIELDS(p, v)
+
+/** Fields read byte per byte, as on big endian targets */
+#pragma push_macro("UbxGetField")
+#undef UbxGetField
+#define UbxGetField(_type, _payload, _offset, _bytes) (_bytes)
+static void read_fields_bytes(uint8_t *p, double *v)
+READ_UBX_FIELDS(p, v)
+#pragma pop_macro("UbxGetField")
+
+static void test_fields(void)
+{
+  note("--- generated field accessors");
+  uint8_t buf[64 + 8];
+  double v_load[NB_UBX_FIELDS], v_bytes[NB_UBX_FIELDS];
+  uint32_t wrong = 0;
+  srand(42);
+  for (int k = 0; k < 1000; k++) {
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+      buf[i] = rand();
+    }
+    /* payload at every alignment */
+    uint8_t *p = &buf[k % 8];
+    read_fields_load(p, v_load);
+    read_fields_bytes(p, v_bytes);
+    if (memcmp(v_load, v_bytes, sizeof(v_load)) != 0) {
+      wrong++;
+    }
+  }
+  cmp_ok(wrong, "==", 0, "field loads read the same values as the byte per byte accessors");
+}
+
+static void benchmark(int rate)
+{
+  generate_stream(rate);
+  clock_t start = clock();
+  parse_bytes();
+  double t_bytes = (double)(clock() - start) / CLOCKS_PER_SEC;
+  start = clock();
+  parse_buffers();
+  double t_buffers = (double)(clock() - start) / CLOCKS_PER_SEC;
+  note("%d Hz, %u bytes/s: byte parser %.1f us/s (%.1f ns/byte), buffer parser %.1f us/s (%.1f ns/byte)",
+       rate, stream_len / STREAM_DURATION,
+       t_bytes * 1e6 / STREAM_DURATION, t_bytes * 1e9 / stream_len,
+       t_buffers * 1e6 / STREAM_DURATION, t_buffers * 1e9 / stream_len);
+}
+
+int main()
+{
+  note("running UBX parser tests");
+  plan(12);
+
+  sys_time.cpu_ticks_per_sec = 1000000;
+  AbiBindMsgGPS(ABI_BROADCAST, &gps_ev, gps_cb);
+
+  test_parser();
+  test_errors();
+  test_fields();
+
+  note("--- parsing time per second of stream");
+  benchmark(10);
+  benchmark(20);
+
+  done_testing();
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_i2c_arch.c
+ * @brief Tests for the linux I2C transaction queue.
+ *
+ * i2c0 is opened on /dev/null, so all transfers fail in the bus thread:
+ * this checks the queue and the status reported to the main thread.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "mcu_periph/i2c.h"
+#include <unistd.h>
+
+#define NB_TRANS (I2C_TRANSACTION_QUEUE_LEN - 1)
+
+static struct i2c_transaction trans[NB_TRANS + 1];
+
+/** Run the I2C event until the transaction is finished */
+static void wait_trans(struct i2c_transaction *t)
+{
+  for (int i = 0; i < 100 && t->status == I2CTransPending; i++) {
+    usleep(1000);
+    i2c_event();
+  }
+}
+
+int main()
+{
+  note("running linux i2c tests");
+  plan(8);
+
+  i2c0_init();
+  struct i2c_arch_stats *stats = i2c_arch_get_stats(&i2c0);
+  if (stats == NULL) {
+    BAIL_OUT("can't open i2c0");
+  }
+
+  ok(i2c_transceive(&i2c0, &trans[0], 0xD0, 1, 6), "transaction submitted");
+  usleep(10000);
+  ok(trans[0].status == I2CTransPending && !i2c_idle(&i2c0),
+     "status only changed from the event function");
+  wait_trans(&trans[0]);
+  ok(trans[0].status == I2CTransFailed && i2c_idle(&i2c0), "transaction done");
+
+  /* fill the queue */
+  int submitted = 0;
+  for (int i = 0; i < NB_TRANS; i++) {
+    submitted += i2c_transmit(&i2c0, &trans[i], 0xD0, 2);
+  }
+  cmp_ok(submitted, "==", NB_TRANS, "queue filled");
+  ok(!i2c_receive(&i2c0, &trans[NB_TRANS], 0xD0, 2) && trans[NB_TRANS].status == I2CTransFailed,
+     "transaction refused when the queue is full");
+  cmp_ok(i2c0.errors->queue_full_cnt, "==", 1, "queue full counted");
+
+  wait_trans(&trans[NB_TRANS - 1]);
+  int failed = 0;
+  for (int i = 0; i < NB_TRANS; i++) {
+    failed += (trans[i].status == I2CTransFailed);
+  }
+  cmp_ok(failed, "==", NB_TRANS, "all transactions reported in order");
+  cmp_ok(stats->nb_trans, "==", NB_TRANS + 1, "transactions counted");
+  note("latency %u us (max %u us), bus time %u us", stats->latency, stats->latency_max, stats->bus_time);
+
+  done_testing();
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_sys_time_prof.c
+ * @brief Tests for the sys_time task statistics (SYS_TIME_PROF).
+ *
+ * A 2ms timer runs a task busy for 300us, then it is not handled
+ * for a while to produce overruns.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "mcu_periph/sys_time.h"
+
+#define TASK_USEC 300
+
+static void busy_wait(uint32_t usec)
+{
+  uint32_t start = get_sys_time_cpu_ticks();
+  while (usec_of_cpu_ticks(get_sys_time_cpu_ticks() - start) < usec);
+}
+
+int main()
+{
+  note("running sys_time statistics tests");
+  plan(7);
+
+  sys_time_init();
+  int tid = sys_time_register_timer(0.002, NULL);
+  if (tid < 0) {
+    BAIL_OUT("can't register timer");
+  }
+  struct sys_time_prof *prof = &sys_time.timer[tid].prof;
+
+  uint32_t start = get_sys_time_cpu_ticks();
+  usleep(10000);
+  uint32_t dt = usec_of_cpu_ticks(get_sys_time_cpu_ticks() - start);
+  ok(dt >= 10000 && dt < 50000, "cpu ticks counter in usec");
+
+  /* run the task for 200ms */
+  while (usec_of_cpu_ticks(get_sys_time_cpu_ticks() - start) < 210000) {
+    if (sys_time_check_and_ack_timer(tid)) {
+      busy_wait(TASK_USEC);
+      sys_time_timer_done(tid);
+    }
+    usleep(100);
+  }
+  note("%u runs, exec %u..%u us, latency max %u us", prof->nb_runs,
+       usec_of_cpu_ticks(prof->exec_min), usec_of_cpu_ticks(prof->exec_max),
+       usec_of_cpu_ticks(prof->latency_max));
+  ok(prof->nb_runs >= 80 && prof->nb_runs <= 101, "task runs counted");
+  ok(usec_of_cpu_ticks(prof->exec_min) >= TASK_USEC &&
+     prof->exec_max >= prof->exec_min && prof->exec_sum >= prof->nb_runs * prof->exec_min,
+     "execution time measured");
+  uint32_t nb = 0;
+  for (int i = 0; i < SYS_TIME_PROF_HIST_SIZE; i++) {
+    nb += prof->hist[i];
+  }
+  /* 300us is in [256, 512[ */
+  ok(nb == prof->nb_runs && prof->hist[6] > 0, "execution time histogram");
+
+  /* not handled for 20ms */
+  uint32_t overruns = prof->overruns;
+  usleep(20000);
+  ok(prof->overruns >= overruns + 5, "missed activations counted as overruns");
+  ok(sys_time_check_and_ack_timer(tid) && usec_of_cpu_ticks(prof->latency_max) >= 15000,
+     "latency of the late activation");
+
+  sys_time_prof_reset(prof);
+  ok(prof->nb_runs == 0 && prof->hist[6] == 0 && prof->overruns > 0, "reset keeps the overruns");
+
+  done_testing();
+}
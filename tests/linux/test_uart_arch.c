@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_uart_arch.c
+ * @brief Tests for the linux UART driver.
+ *
+ * uart0 is opened on the slave side of a pseudo terminal,
+ * the test reads and writes the master side.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#define _GNU_SOURCE
+#include "tap.h"
+#include "mcu_periph/uart.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+
+static int master;
+
+static void uart_open(void)
+{
+  master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+    BAIL_OUT("can't open pseudo terminal");
+  }
+  uart_periph_init(&uart0);
+  strncpy(uart0.dev, ptsname(master), UART_DEV_NAME_SIZE);
+  uart_periph_set_baudrate(&uart0, B921600);
+}
+
+/** Read exactly len bytes from the master side */
+static int master_read(uint8_t *buf, int len)
+{
+  int nb = 0;
+  struct pollfd pfd = { master, POLLIN, 0 };
+  while (nb < len && poll(&pfd, 1, 1000) > 0) {
+    int ret = read(master, buf + nb, len - nb);
+    if (ret > 0) {
+      nb += ret;
+    }
+  }
+  return nb;
+}
+
+/** Run the UART event until nothing more is received */
+static void uart_drain(void)
+{
+  struct uart_arch_stats *stats = uart_arch_get_stats(&uart0);
+  uint32_t rx;
+  do {
+    rx = stats->rx_bytes + stats->rx_dropped;
+    /* give some time to the pty to pass the data */
+    usleep(20000);
+    uart_event();
+  } while (stats->rx_bytes + stats->rx_dropped != rx);
+}
+
+static void test_tx(void)
+{
+  note("--- transmit");
+  struct uart_arch_stats *stats = uart_arch_get_stats(&uart0);
+  uint8_t out[700], in[700];
+  for (int i = 0; i < 700; i++) {
+    out[i] = rand();
+  }
+
+  /* a message is written in one call */
+  for (int i = 0; i < 500; i++) {
+    uart0.device.put_byte(&uart0, out[i]);
+  }
+  uart0.device.send_message(&uart0);
+  cmp_ok(stats->tx_syscalls, "==", 1, "500 bytes message written in one call");
+  ok(master_read(in, 500) == 500 && memcmp(in, out, 500) == 0, "500 bytes received");
+
+  /* one call per contiguous part of the buffer */
+  for (int i = 0; i < 700; i++) {
+    uart0.device.put_byte(&uart0, out[i]);
+  }
+  uart0.device.send_message(&uart0);
+  cmp_ok(stats->tx_syscalls, "==", 3, "wrapped message written in two calls");
+  ok(master_read(in, 700) == 700 && memcmp(in, out, 700) == 0, "wrapped message received");
+  cmp_ok(stats->tx_bytes, "==", 1200, "transmitted bytes counted");
+  ok(!uart0.tx_running, "transmit done");
+
+  /* full transmit buffer */
+  for (int i = 0; i < UART_TX_BUFFER_SIZE + 100; i++) {
+    uart0.device.put_byte(&uart0, i);
+  }
+  cmp_ok(stats->tx_dropped, "==", 101, "bytes over the buffer size dropped");
+  uart_event();
+  uint8_t big[UART_TX_BUFFER_SIZE];
+  cmp_ok(master_read(big, UART_TX_BUFFER_SIZE - 1), "==", UART_TX_BUFFER_SIZE - 1,
+         "queue sent from the event loop");
+}
+
+static void test_rx(void)
+{
+  note("--- receive");
+  struct uart_arch_stats *stats = uart_arch_get_stats(&uart0);
+  uint8_t out[800];
+  for (int i = 0; i < 800; i++) {
+    out[i] = rand();
+  }
+  cmp_ok(write(master, out, 800), "==", 800, "800 bytes sent");
+  uart_drain();
+  int nb = uart0.device.char_available(&uart0);
+  int wrong = 0;
+  for (int i = 0; i < nb; i++) {
+    if (uart0.device.get_byte(&uart0) != out[i]) {
+      wrong++;
+    }
+  }
+  ok(nb == 800 && wrong == 0, "800 bytes received");
+  note("%u bytes in %u read calls", stats->rx_bytes, stats->rx_syscalls);
+  ok(stats->rx_bytes >= 16 * stats->rx_syscalls, "at least 16 bytes per read call");
+
+  /* more data than the receive buffer */
+  uint16_t ore = uart0.ore;
+  uint8_t big[UART_RX_BUFFER_SIZE + 500];
+  memset(big, 0x55, sizeof(big));
+  cmp_ok(write(master, big, sizeof(big)), "==", sizeof(big), "more than the buffer size sent");
+  uart_drain();
+  cmp_ok(uart0.device.char_available(&uart0), "==", UART_RX_BUFFER_SIZE - 1, "receive buffer full");
+  cmp_ok(stats->rx_dropped, "==", 501, "remaining bytes dropped");
+  ok(uart0.ore > ore, "overrun counted");
+}
+
+int main()
+{
+  note("running linux uart tests");
+  plan(15);
+
+  uart_open();
+  test_tx();
+  test_rx();
+
+  done_testing();
+}
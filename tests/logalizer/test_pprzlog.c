@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_pprzlog.c
+ * @brief Tests for the pprzlog indexer and decoder.
+ *
+ * A synthetic log is built with garbage between frames, corrupted and
+ * truncated frames, then indexed and decoded.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "pprzlog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#define NB_FRAMES 1000
+#define MSG_A 10
+#define MSG_B 20
+
+/* telemetry message with a variable array */
+static const struct pprzlog_field_desc msg_a_fields[] = {
+  { "x", PPRZLOG_INT16, PPRZLOG_SCALAR },
+  { "y", PPRZLOG_FLOAT, PPRZLOG_SCALAR },
+  { "arr", PPRZLOG_UINT8, PPRZLOG_VAR_ARRAY },
+};
+static const struct pprzlog_msg_desc msg_a = { "A", MSG_A, 3, msg_a_fields };
+
+/* datalink message with a string and a fixed array */
+static const struct pprzlog_field_desc msg_b_fields[] = {
+  { "t", PPRZLOG_UINT32, PPRZLOG_SCALAR },
+  { "name", PPRZLOG_CHAR, PPRZLOG_VAR_ARRAY },
+  { "v", PPRZLOG_DOUBLE, 2 },
+};
+static const struct pprzlog_msg_desc msg_b = { "B", MSG_B, 3, msg_b_fields };
+
+static uint8_t log_buf[NB_FRAMES * 64];
+static size_t log_len;
+
+static void put_frame(uint8_t source, uint32_t ts, const uint8_t *data, uint8_t len)
+{
+  uint8_t *f = log_buf + log_len;
+  uint8_t ck = 0;
+  int i;
+  f[0] = PPRZLOG_STX;
+  f[1] = len;
+  f[2] = source;
+  memcpy(f + 3, &ts, 4);
+  memcpy(f + 7, data, len);
+  for (i = 1; i < 7 + len; i++) {
+    ck += f[i];
+  }
+  f[7 + len] = ck;
+  log_len += len + PPRZLOG_OVERHEAD;
+}
+
+static uint8_t build_a(uint8_t *d, int i)
+{
+  int16_t x = i;
+  float y = i * 0.5f;
+  uint8_t n = (i / 2) % 4, k, len = 0;
+  d[len++] = 1;
+  d[len++] = MSG_A;
+  memcpy(d + len, &x, 2); len += 2;
+  memcpy(d + len, &y, 4); len += 4;
+  d[len++] = n;
+  for (k = 0; k < n; k++) {
+    d[len++] = i + k;
+  }
+  return len;
+}
+
+static uint8_t build_b(uint8_t *d, int i)
+{
+  uint32_t t = 100000 + i;
+  double v[2] = { i, -i };
+  uint8_t len = 0;
+  d[len++] = 0;
+  d[len++] = MSG_B;
+  memcpy(d + len, &t, 4); len += 4;
+  d[len++] = 3;
+  memcpy(d + len, "abc", 3); len += 3;
+  memcpy(d + len, v, 16); len += 16;
+  return len;
+}
+
+int main(void)
+{
+  struct pprzlog log;
+  struct pprzlog_columns cols;
+  uint8_t d[256];
+  int i, nb_a = 0, nb_b = 0, nb_garbage = 0;
+
+  note("running pprzlog tests");
+  plan(12);
+
+  /* garbage before the first frame */
+  memcpy(log_buf, "\x12\x99\x05\x00", 4);
+  log_len = 4;
+  nb_garbage++;
+  for (i = 0; i < NB_FRAMES; i++) {
+    if (i % 2 == 0) {
+      put_frame(PPRZLOG_SOURCE_TELEMETRY, i * 10, d, build_a(d, i));
+      nb_a++;
+    } else {
+      put_frame(PPRZLOG_SOURCE_DATALINK, i * 10, d, build_b(d, i));
+      nb_b++;
+    }
+    if (i % 100 == 50) {
+      /* corrupt the checksum of the last frame */
+      log_buf[log_len - 1] ^= 0x5a;
+      nb_a--;
+      nb_garbage++;
+    } else if (i % 100 == 75) {
+      /* garbage with fake STX */
+      memcpy(log_buf + log_len, "\x99\x10\x00\x99\x99\x02", 6);
+      log_len += 6;
+      nb_garbage++;
+    }
+  }
+  /* a frame with a valid checksum but a payload not matching A */
+  d[0] = 1; d[1] = MSG_A; d[2] = 0;
+  put_frame(PPRZLOG_SOURCE_TELEMETRY, NB_FRAMES * 10, d, 3);
+  /* truncated frame at the end */
+  put_frame(PPRZLOG_SOURCE_TELEMETRY, NB_FRAMES * 10 + 10, d, build_a(d, 2));
+  log_len -= 3;
+  nb_garbage++;
+
+  pprzlog_open_buffer(&log, log_buf, log_len);
+  int64_t nb = pprzlog_index(&log);
+  ok(nb == nb_a + nb_b + 1, "all valid frames are indexed (%d)", (int)nb);
+  ok(log.index[PPRZLOG_SOURCE_TELEMETRY][MSG_A].nb == (uint32_t)nb_a + 1 &&
+     log.index[PPRZLOG_SOURCE_DATALINK][MSG_B].nb == (uint32_t)nb_b,
+     "frames are indexed by source and message ID");
+  ok(log.nb_errors == (uint64_t)nb_garbage, "%d corrupted parts detected (%u)", nb_garbage,
+     (unsigned)log.nb_errors);
+  ok(log.first_ts == 0 && log.last_ts == NB_FRAMES * 10, "first and last timestamps");
+
+  size_t offset = 0, len;
+  int64_t nb_next = 0;
+  while ((len = pprzlog_next_frame(&log, &offset)) > 0) {
+    offset += len;
+    nb_next++;
+  }
+  ok(nb_next == nb && offset == log_len, "stream all valid frames without index (%d)", (int)nb_next);
+
+  const struct pprzlog_msg_index *idx = &log.index[PPRZLOG_SOURCE_DATALINK][MSG_B];
+  uint32_t k = pprzlog_find_time(idx, 5005);
+  ok(k < idx->nb && idx->entries[k].timestamp == 5010 && idx->entries[k - 1].timestamp < 5005,
+     "find first frame after a given time");
+
+  int ret = pprzlog_export(&log, PPRZLOG_SOURCE_TELEMETRY, &msg_a, 0, UINT32_MAX, &cols);
+  ok(ret == 0 && cols.nb_rows == (uint32_t)nb_a && cols.nb_invalid == 1 && cols.nb_cols == 5,
+     "export A: %u rows, %u columns, %u invalid", cols.nb_rows, cols.nb_cols, cols.nb_invalid);
+  ok(strcmp(cols.names[0], "x") == 0 && strcmp(cols.names[2], "arr[0]") == 0 &&
+     strcmp(cols.names[4], "arr[2]") == 0, "column names");
+  int values_ok = 1;
+  uint32_t r;
+  for (r = 0; r < cols.nb_rows; r++) {
+    int j = (int)lround(cols.time[r] / PPRZLOG_TIME_UNIT) / 10;
+    int n = (j / 2) % 4, c;
+    if (cols.data[0][r] != j || cols.data[1][r] != j * 0.5) {
+      values_ok = 0;
+    }
+    for (c = 0; c < 3; c++) {
+      if ((c < n && cols.data[2 + c][r] != (uint8_t)(j + c)) || (c >= n && !isnan(cols.data[2 + c][r]))) {
+        values_ok = 0;
+      }
+    }
+  }
+  ok(values_ok, "decoded values of A, missing array elements are NaN");
+  pprzlog_columns_free(&cols);
+
+  ok(pprzlog_export(&log, PPRZLOG_SOURCE_DATALINK, &msg_b, 2000, 2999, &cols) == 0 &&
+     cols.nb_rows == 50 && cols.nb_cols == 3 && cols.time[0] == 2010 * PPRZLOG_TIME_UNIT &&
+     cols.data[0][0] == 100201 && cols.data[1][0] == 201 && cols.data[2][0] == -201,
+     "export B in a time window, strings are skipped");
+  pprzlog_columns_free(&cols);
+  pprzlog_close(&log);
+
+  /* same log through a mapped file */
+  char path[] = "/tmp/test_pprzlogXXXXXX";
+  int fd = mkstemp(path);
+  ok(fd >= 0 && write(fd, log_buf, log_len) == (ssize_t)log_len, "write temporary log file");
+  close(fd);
+  ok(pprzlog_open(&log, path) == 0 && pprzlog_index(&log) == nb_a + nb_b + 1 &&
+     log.nb_errors == (uint64_t)nb_garbage, "index a mapped file");
+  pprzlog_close(&log);
+  unlink(path);
+
+  done_testing();
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_pprz_algebra_generic.c
+ * @brief Tests and benchmarks of the type generic algebra functions.
+ *
+ * The same quaternion propagation, rotation matrix composition and
+ * normalization code is run with int32, float and double types,
+ * results are compared with each other and the time per step is reported.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "math/pprz_algebra_generic.h"
+#include <math.h>
+#include <time.h>
+
+#define NB_STEPS 100000
+/** propagation steps, short enough for fixed point to stay close to double */
+#define NB_PROPAGATION 1000
+
+/* small rotation applied at each propagation step */
+static const double dq_ref[4] = { 0.99999, 0.003, -0.002, 0.001 };
+
+#define ELAPSED_NS(_start, _n) ((double)(clock() - (_start)) / CLOCKS_PER_SEC / (_n) * 1e9)
+
+/** Quaternion propagation: q = q comp dq, normalized every step */
+#define BENCH_QUAT_PROPAGATION(_Quat, _q, _one) {               \
+    struct _Quat dq, tmp;                                       \
+    QUAT_ASSIGN(dq, dq_ref[0] * _one, dq_ref[1] * _one,         \
+                dq_ref[2] * _one, dq_ref[3] * _one);            \
+    pprz_quat_normalize(&dq);                                   \
+    pprz_quat_identity(&_q);                                    \
+    clock_t start = clock();                                    \
+    for (int i = 0; i < NB_PROPAGATION; i++) {                  \
+      pprz_quat_comp(&tmp, &_q, &dq);                           \
+      pprz_quat_normalize(&tmp);                                \
+      QUAT_COPY(_q, tmp);                                       \
+    }                                                           \
+    note("%-6s quaternion propagation: %.1f ns per step",      \
+         #_Quat, ELAPSED_NS(start, NB_PROPAGATION));            \
+  }
+
+/** Rotation matrix composition: m = m comp dm, the rotation of dq */
+#define BENCH_RMAT_COMPOSITION(_Quat, _RMat, _m, _one) {        \
+    struct _Quat dq;                                            \
+    struct _RMat dm, tmp;                                       \
+    QUAT_ASSIGN(dq, dq_ref[0] * _one, dq_ref[1] * _one,         \
+                dq_ref[2] * _one, dq_ref[3] * _one);            \
+    pprz_quat_normalize(&dq);                                   \
+    pprz_rmat_of_quat(&dm, &dq);                                \
+    pprz_rmat_identity(&_m);                                    \
+    clock_t start = clock();                                    \
+    for (int i = 0; i < NB_PROPAGATION; i++) {                  \
+      pprz_rmat_comp(&tmp, &_m, &dm);                           \
+      RMAT_COPY(_m, tmp);                                       \
+    }                                                           \
+    note("%-6s rotation matrix composition: %.1f ns per step", \
+         #_RMat, ELAPSED_NS(start, NB_PROPAGATION));            \
+  }
+
+/** Normalization of a quaternion with a norm around 2 */
+#define BENCH_QUAT_NORMALIZATION(_Quat, _one) {                 \
+    struct _Quat q;                                             \
+    clock_t start = clock();                                    \
+    for (int i = 0; i < NB_STEPS; i++) {                        \
+      QUAT_ASSIGN(q, _one, _one, (i & 0xff) * _one / 256,       \
+                  _one);                                        \
+      pprz_quat_normalize(&q);                                  \
+    }                                                           \
+    note("%-6s quaternion normalization: %.1f ns per step",    \
+         #_Quat, ELAPSED_NS(start, NB_STEPS));                  \
+  }
+
+static double quat_dist(double qi, double qx, double qy, double qz, struct DoubleQuat *ref)
+{
+  /* q and -q are the same rotation */
+  double d1 = fabs(qi - ref->qi) + fabs(qx - ref->qx) + fabs(qy - ref->qy) + fabs(qz - ref->qz);
+  double d2 = fabs(qi + ref->qi) + fabs(qx + ref->qx) + fabs(qy + ref->qy) + fabs(qz + ref->qz);
+  return fmin(d1, d2);
+}
+
+static void test_quat_propagation(void)
+{
+  note("--- quaternion propagation over %d steps", NB_PROPAGATION);
+  struct DoubleQuat qd;
+  struct FloatQuat qf;
+  struct Int32Quat qi;
+  BENCH_QUAT_PROPAGATION(DoubleQuat, qd, 1.);
+  BENCH_QUAT_PROPAGATION(FloatQuat, qf, 1.f);
+  BENCH_QUAT_PROPAGATION(Int32Quat, qi, QUAT1_BFP_OF_REAL(1));
+
+  double ef = quat_dist(qf.qi, qf.qx, qf.qy, qf.qz, &qd);
+  double ei = quat_dist(QUAT1_FLOAT_OF_BFP(qi.qi), QUAT1_FLOAT_OF_BFP(qi.qx),
+                        QUAT1_FLOAT_OF_BFP(qi.qy), QUAT1_FLOAT_OF_BFP(qi.qz), &qd);
+  note("distance to double result: float %.2e, int32 %.2e", ef, ei);
+  ok(ef < 1e-2, "float propagation matches double");
+  ok(ei < 5e-2, "int32 propagation matches double");
+  ok(fabs(double_quat_norm(&qd) - 1.) < 1e-12, "double quaternion stays normalized");
+}
+
+static void test_rmat_composition(void)
+{
+  note("--- rotation matrix composition over %d steps", NB_PROPAGATION);
+  struct DoubleRMat md;
+  struct FloatRMat mf;
+  struct Int32RMat mi;
+  BENCH_RMAT_COMPOSITION(DoubleQuat, DoubleRMat, md, 1.);
+  BENCH_RMAT_COMPOSITION(FloatQuat, FloatRMat, mf, 1.f);
+  BENCH_RMAT_COMPOSITION(Int32Quat, Int32RMat, mi, QUAT1_BFP_OF_REAL(1));
+
+  double ef = 0., ei = 0.;
+  for (int i = 0; i < 9; i++) {
+    ef = fmax(ef, fabs(mf.m[i] - md.m[i]));
+    ei = fmax(ei, fabs(TRIG_FLOAT_OF_BFP(mi.m[i]) - md.m[i]));
+  }
+  note("max element error to double result: float %.2e, int32 %.2e", ef, ei);
+  ok(ef < 1e-4, "float composition matches double");
+  /* each fixed point product is truncated, the matrix is not orthogonalized */
+  ok(ei < 1e-1, "int32 composition matches double");
+
+  /* m comp_inv m is the identity */
+  struct DoubleRMat id;
+  pprz_rmat_comp_inv(&id, &md, &md);
+  ok(fabs(id.m[0] - 1.) < 1e-9 && fabs(id.m[1]) < 1e-9 && fabs(id.m[4] - 1.) < 1e-9,
+     "double comp_inv of itself is identity");
+}
+
+static void test_quat_normalization(void)
+{
+  note("--- quaternion normalization");
+  BENCH_QUAT_NORMALIZATION(DoubleQuat, 1.);
+  BENCH_QUAT_NORMALIZATION(FloatQuat, 1.f);
+  BENCH_QUAT_NORMALIZATION(Int32Quat, QUAT1_BFP_OF_REAL(1));
+
+  /* generic and typed functions give the same results */
+  struct FloatQuat a = { 0.5, 0.5, 0.5, 0.5 }, b = { 0.8, 0.6, 0., 0. }, c1, c2;
+  pprz_quat_comp_inv(&c1, &a, &b);
+  float_quat_comp_inv(&c2, &a, &b);
+  ok(c1.qi == c2.qi && c1.qx == c2.qx && c1.qy == c2.qy && c1.qz == c2.qz,
+     "generic call is the typed function");
+  struct Int32Quat qi = { 3 << 12, 4 << 12, 0, 0 };
+  pprz_quat_normalize(&qi);
+  cmp_ok(pprz_quat_norm(&qi), "==", QUAT1_BFP_OF_REAL(1), "int32 quaternion normalized");
+}
+
+int main()
+{
+  note("running type generic algebra tests");
+  plan(8);
+
+  test_quat_propagation();
+  test_rmat_composition();
+  test_quat_normalization();
+
+  done_testing();
+}
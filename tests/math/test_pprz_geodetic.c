@@ -29,9 +29,12 @@
 
 #include "tap.h"
 
+#include <time.h>
+
 #include "math/pprz_geodetic_int.h"
 #include "math/pprz_geodetic_float.h"
 #include "math/pprz_geodetic_double.h"
+#include "math/pprz_geodetic_wmm2010.h"
 
 /*
  * toulouse lat 43.6052765, lon 1.4427764, alt 180.123019274324 -> x 4624497.0 y 116475.0 z 4376563.0
@@ -355,10 +358,156 @@ static void test_lla_of_ecef(void)
   cmp_ok(lla_i.alt, "==", lla_ref_i.alt, "altitude (int) matches reference");
 }
 
+static void test_lla_of_ecef_grid(void)
+{
+  note("--- test lla <-> ecef on a global grid, including poles and altitudes up to 100km");
+
+#define GRID_MAX 40000
+  static struct LlaCoor_d lla_in[GRID_MAX];
+  static struct EcefCoor_d ecef[GRID_MAX];
+  static struct LlaCoor_d lla_out[GRID_MAX];
+  int n = 0;
+  for (double lat = -90.; lat <= 90.; lat += 2.5) {
+    for (double lon = -180.; lon < 180.; lon += 10.) {
+      for (double alt = -1000.; alt <= 100000.; alt += 10000.) {
+        if (n < GRID_MAX) {
+          lla_in[n].lat = RadOfDeg(lat);
+          lla_in[n].lon = RadOfDeg(lon);
+          lla_in[n].alt = alt;
+          n++;
+        }
+      }
+    }
+  }
+  ecef_of_lla_array_d(ecef, lla_in, n);
+  lla_of_ecef_array_d(lla_out, ecef, n);
+
+  double max_ecef_err = 0.;
+  double max_f_lat_err = 0., max_f_alt_err = 0.;
+  int batch_mismatch = 0;
+  for (int i = 0; i < n; i++) {
+    /* ECEF -> LLA -> ECEF */
+    struct EcefCoor_d ecef_check, ecef_diff;
+    ecef_of_lla_d(&ecef_check, &lla_out[i]);
+    VECT3_DIFF(ecef_diff, ecef_check, ecef[i]);
+    double err = sqrt(VECT3_NORM2(ecef_diff));
+    if (err > max_ecef_err) { max_ecef_err = err; }
+    /* batch must give the same result as the single point version */
+    struct LlaCoor_d lla_single;
+    lla_of_ecef_d(&lla_single, &ecef[i]);
+    if (lla_single.lat != lla_out[i].lat || lla_single.lon != lla_out[i].lon ||
+        lla_single.alt != lla_out[i].alt) {
+      batch_mismatch++;
+    }
+    /* single precision against double */
+    struct EcefCoor_f ecef_f = { ecef[i].x, ecef[i].y, ecef[i].z };
+    struct LlaCoor_f lla_f;
+    lla_of_ecef_f(&lla_f, &ecef_f);
+    if (fabs(lla_f.lat - lla_out[i].lat) > max_f_lat_err) { max_f_lat_err = fabs(lla_f.lat - lla_out[i].lat); }
+    if (fabs(lla_f.alt - lla_out[i].alt) > max_f_alt_err) { max_f_alt_err = fabs(lla_f.alt - lla_out[i].alt); }
+  }
+  note("%d points, max ECEF -> LLA -> ECEF error %g m", n, max_ecef_err);
+  ok(max_ecef_err < 1e-6, "ECEF -> LLA -> ECEF in double has less than 1e-6m error on the grid");
+  cmp_ok(batch_mismatch, "==", 0, "lla_of_ecef_array_d matches lla_of_ecef_d");
+  note("float max latitude error %g rad, altitude error %g m", max_f_lat_err, max_f_alt_err);
+  ok(max_f_lat_err < 5e-7 && max_f_alt_err < 5., "lla_of_ecef_f within float resolution of double");
+
+  /* LTP definition from LLA and from ECEF must agree */
+  struct LlaCoor_d lla_ref = { RadOfDeg(43.6052765), RadOfDeg(1.4427764), 180.123 };
+  struct LtpDef_d ltp_lla, ltp_ecef;
+  ltp_def_from_lla_d(&ltp_lla, &lla_ref);
+  ltp_def_from_ecef_d(&ltp_ecef, &ltp_lla.ecef);
+  double max_m_err = 0.;
+  for (int i = 0; i < 9; i++) {
+    if (fabs(ltp_lla.ltp_of_ecef.m[i] - ltp_ecef.ltp_of_ecef.m[i]) > max_m_err) {
+      max_m_err = fabs(ltp_lla.ltp_of_ecef.m[i] - ltp_ecef.ltp_of_ecef.m[i]);
+    }
+  }
+  ok(max_m_err < 1e-12, "ltp_def_from_lla_d and ltp_def_from_ecef_d give the same rotation");
+
+  /* batched NED conversion against the single point version */
+  static struct NedCoor_d ned[GRID_MAX];
+  ned_of_ecef_point_array_d(ned, &ltp_ecef, ecef, n);
+  double max_ned_err = 0.;
+  for (int i = 0; i < n; i++) {
+    struct NedCoor_d ned_single, ned_diff;
+    ned_of_ecef_point_d(&ned_single, &ltp_ecef, &ecef[i]);
+    VECT3_DIFF(ned_diff, ned_single, ned[i]);
+    if (sqrt(VECT3_NORM2(ned_diff)) > max_ned_err) { max_ned_err = sqrt(VECT3_NORM2(ned_diff)); }
+  }
+  ok(max_ned_err < 1e-6, "ned_of_ecef_point_array_d matches ned_of_ecef_point_d");
+
+  /* throughput, for information only */
+  const int nb_run = 20;
+  clock_t start = clock();
+  for (int k = 0; k < nb_run; k++) {
+    lla_of_ecef_array_d(lla_out, ecef, n);
+  }
+  double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+  note("lla_of_ecef_array_d: %.1f ns per point", elapsed / (nb_run * n) * 1e9);
+#undef GRID_MAX
+}
+
+static double wmm_grid_max_error(struct WmmGrid *grid, float lat_c, float lon_c, float range)
+{
+  double max_err = 0.;
+  for (float lat = lat_c - range; lat <= lat_c + range; lat += range / 7.f) {
+    for (float lon = lon_c - range; lon <= lon_c + range; lon += range / 7.f) {
+      for (float alt = 0.f; alt <= 12.f; alt += 3.f) {
+        double ref[3];
+        mag_calc(1, lat, lon, alt, grid->nmax, grid->gh, &ref[0], &ref[1], &ref[2],
+                 IEXT, EXT_COEFF1, EXT_COEFF2, EXT_COEFF3);
+        float field[3];
+        if (!wmm_grid_lookup(grid, lat, lon, alt, field)) {
+          return 1e9;
+        }
+        double err = sqrt((field[0] - ref[0]) * (field[0] - ref[0]) + (field[1] - ref[1]) * (field[1] - ref[1]) +
+                          (field[2] - ref[2]) * (field[2] - ref[2]));
+        if (err > max_err) { max_err = err; }
+      }
+    }
+  }
+  return max_err;
+}
+
+static void test_wmm_grid(void)
+{
+  note("--- test WMM interpolation grid against the spherical harmonic model");
+
+  static struct WmmGrid grid;
+  wmm_grid_init(&grid, 2014.5, 43.6, 1.44, 1.0, 0., 10.);
+  float field[3];
+  ok(!wmm_grid_lookup(&grid, 43.6, 1.44, 0.2, field), "lookup fails while the grid is not built");
+  int nb_calls = 1;
+  while (!wmm_grid_build(&grid, 1)) {
+    nb_calls++;
+  }
+  cmp_ok(nb_calls, "==", WMM_GRID_NB_NODES, "grid built one node per call");
+
+  double max_err = wmm_grid_max_error(&grid, 43.6, 1.44, 1.4);
+  note("max interpolation error %.1f nT", max_err);
+  ok(max_err < 50., "interpolated field within 50nT of the model");
+  ok(!wmm_grid_lookup(&grid, 46., 1.44, 0.2, field), "lookup fails outside of the grid");
+
+  /* grid across the antimeridian */
+  wmm_grid_init(&grid, 2014.5, -17.5, 179.5, 1.0, 0., 10.);
+  wmm_grid_build(&grid, WMM_GRID_NB_NODES);
+  max_err = wmm_grid_max_error(&grid, -17.5, 179.5, 1.4);
+  note("max interpolation error across the antimeridian %.1f nT", max_err);
+  ok(max_err < 50., "interpolation across the antimeridian");
+
+  /* default spacing of the geo_mag module */
+  wmm_grid_init(&grid, 2014.5, 43.6, 1.44, 2.0, 0., 10.);
+  wmm_grid_build(&grid, WMM_GRID_NB_NODES);
+  max_err = wmm_grid_max_error(&grid, 43.6, 1.44, 2.8);
+  note("max interpolation error with a 2 deg spacing %.1f nT", max_err);
+  ok(max_err < 20., "interpolated field within 20nT of the model with a 2 deg spacing");
+}
+
 int main()
 {
   note("runing geodetic math tests");
-  plan(12);
+  plan(23);
 
   test_ecef_of_ned_int();
   test_enu_of_ecef_int();
@@ -366,6 +515,8 @@ int main()
   test_ecef_to_enu_to_ecef_float();
   test_lla_of_utm();
   test_lla_of_ecef();
+  test_lla_of_ecef_grid();
+  test_wmm_grid();
 
   done_testing();
 }
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_pprz_kalman.c
+ * @brief Tests for the packed covariance propagation and update.
+ *
+ * Results are compared with the full matrix formulas.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_kalman_float.h"
+#include "math/pprz_simple_matrix.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define N 6
+#define K_A 3
+#define M_B (N - K_A)
+#define TOL 1e-5
+
+/** random symmetric positive definite matrix */
+static void random_spd(float a[N][N])
+{
+  float b[N][N];
+  int i, j, k;
+  for (i = 0; i < N; i++) {
+    for (j = 0; j < N; j++) {
+      b[i][j] = (float)rand() / RAND_MAX - 0.5f;
+    }
+  }
+  for (i = 0; i < N; i++) {
+    for (j = 0; j < N; j++) {
+      float s = (i == j) ? 0.1f : 0.f;
+      for (k = 0; k < N; k++) {
+        s += b[i][k] * b[j][k];
+      }
+      a[i][j] = s;
+    }
+  }
+}
+
+static float max_diff(float a[N][N], float b[N][N])
+{
+  float d = 0.f;
+  int i, j;
+  for (i = 0; i < N; i++) {
+    for (j = 0; j < N; j++) {
+      if (fabsf(a[i][j] - b[i][j]) > d) {
+        d = fabsf(a[i][j] - b[i][j]);
+      }
+    }
+  }
+  return d;
+}
+
+int main()
+{
+  float P[PPRZ_KF_PACKED_SIZE(N)];
+  float _Pd[N][N], _o[N][N], _tmp[N][N];
+  MAKE_MATRIX_PTR(Pd, _Pd, N);
+  MAKE_MATRIX_PTR(o, _o, N);
+  MAKE_MATRIX_PTR(tmp, _tmp, N);
+  int i, j, k;
+
+  note("running packed covariance tests");
+  plan(5);
+
+  srand(42);
+  random_spd(_Pd);
+
+  /* pack / unpack */
+  pprz_kf_pack_float(P, Pd, N);
+  pprz_kf_unpack_float(o, P, N);
+  float diff = max_diff(_Pd, _o);
+  ok(diff == 0.f && P[PPRZ_KF_IDX(2, 4, N)] == _Pd[2][4], "pack / unpack");
+
+  /* block propagation against F * P * F^T */
+  float A[K_A][K_A] = {{ 1.f, 0.02f, -0.01f }, { -0.02f, 1.f, 0.03f }, { 0.01f, -0.03f, 1.f }};
+  float B[K_A][M_B] = {{ -0.1f, 0.f, 0.05f }, { 0.f, -0.1f, 0.f }, { 0.2f, 0.f, -0.1f }};
+  float _F[N][N];
+  MAKE_MATRIX_PTR(F, _F, N);
+  for (i = 0; i < N; i++) {
+    for (j = 0; j < N; j++) {
+      F[i][j] = (i == j) ? 1.f : 0.f;
+    }
+  }
+  for (i = 0; i < K_A; i++) {
+    for (j = 0; j < K_A; j++) {
+      F[i][j] = A[i][j];
+    }
+    for (j = 0; j < M_B; j++) {
+      F[i][K_A + j] = B[i][j];
+    }
+  }
+  float_mat_mul(tmp, F, Pd, N, N, N);
+  float_mat_transpose(F, N);
+  float_mat_mul(Pd, tmp, F, N, N, N);
+  pprz_kf_propagate_block_float(P, &A[0][0], &B[0][0], K_A, N);
+  pprz_kf_unpack_float(o, P, N);
+  diff = max_diff(_Pd, _o);
+  ok(diff < TOL, "block propagation: F * P * F^T (%g)", diff);
+
+  /* diagonal process noise */
+  float q[N] = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f };
+  for (i = 0; i < N; i++) {
+    Pd[i][i] += q[i];
+  }
+  pprz_kf_add_diag_float(P, q, N);
+  pprz_kf_unpack_float(o, P, N);
+  diff = max_diff(_Pd, _o);
+  ok(diff < TOL, "add diagonal (%g)", diff);
+
+  /* sequential scalar updates against the batch update with a 3x3 inverse */
+  float H[3][N] = {{ 0.f, -0.3f, 0.8f, 0.f, 0.f, 0.f },
+    { 0.3f, 0.f, -0.5f, 0.f, 0.f, 0.f },
+    { -0.8f, 0.5f, 0.f, 0.f, 0.f, 0.f }
+  };
+  float r[3] = { 0.2f, 0.3f, 0.1f };
+  float e[3] = { 0.05f, -0.1f, 0.2f };
+  float _PHt[N][3], S[3][3], _invS[3][3], _Kb[N][3];
+  MAKE_MATRIX_PTR(PHt, _PHt, N);
+  MAKE_MATRIX_PTR(invS, _invS, 3);
+  MAKE_MATRIX_PTR(Kb, _Kb, N);
+  float xb[N];
+  for (i = 0; i < N; i++) {
+    for (j = 0; j < 3; j++) {
+      PHt[i][j] = 0.f;
+      for (k = 0; k < N; k++) {
+        PHt[i][j] += Pd[i][k] * H[j][k];
+      }
+    }
+  }
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < 3; j++) {
+      S[i][j] = (i == j) ? r[i] : 0.f;
+      for (k = 0; k < N; k++) {
+        S[i][j] += H[i][k] * PHt[k][j];
+      }
+    }
+  }
+  MAT_INV33(_invS, S);
+  float_mat_mul(Kb, PHt, invS, N, 3, 3);
+  for (i = 0; i < N; i++) {
+    xb[i] = Kb[i][0] * e[0] + Kb[i][1] * e[1] + Kb[i][2] * e[2];
+    for (j = 0; j < N; j++) {
+      tmp[i][j] = Pd[i][j] - (Kb[i][0] * PHt[j][0] + Kb[i][1] * PHt[j][1] + Kb[i][2] * PHt[j][2]);
+    }
+  }
+
+  float x[N] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+  float K[N];
+  for (k = 0; k < 3; k++) {
+    float res = e[k];
+    for (j = 0; j < K_A; j++) {
+      res -= H[k][j] * x[j];
+    }
+    pprz_kf_update_scalar_float(P, K, H[k], K_A, r[k], N);
+    for (i = 0; i < N; i++) {
+      x[i] += K[i] * res;
+    }
+  }
+  pprz_kf_unpack_float(o, P, N);
+  diff = max_diff(_tmp, _o);
+  ok(diff < TOL, "sequential scalar updates: covariance (%g)", diff);
+  float dx = 0.f;
+  for (i = 0; i < N; i++) {
+    if (fabsf(x[i] - xb[i]) > dx) {
+      dx = fabsf(x[i] - xb[i]);
+    }
+  }
+  ok(dx < TOL, "sequential scalar updates: state correction (%g)", dx);
+
+  done_testing();
+}
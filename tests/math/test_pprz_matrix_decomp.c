@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_pprz_matrix_decomp.c
+ * @brief Tests for the matrix decompositions.
+ *
+ * The contiguous fixed size kernels are checked against the row pointer
+ * versions and by reconstruction of the decomposed matrices.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_matrix_decomp_float.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define N 9
+#define TOL 1e-4
+
+/** random symmetric positive definite matrix */
+static void random_spd(float *A, int n)
+{
+  float B[n * n];
+  int i, j, k;
+  for (i = 0; i < n * n; i++) {
+    B[i] = (float)rand() / RAND_MAX - 0.5f;
+  }
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      float s = (i == j) ? 0.5f : 0.f;
+      for (k = 0; k < n; k++) {
+        s += B[i * n + k] * B[j * n + k];
+      }
+      A[i * n + j] = s;
+    }
+  }
+}
+
+static float max_diff(const float *a, const float *b, int n)
+{
+  float d = 0.f;
+  int i;
+  for (i = 0; i < n; i++) {
+    if (fabsf(a[i] - b[i]) > d) {
+      d = fabsf(a[i] - b[i]);
+    }
+  }
+  return d;
+}
+
+/** o = L * D * L^T, D = identity if ld is FALSE */
+static void reconstruct(float *o, const float *L, int n, bool_t ld)
+{
+  int i, j, k;
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      float s = 0.f;
+      for (k = 0; k <= i && k <= j; k++) {
+        if (ld) {
+          float lik = (i == k) ? 1.f : L[i * n + k];
+          float ljk = (j == k) ? 1.f : L[j * n + k];
+          s += lik * L[k * n + k] * ljk;
+        } else {
+          s += L[i * n + k] * L[j * n + k];
+        }
+      }
+      o[i * n + j] = s;
+    }
+  }
+}
+
+int main()
+{
+  float A[N * N], L[N * N], LD[N * N], B[N * N];
+  float x[N], b[N], y[N], u[N];
+  int i, j, k;
+
+  note("running matrix decomposition tests");
+  plan(9);
+
+  srand(42);
+  random_spd(A, N);
+
+  /* Cholesky, compared with the row pointer version */
+  float _Ap[N][N], _Lp[N][N];
+  MAKE_MATRIX_PTR(Ap, _Ap, N);
+  MAKE_MATRIX_PTR(Lp, _Lp, N);
+  memcpy(_Ap, A, sizeof(A));
+  pprz_cholesky_float(Lp, Ap, N);
+  memcpy(L, A, sizeof(A));
+  bool_t ret = pprz_cholesky_float9(L);
+  float diff = max_diff(L, &_Lp[0][0], N * N);
+  ok(ret && diff < TOL, "cholesky: same factor as pprz_cholesky_float (%g)", diff);
+
+  /* Cholesky solve */
+  for (i = 0; i < N; i++) {
+    x[i] = i - 4.f;
+  }
+  for (i = 0; i < N; i++) {
+    b[i] = 0.f;
+    for (k = 0; k < N; k++) {
+      b[i] += A[i * N + k] * x[k];
+    }
+  }
+  memcpy(y, b, sizeof(b));
+  pprz_cholesky_solve_float9(L, y);
+  diff = max_diff(x, y, N);
+  ok(diff < 1e-3, "cholesky solve (%g)", diff);
+
+  /* LDLT */
+  memcpy(LD, A, sizeof(A));
+  ret = pprz_ldlt_float9(LD);
+  reconstruct(B, LD, N, TRUE);
+  diff = max_diff(A, B, N * N);
+  ok(ret && diff < TOL, "ldlt: L * D * L^T = A (%g)", diff);
+
+  memcpy(y, b, sizeof(b));
+  pprz_ldlt_solve_float9(LD, y);
+  diff = max_diff(x, y, N);
+  ok(diff < 1e-3, "ldlt solve (%g)", diff);
+
+  /* rank-1 update of the Cholesky factor, compared with the factor of the updated matrix */
+  for (i = 0; i < N; i++) {
+    u[i] = 0.3f * (i % 3) - 0.2f;
+  }
+  for (i = 0; i < N; i++) {
+    for (j = 0; j < N; j++) {
+      B[i * N + j] = A[i * N + j] + u[i] * u[j];
+    }
+  }
+  float Lu[N * N];
+  memcpy(Lu, B, sizeof(B));
+  pprz_cholesky_float9(Lu);
+  memcpy(y, u, sizeof(u));
+  ret = pprz_cholesky_update_float9(L, y, 1.f);
+  diff = max_diff(L, Lu, N * N);
+  ok(ret && diff < TOL, "cholesky rank-1 update (%g)", diff);
+
+  /* and downdate back */
+  memcpy(y, u, sizeof(u));
+  ret = pprz_cholesky_update_float9(L, y, -1.f);
+  diff = max_diff(L, &_Lp[0][0], N * N);
+  ok(ret && diff < TOL, "cholesky rank-1 downdate (%g)", diff);
+
+  /* rank-1 update of the LDLT decomposition */
+  memcpy(y, u, sizeof(u));
+  ret = pprz_ldlt_update_float9(LD, y, -0.5f);
+  reconstruct(L, LD, N, TRUE);
+  for (i = 0; i < N; i++) {
+    for (j = 0; j < N; j++) {
+      B[i * N + j] = A[i * N + j] - 0.5f * u[i] * u[j];
+    }
+  }
+  diff = max_diff(L, B, N * N);
+  ok(ret && diff < TOL, "ldlt rank-1 downdate (%g)", diff);
+
+  /* QR of a non symmetric matrix */
+  float Q[N * N], R[N * N];
+  for (i = 0; i < N * N; i++) {
+    R[i] = B[i] + 0.1f * (i % 7);
+  }
+  memcpy(B, R, sizeof(R));
+  pprz_qr_float9(Q, R);
+  float tri = 0.f;
+  for (i = 0; i < N; i++) {
+    for (j = 0; j < N; j++) {
+      float s = 0.f, id = 0.f;
+      for (k = 0; k < N; k++) {
+        s += Q[i * N + k] * R[k * N + j];
+        id += Q[k * N + i] * Q[k * N + j];
+      }
+      L[i * N + j] = s;
+      LD[i * N + j] = id - ((i == j) ? 1.f : 0.f);
+      if (j < i && fabsf(R[i * N + j]) > tri) {
+        tri = fabsf(R[i * N + j]);
+      }
+    }
+  }
+  diff = max_diff(L, B, N * N);
+  ok(diff < TOL && tri < TOL, "qr: Q * R = A with R upper triangular (%g, %g)", diff, tri);
+  memset(B, 0, sizeof(B));
+  diff = max_diff(LD, B, N * N);
+  ok(diff < TOL, "qr: Q is orthogonal (%g)", diff);
+
+  done_testing();
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_pprz_trig_int.c
+ * @brief Tests for the fixed point trigonometric and square root functions.
+ *
+ * Results are compared with libm, the time per call is reported.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "math/pprz_algebra_int.h"
+#include "math/pprz_trig_int.h"
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#define NB_BENCH 1000000
+
+static volatile int32_t sink;
+
+static void test_sin_cos(void)
+{
+  note("--- sin/cos over [-4pi, 4pi]");
+  double max_err = 0.;
+  for (int32_t a = -2 * INT32_ANGLE_2_PI; a <= 2 * INT32_ANGLE_2_PI; a++) {
+    double rad = ANGLE_FLOAT_OF_BFP(a);
+    double es = fabs(pprz_itrig_sin(a) - sin(rad) * (1 << INT32_TRIG_FRAC));
+    double ec = fabs(pprz_itrig_cos(a) - cos(rad) * (1 << INT32_TRIG_FRAC));
+    if (es > max_err) { max_err = es; }
+    if (ec > max_err) { max_err = ec; }
+  }
+  note("max error %.3f LSB", max_err);
+  ok(max_err <= 1., "sin/cos error below 1 LSB");
+
+  int32_t angles[64], s[64], c[64];
+  int mismatch = 0;
+  for (int i = 0; i < 64; i++) {
+    angles[i] = (int32_t)(rand() % (4 * INT32_ANGLE_2_PI)) - 2 * INT32_ANGLE_2_PI;
+  }
+  pprz_itrig_sincos_array(s, c, angles, 64);
+  for (int i = 0; i < 64; i++) {
+    int32_t si, ci;
+    pprz_itrig_sincos(angles[i], &si, &ci);
+    if (si != s[i] || ci != c[i] || si != pprz_itrig_sin(angles[i]) || ci != pprz_itrig_cos(angles[i])) {
+      mismatch++;
+    }
+  }
+  cmp_ok(mismatch, "==", 0, "sincos and sincos_array match sin and cos");
+
+  clock_t start = clock();
+  for (int32_t i = 0; i < NB_BENCH; i++) {
+    sink = pprz_itrig_sin(i);
+  }
+  note("pprz_itrig_sin: %.1f ns per call",
+       (double)(clock() - start) / CLOCKS_PER_SEC / NB_BENCH * 1e9);
+}
+
+static void test_atan2(void)
+{
+  note("--- atan2 on circles of radius 1 to 2^30");
+  double max_err = 0.;
+  for (int scale = 0; scale <= 30; scale += 3) {
+    const double r = (double)(1 << scale);
+    for (int k = 0; k < 3600; k++) {
+      const double ang = -M_PI + k * M_PI / 1800.;
+      const int32_t x = (int32_t)lrint(r * cos(ang));
+      const int32_t y = (int32_t)lrint(r * sin(ang));
+      if (x == 0 && y == 0) {
+        continue;
+      }
+      double e = fabs(int32_atan2(y, x) - atan2(y, x) * (1 << INT32_ANGLE_FRAC));
+      /* +pi and -pi are the same angle */
+      e = fmin(e, fabs(e - INT32_ANGLE_2_PI));
+      if (e > max_err) { max_err = e; }
+    }
+  }
+  note("max error %.3f LSB (%.2e rad)", max_err, max_err / (1 << INT32_ANGLE_FRAC));
+  ok(max_err <= 1., "atan2 error below 1 LSB");
+  cmp_ok(int32_atan2(0, 0), "==", 0, "atan2(0, 0) is 0");
+  ok(abs(int32_atan2(0, INT32_MIN) - INT32_ANGLE_PI) <= 1 && abs(int32_atan2(INT32_MIN, 0) + INT32_ANGLE_PI_2) <= 1,
+     "atan2 of extreme values");
+
+  clock_t start = clock();
+  for (int32_t i = 0; i < NB_BENCH; i++) {
+    sink = int32_atan2(i, 1000);
+  }
+  note("int32_atan2: %.1f ns per call",
+       (double)(clock() - start) / CLOCKS_PER_SEC / NB_BENCH * 1e9);
+}
+
+static void test_sqrt(void)
+{
+  note("--- integer square root");
+  int wrong = 0;
+  for (uint32_t i = 0; i < 200000; i++) {
+    uint32_t in = (i < 100000) ? i : (uint32_t)rand() * 2u + (rand() & 1);
+    uint32_t ref = (uint32_t)llrint(sqrt((double)in));
+    if (int32_sqrt(in) != ref) {
+      wrong++;
+    }
+  }
+  cmp_ok(int32_sqrt(UINT32_MAX), "==", 65536, "sqrt of UINT32_MAX");
+  cmp_ok(wrong, "==", 0, "int32_sqrt rounded to nearest");
+
+  /* quaternion normalization */
+  double max_norm_err = 0.;
+  for (int i = 0; i < 10000; i++) {
+    struct Int32Quat q = { rand() % 40000 - 20000, rand() % 40000 - 20000,
+                           rand() % 40000 - 20000, rand() % 40000 - 20000 };
+    int32_quat_normalize(&q);
+    double n = sqrt((double)q.qi * q.qi + (double)q.qx * q.qx + (double)q.qy * q.qy + (double)q.qz * q.qz);
+    if (fabs(n - (1 << INT32_QUAT_FRAC)) > max_norm_err) {
+      max_norm_err = fabs(n - (1 << INT32_QUAT_FRAC));
+    }
+  }
+  note("quaternion norm max error %.2f LSB", max_norm_err);
+  ok(max_norm_err < 2., "int32_quat_normalize norm within 2 LSB of 1");
+
+  clock_t start = clock();
+  for (int32_t i = 0; i < NB_BENCH; i++) {
+    sink = int32_sqrt((uint32_t)i << 10);
+  }
+  note("int32_sqrt: %.1f ns per call",
+       (double)(clock() - start) / CLOCKS_PER_SEC / NB_BENCH * 1e9);
+}
+
+int main()
+{
+  note("running fixed point trig tests");
+  plan(8);
+
+  test_sin_cos();
+  test_atan2();
+  test_sqrt();
+
+  done_testing();
+}
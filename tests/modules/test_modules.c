@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_modules.c
+ * @brief Smoke test of the periodic scheduler generated by gen_modules.
+ *
+ * The modules.h generated for a test airframe is compiled with the test.
+ * modules_periodic_task is run over two schedule periods, checking the
+ * period of each function and the load of each tick against the load
+ * predicted by the generator.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include <math.h>
+
+#define MODULES_C
+#include "generated/modules.h"
+
+struct test_function {
+  const char *name;
+  uint32_t period;    ///< expected period in ticks
+  float cost;         ///< declared cost in usec
+};
+
+#if defined TEST_AIRFRAME_harmonic
+static const struct test_function functions[] = {
+  { "harmonic_512hz", 1, 10 },
+  { "harmonic_256hz", 2, 30 },
+  { "harmonic_128hz", 4, 40 },
+  { "harmonic_64hz_a", 8, 50 },
+  { "harmonic_64hz_b", 8, 50 },
+  { "harmonic_32hz", 16, 0 },
+  { "harmonic_16hz", 32, 100 },
+  { "harmonic_1hz", 512, 200 }
+};
+/** least common multiple of the periods */
+#define SCHEDULE_PERIOD 512
+#define LOAD_EXACT TRUE
+#else
+static const struct test_function functions[] = {
+  { "rates_512hz", 1, 10 },
+  { "rates_100hz", 5, 60 },
+  { "rates_60hz", 8, 80 },
+  { "rates_50hz", 10, 40 },
+  { "rates_10hz", 51, 150 },
+  { "rates_1hz", 512, 300 }
+};
+#define SCHEDULE_PERIOD 130560
+#define LOAD_EXACT FALSE
+#endif
+
+#define NB_FUNCTIONS (sizeof(functions) / sizeof(functions[0]))
+
+static uint32_t tick;
+static float tick_load;
+static uint32_t nb_calls[NB_FUNCTIONS];
+static uint32_t last_call[NB_FUNCTIONS];
+static uint32_t wrong_period[NB_FUNCTIONS];
+
+void test_call(uint8_t id)
+{
+  if (nb_calls[id] > 0 && tick - last_call[id] != functions[id].period) {
+    wrong_period[id]++;
+  }
+  last_call[id] = tick;
+  nb_calls[id]++;
+  tick_load += functions[id].cost;
+}
+
+int main()
+{
+  note("running gen_modules tests");
+  plan(5);
+
+  ok(GEN_WARNINGS == 0, "modules.h generated without warnings");
+
+  /* load of the ticks of the second schedule period */
+  float max_load = 0, sum_load = 0, sum_costs = 0;
+  for (tick = 0; tick < 2 * SCHEDULE_PERIOD; tick++) {
+    tick_load = 0;
+    modules_periodic_task();
+    if (tick >= SCHEDULE_PERIOD) {
+      max_load = Max(max_load, tick_load);
+      sum_load += tick_load;
+    }
+  }
+  float avg_load = sum_load / SCHEDULE_PERIOD;
+
+  bool_t periods_ok = TRUE;
+  for (uint8_t i = 0; i < NB_FUNCTIONS; i++) {
+    if (wrong_period[i] != 0 || nb_calls[i] != 2 * SCHEDULE_PERIOD / functions[i].period) {
+      diag("%s: %u calls, %u wrong periods", functions[i].name, nb_calls[i], wrong_period[i]);
+      periods_ok = FALSE;
+    }
+    sum_costs += functions[i].cost;
+  }
+  ok(periods_ok, "each function runs at its period");
+
+  note("load %.1fus max, %.1fus average, sum of the costs %.1fus", max_load, avg_load, sum_costs);
+  /* periods not harmonic, the functions meet in some ticks */
+  skip(!LOAD_EXACT, 1, "periods not harmonic");
+  ok(max_load < sum_costs / 2, "functions spread over the ticks");
+  end_skip;
+
+#ifdef MODULES_PERIODIC_LOAD_MAX
+  note("predicted load %.1fus max, %.1fus average", MODULES_PERIODIC_LOAD_MAX, MODULES_PERIODIC_LOAD_AVG);
+  ok(LOAD_EXACT, "predicted load defined for a complete simulation");
+  ok(fabs(max_load - MODULES_PERIODIC_LOAD_MAX) < 0.05 && fabs(avg_load - MODULES_PERIODIC_LOAD_AVG) < 0.05,
+     "predicted load matches the load of the ticks");
+#else
+  ok(!LOAD_EXACT, "predicted load not defined for a schedule longer than the simulation");
+  skip(TRUE, 1, "no predicted load");
+  end_skip;
+#endif
+
+  done_testing();
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_modules.h
+ * Periodic functions of the test modules, each one records its call.
+ */
+
+#ifndef TEST_MODULES_H
+#define TEST_MODULES_H
+
+#include "std.h"
+
+extern void test_call(uint8_t id);
+
+/* conf/modules/test_harmonic.xml */
+#define harmonic_512hz() test_call(0)
+#define harmonic_256hz() test_call(1)
+#define harmonic_128hz() test_call(2)
+#define harmonic_64hz_a() test_call(3)
+#define harmonic_64hz_b() test_call(4)
+#define harmonic_32hz() test_call(5)
+#define harmonic_16hz() test_call(6)
+#define harmonic_1hz() test_call(7)
+
+/* conf/modules/test_rates.xml */
+#define rates_512hz() test_call(0)
+#define rates_100hz() test_call(1)
+#define rates_60hz() test_call(2)
+#define rates_50hz() test_call(3)
+#define rates_10hz() test_call(4)
+#define rates_1hz() test_call(5)
+
+#endif /* TEST_MODULES_H */
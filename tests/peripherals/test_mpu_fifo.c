@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_mpu_fifo.c
+ * @brief Tests of the FIFO burst decoding of the MPU60x0 and MPU9250 drivers.
+ *
+ * The samples are big endian accel then gyro words, the time stamps are
+ * interpolated back from the FIFO count with the sample period.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "peripherals/mpu60x0.h"
+#include "peripherals/mpu9250.h"
+#include <string.h>
+
+#define SAMPLE_SIZE 12
+#define PERIOD 500
+
+/* stubs of the SPI/I2C drivers, slaves are configured by them */
+bool_t mpu60x0_configure_i2c_slaves(Mpu60x0ConfigSet mpu_set __attribute__((unused)), void *mpu __attribute__((unused)))
+{
+  return TRUE;
+}
+
+bool_t mpu9250_configure_i2c_slaves(Mpu9250ConfigSet mpu_set __attribute__((unused)), void *mpu __attribute__((unused)))
+{
+  return TRUE;
+}
+
+/** Fill a burst of nb samples: accel x is the sample index, gyro x is negative */
+static void fill_burst(uint8_t *buf, uint8_t nb)
+{
+  for (uint8_t i = 0; i < nb; i++) {
+    uint8_t *s = buf + i * SAMPLE_SIZE;
+    s[0] = 0x01; s[1] = i;    // accel x: 0x0100 + i
+    s[2] = 0x12; s[3] = 0x34; // accel y: 0x1234
+    s[4] = 0x80; s[5] = 0x00; // accel z: -32768
+    s[6] = 0xFF; s[7] = 0xFE; // gyro p: -2
+    s[8] = 0x7F; s[9] = 0xFF; // gyro q: 32767
+    s[10] = 0x00; s[11] = 0x2A; // gyro r: 42
+  }
+}
+
+static void test_mpu60x0(void)
+{
+  note("--- MPU60x0");
+  struct Mpu60x0Fifo fifo;
+  uint8_t buf[4 * SAMPLE_SIZE];
+  memset(&fifo, 0, sizeof(fifo));
+  fill_burst(buf, 4);
+
+  /* 3 samples read out of 5 in the FIFO */
+  fifo.nb_available = 5;
+  fifo.count_stamp = 10000;
+  mpu60x0_fifo_decode(&fifo, buf, 3, PERIOD);
+  cmp_ok(fifo.nb_samples, "==", 3, "number of samples decoded");
+  ok(fifo.accel[2][0] == 0x0102 && fifo.accel[1][1] == 0x1234 && fifo.accel[0][2] == -32768,
+     "accel words are big endian");
+  ok(fifo.rates[2][0] == -2 && fifo.rates[1][1] == 32767 && fifo.rates[0][2] == 42,
+     "gyro words are big endian, after the accel");
+  ok(fifo.stamp[0] == 8000 && fifo.stamp[1] == 8500 && fifo.stamp[2] == 9000,
+     "stamps of the oldest samples when some are left in the FIFO");
+
+  /* remaining samples */
+  fifo.nb_available = 2;
+  fifo.count_stamp = 10100;
+  mpu60x0_fifo_decode(&fifo, buf, 2, PERIOD);
+  ok(fifo.stamp[0] == 9600 && fifo.stamp[1] == 10100, "last sample stamped at the count");
+  cmp_ok(fifo.sample_cnt, "==", 5, "samples counted");
+
+  ok(MPU60X0_FIFO_MAX_SAMPLES * MPU60X0_FIFO_POLL_FREQ >= MPU60X0_FIFO_SAMPLE_FREQ,
+     "burst holds the samples between two polls");
+}
+
+static void test_mpu9250(void)
+{
+  note("--- MPU9250");
+  struct Mpu9250Fifo fifo;
+  uint8_t buf[4 * SAMPLE_SIZE];
+  memset(&fifo, 0, sizeof(fifo));
+  fill_burst(buf, 4);
+
+  fifo.nb_available = 5;
+  fifo.count_stamp = 10000;
+  mpu9250_fifo_decode(&fifo, buf, 3, PERIOD);
+  cmp_ok(fifo.nb_samples, "==", 3, "number of samples decoded");
+  ok(fifo.accel[2][0] == 0x0102 && fifo.accel[1][1] == 0x1234 && fifo.accel[0][2] == -32768,
+     "accel words are big endian");
+  ok(fifo.rates[2][0] == -2 && fifo.rates[1][1] == 32767 && fifo.rates[0][2] == 42,
+     "gyro words are big endian, after the accel");
+  ok(fifo.stamp[0] == 8000 && fifo.stamp[1] == 8500 && fifo.stamp[2] == 9000,
+     "stamps of the oldest samples when some are left in the FIFO");
+
+  ok(MPU9250_FIFO_MAX_SAMPLES * MPU9250_FIFO_POLL_FREQ >= MPU9250_FIFO_SAMPLE_FREQ,
+     "burst holds the samples between two polls");
+}
+
+int main()
+{
+  note("running MPU FIFO tests");
+  plan(12);
+
+  test_mpu60x0();
+  test_mpu9250();
+
+  done_testing();
+}
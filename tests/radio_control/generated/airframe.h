@@ -0,0 +1,8 @@
+/* fake generated airframe file */
+
+#ifndef AIRFRAME_H
+#define AIRFRAME_H
+
+#define RADIO_CONTROL_NB_CHANNEL 4
+
+#endif // AIRFRAME_H
@@ -0,0 +1,43 @@
+/* fake generated radio file, 4 channels without filter */
+
+#ifndef RADIO_H
+#define RADIO_H
+
+#define RADIO_NAME "test"
+
+#define RADIO_CTL_NB 4
+
+#define RADIO_FILTER 0
+
+#define RADIO_THROTTLE 0
+#define RADIO_ROLL 1
+#define RADIO_PITCH 2
+#define RADIO_YAW 3
+
+#define NormalizePpmIIR(_ppm, _rc) {\
+  int32_t tmp_radio;\
+  int32_t tmp_value;\
+\
+  tmp_radio = _ppm[RADIO_THROTTLE] - RC_PPM_TICKS_OF_USEC(1000);\
+  tmp_value = (tmp_radio * MAX_PPRZ) / (RC_PPM_SIGNED_TICKS_OF_USEC(2000-1000));\
+  Bound(tmp_value, 0, MAX_PPRZ); \
+  _rc.values[RADIO_THROTTLE] = (pprz_t)(tmp_value);\
+\
+  tmp_radio = _ppm[RADIO_ROLL] - RC_PPM_TICKS_OF_USEC(1500);\
+  tmp_value = (tmp_radio >=0 ? (tmp_radio *  MAX_PPRZ) / (RC_PPM_SIGNED_TICKS_OF_USEC(2000-1500)) : (tmp_radio * MIN_PPRZ) / (RC_PPM_SIGNED_TICKS_OF_USEC(1000-1500)));\
+  Bound(tmp_value, MIN_PPRZ, MAX_PPRZ); \
+  _rc.values[RADIO_ROLL] = (pprz_t)(tmp_value);\
+\
+  tmp_radio = _ppm[RADIO_PITCH] - RC_PPM_TICKS_OF_USEC(1500);\
+  tmp_value = (tmp_radio >=0 ? (tmp_radio *  MAX_PPRZ) / (RC_PPM_SIGNED_TICKS_OF_USEC(2000-1500)) : (tmp_radio * MIN_PPRZ) / (RC_PPM_SIGNED_TICKS_OF_USEC(1000-1500)));\
+  Bound(tmp_value, MIN_PPRZ, MAX_PPRZ); \
+  _rc.values[RADIO_PITCH] = (pprz_t)(tmp_value);\
+\
+  tmp_radio = _ppm[RADIO_YAW] - RC_PPM_TICKS_OF_USEC(1500);\
+  tmp_value = (tmp_radio >=0 ? (tmp_radio *  MAX_PPRZ) / (RC_PPM_SIGNED_TICKS_OF_USEC(2000-1500)) : (tmp_radio * MIN_PPRZ) / (RC_PPM_SIGNED_TICKS_OF_USEC(1000-1500)));\
+  Bound(tmp_value, MIN_PPRZ, MAX_PPRZ); \
+  _rc.values[RADIO_YAW] = (pprz_t)(tmp_value);\
+\
+}
+
+#endif // RADIO_H
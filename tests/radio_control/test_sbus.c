@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_sbus.c
+ * @brief Tests and benchmark of the SBUS decoder.
+ *
+ * A receiver stream is generated as a SBUS receiver outputs it every 7 ms,
+ * with lost frames and corrupted frames. It is decoded by buffers and
+ * through the uart receive buffer, the channels are compared with a bit per
+ * bit decoder and the time stamps and the latency are checked.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "subsystems/radio_control.h"
+#include "mcu_periph/sys_time.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STREAM_DURATION 60
+#define FRAME_PERIOD_MS 7
+#define NB_FRAMES_MAX (STREAM_DURATION * 1000 / FRAME_PERIOD_MS + 1)
+#define FRAME_LENGTH (SBUS_BUF_LENGTH + 1)
+#define STREAM_MAX (NB_FRAMES_MAX * FRAME_LENGTH + 64)
+
+/* stubs of the autopilot */
+struct sys_time sys_time;
+
+void uart_transmit(struct uart_periph *p __attribute__((unused)), uint8_t data __attribute__((unused))) {}
+void uart_periph_set_baudrate(struct uart_periph *p __attribute__((unused)), uint32_t baud __attribute__((unused))) {}
+void uart_periph_set_bits_stop_parity(struct uart_periph *p __attribute__((unused)), uint8_t bits __attribute__((unused)),
+                                      uint8_t stop __attribute__((unused)), uint8_t parity __attribute__((unused))) {}
+
+/** Generated frames */
+struct test_frame {
+  uint32_t start;           ///< position of the start byte in the stream
+  uint16_t channels[SBUS_NB_CHANNEL];
+  bool_t lost;              ///< frame lost flag set
+  bool_t corrupted;         ///< wrong end byte
+  uint32_t start_chunk;     ///< chunk or event the start byte was read in
+};
+
+static uint8_t stream[STREAM_MAX];
+static uint32_t stream_len;
+static struct test_frame frames[NB_FRAMES_MAX];
+static uint32_t nb_frames;
+
+/*
+ * Stream generation
+ */
+
+/** Previous bit per bit decoder as reference */
+static void ref_decode(const uint8_t *src, uint16_t *dst)
+{
+  uint8_t byteInRawBuf = 0;
+  uint8_t bitInRawBuf = 0;
+  uint8_t channel = 0;
+  uint8_t bitInChannel = 0;
+
+  memset(dst, 0, SBUS_NB_CHANNEL * sizeof(uint16_t));
+  for (uint8_t i = 0; i < (SBUS_NB_CHANNEL * 11); i++) {
+    if (src[byteInRawBuf] & (1 << bitInRawBuf)) {
+      dst[channel] |= (1 << bitInChannel);
+    }
+    bitInRawBuf++;
+    bitInChannel++;
+    if (bitInRawBuf == 8) {
+      bitInRawBuf = 0;
+      byteInRawBuf++;
+    }
+    if (bitInChannel == 11) {
+      bitInChannel = 0;
+      channel++;
+    }
+  }
+}
+
+/** Frame number from the channels of a decoded frame */
+static uint32_t frame_nb(const uint16_t *channels)
+{
+  return channels[14] | ((uint32_t)channels[15] << 11);
+}
+
+static void add_frame(uint32_t k)
+{
+  struct test_frame *f = &frames[nb_frames++];
+  f->start = stream_len;
+  /* sticks, random switches and the frame number */
+  for (int i = 0; i < 4; i++) {
+    f->channels[i] = 1024 + (int)(800 * sin(k * 0.01 + i));
+  }
+  for (int i = 4; i < 14; i++) {
+    f->channels[i] = rand() & 0x7ff;
+  }
+  f->channels[14] = k & 0x7ff;
+  f->channels[15] = k >> 11;
+  f->lost = (k % 50 == 17);
+  f->corrupted = (k % 97 == 33);
+
+  uint8_t *p = &stream[stream_len];
+  memset(p, 0, FRAME_LENGTH);
+  p[0] = 0x0f;
+  uint32_t bit = 0;
+  for (int i = 0; i < SBUS_NB_CHANNEL; i++) {
+    for (int b = 0; b < 11; b++, bit++) {
+      if (f->channels[i] & (1 << b)) {
+        p[1 + bit / 8] |= 1 << (bit % 8);
+      }
+    }
+  }
+  p[23] = f->lost ? 0x04 : 0;
+  p[24] = f->corrupted ? 0x04 : 0;
+  stream_len += FRAME_LENGTH;
+}
+
+static void generate_stream(void)
+{
+  stream_len = 0;
+  nb_frames = 0;
+  /* start in the middle of a frame */
+  for (int i = 0; i < 13; i++) {
+    stream[stream_len++] = 0xa5;
+  }
+  for (uint32_t k = 0; k < STREAM_DURATION * 1000 / FRAME_PERIOD_MS; k++) {
+    add_frame(k);
+  }
+}
+
+/*
+ * Decoding
+ */
+
+/** Chunk size of the reads, as the spans of a uart receive buffer */
+static uint16_t chunk_len(uint32_t i)
+{
+  return 1 + (i * 7919) % 96;
+}
+
+static void reset_sbus(void)
+{
+  memset(&sbus, 0, sizeof(sbus));
+}
+
+/** Decode by buffers, the stamp of a buffer is its index.
+ * @return number of errors
+ */
+static uint32_t parse_buffers(uint32_t *nb_available)
+{
+  uint32_t errors = 0, pos = 0, next_start = 0, next_end = 0;
+  reset_sbus();
+  *nb_available = 0;
+  for (uint32_t i = 0; pos < stream_len; i++) {
+    uint16_t len = Min(chunk_len(i), stream_len - pos);
+    sbus_common_parse_buffer(&sbus, &stream[pos], len, i);
+    pos += len;
+    while (next_start < nb_frames && frames[next_start].start < pos) {
+      frames[next_start++].start_chunk = i;
+    }
+    /* last frame with a correct end byte ending in this chunk */
+    struct test_frame *last = NULL;
+    while (next_end < nb_frames && frames[next_end].start + FRAME_LENGTH <= pos) {
+      if (!frames[next_end].corrupted) {
+        last = &frames[next_end];
+      }
+      next_end++;
+    }
+    if (last != NULL) {
+      if (sbus.frame_available != !last->lost ||
+          memcmp(sbus.pulses, last->channels, sizeof(sbus.pulses)) != 0 ||
+          sbus.frame_stamp != last->start_chunk) {
+        errors++;
+      }
+    } else if (sbus.frame_available) {
+      errors++;
+    }
+    *nb_available += sbus.frame_available;
+    sbus.frame_available = FALSE;
+  }
+  return errors;
+}
+
+static uint32_t nb_handled, handler_errors;
+
+static void frame_handler(void)
+{
+  uint32_t k = frame_nb(sbus.pulses);
+  if (k >= nb_frames || frames[k].lost || frames[k].corrupted ||
+      memcmp(sbus.pulses, frames[k].channels, sizeof(sbus.pulses)) != 0 ||
+      radio_control.frame_stamp != frames[k].start_chunk * 1000000) {
+    handler_errors++;
+  }
+  nb_handled++;
+}
+
+/** Feed the stream through the uart receive buffer, one event per second,
+ * the actuators are set 2.5 ms after each event.
+ * @return number of latency errors
+ */
+static uint32_t parse_uart(void)
+{
+  uint32_t errors = 0, pos = 0, next_start = 0;
+  reset_sbus();
+  radio_control_init();
+  nb_handled = 0;
+  handler_errors = 0;
+  sys_time.nb_sec = 0;
+  while (pos < stream_len || uart_char_available(&uart0)) {
+    uint16_t space = UART_RX_BUFFER_SIZE - 1 - uart_char_available(&uart0);
+    uint16_t len = Min(Min(space, chunk_len(sys_time.nb_sec)), stream_len - pos);
+    for (uint16_t i = 0; i < len; i++) {
+      uart0.rx_buf[uart0.rx_insert_idx] = stream[pos++];
+      uart0.rx_insert_idx = (uart0.rx_insert_idx + 1) % UART_RX_BUFFER_SIZE;
+    }
+    sys_time.nb_sec++;
+    sys_time.nb_sec_rem = 0;
+    while (next_start < nb_frames && frames[next_start].start < pos) {
+      frames[next_start++].start_chunk = sys_time.nb_sec;
+    }
+    uint32_t handled = nb_handled;
+    RadioControlEvent(frame_handler);
+    sys_time.nb_sec_rem = 2500;
+    radio_control_latency_update();
+    if (nb_handled != handled &&
+        radio_control.latency.last != (sys_time.nb_sec - frames[frame_nb(sbus.pulses)].start_chunk) * 1000000 + 2500) {
+      errors++;
+    }
+    /* only the first update after a frame is counted */
+    radio_control_latency_update();
+  }
+  return errors;
+}
+
+static void test_decoder(void)
+{
+  note("--- decoder");
+  generate_stream();
+  uint32_t wrong = 0, nb_good = 0, nb_available = 0;
+  for (uint32_t k = 0; k < nb_frames; k++) {
+    uint16_t ref[SBUS_NB_CHANNEL];
+    ref_decode(&stream[frames[k].start + 1], ref);
+    reset_sbus();
+    sbus_common_parse_buffer(&sbus, &stream[frames[k].start], FRAME_LENGTH, k);
+    if (!frames[k].corrupted && memcmp(sbus.pulses, ref, sizeof(ref)) != 0) {
+      wrong++;
+    }
+    nb_good += !frames[k].lost && !frames[k].corrupted;
+    nb_available += sbus.frame_available;
+  }
+  cmp_ok(wrong, "==", 0, "channels unpacked as with the bit per bit decoder");
+  note("%u frames, %u available", nb_frames, nb_available);
+  cmp_ok(nb_available, "==", nb_good, "lost and corrupted frames dropped");
+
+  ok(parse_buffers(&nb_available) == 0, "last frame of each buffer decoded with the stamp of its start byte");
+}
+
+static void test_uart(void)
+{
+  note("--- uart and latency");
+  uint32_t errors = parse_uart();
+  ok(nb_handled > 0 && handler_errors == 0, "frames handled from the uart buffer with their reception time");
+  ok(errors == 0, "latency from the reception to the actuators");
+  cmp_ok(radio_control.latency.nb_frames, "==", nb_handled, "one latency per handled frame");
+  note("latency min %u us, max %u us", radio_control.latency.min, radio_control.latency.max);
+  ok(radio_control.latency.min == 2500 && radio_control.latency.max >= 1002500,
+     "latency bounds with frames received over several events");
+}
+
+static void test_benchmark(void)
+{
+  note("--- decoding time per second of stream");
+  generate_stream();
+  uint16_t ref[SBUS_NB_CHANNEL];
+  clock_t start = clock();
+  for (uint32_t k = 0; k < nb_frames; k++) {
+    ref_decode(&stream[frames[k].start + 1], ref);
+  }
+  double t_ref = (double)(clock() - start) / CLOCKS_PER_SEC;
+  uint32_t nb_available;
+  start = clock();
+  parse_buffers(&nb_available);
+  double t_buffers = (double)(clock() - start) / CLOCKS_PER_SEC;
+  note("%u bytes/s: bit per bit unpacking only %.1f us/s, buffer decoder %.1f us/s (%.1f ns/byte)",
+       stream_len / STREAM_DURATION, t_ref * 1e6 / STREAM_DURATION,
+       t_buffers * 1e6 / STREAM_DURATION, t_buffers * 1e9 / stream_len);
+  ok(t_buffers < STREAM_DURATION * 0.01, "decoding below 1%% of the cpu time");
+}
+
+int main()
+{
+  note("running SBUS decoder tests");
+  plan(8);
+
+  sys_time.cpu_ticks_per_sec = 1000000;
+
+  test_decoder();
+  test_uart();
+  test_benchmark();
+
+  done_testing();
+}
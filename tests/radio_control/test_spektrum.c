@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_spektrum.c
+ * @brief Tests and benchmark of the spektrum frame decoder.
+ *
+ * Streams of satellite receivers are generated for a DSMX transmitter
+ * (12 channels, 11 bit, two frames every 22 ms) and a DSM2 transmitter
+ * (7 channels, 10 bit, one frame every 22 ms). The frames are split as the
+ * arch parsers do it from the time between the bytes, and the channels
+ * are decoded as a block and compared with a word per word decoder.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include "subsystems/radio_control/spektrum.h"
+#include "paparazzi.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#define STREAM_DURATION 60
+#define NB_SETS (STREAM_DURATION * 1000 / 22)
+#define MAX_FRAMES 2
+#define STREAM_MAX (NB_SETS * MAX_FRAMES * SPEKTRUM_FRAME_LENGTH)
+
+static uint8_t stream[STREAM_MAX];
+static uint32_t stream_len;
+/** channel values of each set of frames */
+static uint16_t sent[NB_SETS][SPEKTRUM_NB_CHANNEL];
+
+/*
+ * Stream generation
+ */
+
+static void put_word(uint8_t *p, uint16_t w)
+{
+  p[0] = w >> 8;
+  p[1] = w;
+}
+
+/** Generate a stream
+ * @param encoding 0 for 10 bit, 1 for 11 bit
+ * @param nb_channels number of channels sent
+ */
+static void generate_stream(uint8_t encoding, uint8_t nb_channels)
+{
+  const uint8_t shift = 10 + encoding;
+  const uint8_t nb_frames = (nb_channels + SPEKTRUM_CHANNELS_PER_FRAME - 1) / SPEKTRUM_CHANNELS_PER_FRAME;
+  stream_len = 0;
+  for (int k = 0; k < NB_SETS; k++) {
+    for (int c = 0; c < nb_channels; c++) {
+      sent[k][c] = (1 << (shift - 1)) + (int)((0x2AC >> (1 - encoding)) * sin(k * 0.02 + c));
+    }
+    for (int f = 0; f < nb_frames; f++) {
+      uint8_t *p = &stream[stream_len];
+      p[0] = k % 3;                                   /* lost frames */
+      p[1] = (encoding << 4) | nb_frames;             /* system */
+      for (int i = 0; i < SPEKTRUM_CHANNELS_PER_FRAME; i++) {
+        /* channels in reverse order, unused words at the end */
+        int c = nb_channels - 1 - (f * SPEKTRUM_CHANNELS_PER_FRAME + i);
+        uint16_t w = (c >= 0) ? (c << shift) | sent[k][c] : 0xffff;
+        if (f == 1 && i == 0) {
+          w |= 0x8000;
+        }
+        put_word(&p[2 + 2 * i], w);
+      }
+      stream_len += SPEKTRUM_FRAME_LENGTH;
+    }
+  }
+}
+
+/*
+ * Decoding
+ */
+
+/** Previous word per word decoder as reference */
+static uint8_t ref_decode(int16_t *values, const uint8_t *data, uint8_t nb_words,
+                          uint8_t encoding, uint8_t *max_channel)
+{
+  uint8_t nb = 0;
+  for (int i = 0; i < nb_words; i++) {
+    uint16_t ChannelData = ((uint16_t)data[2 * i] << 8) | data[2 * i + 1];
+    uint8_t ChannelNum;
+    switch (encoding) {
+      case (0) :
+        ChannelNum = (ChannelData >> 10) & 0x0f;
+        if (ChannelNum < SPEKTRUM_NB_CHANNEL) {
+          values[ChannelNum] = ChannelData & 0x3ff;
+          values[ChannelNum] -= 0x200;
+          values[ChannelNum] *= MAX_PPRZ / 0x156;
+          nb++;
+        }
+        break;
+      case (1) :
+        ChannelNum = (ChannelData >> 11) & 0x0f;
+        if (ChannelNum < SPEKTRUM_NB_CHANNEL) {
+          values[ChannelNum] = ChannelData & 0x7ff;
+          values[ChannelNum] -= 0x400;
+          values[ChannelNum] *= MAX_PPRZ / 0x2AC;
+          nb++;
+        }
+        break;
+      default : ChannelNum = 0x0F; break;
+    }
+    if ((ChannelNum != 0x0F) && (ChannelNum > *max_channel)) {
+      *max_channel = ChannelNum;
+    }
+  }
+  return nb;
+}
+
+typedef uint8_t (*decoder_t)(int16_t *, const uint8_t *, uint8_t, uint8_t, uint8_t *);
+
+/** Decoded sets of frames */
+static int16_t values[NB_SETS][SPEKTRUM_NB_CHANNEL];
+static uint8_t nb_values[NB_SETS];
+static uint8_t max_channels[NB_SETS];
+
+/** Replay the stream frame per frame as the main receiver parser
+ * @return number of decoded sets of frames
+ */
+static uint32_t replay(decoder_t decode)
+{
+  uint8_t data[MAX_FRAMES * SPEKTRUM_CHANNELS_PER_FRAME * 2];
+  uint8_t frame_cnt = 0;
+  uint32_t nb = 0;
+  for (uint32_t pos = 0; pos + SPEKTRUM_FRAME_LENGTH <= stream_len; pos += SPEKTRUM_FRAME_LENGTH) {
+    const uint8_t *frame = &stream[pos];
+    const uint8_t encoding = (frame[1] & 0x10) >> 4;
+    const uint8_t expected = frame[1] & 0x03;
+    const uint8_t second = (frame[2] & 0x80) ? 1 : 0;
+    memcpy(&data[second * SPEKTRUM_CHANNELS_PER_FRAME * 2], &frame[2], SPEKTRUM_CHANNELS_PER_FRAME * 2);
+    if (++frame_cnt == expected) {
+      frame_cnt = 0;
+      max_channels[nb] = 0;
+      nb_values[nb] = decode(values[nb], data, SPEKTRUM_CHANNELS_PER_FRAME * expected, encoding,
+                             &max_channels[nb]);
+      nb++;
+    }
+  }
+  return nb;
+}
+
+/** Check the decoded values against the sent ones */
+static bool_t check_values(uint32_t nb, uint8_t encoding, uint8_t nb_channels)
+{
+  const int16_t center = 1 << (9 + encoding);
+  const int16_t scale = encoding ? MAX_PPRZ / 0x2AC : MAX_PPRZ / 0x156;
+  if (nb != NB_SETS) {
+    return FALSE;
+  }
+  for (uint32_t k = 0; k < nb; k++) {
+    if (nb_values[k] != nb_channels || max_channels[k] != nb_channels - 1) {
+      return FALSE;
+    }
+    for (int c = 0; c < nb_channels; c++) {
+      if (values[k][c] != (sent[k][c] - center) * scale) {
+        return FALSE;
+      }
+    }
+  }
+  return TRUE;
+}
+
+static void test_decoder(void)
+{
+  note("--- decoder");
+  generate_stream(1, 12);
+  uint32_t nb = replay(spektrum_decode_channels);
+  ok(check_values(nb, 1, 12), "DSMX 11 bit channels decoded from two frames");
+  ok(nb_values[0] == 12 && max_channels[0] == 11, "unused words skipped");
+
+  generate_stream(0, 7);
+  nb = replay(spektrum_decode_channels);
+  ok(check_values(nb, 0, 7), "DSM2 10 bit channels decoded from one frame");
+
+  int16_t v[SPEKTRUM_NB_CHANNEL] = { 0 }, v_ref[SPEKTRUM_NB_CHANNEL] = { 0 };
+  uint8_t max = 0, max_ref = 0;
+  uint8_t data[SPEKTRUM_CHANNELS_PER_FRAME * 2];
+  for (int i = 0; i < SPEKTRUM_CHANNELS_PER_FRAME; i++) {
+    /* channels 0 to 5 and 13 */
+    put_word(&data[2 * i], ((i < 6 ? i : 13) << 11) | (0x400 + 50 * i));
+  }
+  uint8_t cnt = spektrum_decode_channels(v, data, SPEKTRUM_CHANNELS_PER_FRAME, 1, &max);
+  uint8_t cnt_ref = ref_decode(v_ref, data, SPEKTRUM_CHANNELS_PER_FRAME, 1, &max_ref);
+  ok(cnt == 6 && max == 13 && cnt_ref == cnt && max_ref == max && memcmp(v, v_ref, sizeof(v)) == 0,
+     "channels above the number of channels counted as missing");
+}
+
+static void benchmark(uint8_t encoding, uint8_t nb_channels, const char *name)
+{
+  generate_stream(encoding, nb_channels);
+  clock_t start = clock();
+  replay(ref_decode);
+  double t_ref = (double)(clock() - start) / CLOCKS_PER_SEC;
+  start = clock();
+  replay(spektrum_decode_channels);
+  double t_block = (double)(clock() - start) / CLOCKS_PER_SEC;
+  note("%s, %u bytes/s: word per word decoder %.1f us/s, block decoder %.1f us/s (%.1f ns/byte)",
+       name, stream_len / STREAM_DURATION, t_ref * 1e6 / STREAM_DURATION,
+       t_block * 1e6 / STREAM_DURATION, t_block * 1e9 / stream_len);
+  ok(t_block < STREAM_DURATION * 0.01, "%s decoding below 1%% of the cpu time", name);
+}
+
+int main()
+{
+  note("running spektrum decoder tests");
+  plan(6);
+
+  test_decoder();
+
+  note("--- decoding time per second of stream");
+  benchmark(1, 12, "DSMX");
+  benchmark(0, 7, "DSM2");
+
+  done_testing();
+}
@@ -0,0 +1,22 @@
+/* Stub of the generated settings header for test_persistent_settings */
+
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+/* Persistent Settings */
+struct PersistentSettings {
+  float s_0; /* gain_a */
+  int32_t s_1; /* gain_b */
+  uint8_t s_2; /* mode */
+};
+
+extern struct PersistentSettings pers_settings;
+
+#define PERSISTENT_SETTINGS_NB 3
+#define PERSISTENT_SETTINGS_DESC { \
+ { "gain_a", offsetof(struct PersistentSettings, s_0), sizeof(pers_settings.s_0) }, \
+ { "gain_b", offsetof(struct PersistentSettings, s_1), sizeof(pers_settings.s_1) }, \
+ { "mode", offsetof(struct PersistentSettings, s_2), sizeof(pers_settings.s_2) }, \
+}
+
+#endif // SETTINGS_H
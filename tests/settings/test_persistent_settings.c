@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2015 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_persistent_settings.c
+ * @brief Tests for the linux persistent settings store.
+ *
+ * Uses the stub generated/settings.h of this directory.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "subsystems/settings.h"
+#include "generated/settings.h"
+
+#define SETTINGS_FILE "pprz_persistent_settings.binary"
+
+struct PersistentSettings pers_settings;
+
+static long file_size(const char *name)
+{
+  struct stat st;
+  if (stat(name, &st) < 0) {
+    return -1;
+  }
+  return st.st_size;
+}
+
+static void set_defaults(struct PersistentSettings *s)
+{
+  s->s_0 = 1.5;
+  s->s_1 = 42;
+  s->s_2 = 3;
+}
+
+/* write a record as the previous firmware would have done */
+static uint32_t fnv1a(const char *s)
+{
+  uint32_t h = 2166136261UL;
+  while (*s) { h ^= (uint8_t)*s++; h *= 16777619UL; }
+  return h;
+}
+
+static uint32_t crc32(const uint8_t *buf, uint32_t len)
+{
+  uint32_t crc = 0xFFFFFFFF;
+  uint32_t i;
+  int k;
+  for (i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (k = 0; k < 8; k++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (-(crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static void fwrite_record(FILE *f, const char *name, const void *val, uint8_t len)
+{
+  uint8_t b[32];
+  uint32_t key = fnv1a(name);
+  memcpy(b, &key, 4);
+  b[4] = len;
+  b[5] = 0;
+  memcpy(&b[6], val, len);
+  uint32_t crc = crc32(b, 6 + len);
+  memcpy(&b[6 + len], &crc, 4);
+  fwrite(b, 1, 10 + len, f);
+}
+
+int main()
+{
+  struct PersistentSettings s;
+
+  note("running persistent settings tests");
+  plan(8);
+
+  remove(SETTINGS_FILE);
+
+  set_defaults(&s);
+  ok(persistent_read(&s, sizeof(s)) != 0 && s.s_1 == 42,
+     "reading without file fails and keeps defaults");
+
+  s.s_0 = 2.5; s.s_1 = -7; s.s_2 = 9;
+  ok(persistent_write(&s, sizeof(s)) == 0, "first write (full file)");
+  long full_size = file_size(SETTINGS_FILE);
+
+  set_defaults(&s);
+  ok(persistent_read(&s, sizeof(s)) == 0 && s.s_0 == 2.5 && s.s_1 == -7 && s.s_2 == 9,
+     "settings are read back");
+
+  s.s_1 = 100;
+  persistent_write(&s, sizeof(s));
+  long size_one = file_size(SETTINGS_FILE);
+  ok(size_one == full_size + 10 + 4,
+     "saving one changed setting only appends its record (%ld -> %ld bytes)", full_size, size_one);
+
+  /* power loss in the middle of the next append */
+  s.s_1 = 200;
+  persistent_write(&s, sizeof(s));
+  truncate(SETTINGS_FILE, file_size(SETTINGS_FILE) - 3);
+  set_defaults(&s);
+  ok(persistent_read(&s, sizeof(s)) == 0 && s.s_1 == 100 && s.s_0 == 2.5,
+     "a torn record is ignored and the previous value is kept (got %d)", s.s_1);
+
+  /* many saves are compacted */
+  int i;
+  for (i = 0; i < 100; i++) {
+    s.s_1 = i;
+    persistent_write(&s, sizeof(s));
+  }
+  set_defaults(&s);
+  persistent_read(&s, sizeof(s));
+  ok(file_size(SETTINGS_FILE) <= full_size + 8 * 3 * 14 && s.s_1 == 99 &&
+     file_size(SETTINGS_FILE ".tmp") < 0,
+     "file is compacted (%ld bytes) and holds the last value (%d)", file_size(SETTINGS_FILE), s.s_1);
+
+  /* file from a previous firmware with another settings list */
+  FILE *f = fopen(SETTINGS_FILE, "wb");
+  uint32_t header[3] = {0x53505050, 2, 0xdeadbeef};
+  fwrite(header, 4, 3, f);
+  float old_a = 7.25;
+  int16_t old_removed = 3;
+  uint8_t old_mode = 1;
+  fwrite_record(f, "gain_a", &old_a, 4);
+  fwrite_record(f, "removed_setting", &old_removed, 2);
+  fwrite_record(f, "mode", &old_mode, 1);
+  fclose(f);
+  set_defaults(&s);
+  ok(persistent_read(&s, sizeof(s)) == 0 && s.s_0 == 7.25f && s.s_1 == 42 && s.s_2 == 1,
+     "settings are migrated by name after a schema change");
+  persistent_write(&s, sizeof(s));
+  ok(file_size(SETTINGS_FILE) == full_size,
+     "next save rewrites the file with the current schema");
+
+  remove(SETTINGS_FILE);
+  done_testing();
+}